@@ -1,2 +1,47 @@
+#include <stdlib.h>
+
+#include "stb_image_allocator.h"
+
+#if defined(_MSC_VER)
+#define STBI_ALLOCATOR_THREAD_LOCAL __declspec(thread)
+#else
+#define STBI_ALLOCATOR_THREAD_LOCAL __thread
+#endif
+
+static STBI_ALLOCATOR_THREAD_LOCAL const stbi_allocator *stbi__allocator;
+
+const stbi_allocator *stbi_set_thread_allocator(
+    const stbi_allocator *allocator) {
+  const stbi_allocator *previous = stbi__allocator;
+  stbi__allocator = allocator;
+  return previous;
+}
+
+static void *stbi__allocator_malloc(size_t size) {
+  if (stbi__allocator)
+    return stbi__allocator->allocate(stbi__allocator->user, size);
+  return malloc(size);
+}
+
+static void *stbi__allocator_realloc(void *data, size_t old_size,
+    size_t new_size) {
+  if (stbi__allocator)
+    return stbi__allocator->reallocate(stbi__allocator->user, data,
+        old_size, new_size);
+  return realloc(data, new_size);
+}
+
+static void stbi__allocator_free(void *data) {
+  if (stbi__allocator)
+    stbi__allocator->free(stbi__allocator->user, data);
+  else
+    free(data);
+}
+
+#define STBI_MALLOC(size) stbi__allocator_malloc(size)
+#define STBI_REALLOC_SIZED(data, old_size, new_size)                         \
+  stbi__allocator_realloc(data, old_size, new_size)
+#define STBI_FREE(data) stbi__allocator_free(data)
+
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
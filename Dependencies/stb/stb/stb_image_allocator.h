@@ -0,0 +1,27 @@
+#ifndef STB_IMAGE_ALLOCATOR_H
+#define STB_IMAGE_ALLOCATOR_H
+
+#include <stddef.h>
+
+typedef void *(*stbi_allocate_callback)(void *user, size_t size);
+typedef void *(*stbi_reallocate_callback)(void *user, void *data,
+    size_t old_size, size_t new_size);
+typedef void (*stbi_free_callback)(void *user, void *data);
+
+typedef struct stbi_allocator {
+  stbi_allocate_callback allocate;
+  stbi_reallocate_callback reallocate;
+  stbi_free_callback free;
+  void *user;
+} stbi_allocator;
+
+/* stb_image has no way to pass a context to STBI_MALLOC, so the allocator
+   is per thread. Every allocation made by stbi_load* on this thread, the
+   returned pixels included, goes through it until it is changed again. A
+   NULL allocator falls back to malloc. Returns the previous allocator so
+   callers can restore it. The old size is passed to reallocate so
+   allocators without a realloc of their own can copy instead. */
+const stbi_allocator *stbi_set_thread_allocator(
+    const stbi_allocator *allocator);
+
+#endif
@@ -1,11 +1,14 @@
 #version 450
 
 layout(set = 0, binding = 0) uniform UBO {
-  mat4 model;
   mat4 view;
   mat4 projection;
 } ubo;
 
+layout(push_constant) uniform PushConstants {
+  mat4 model;
+} pushConstants;
+
 layout (location = 0) in vec3 inPosition;
 layout (location = 1) in vec3 inColor;
 layout (location = 2) in vec2 inUV;
@@ -18,9 +21,10 @@ void main() {
   outUV = inUV;
 
 #if 1
-  gl_Position = ubo.projection * ubo.view * ubo.model * vec4(inPosition, 1.0);
+  gl_Position = ubo.projection * ubo.view * pushConstants.model *
+                vec4(inPosition, 1.0);
 #elif 0
-  gl_Position = ubo.model * vec4(inPosition, 1.0);
+  gl_Position = pushConstants.model * vec4(inPosition, 1.0);
 #elif 0
   gl_Position = vec4(inPosition, 1.0);
 #elif 0
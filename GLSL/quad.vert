@@ -0,0 +1,28 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform UBO {
+  mat4 view;
+  mat4 projection;
+} ubo;
+
+layout(push_constant) uniform PushConstants {
+  mat4 model;
+} pushConstants;
+
+layout (location = 0) in vec2 inCorner;
+layout (location = 1) in vec4 inRect;
+layout (location = 2) in vec4 inUVRect;
+layout (location = 3) in vec3 inColor;
+
+layout (location = 0) out vec3 outColor;
+layout (location = 1) out vec2 outUV;
+
+void main() {
+  vec2 position = mix(inRect.xy, inRect.zw, inCorner);
+
+  outColor = inColor;
+  outUV = mix(inUVRect.xy, inUVRect.zw, inCorner);
+
+  gl_Position = ubo.projection * ubo.view * pushConstants.model *
+                vec4(position, 0.0, 1.0);
+}
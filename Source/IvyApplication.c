@@ -87,10 +87,13 @@ IVY_API char const *const *ivyGetRequiredVulkanExtensions(
 }
 
 IVY_API VkResult ivyCreateVulkanSurface(VkInstance instance,
-    IvyApplication *application, VkSurfaceKHR *surface) {
+    IvyApplication *application,
+    VkAllocationCallbacks const *allocationCallbacks, VkSurfaceKHR *surface) {
 #if defined(IVY_USE_GLFW)
-  return ivyGLFWCreateVulkanSurface(instance, application, surface);
+  return ivyGLFWCreateVulkanSurface(instance, application,
+      allocationCallbacks, surface);
 #elif defined(IVY_USE_COCOA)
-  return ivyCocoaCreateVulkanSurface(instance, application, surface);
+  return ivyCocoaCreateVulkanSurface(instance, application,
+      allocationCallbacks, surface);
 #endif
 }
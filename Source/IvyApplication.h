@@ -41,6 +41,7 @@ IVY_API char const *const *ivyGetRequiredVulkanExtensions(
     IvyApplication *application, uint32_t *count);
 
 IVY_API VkResult ivyCreateVulkanSurface(VkInstance instance,
-    IvyApplication *application, VkSurfaceKHR *surface);
+    IvyApplication *application,
+    VkAllocationCallbacks const *allocationCallbacks, VkSurfaceKHR *surface);
 
 #endif
@@ -1,63 +1,342 @@
+#define _DEFAULT_SOURCE
+
 #include "IvyArenaMemoryAllocator.h"
 
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 IVY_INTERNAL uint64_t ivyRoundUp(uint64_t value, uint64_t by) {
-  uint64_t const n = value / by;
+  return ((value + by - 1) / by) * by;
+}
+
+IVY_INTERNAL uint64_t ivyGetArenaMemoryBlockHeaderSize(uint64_t alignment) {
+  return ivyRoundUp(sizeof(IvyArenaMemoryBlock), alignment);
+}
+
+IVY_INTERNAL uint8_t *ivyGetArenaMemoryBlockData(IvyArenaMemoryBlock *block,
+    uint64_t alignment) {
+  return (uint8_t *)block + ivyGetArenaMemoryBlockHeaderSize(alignment);
+}
+
+IVY_INTERNAL IvyArenaMemoryBlock *ivyCreateArenaMemoryBlock(uint64_t capacity,
+    uint64_t alignment, IvyArenaMemoryBlock *previous) {
+  IvyArenaMemoryBlock *block;
+
+  block = malloc(ivyGetArenaMemoryBlockHeaderSize(alignment) + capacity);
+  if (!block) {
+    return NULL;
+  }
+
+  block->previous = previous;
+  block->capacity = capacity;
+  block->position = 0;
+
+  return block;
+}
+
+// NOTE: the whole range starts inaccessible, only the first granule is
+//       committed so the header can be written
+IVY_INTERNAL IvyArenaMemoryBlock *ivyReserveArenaMemoryBlock(
+    IvyArenaMemoryAllocator *arenaAllocator, uint64_t capacity,
+    IvyBool useHugePages) {
+  void *region = MAP_FAILED;
+  IvyArenaMemoryBlock *block;
+  uint64_t const headerSize =
+      ivyGetArenaMemoryBlockHeaderSize(arenaAllocator->alignment);
+  uint64_t const reservedSize =
+      ivyRoundUp(headerSize + capacity, arenaAllocator->commitGranularity);
+
+  // NOTE: explicit huge pages are taken from the pool when mapping, so this
+  //       fails right away instead of faulting later when the pool is short
+#ifdef MAP_HUGETLB
+  if (useHugePages) {
+    region = mmap(NULL, reservedSize, PROT_NONE,
+        MAP_PRIVATE | MAP_ANON | MAP_HUGETLB, -1, 0);
+  }
+#endif
+
+  if (MAP_FAILED == region) {
+    region = mmap(NULL, reservedSize, PROT_NONE, MAP_PRIVATE | MAP_ANON, -1,
+        0);
+    if (MAP_FAILED == region) {
+      return NULL;
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (useHugePages) {
+      madvise(region, reservedSize, MADV_HUGEPAGE);
+    }
+#endif
+  }
+
+  if (mprotect(region, arenaAllocator->commitGranularity,
+          PROT_READ | PROT_WRITE)) {
+    munmap(region, reservedSize);
+    return NULL;
+  }
+
+  arenaAllocator->committedSize = arenaAllocator->commitGranularity;
+
+  block = region;
+  block->previous = NULL;
+  block->capacity = reservedSize - headerSize;
+  block->position = 0;
+
+  return block;
+}
+
+IVY_INTERNAL void ivyDestroyArenaMemoryBlock(
+    IvyArenaMemoryAllocator *arenaAllocator, IvyArenaMemoryBlock *block) {
+  if (arenaAllocator->isVirtual) {
+    munmap(block,
+        ivyGetArenaMemoryBlockHeaderSize(arenaAllocator->alignment) +
+            block->capacity);
+  } else {
+    free(block);
+  }
+}
+
+// NOTE: makes sure everything up to position is backed by memory. Always
+//       succeeds for arenas that aren't virtual
+IVY_INTERNAL IvyBool ivyCommitArenaMemory(
+    IvyArenaMemoryAllocator *arenaAllocator, uint64_t position) {
+  uint64_t newCommittedSize;
+  uint64_t const headerSize =
+      ivyGetArenaMemoryBlockHeaderSize(arenaAllocator->alignment);
+
+  if (!arenaAllocator->isVirtual) {
+    return 1;
+  }
+
+  if (headerSize + position <= arenaAllocator->committedSize) {
+    return 1;
+  }
 
-  if (!value) {
+  newCommittedSize = ivyRoundUp(headerSize + position,
+      arenaAllocator->commitGranularity);
+
+  if (mprotect((uint8_t *)arenaAllocator->currentBlock +
+                   arenaAllocator->committedSize,
+          newCommittedSize - arenaAllocator->committedSize,
+          PROT_READ | PROT_WRITE)) {
     return 0;
   }
 
-  return by * n + n;
+  arenaAllocator->committedSize = newCommittedSize;
+
+  return 1;
+}
+
+// NOTE: gives the pages past the retained size back to the system, they
+//       read as zero once they are committed again
+IVY_INTERNAL void ivyDecommitArenaMemory(
+    IvyArenaMemoryAllocator *arenaAllocator) {
+  uint64_t retainedSize;
+  uint8_t *block = (uint8_t *)arenaAllocator->currentBlock;
+
+  if (!arenaAllocator->isVirtual) {
+    return;
+  }
+
+  retainedSize = ivyRoundUp(
+      ivyGetArenaMemoryBlockHeaderSize(arenaAllocator->alignment) +
+          arenaAllocator->retainedCommitSize,
+      arenaAllocator->commitGranularity);
+
+  if (arenaAllocator->committedSize <= retainedSize) {
+    return;
+  }
+
+  madvise(block + retainedSize, arenaAllocator->committedSize - retainedSize,
+      MADV_DONTNEED);
+  mprotect(block + retainedSize, arenaAllocator->committedSize - retainedSize,
+      PROT_NONE);
+
+  arenaAllocator->committedSize = retainedSize;
+}
+
+IVY_INTERNAL void ivySetCurrentArenaMemoryBlock(
+    IvyArenaMemoryAllocator *arenaAllocator, IvyArenaMemoryBlock *block) {
+  arenaAllocator->currentBlock = block;
+  arenaAllocator->capacity = block->capacity;
+  arenaAllocator->position = block->position;
+  arenaAllocator->data =
+      ivyGetArenaMemoryBlockData(block, arenaAllocator->alignment);
+}
+
+IVY_INTERNAL IvyBool ivyChainArenaMemoryBlock(
+    IvyArenaMemoryAllocator *arenaAllocator, uint64_t size) {
+  IvyArenaMemoryBlock *block;
+  uint64_t capacity = arenaAllocator->blockSize;
+
+  if (capacity < size) {
+    capacity = size;
+  }
+
+  block = ivyCreateArenaMemoryBlock(capacity, arenaAllocator->alignment,
+      arenaAllocator->currentBlock);
+  if (!block) {
+    return 0;
+  }
+
+  arenaAllocator->currentBlock->position = arenaAllocator->position;
+  ivySetCurrentArenaMemoryBlock(arenaAllocator, block);
+
+  return 1;
 }
 
-#include <stdio.h>
 IVY_INTERNAL void *ivyArenaMemoryAllocatorAllocate(
     IvyAnyMemoryAllocator allocator, uint64_t size) {
   uint64_t position;
   uint64_t newPosition;
-  uint64_t requiredSize;
   IvyArenaMemoryAllocator *arenaAllocator = allocator;
-  uint8_t *data = arenaAllocator->data;
+
+  if (arenaAllocator->position + size > arenaAllocator->capacity) {
+    if (!arenaAllocator->isGrowable) {
+      return NULL;
+    }
+
+    if (!ivyChainArenaMemoryBlock(arenaAllocator, size)) {
+      return NULL;
+    }
+  }
 
   position = arenaAllocator->position;
   newPosition = position + ivyRoundUp(size, arenaAllocator->alignment);
-  requiredSize = position + size;
 
-  printf("%s\n", __PRETTY_FUNCTION__);
-  printf("  arenaAllocator: %p, position: %llu\n  newPosition: %llu\n",
-      allocator, position, newPosition);
+  // NOTE: the padding of the last allocation may not fit
+  if (newPosition > arenaAllocator->capacity) {
+    newPosition = arenaAllocator->capacity;
+  }
 
-  if (requiredSize > arenaAllocator->capacity)
+  if (!ivyCommitArenaMemory(arenaAllocator, newPosition)) {
     return NULL;
+  }
 
   arenaAllocator->position = newPosition;
 
   ++arenaAllocator->aliveAllocationCount;
-  return arenaAllocator->previousAllocation = data + position;
+  return arenaAllocator->previousAllocation =
+             (uint8_t *)arenaAllocator->data + position;
 }
 
 IVY_INTERNAL void *ivyArenaMemoryAllocatorAllocateAndZeroMemory(
     IvyAnyMemoryAllocator allocator, uint64_t count, uint64_t elementSize) {
   uint64_t size = count * elementSize;
   void *allocation = ivyAllocateMemory(allocator, size);
-  IVY_MEMSET(allocation, 0, size);
+  if (allocation) {
+    IVY_MEMSET(allocation, 0, size);
+  }
   return allocation;
 }
 
+// NOTE: allocations don't store their size, so this is how many bytes from
+//       data to the end of the used part of its block. Never less than the
+//       size of the allocation, maybe more
+IVY_INTERNAL uint64_t ivyGetArenaMemoryAllocationMaxSize(
+    IvyArenaMemoryAllocator *arenaAllocator, void *data) {
+  uint64_t position = arenaAllocator->position;
+  IvyArenaMemoryBlock *block = arenaAllocator->currentBlock;
+
+  while (block) {
+    uint8_t *blockData =
+        ivyGetArenaMemoryBlockData(block, arenaAllocator->alignment);
+
+    if (blockData <= (uint8_t *)data &&
+        (uint8_t *)data <= blockData + block->capacity) {
+      return blockData + position - (uint8_t *)data;
+    }
+
+    block = block->previous;
+    if (block) {
+      position = block->position;
+    }
+  }
+
+  IVY_ASSERT(0 && "data was not allocated by this arena");
+  return 0;
+}
+
 IVY_INTERNAL void *ivyArenaMemoryAllocatorReallocate(
     IvyAnyMemoryAllocator allocator, void *data, uint64_t newSize) {
-  IVY_UNUSED(allocator);
-  IVY_UNUSED(data);
-  IVY_UNUSED(newSize);
-  return NULL;
+  void *newData;
+  uint64_t copySize;
+  IvyArenaMemoryAllocator *arenaAllocator = allocator;
+
+  if (!data) {
+    return ivyArenaMemoryAllocatorAllocate(allocator, newSize);
+  }
+
+  // NOTE: the top allocation just moves the position when it still fits
+  if (data == arenaAllocator->previousAllocation) {
+    uint64_t const offset =
+        (uint8_t *)data - (uint8_t *)arenaAllocator->data;
+
+    if (offset + newSize <= arenaAllocator->capacity) {
+      uint64_t newPosition =
+          offset + ivyRoundUp(newSize, arenaAllocator->alignment);
+
+      if (newPosition > arenaAllocator->capacity) {
+        newPosition = arenaAllocator->capacity;
+      }
+
+      if (!ivyCommitArenaMemory(arenaAllocator, newPosition)) {
+        return NULL;
+      }
+
+      arenaAllocator->position = newPosition;
+      return data;
+    }
+  }
+
+  copySize = ivyGetArenaMemoryAllocationMaxSize(arenaAllocator, data);
+  if (copySize > newSize) {
+    copySize = newSize;
+  }
+
+  newData = ivyArenaMemoryAllocatorAllocate(allocator, newSize);
+  if (!newData) {
+    return NULL;
+  }
+
+  IVY_MEMCPY(newData, data, copySize);
+
+  // NOTE: the old allocation is dead now, there is at least the new one
+  //       alive so this never clears the arena
+  --arenaAllocator->aliveAllocationCount;
+
+  return newData;
 }
 
 IVY_INTERNAL void ivyArenaMemoryAllocatorClear(
     IvyAnyMemoryAllocator allocator) {
+  IvyArenaMemoryBlock *block;
   IvyArenaMemoryAllocator *arenaAllocator = allocator;
-  arenaAllocator->position = 0;
+  IvyArenaMemoryBlock *largestBlock = arenaAllocator->currentBlock;
+
+  for (block = largestBlock->previous; block; block = block->previous) {
+    if (block->capacity > largestBlock->capacity) {
+      largestBlock = block;
+    }
+  }
+
+  block = arenaAllocator->currentBlock;
+  while (block) {
+    IvyArenaMemoryBlock *previous = block->previous;
+
+    if (block != largestBlock) {
+      ivyDestroyArenaMemoryBlock(arenaAllocator, block);
+    }
+
+    block = previous;
+  }
+
+  largestBlock->previous = NULL;
+  largestBlock->position = 0;
+  ivySetCurrentArenaMemoryBlock(arenaAllocator, largestBlock);
+  ivyDecommitArenaMemory(arenaAllocator);
+
   arenaAllocator->previousAllocation = NULL;
   arenaAllocator->aliveAllocationCount = 0;
 }
@@ -66,24 +345,48 @@ IVY_INTERNAL void ivyArenaMemoryAllocatorFree(IvyAnyMemoryAllocator allocator,
     void *data) {
   IvyArenaMemoryAllocator *arenaAllocator = allocator;
 
-  IVY_UNUSED(data);
+  if (!data) {
+    return;
+  }
 
   IVY_ASSERT(arenaAllocator->aliveAllocationCount);
 
+  // NOTE: freeing the top allocation gives its memory back right away
+  if (data == arenaAllocator->previousAllocation) {
+    arenaAllocator->position =
+        (uint8_t *)data - (uint8_t *)arenaAllocator->data;
+    arenaAllocator->previousAllocation = NULL;
+  }
+
   if (arenaAllocator->aliveAllocationCount) {
     --arenaAllocator->aliveAllocationCount;
   }
 
+  // NOTE: with nothing alive the current block can be reused from the
+  //       start. The chain is kept as is, markers may still point at any of
+  //       its blocks
   if (!arenaAllocator->aliveAllocationCount) {
-    ivyClearMemoryAllocator(allocator);
+    arenaAllocator->position = 0;
+    arenaAllocator->previousAllocation = NULL;
+    ivyDecommitArenaMemory(arenaAllocator);
   }
 }
 
 IVY_INTERNAL void ivyArenaMemoryAllocatorDestroy(
     IvyAnyMemoryAllocator allocator) {
   IvyArenaMemoryAllocator *arenaAllocator = allocator;
+  IvyArenaMemoryBlock *block = arenaAllocator->currentBlock;
+
   IVY_ASSERT(!arenaAllocator->aliveAllocationCount);
-  free(arenaAllocator->data);
+
+  while (block) {
+    IvyArenaMemoryBlock *previous = block->previous;
+    ivyDestroyArenaMemoryBlock(arenaAllocator, block);
+    block = previous;
+  }
+
+  arenaAllocator->currentBlock = NULL;
+  arenaAllocator->data = NULL;
 }
 
 static IvyMemoryAllocatorDispatch arenaMemoryAllocatorDispatch = {
@@ -92,23 +395,88 @@ static IvyMemoryAllocatorDispatch arenaMemoryAllocatorDispatch = {
     ivyArenaMemoryAllocatorReallocate, ivyArenaMemoryAllocatorFree,
     ivyArenaMemoryAllocatorClear, ivyArenaMemoryAllocatorDestroy};
 
-IVY_API IvyCode ivyCreateArenaMemoryAllocator(uint64_t size,
-    IvyArenaMemoryAllocator *allocator) {
-
-  // FIXME(Samuel): instead of using malloc, give some way to overload this or
-  // just ask for a buffer instead
+IVY_INTERNAL IvyCode ivySetupArenaMemoryAllocator(uint64_t blockSize,
+    IvyBool isGrowable, IvyBool isVirtual, IvyBool useHugePages,
+    uint64_t retainedCommitSize, IvyArenaMemoryAllocator *allocator) {
+  IvyArenaMemoryBlock *block;
 
   ivySetupMemoryAllocatorBase(&arenaMemoryAllocatorDispatch, &allocator->base);
 
-  allocator->capacity = size;
-  allocator->position = 0;
+  allocator->isGrowable = isGrowable;
+  allocator->isVirtual = isVirtual;
+  allocator->commitGranularity = 0;
+  allocator->committedSize = 0;
+  allocator->retainedCommitSize = retainedCommitSize;
+  allocator->blockSize = blockSize;
   allocator->alignment = sizeof(void *);
   allocator->aliveAllocationCount = 0;
   allocator->previousAllocation = NULL;
-  allocator->data = malloc(allocator->capacity);
-  if (!allocator->data) {
+  allocator->capacity = 0;
+  allocator->position = 0;
+  allocator->data = NULL;
+  allocator->currentBlock = NULL;
+
+  if (isVirtual) {
+    uint64_t const pageSize = (uint64_t)sysconf(_SC_PAGESIZE);
+
+    allocator->commitGranularity =
+        useHugePages ? IVY_ARENA_HUGE_PAGE_SIZE
+                     : ivyRoundUp(IVY_ARENA_COMMIT_GRANULARITY, pageSize);
+
+    block = ivyReserveArenaMemoryBlock(allocator, blockSize, useHugePages);
+  } else {
+    block = ivyCreateArenaMemoryBlock(blockSize, allocator->alignment, NULL);
+  }
+
+  if (!block) {
     return IVY_ERROR_NO_MEMORY;
   }
 
+  ivySetCurrentArenaMemoryBlock(allocator, block);
+
   return IVY_OK;
 }
+
+IVY_API IvyCode ivyCreateArenaMemoryAllocator(uint64_t size,
+    IvyArenaMemoryAllocator *allocator) {
+  return ivySetupArenaMemoryAllocator(size, 0, 0, 0, 0, allocator);
+}
+
+IVY_API IvyCode ivyCreateGrowableArenaMemoryAllocator(uint64_t blockSize,
+    IvyArenaMemoryAllocator *allocator) {
+  return ivySetupArenaMemoryAllocator(blockSize, 1, 0, 0, 0, allocator);
+}
+
+IVY_API IvyCode ivyCreateVirtualArenaMemoryAllocator(uint64_t reserveSize,
+    uint64_t retainedCommitSize, IvyBool useHugePages,
+    IvyArenaMemoryAllocator *allocator) {
+  return ivySetupArenaMemoryAllocator(reserveSize, 0, 1, useHugePages,
+      retainedCommitSize, allocator);
+}
+
+IVY_API void ivyGetArenaMemoryMarker(IvyArenaMemoryAllocator *allocator,
+    IvyArenaMemoryMarker *marker) {
+  marker->block = allocator->currentBlock;
+  marker->position = allocator->position;
+  marker->aliveAllocationCount = allocator->aliveAllocationCount;
+}
+
+IVY_API void ivyFreeArenaMemoryToMarker(IvyArenaMemoryAllocator *allocator,
+    IvyArenaMemoryMarker const *marker) {
+  IVY_ASSERT(marker->aliveAllocationCount <= allocator->aliveAllocationCount);
+
+  while (allocator->currentBlock != marker->block) {
+    IvyArenaMemoryBlock *previous = allocator->currentBlock->previous;
+
+    IVY_ASSERT(previous);
+
+    ivyDestroyArenaMemoryBlock(allocator, allocator->currentBlock);
+    allocator->currentBlock = previous;
+  }
+
+  allocator->currentBlock->position = marker->position;
+  ivySetCurrentArenaMemoryBlock(allocator, allocator->currentBlock);
+
+  allocator->previousAllocation = NULL;
+  allocator->aliveAllocationCount = marker->aliveAllocationCount;
+}
@@ -3,17 +3,73 @@
 
 #include "IvyMemoryAllocator.h"
 
+// NOTE: virtual arenas commit at least this much at a time, or a whole
+//       huge page when they use them
+#define IVY_ARENA_COMMIT_GRANULARITY (64 * 1024)
+#define IVY_ARENA_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// NOTE: every block is a single malloc, the header sits right before the
+//       data. previous points to the block that was current before this one
+typedef struct IvyArenaMemoryBlock {
+  struct IvyArenaMemoryBlock *previous;
+  uint64_t capacity;
+  uint64_t position;
+} IvyArenaMemoryBlock;
+
+// NOTE: capacity, position and data always describe the current block. When
+//       the arena is growable and the current block runs out, a new block
+//       of at least blockSize is chained in front of it. A virtual arena
+//       has a single reserved block instead, committedSize is how much of
+//       it (header included) is backed by memory
 typedef struct IvyArenaMemoryAllocator {
   IvyMemoryAllocatorBase base;
+  IvyBool isGrowable;
+  IvyBool isVirtual;
+  uint64_t commitGranularity;
+  uint64_t committedSize;
+  uint64_t retainedCommitSize;
+  uint64_t blockSize;
   uint64_t capacity;
   uint64_t position;
   uint64_t alignment;
   int32_t aliveAllocationCount;
   void *previousAllocation;
   void *data;
+  IvyArenaMemoryBlock *currentBlock;
 } IvyArenaMemoryAllocator;
 
+typedef struct IvyArenaMemoryMarker {
+  IvyArenaMemoryBlock *block;
+  uint64_t position;
+  int32_t aliveAllocationCount;
+} IvyArenaMemoryMarker;
+
+// NOTE: a single block of size bytes, allocations that don't fit fail
 IVY_API IvyCode ivyCreateArenaMemoryAllocator(uint64_t size,
     IvyArenaMemoryAllocator *allocator);
 
+// NOTE: starts with a block of blockSize bytes and chains new ones when it
+//       runs out. Clearing keeps only the largest block around
+IVY_API IvyCode ivyCreateGrowableArenaMemoryAllocator(uint64_t blockSize,
+    IvyArenaMemoryAllocator *allocator);
+
+// NOTE: reserves reserveSize bytes of address space with mmap and only
+//       commits pages as the position reaches them, so a big arena costs
+//       what it touches. Clearing decommits everything past
+//       retainedCommitSize. With useHugePages it asks for explicit huge
+//       pages first, which come out of the pool for the whole reservation,
+//       and falls back to transparent huge pages where the system has them
+IVY_API IvyCode ivyCreateVirtualArenaMemoryAllocator(uint64_t reserveSize,
+    uint64_t retainedCommitSize, IvyBool useHugePages,
+    IvyArenaMemoryAllocator *allocator);
+
+IVY_API void ivyGetArenaMemoryMarker(IvyArenaMemoryAllocator *allocator,
+    IvyArenaMemoryMarker *marker);
+
+// NOTE: releases everything allocated after the marker was taken, blocks
+//       chained since then included. Markers have to be freed in reverse
+//       order and a clear invalidates all of them
+IVY_API void ivyFreeArenaMemoryToMarker(IvyArenaMemoryAllocator *allocator,
+    IvyArenaMemoryMarker const *marker);
+
 #endif
@@ -0,0 +1,25 @@
+#ifndef IVY_ATOMIC_H
+#define IVY_ATOMIC_H
+
+#include "IvyDeclarations.h"
+
+// NOTE: C90 has no atomics, so these wrap the GCC/Clang builtins. Loads
+//       acquire, stores release and read-modify-writes do both
+#define IVY_ATOMIC_LOAD(pointer) __atomic_load_n((pointer), __ATOMIC_ACQUIRE)
+
+#define IVY_ATOMIC_STORE(pointer, value)                                     \
+  __atomic_store_n((pointer), (value), __ATOMIC_RELEASE)
+
+// NOTE: both return the value after the operation
+#define IVY_ATOMIC_ADD(pointer, value)                                       \
+  __atomic_add_fetch((pointer), (value), __ATOMIC_ACQ_REL)
+
+#define IVY_ATOMIC_SUB(pointer, value)                                       \
+  __atomic_sub_fetch((pointer), (value), __ATOMIC_ACQ_REL)
+
+// NOTE: on failure *expected is updated with the current value
+#define IVY_ATOMIC_COMPARE_EXCHANGE(pointer, expected, desired)              \
+  __atomic_compare_exchange_n((pointer), (expected), (desired), 0,           \
+      __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+#endif
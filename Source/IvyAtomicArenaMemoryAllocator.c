@@ -0,0 +1,136 @@
+#include "IvyAtomicArenaMemoryAllocator.h"
+
+#include "IvyAtomic.h"
+
+#include <stdlib.h>
+
+typedef struct IvyAtomicArenaMemoryHeader {
+  uint64_t size;
+  uint64_t padding;
+} IvyAtomicArenaMemoryHeader;
+
+#define IVY_ATOMIC_ARENA_HEADER_SIZE                                         \
+  ((uint64_t)sizeof(IvyAtomicArenaMemoryHeader))
+
+IVY_INTERNAL uint64_t ivyAlignAtomicArenaMemorySize(uint64_t size) {
+  return (size + IVY_ATOMIC_ARENA_ALIGNMENT - 1) &
+         ~(uint64_t)(IVY_ATOMIC_ARENA_ALIGNMENT - 1);
+}
+
+IVY_INTERNAL void *ivyAtomicArenaMemoryAllocatorAllocate(
+    IvyAnyMemoryAllocator allocator, uint64_t size) {
+  uint64_t end;
+  uint64_t alignedSize;
+  IvyAtomicArenaMemoryHeader *header;
+  IvyAtomicArenaMemoryAllocator *arenaAllocator = allocator;
+
+  alignedSize =
+      IVY_ATOMIC_ARENA_HEADER_SIZE + ivyAlignAtomicArenaMemorySize(size);
+
+  // NOTE: a failed allocation still moves the position past the capacity,
+  //       which only makes the following ones fail as well
+  end = IVY_ATOMIC_ADD(&arenaAllocator->position, alignedSize);
+  if (end > arenaAllocator->capacity) {
+    return NULL;
+  }
+
+  header = (IvyAtomicArenaMemoryHeader *)((uint8_t *)arenaAllocator->data +
+                                          end - alignedSize);
+  header->size = size;
+  header->padding = 0;
+
+  IVY_ATOMIC_ADD(&arenaAllocator->aliveAllocationCount, 1);
+  return header + 1;
+}
+
+IVY_INTERNAL void *ivyAtomicArenaMemoryAllocatorAllocateAndZeroMemory(
+    IvyAnyMemoryAllocator allocator, uint64_t count, uint64_t elementSize) {
+  uint64_t size = count * elementSize;
+  void *allocation = ivyAtomicArenaMemoryAllocatorAllocate(allocator, size);
+  if (allocation) {
+    IVY_MEMSET(allocation, 0, size);
+  }
+  return allocation;
+}
+
+IVY_INTERNAL void ivyAtomicArenaMemoryAllocatorFree(
+    IvyAnyMemoryAllocator allocator, void *data) {
+  IvyAtomicArenaMemoryAllocator *arenaAllocator = allocator;
+
+  if (!data) {
+    return;
+  }
+
+  IVY_ATOMIC_SUB(&arenaAllocator->aliveAllocationCount, 1);
+}
+
+IVY_INTERNAL void *ivyAtomicArenaMemoryAllocatorReallocate(
+    IvyAnyMemoryAllocator allocator, void *data, uint64_t newSize) {
+  void *newData;
+  IvyAtomicArenaMemoryHeader *header;
+
+  if (!data) {
+    return ivyAtomicArenaMemoryAllocatorAllocate(allocator, newSize);
+  }
+
+  header = (IvyAtomicArenaMemoryHeader *)data - 1;
+  if (newSize <= header->size) {
+    return data;
+  }
+
+  newData = ivyAtomicArenaMemoryAllocatorAllocate(allocator, newSize);
+  if (!newData) {
+    return NULL;
+  }
+
+  IVY_MEMCPY(newData, data, header->size);
+  ivyAtomicArenaMemoryAllocatorFree(allocator, data);
+
+  return newData;
+}
+
+IVY_INTERNAL void ivyAtomicArenaMemoryAllocatorClear(
+    IvyAnyMemoryAllocator allocator) {
+  IvyAtomicArenaMemoryAllocator *arenaAllocator = allocator;
+  IVY_ATOMIC_STORE(&arenaAllocator->position, 0);
+  IVY_ATOMIC_STORE(&arenaAllocator->aliveAllocationCount, 0);
+}
+
+IVY_INTERNAL void ivyAtomicArenaMemoryAllocatorDestroy(
+    IvyAnyMemoryAllocator allocator) {
+  IvyAtomicArenaMemoryAllocator *arenaAllocator = allocator;
+  IVY_ASSERT(!IVY_ATOMIC_LOAD(&arenaAllocator->aliveAllocationCount));
+  free(arenaAllocator->data);
+  arenaAllocator->data = NULL;
+}
+
+IVY_INTERNAL IvyMemoryAllocatorDispatch const
+    atomicArenaMemoryAllocatorDispatch = {
+        ivyAtomicArenaMemoryAllocatorAllocate,
+        ivyAtomicArenaMemoryAllocatorAllocateAndZeroMemory,
+        ivyAtomicArenaMemoryAllocatorReallocate,
+        ivyAtomicArenaMemoryAllocatorFree,
+        ivyAtomicArenaMemoryAllocatorClear,
+        ivyAtomicArenaMemoryAllocatorDestroy};
+
+IVY_API IvyCode ivyCreateAtomicArenaMemoryAllocator(uint64_t size,
+    IvyAtomicArenaMemoryAllocator *allocator) {
+  ivySetupMemoryAllocatorBase(&atomicArenaMemoryAllocatorDispatch,
+      &allocator->base);
+
+  allocator->capacity = size;
+  allocator->position = 0;
+  allocator->aliveAllocationCount = 0;
+  allocator->data = malloc(allocator->capacity);
+  if (!allocator->data) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+
+  return IVY_OK;
+}
+
+IVY_API uint64_t ivyGetAtomicArenaMemoryUsedSize(
+    IvyAtomicArenaMemoryAllocator *allocator) {
+  uint64_t const position = IVY_ATOMIC_LOAD(&allocator->position);
+  return IVY_MIN(position, allocator->capacity);
+}
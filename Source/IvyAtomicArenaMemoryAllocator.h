@@ -0,0 +1,28 @@
+#ifndef IVY_ATOMIC_ARENA_MEMORY_ALLOCATOR_H
+#define IVY_ATOMIC_ARENA_MEMORY_ALLOCATOR_H
+
+#include "IvyMemoryAllocator.h"
+
+#define IVY_ATOMIC_ARENA_ALIGNMENT 16
+
+// NOTE: a fixed region shared by several threads. Allocating is a single
+//       atomic add on the position, so parallel loaders can write into the
+//       same region without locking. Every allocation is preceded by its
+//       size so reallocate knows how much to copy. Nothing is reclaimed
+//       until the arena is cleared, which can't race with anything else
+typedef struct IvyAtomicArenaMemoryAllocator {
+  IvyMemoryAllocatorBase base;
+  uint64_t capacity;
+  uint64_t position;
+  int32_t aliveAllocationCount;
+  void *data;
+} IvyAtomicArenaMemoryAllocator;
+
+IVY_API IvyCode ivyCreateAtomicArenaMemoryAllocator(uint64_t size,
+    IvyAtomicArenaMemoryAllocator *allocator);
+
+// NOTE: the amount of the region handed out so far, capped to the capacity
+IVY_API uint64_t ivyGetAtomicArenaMemoryUsedSize(
+    IvyAtomicArenaMemoryAllocator *allocator);
+
+#endif
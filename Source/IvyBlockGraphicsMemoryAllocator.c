@@ -0,0 +1,492 @@
+#include "IvyBlockGraphicsMemoryAllocator.h"
+
+#include "IvyRenderer.h"
+
+#define IVY_DEFAULT_GRAPHICS_MEMORY_FREE_RANGE_CAPACITY 16
+#define IVY_DEFAULT_GRAPHICS_MEMORY_BLOCK_COUNT 8
+
+IVY_INTERNAL uint64_t ivyAlignGraphicsMemoryOffset(uint64_t offset,
+    uint64_t alignment) {
+  IVY_ASSERT(alignment);
+  IVY_ASSERT(!(alignment & (alignment - 1)));
+  return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+IVY_INTERNAL IvyBool ivyIsGraphicsMemoryBlockEmpty(
+    IvyGraphicsMemoryBlock const *block) {
+  IVY_ASSERT(block);
+  return !block->chunk.memory;
+}
+
+IVY_INTERNAL IvyCode ivyReserveGraphicsMemoryBlockFreeRanges(
+    IvyAnyMemoryAllocator allocator, uint32_t capacity,
+    IvyGraphicsMemoryBlock *block) {
+  uint32_t newCapacity;
+  IvyGraphicsMemoryRange *newFreeRanges;
+
+  if (capacity <= block->freeRangeCapacity) {
+    return IVY_OK;
+  }
+
+  newCapacity = IVY_MAX(capacity, 2 * block->freeRangeCapacity);
+  newFreeRanges = ivyReallocateMemory(allocator, block->freeRanges,
+      newCapacity * sizeof(*newFreeRanges));
+  IVY_ASSERT(newFreeRanges);
+  if (!newFreeRanges) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+
+  block->freeRangeCapacity = newCapacity;
+  block->freeRanges = newFreeRanges;
+
+  return IVY_OK;
+}
+
+IVY_INTERNAL void ivyRemoveGraphicsMemoryBlockFreeRange(uint32_t index,
+    IvyGraphicsMemoryBlock *block) {
+  IVY_ASSERT(index < block->freeRangeCount);
+  IVY_MEMMOVE(&block->freeRanges[index], &block->freeRanges[index + 1],
+      (block->freeRangeCount - index - 1) * sizeof(*block->freeRanges));
+  --block->freeRangeCount;
+}
+
+IVY_INTERNAL void ivyInsertGraphicsMemoryBlockFreeRange(uint32_t index,
+    uint64_t offset, uint64_t size, IvyGraphicsMemoryBlock *block) {
+  IVY_ASSERT(index <= block->freeRangeCount);
+  IVY_ASSERT(block->freeRangeCount < block->freeRangeCapacity);
+  IVY_MEMMOVE(&block->freeRanges[index + 1], &block->freeRanges[index],
+      (block->freeRangeCount - index) * sizeof(*block->freeRanges));
+  block->freeRanges[index].offset = offset;
+  block->freeRanges[index].size = size;
+  ++block->freeRangeCount;
+}
+
+IVY_INTERNAL IvyCode ivyCreateGraphicsMemoryBlock(IvyGraphicsDevice *device,
+    IvyAnyMemoryAllocator allocator, uint32_t flags, uint32_t memoryTypeIndex,
+    uint64_t size, IvyBool isDedicated, IvyGraphicsMemoryBlock *block) {
+  IvyCode ivyCode;
+
+  IVY_MEMSET(block, 0, sizeof(*block));
+  ivySetupEmptyGraphicsMemoryChunk(&block->chunk);
+
+  ivyCode = ivyReserveGraphicsMemoryBlockFreeRanges(allocator,
+      IVY_DEFAULT_GRAPHICS_MEMORY_FREE_RANGE_CAPACITY, block);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    return ivyCode;
+  }
+
+  ivyCode = ivyAllocateGraphicsMemoryChunk(device, flags,
+      1U << memoryTypeIndex, size, &block->chunk);
+  if (ivyCode) {
+    ivyFreeMemory(allocator, block->freeRanges);
+    IVY_MEMSET(block, 0, sizeof(*block));
+    return ivyCode;
+  }
+
+  block->memoryTypeIndex = memoryTypeIndex;
+  block->isDedicated = isDedicated;
+  block->aliveAllocationCount = 0;
+  block->freeSize = size;
+  ivyInsertGraphicsMemoryBlockFreeRange(0, 0, size, block);
+
+  return IVY_OK;
+}
+
+IVY_INTERNAL void ivyDestroyGraphicsMemoryBlock(IvyGraphicsDevice *device,
+    IvyAnyMemoryAllocator allocator, IvyGraphicsMemoryBlock *block) {
+  if (!ivyIsGraphicsMemoryBlockEmpty(block)) {
+    ivyFreeGraphicsMemoryChunk(device, &block->chunk);
+  }
+
+  if (block->freeRanges) {
+    ivyFreeMemory(allocator, block->freeRanges);
+  }
+
+  IVY_MEMSET(block, 0, sizeof(*block));
+  ivySetupEmptyGraphicsMemoryChunk(&block->chunk);
+}
+
+// NOTE: best fit, the free range that leaves the smallest tail wins. The
+//       alignment padding in front of the allocation stays in the free list
+IVY_INTERNAL IvyBool ivyAllocateFromGraphicsMemoryBlock(
+    IvyAnyMemoryAllocator allocator, uint64_t size, uint64_t alignment,
+    IvyGraphicsMemoryBlock *block, uint64_t *offset) {
+  uint32_t index;
+  uint32_t bestIndex = (uint32_t)-1;
+  uint64_t bestOffset = 0;
+  uint64_t bestRemainder = (uint64_t)-1;
+
+  if (block->freeSize < size) {
+    return 0;
+  }
+
+  for (index = 0; index < block->freeRangeCount; ++index) {
+    IvyGraphicsMemoryRange *range = &block->freeRanges[index];
+    uint64_t alignedOffset;
+    uint64_t remainder;
+
+    alignedOffset = ivyAlignGraphicsMemoryOffset(range->offset, alignment);
+    if (alignedOffset + size > range->offset + range->size) {
+      continue;
+    }
+
+    remainder = range->offset + range->size - (alignedOffset + size);
+    if (remainder < bestRemainder) {
+      bestIndex = index;
+      bestOffset = alignedOffset;
+      bestRemainder = remainder;
+      if (!remainder) {
+        break;
+      }
+    }
+  }
+
+  if ((uint32_t)-1 == bestIndex) {
+    return 0;
+  }
+
+  // NOTE: carving can split a range in two, reserve up front so freeing
+  //       never has to grow the array
+  if (ivyReserveGraphicsMemoryBlockFreeRanges(allocator,
+          block->aliveAllocationCount + 2, block)) {
+    return 0;
+  }
+
+  {
+    IvyGraphicsMemoryRange *range = &block->freeRanges[bestIndex];
+    uint64_t headSize = bestOffset - range->offset;
+
+    if (headSize) {
+      range->size = headSize;
+      if (bestRemainder) {
+        ivyInsertGraphicsMemoryBlockFreeRange(bestIndex + 1, bestOffset + size,
+            bestRemainder, block);
+      }
+    } else if (bestRemainder) {
+      range->offset = bestOffset + size;
+      range->size = bestRemainder;
+    } else {
+      ivyRemoveGraphicsMemoryBlockFreeRange(bestIndex, block);
+    }
+  }
+
+  ++block->aliveAllocationCount;
+  block->freeSize -= size;
+  *offset = bestOffset;
+
+  return 1;
+}
+
+IVY_INTERNAL void ivyFreeFromGraphicsMemoryBlock(uint64_t offset,
+    uint64_t size, IvyGraphicsMemoryBlock *block) {
+  uint32_t index;
+  IvyBool mergesWithPrevious;
+  IvyBool mergesWithNext;
+
+  IVY_ASSERT(0 < block->aliveAllocationCount);
+
+  for (index = 0; index < block->freeRangeCount; ++index) {
+    if (offset < block->freeRanges[index].offset) {
+      break;
+    }
+  }
+
+  if (0 < index) {
+    IvyGraphicsMemoryRange *previous = &block->freeRanges[index - 1];
+    mergesWithPrevious = offset == previous->offset + previous->size;
+  } else {
+    mergesWithPrevious = 0;
+  }
+
+  mergesWithNext = index < block->freeRangeCount &&
+                   offset + size == block->freeRanges[index].offset;
+
+  if (mergesWithPrevious && mergesWithNext) {
+    block->freeRanges[index - 1].size += size + block->freeRanges[index].size;
+    ivyRemoveGraphicsMemoryBlockFreeRange(index, block);
+  } else if (mergesWithPrevious) {
+    block->freeRanges[index - 1].size += size;
+  } else if (mergesWithNext) {
+    block->freeRanges[index].offset = offset;
+    block->freeRanges[index].size += size;
+  } else {
+    ivyInsertGraphicsMemoryBlockFreeRange(index, offset, size, block);
+  }
+
+  --block->aliveAllocationCount;
+  block->freeSize += size;
+}
+
+IVY_INTERNAL int32_t ivyFindEmptyBlockSlotInBlockGraphicsMemoryAllocator(
+    IvyBlockGraphicsMemoryAllocator *allocator) {
+  int32_t index;
+  int32_t newBlockCount;
+  IvyGraphicsMemoryBlock *newBlocks;
+
+  for (index = 0; index < allocator->blockCount; ++index) {
+    if (ivyIsGraphicsMemoryBlockEmpty(&allocator->blocks[index])) {
+      return index;
+    }
+  }
+
+  newBlockCount = IVY_MAX(IVY_DEFAULT_GRAPHICS_MEMORY_BLOCK_COUNT,
+      2 * allocator->blockCount);
+  newBlocks = ivyReallocateMemory(allocator->ownerMemoryAllocator,
+      allocator->blocks, newBlockCount * sizeof(*newBlocks));
+  IVY_ASSERT(newBlocks);
+  if (!newBlocks) {
+    return -1;
+  }
+
+  for (index = allocator->blockCount; index < newBlockCount; ++index) {
+    IVY_MEMSET(&newBlocks[index], 0, sizeof(newBlocks[index]));
+    ivySetupEmptyGraphicsMemoryChunk(&newBlocks[index].chunk);
+  }
+
+  index = allocator->blockCount;
+  allocator->blockCount = newBlockCount;
+  allocator->blocks = newBlocks;
+
+  return index;
+}
+
+IVY_INTERNAL void ivyFillGraphicsMemoryFromBlock(int32_t slot,
+    uint64_t offset, uint64_t size, IvyGraphicsMemoryBlock const *block,
+    IvyGraphicsMemory *memory) {
+  memory->data =
+      block->chunk.data ? (uint8_t *)block->chunk.data + offset : NULL;
+  memory->slot = slot;
+  memory->flags = (uint32_t)block->chunk.flags;
+  memory->type = block->memoryTypeIndex;
+  memory->offset = offset;
+  memory->size = size;
+  memory->memory = block->chunk.memory;
+}
+
+IVY_INTERNAL IvyCode ivyBlockGraphicsMemoryAllocatorAllocate(
+    IvyGraphicsDevice *device, IvyAnyGraphicsMemoryAllocator allocator,
+    uint32_t flags, uint32_t type, uint64_t size, uint64_t alignment,
+    IvyGraphicsMemory *memory) {
+  IvyCode ivyCode;
+  int32_t slot;
+  uint64_t offset;
+  uint64_t blockSize;
+  uint32_t memoryTypeIndex;
+  IvyBool isDedicated;
+  IvyGraphicsMemoryBlock *block;
+  IvyBlockGraphicsMemoryAllocator *blockAllocator = allocator;
+
+  IVY_ASSERT(device);
+  IVY_ASSERT(allocator);
+  IVY_ASSERT(memory);
+  IVY_ASSERT(size);
+
+  memoryTypeIndex =
+      ivyFindVulkanMemoryTypeIndex(&device->memoryProperties, flags, type);
+  IVY_ASSERT((uint32_t)-1 != memoryTypeIndex);
+  if ((uint32_t)-1 == memoryTypeIndex) {
+    return IVY_ERROR_NO_GRAPHICS_MEMORY;
+  }
+
+  // NOTE: buffers and images may share a block, keeping every allocation
+  //       aligned and sized to bufferImageGranularity guarantees a linear and
+  //       an optimal resource never land on the same page
+  alignment = IVY_MAX(alignment, blockAllocator->bufferImageGranularity);
+  alignment = IVY_MAX(alignment, 1);
+  size = ivyAlignGraphicsMemoryOffset(size,
+      blockAllocator->bufferImageGranularity);
+
+  for (slot = 0; slot < blockAllocator->blockCount; ++slot) {
+    block = &blockAllocator->blocks[slot];
+
+    if (ivyIsGraphicsMemoryBlockEmpty(block) || block->isDedicated) {
+      continue;
+    }
+
+    if (memoryTypeIndex != block->memoryTypeIndex ||
+        flags != block->chunk.flags) {
+      continue;
+    }
+
+    if (ivyAllocateFromGraphicsMemoryBlock(
+            blockAllocator->ownerMemoryAllocator, size, alignment, block,
+            &offset)) {
+      ivyFillGraphicsMemoryFromBlock(slot, offset, size, block, memory);
+      return IVY_OK;
+    }
+  }
+
+  if (blockAllocator->vulkanAllocationCount >=
+      blockAllocator->maxMemoryAllocationCount) {
+    return IVY_ERROR_NO_GRAPHICS_MEMORY;
+  }
+
+  blockSize = blockAllocator->blockSizes[memoryTypeIndex];
+  isDedicated = size > blockSize / 2;
+  if (isDedicated) {
+    blockSize = size;
+  }
+
+  slot = ivyFindEmptyBlockSlotInBlockGraphicsMemoryAllocator(blockAllocator);
+  if (0 > slot) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+
+  block = &blockAllocator->blocks[slot];
+  ivyCode = ivyCreateGraphicsMemoryBlock(device,
+      blockAllocator->ownerMemoryAllocator, flags, memoryTypeIndex, blockSize,
+      isDedicated, block);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    return ivyCode;
+  }
+
+  ++blockAllocator->vulkanAllocationCount;
+
+  if (!ivyAllocateFromGraphicsMemoryBlock(blockAllocator->ownerMemoryAllocator,
+          size, alignment, block, &offset)) {
+    ivyDestroyGraphicsMemoryBlock(device,
+        blockAllocator->ownerMemoryAllocator, block);
+    --blockAllocator->vulkanAllocationCount;
+    return IVY_ERROR_NO_GRAPHICS_MEMORY;
+  }
+
+  ivyFillGraphicsMemoryFromBlock(slot, offset, size, block, memory);
+
+  return IVY_OK;
+}
+
+IVY_INTERNAL IvyBool ivyHasOtherEmptyGraphicsMemoryBlock(
+    IvyBlockGraphicsMemoryAllocator *allocator,
+    IvyGraphicsMemoryBlock const *block) {
+  int32_t index;
+
+  for (index = 0; index < allocator->blockCount; ++index) {
+    IvyGraphicsMemoryBlock const *other = &allocator->blocks[index];
+
+    if (other == block || ivyIsGraphicsMemoryBlockEmpty(other)) {
+      continue;
+    }
+
+    if (!other->isDedicated && !other->aliveAllocationCount &&
+        other->memoryTypeIndex == block->memoryTypeIndex &&
+        other->chunk.flags == block->chunk.flags) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+IVY_INTERNAL void ivyBlockGraphicsMemoryAllocatorFree(
+    IvyGraphicsDevice *device, IvyAnyGraphicsMemoryAllocator allocator,
+    IvyGraphicsMemory *memory) {
+  IvyGraphicsMemoryBlock *block;
+  IvyBlockGraphicsMemoryAllocator *blockAllocator = allocator;
+
+  IVY_ASSERT(device);
+  IVY_ASSERT(allocator);
+  IVY_ASSERT(memory);
+
+  if (!memory->memory) {
+    return;
+  }
+
+  IVY_ASSERT(0 <= memory->slot);
+  IVY_ASSERT(memory->slot < blockAllocator->blockCount);
+
+  block = &blockAllocator->blocks[memory->slot];
+  IVY_ASSERT(block->chunk.memory == memory->memory);
+
+  ivyFreeFromGraphicsMemoryBlock(memory->offset, memory->size, block);
+
+  // NOTE: keep one empty block per memory type around so a frame that
+  //       allocates and frees the same amount does not hit vkAllocateMemory
+  if (!block->aliveAllocationCount &&
+      (block->isDedicated ||
+          ivyHasOtherEmptyGraphicsMemoryBlock(blockAllocator, block))) {
+    ivyDestroyGraphicsMemoryBlock(device,
+        blockAllocator->ownerMemoryAllocator, block);
+    --blockAllocator->vulkanAllocationCount;
+  }
+
+  memory->data = NULL;
+  memory->slot = -1;
+  memory->offset = 0;
+  memory->size = 0;
+  memory->memory = VK_NULL_HANDLE;
+}
+
+IVY_INTERNAL void ivyDestroyBlockGraphicsMemoryAllocator(
+    IvyGraphicsDevice *device, IvyAnyGraphicsMemoryAllocator allocator) {
+  int32_t index;
+  IvyBlockGraphicsMemoryAllocator *blockAllocator;
+
+  IVY_ASSERT(allocator);
+  blockAllocator = allocator;
+
+  if (!blockAllocator->blocks) {
+    return;
+  }
+
+  for (index = 0; index < blockAllocator->blockCount; ++index) {
+    ivyDestroyGraphicsMemoryBlock(device,
+        blockAllocator->ownerMemoryAllocator, &blockAllocator->blocks[index]);
+  }
+
+  ivyFreeMemory(blockAllocator->ownerMemoryAllocator, blockAllocator->blocks);
+  blockAllocator->blocks = NULL;
+  blockAllocator->blockCount = 0;
+  blockAllocator->vulkanAllocationCount = 0;
+}
+
+IVY_INTERNAL IvyGraphicsMemoryAllocatorDispatch const
+    blockGraphicsMemoryAllocatorDispatch = {
+        ivyBlockGraphicsMemoryAllocatorAllocate,
+        ivyBlockGraphicsMemoryAllocatorFree, NULL,
+        ivyDestroyBlockGraphicsMemoryAllocator};
+
+IVY_API IvyCode ivyCreateBlockGraphicsMemoryAllocator(
+    IvyAnyMemoryAllocator allocator, IvyGraphicsDevice *device,
+    IvyBlockGraphicsMemoryAllocator *graphicsAllocator) {
+  uint32_t index;
+  VkPhysicalDeviceProperties properties;
+  VkPhysicalDeviceMemoryProperties const *memoryProperties;
+
+  IVY_ASSERT(allocator);
+  IVY_ASSERT(device);
+  IVY_ASSERT(graphicsAllocator);
+
+  IVY_MEMSET(graphicsAllocator, 0, sizeof(*graphicsAllocator));
+
+  ivySetupGraphicsMemoryAllocatorBase(&blockGraphicsMemoryAllocatorDispatch,
+      &graphicsAllocator->base);
+
+  vkGetPhysicalDeviceProperties(device->physicalDevice, &properties);
+  memoryProperties = &device->memoryProperties;
+
+  graphicsAllocator->ownerMemoryAllocator = allocator;
+  graphicsAllocator->bufferImageGranularity =
+      IVY_MAX(properties.limits.bufferImageGranularity, 1);
+  graphicsAllocator->maxMemoryAllocationCount =
+      properties.limits.maxMemoryAllocationCount;
+  graphicsAllocator->vulkanAllocationCount = 0;
+
+  // NOTE: small heaps (e.g. the 256MiB BAR heap) get smaller blocks so a
+  //       single block never eats a big part of them
+  for (index = 0; index < memoryProperties->memoryTypeCount; ++index) {
+    uint32_t heapIndex = memoryProperties->memoryTypes[index].heapIndex;
+    uint64_t heapSize = memoryProperties->memoryHeaps[heapIndex].size;
+    uint64_t blockSize = IVY_MIN(IVY_DEFAULT_GRAPHICS_MEMORY_BLOCK_SIZE,
+        heapSize / 8);
+
+    graphicsAllocator->blockSizes[index] =
+        IVY_MAX(blockSize, IVY_MIN_GRAPHICS_MEMORY_BLOCK_SIZE);
+  }
+
+  graphicsAllocator->blockCount = 0;
+  graphicsAllocator->blocks = NULL;
+
+  return IVY_OK;
+}
@@ -0,0 +1,46 @@
+#ifndef IVY_BLOCK_GRAPHICS_MEMORY_ALLOCATOR_H
+#define IVY_BLOCK_GRAPHICS_MEMORY_ALLOCATOR_H
+
+#include "IvyGraphicsMemoryAllocator.h"
+#include "IvyGraphicsMemoryChunk.h"
+#include "IvyMemoryAllocator.h"
+
+#define IVY_DEFAULT_GRAPHICS_MEMORY_BLOCK_SIZE (64ULL * 1024ULL * 1024ULL)
+#define IVY_MIN_GRAPHICS_MEMORY_BLOCK_SIZE (1ULL * 1024ULL * 1024ULL)
+
+typedef struct IvyGraphicsDevice IvyGraphicsDevice;
+
+typedef struct IvyGraphicsMemoryRange {
+  uint64_t offset;
+  uint64_t size;
+} IvyGraphicsMemoryRange;
+
+// NOTE: freeRanges is kept sorted by offset so neighbours can be coalesced
+//       on free. There are never more free ranges than allocations + 1.
+typedef struct IvyGraphicsMemoryBlock {
+  IvyGraphicsMemoryChunk chunk;
+  uint32_t memoryTypeIndex;
+  IvyBool isDedicated;
+  int32_t aliveAllocationCount;
+  uint64_t freeSize;
+  uint32_t freeRangeCount;
+  uint32_t freeRangeCapacity;
+  IvyGraphicsMemoryRange *freeRanges;
+} IvyGraphicsMemoryBlock;
+
+typedef struct IvyBlockGraphicsMemoryAllocator {
+  IvyGraphicsMemoryAllocatorBase base;
+  IvyAnyMemoryAllocator ownerMemoryAllocator;
+  uint64_t bufferImageGranularity;
+  uint32_t maxMemoryAllocationCount;
+  uint32_t vulkanAllocationCount;
+  uint64_t blockSizes[VK_MAX_MEMORY_TYPES];
+  int32_t blockCount;
+  IvyGraphicsMemoryBlock *blocks;
+} IvyBlockGraphicsMemoryAllocator;
+
+IVY_API IvyCode ivyCreateBlockGraphicsMemoryAllocator(
+    IvyAnyMemoryAllocator allocator, IvyGraphicsDevice *device,
+    IvyBlockGraphicsMemoryAllocator *graphicsAllocator);
+
+#endif
@@ -38,6 +38,7 @@ IVY_API char const *const *ivyCocoaGetRequiredVulkanExtensions(
     IvyCocoaApplication *application, uint32_t *count);
 
 IVY_API VkResult ivyCocoaCreateVulkanSurface(VkInstance instance,
-    IvyCocoaApplication *application, VkSurfaceKHR *surface);
+    IvyCocoaApplication *application,
+    VkAllocationCallbacks const *allocationCallbacks, VkSurfaceKHR *surface);
 
 #endif
@@ -105,10 +105,12 @@ IVY_API char const *const *ivyCocoaGetRequiredVulkanExtensions(
 }
 
 IVY_API VkResult ivyCocoaCreateVulkanSurface(VkInstance instance,
-    IvyCocoaApplication *application, VkSurfaceKHR *surface)
+    IvyCocoaApplication *application,
+    VkAllocationCallbacks const *allocationCallbacks, VkSurfaceKHR *surface)
 {
 	IVY_UNUSED(instance);
 	IVY_UNUSED(application);
+	IVY_UNUSED(allocationCallbacks);
 	IVY_UNUSED(surface);
 	IVY_TODO();
 	return VK_ERROR_UNKNOWN;
@@ -34,7 +34,9 @@ typedef int IvyCode;
 
 #if 1
 #include <string.h>
+#define IVY_MEMCMP memcmp
 #define IVY_MEMCPY memcpy
+#define IVY_MEMMOVE memmove
 #define IVY_MEMSET memset
 #define IVY_STRNCMP strncmp
 #endif
@@ -4,170 +4,189 @@
 
 #include "IvyLog.h"
 
-IVY_INTERNAL IvyCode ivyBindGraphicsVertexData(IvyRenderer *renderer,
-    uint64_t vertexCount, IvyGraphicsVertex332 const *vertices) {
+IVY_INTERNAL void ivySetGraphicsQuadVertex(float x, float y, float u,
+    float v, float red, float green, float blue,
+    IvyGraphicsVertex332 *vertex) {
+  vertex->position.x = x;
+  vertex->position.y = y;
+  vertex->position.z = 0.0F;
+  vertex->color.x = red;
+  vertex->color.y = green;
+  vertex->color.z = blue;
+  vertex->uv.x = u;
+  vertex->uv.y = v;
+}
+
+IVY_INTERNAL IvyCode ivyReserveGraphicsQuadBatch(IvyRenderer *renderer) {
   IvyCode ivyCode;
   IvyGraphicsTemporaryBuffer vertexBuffer;
-  IvyGraphicsFrame *frame = ivyGetCurrentGraphicsFrame(renderer);
+  IvyGraphicsQuadBatch *batch = &renderer->quadBatch;
 
   ivyCode = ivyRequestGraphicsTemporaryBuffer(renderer,
-      vertexCount * sizeof(*vertices), &vertexBuffer);
+      IVY_VERTEX_TEMPORARY_BUFFER,
+      IVY_MAX_BATCHED_QUADS * 4 * sizeof(*batch->vertices), &vertexBuffer);
   IVY_ASSERT(!ivyCode);
   if (ivyCode) {
     return ivyCode;
   }
 
-  IVY_MEMCPY(vertexBuffer.data, vertices, vertexBuffer.size);
-
-  vkCmdBindVertexBuffers(frame->commandBuffer, 0, 1, &vertexBuffer.buffer,
-      &vertexBuffer.offsetInU64);
+  batch->firstQuad = 0;
+  batch->quadCount = 0;
+  batch->vertexBuffer = vertexBuffer.buffer;
+  batch->vertexBufferOffset = vertexBuffer.offsetInU64;
+  batch->vertices = vertexBuffer.data;
 
   return IVY_OK;
 }
 
-IVY_INTERNAL IvyCode ivyBindGraphicsIndexData(IvyRenderer *renderer,
-    uint64_t indexCount, IvyGraphicsProgramIndex const *indices) {
+IVY_API IvyCode ivyDrawRectangle(IvyRenderer *renderer, float topLeftX,
+    float topLeftY, float bottomRightX, float bottomRightY, float red,
+    float green, float blue, IvyGraphicsTexture *texture) {
   IvyCode ivyCode;
-  IvyGraphicsTemporaryBuffer indexBuffer;
-  IvyGraphicsFrame *frame = ivyGetCurrentGraphicsFrame(renderer);
+  IvyGraphicsVertex332 *vertices;
+  IvyGraphicsQuadBatch *batch = &renderer->quadBatch;
+  IvyGraphicsProgram *program = &renderer->basicGraphicsProgram;
+
+  if (batch->program != program || batch->texture != texture) {
+    ivyCode = ivyFlushGraphicsQuadBatch(renderer);
+    IVY_ASSERT(!ivyCode);
+    if (ivyCode) {
+      return ivyCode;
+    }
+
+    batch->program = program;
+    batch->texture = texture;
+  }
 
-  ivyCode = ivyRequestGraphicsTemporaryBuffer(renderer,
-      indexCount * sizeof(*indices), &indexBuffer);
-  if (ivyCode) {
-    return ivyCode;
+  if (!batch->vertices || IVY_MAX_BATCHED_QUADS == batch->quadCount) {
+    ivyCode = ivyFlushGraphicsQuadBatch(renderer);
+    IVY_ASSERT(!ivyCode);
+    if (ivyCode) {
+      return ivyCode;
+    }
+
+    ivyCode = ivyReserveGraphicsQuadBatch(renderer);
+    IVY_ASSERT(!ivyCode);
+    if (ivyCode) {
+      return ivyCode;
+    }
   }
 
-  IVY_MEMCPY(indexBuffer.data, indices, indexBuffer.size);
+  vertices = &batch->vertices[batch->quadCount * 4];
+
+  ivySetGraphicsQuadVertex(topLeftX, topLeftY, 0.0F, 0.0F, red, green, blue,
+      &vertices[0]);
+  ivySetGraphicsQuadVertex(bottomRightX, topLeftY, 1.0F, 0.0F, red, green,
+      blue, &vertices[1]);
+  ivySetGraphicsQuadVertex(topLeftX, bottomRightY, 0.0F, 1.0F, red, green,
+      blue, &vertices[2]);
+  ivySetGraphicsQuadVertex(bottomRightX, bottomRightY, 1.0F, 1.0F, red,
+      green, blue, &vertices[3]);
 
-  vkCmdBindIndexBuffer(frame->commandBuffer, indexBuffer.buffer,
-      indexBuffer.offsetInU32, VK_INDEX_TYPE_UINT32);
+  ++batch->quadCount;
 
   return IVY_OK;
 }
 
-IVY_INTERNAL IvyCode IvyBindGraphicsUniformData(IvyRenderer *renderer,
-    IvyGraphicsProgramUniform *uniform) {
+IVY_API IvyCode ivyDrawRectangleInRecordingContext(IvyRenderer *renderer,
+    IvyGraphicsRecordingContext *recordingContext, float topLeftX,
+    float topLeftY, float bottomRightX, float bottomRightY, float red,
+    float green, float blue, IvyGraphicsTexture *texture) {
   IvyCode ivyCode;
-  IvyGraphicsTemporaryBuffer uniformBuffer;
-  IvyGraphicsFrame *frame = ivyGetCurrentGraphicsFrame(renderer);
+  IvyM4 model;
+  IvyGraphicsVertex332 *vertices;
+  IvyGraphicsTemporaryBuffer vertexBuffer;
 
-  ivyCode = ivyRequestGraphicsTemporaryBuffer(renderer, sizeof(*uniform),
-      &uniformBuffer);
+  ivyCode = ivyRequestGraphicsTemporaryBufferInRecordingContext(renderer,
+      recordingContext, IVY_VERTEX_TEMPORARY_BUFFER, 4 * sizeof(*vertices),
+      &vertexBuffer);
+  IVY_ASSERT(!ivyCode);
   if (ivyCode) {
     return ivyCode;
   }
 
-  IVY_MEMCPY(uniformBuffer.data, uniform, uniformBuffer.size);
+  vertices = vertexBuffer.data;
+
+  ivySetGraphicsQuadVertex(topLeftX, topLeftY, 0.0F, 0.0F, red, green, blue,
+      &vertices[0]);
+  ivySetGraphicsQuadVertex(bottomRightX, topLeftY, 1.0F, 0.0F, red, green,
+      blue, &vertices[1]);
+  ivySetGraphicsQuadVertex(topLeftX, bottomRightY, 0.0F, 1.0F, red, green,
+      blue, &vertices[2]);
+  ivySetGraphicsQuadVertex(bottomRightX, bottomRightY, 1.0F, 1.0F, red,
+      green, blue, &vertices[3]);
+
+  ivyBindGraphicsProgramInRecordingContext(recordingContext,
+      &renderer->basicGraphicsProgram);
+
+  vkCmdBindVertexBuffers(recordingContext->commandBuffer, 0, 1,
+      &vertexBuffer.buffer, &vertexBuffer.offsetInU64);
 
-  vkCmdBindDescriptorSets(frame->commandBuffer,
-      VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->mainPipelineLayout, 0, 1,
-      &uniformBuffer.descriptorSet, 1, &uniformBuffer.offsetInU32);
+  vkCmdBindIndexBuffer(recordingContext->commandBuffer,
+      renderer->quadIndexBuffer->buffer, 0, VK_INDEX_TYPE_UINT32);
+
+  ivyIdentityM4(&model);
+  ivyPushGraphicsModelMatrixInRecordingContext(renderer, recordingContext,
+      &model);
+
+  ivyBindGraphicsTextureInRecordingContext(renderer, recordingContext,
+      texture);
+
+  vkCmdDrawIndexed(recordingContext->commandBuffer, 6, 1, 0, 0, 0);
 
   return IVY_OK;
 }
 
-IVY_INTERNAL void ivyBindGraphicsTexture(IvyRenderer *renderer,
+IVY_API IvyCode ivyDrawRectanglesInstanced(IvyRenderer *renderer,
+    uint32_t instanceCount, IvyGraphicsQuadInstance const *instances,
     IvyGraphicsTexture *texture) {
-  IvyGraphicsFrame *frame = ivyGetCurrentGraphicsFrame(renderer);
-  vkCmdBindDescriptorSets(frame->commandBuffer,
-      VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->mainPipelineLayout, 1, 1,
-      &texture->descriptorSet, 0, NULL);
-}
-
-IVY_API IvyCode ivyDrawRectangle(IvyRenderer *renderer, float topLeftX,
-    float topLeftY, float bottomRightX, float bottomRightY, float red,
-    float green, float blue, IvyGraphicsTexture *texture) {
   IvyCode ivyCode;
+  IvyM4 model;
+  VkBuffer vertexBuffers[2];
+  VkDeviceSize vertexBufferOffsets[2];
+  IvyGraphicsTemporaryBuffer instanceBuffer;
+  VkCommandBuffer commandBuffer =
+      ivyGetCurrentGraphicsCommandBuffer(renderer);
+
+  if (!instanceCount) {
+    return IVY_OK;
+  }
 
-  IvyGraphicsProgramUniform uniform;
-  IvyGraphicsVertex332 vertices[4];
-  // IvyGraphicsProgramIndex const indices[] = {0, 2, 1, 2, 3, 1};
-  // IvyGraphicsProgramIndex const indices[] = {1, 3, 2, 0, 0, 0};
-  // IvyGraphicsProgramIndex const indices[] = {3, 2, 1, 2, 3, 1};
-  IvyGraphicsProgramIndex const indices[] = {0, 2, 3, 3, 1, 0};
-
-  IvyGraphicsFrame *frame = ivyGetCurrentGraphicsFrame(renderer);
-
-  vertices[0].position.x = topLeftX;
-  vertices[0].position.y = topLeftY;
-  vertices[0].position.z = 0.0F;
-  vertices[0].color.x = red;
-  vertices[0].color.y = green;
-  vertices[0].color.z = blue;
-  vertices[0].uv.x = 0.0F;
-  vertices[0].uv.y = 0.0F;
-
-#if 0
-  IVY_DEBUG_LOG(" red: %.2f\n"#include "IvyLog.h", red);
-  IVY_DEBUG_LOG(" green: %.2f\n", green);
-  IVY_DEBUG_LOG(" blue: %.2f\n", blue);
-#endif
-
-  vertices[1].position.x = bottomRightX;
-  vertices[1].position.y = topLeftY;
-  vertices[1].position.z = 0.0F;
-  vertices[1].color.x = red;
-  vertices[1].color.y = green;
-  vertices[1].color.z = blue;
-  vertices[1].uv.x = 1.0F;
-  vertices[1].uv.y = 0.0F;
-
-  vertices[2].position.x = topLeftX;
-  vertices[2].position.y = bottomRightY;
-  vertices[2].position.z = 0.0F;
-  vertices[2].color.x = red;
-  vertices[2].color.y = green;
-  vertices[2].color.z = blue;
-  vertices[2].uv.x = 0.0F;
-  vertices[2].uv.y = 1.0F;
-
-  vertices[3].position.x = bottomRightX;
-  vertices[3].position.y = bottomRightY;
-  vertices[3].position.z = 0.0F;
-  vertices[3].color.x = red;
-  vertices[3].color.y = green;
-  vertices[3].color.z = blue;
-  vertices[3].uv.x = 1.0F;
-  vertices[3].uv.y = 1.0F;
-
-  ivyBindGraphicsProgram(renderer, &renderer->basicGraphicsProgram);
-
-  ivyCode = ivyBindGraphicsVertexData(renderer, IVY_ARRAY_LENGTH(vertices),
-      vertices);
+  ivyCode = ivyFlushGraphicsQuadBatch(renderer);
   IVY_ASSERT(!ivyCode);
   if (ivyCode) {
     return ivyCode;
   }
 
-  ivyCode =
-      ivyBindGraphicsIndexData(renderer, IVY_ARRAY_LENGTH(indices), indices);
+  ivyCode = ivyRequestGraphicsTemporaryBuffer(renderer,
+      IVY_VERTEX_TEMPORARY_BUFFER, instanceCount * sizeof(*instances),
+      &instanceBuffer);
   IVY_ASSERT(!ivyCode);
   if (ivyCode) {
     return ivyCode;
   }
 
-  ivyCopyM4(&renderer->cameraView, &uniform.view);
-  ivyCopyM4(&renderer->projection, &uniform.projection);
+  IVY_MEMCPY(instanceBuffer.data, instances, instanceBuffer.size);
 
-#if 1
-  {
-    IvyV3 const position = {0.0F, 0.0F, 0.0F};
+  ivyBindGraphicsProgram(renderer, &renderer->quadInstanceGraphicsProgram);
 
-    ivyIdentityM4(&uniform.model);
-    ivyTranslateM4(&position, &uniform.model);
-  }
-#endif
+  vertexBuffers[0] = renderer->unitQuadVertexBuffer->buffer;
+  vertexBufferOffsets[0] = 0;
+  vertexBuffers[1] = instanceBuffer.buffer;
+  vertexBufferOffsets[1] = instanceBuffer.offsetInU64;
 
-  ivyCode = IvyBindGraphicsUniformData(renderer, &uniform);
-  IVY_ASSERT(!ivyCode);
-  if (ivyCode) {
-    return ivyCode;
-  }
+  vkCmdBindVertexBuffers(commandBuffer, 0,
+      IVY_ARRAY_LENGTH(vertexBuffers), vertexBuffers, vertexBufferOffsets);
+
+  vkCmdBindIndexBuffer(commandBuffer,
+      renderer->quadIndexBuffer->buffer, 0, VK_INDEX_TYPE_UINT32);
+
+  ivyIdentityM4(&model);
+  ivyPushGraphicsModelMatrix(renderer, &model);
 
   ivyBindGraphicsTexture(renderer, texture);
 
-  vkCmdDrawIndexed(frame->commandBuffer, IVY_ARRAY_LENGTH(indices), 1, 0, 0,
-      0);
+  vkCmdDrawIndexed(commandBuffer, 6, instanceCount, 0, 0, 0);
 
   return IVY_OK;
 }
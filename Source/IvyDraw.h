@@ -8,4 +8,16 @@ IVY_API IvyCode ivyDrawRectangle(IvyRenderer *renderer, float topLeftX,
     float topLeftY, float bottomRightX, float bottomRightY, float red,
     float green, float blue, IvyGraphicsTexture *texture);
 
+// NOTE: not batched, every call is its own draw. Safe to call from the
+//       thread that owns the recording context
+IVY_API IvyCode ivyDrawRectangleInRecordingContext(IvyRenderer *renderer,
+    IvyGraphicsRecordingContext *recordingContext, float topLeftX,
+    float topLeftY, float bottomRightX, float bottomRightY, float red,
+    float green, float blue, IvyGraphicsTexture *texture);
+
+// NOTE: draws every instance with a single instanced draw over the unit quad
+IVY_API IvyCode ivyDrawRectanglesInstanced(IvyRenderer *renderer,
+    uint32_t instanceCount, IvyGraphicsQuadInstance const *instances,
+    IvyGraphicsTexture *texture);
+
 #endif
@@ -0,0 +1,409 @@
+#include "IvyDrawList.h"
+
+#include "IvyRenderer.h"
+
+#define IVY_DRAW_LIST_RADIX_BITS 8
+#define IVY_DRAW_LIST_RADIX_BUCKETS (1 << IVY_DRAW_LIST_RADIX_BITS)
+#define IVY_DRAW_LIST_RADIX_PASSES                                           \
+  (sizeof(uint64_t) * 8 / IVY_DRAW_LIST_RADIX_BITS)
+
+#define IVY_DRAW_LIST_PROGRAM_SHIFT 56
+#define IVY_DRAW_LIST_TEXTURE_SHIFT 40
+#define IVY_DRAW_LIST_DEPTH_SHIFT 16
+
+IVY_API IvyCode ivyCreateDrawList(IvyAnyMemoryAllocator allocator,
+    IvyDrawList *drawList) {
+  IVY_MEMSET(drawList, 0, sizeof(*drawList));
+  drawList->ownerMemoryAllocator = allocator;
+  return IVY_OK;
+}
+
+IVY_API void ivyDestroyDrawList(IvyDrawList *drawList) {
+  IvyAnyMemoryAllocator allocator = drawList->ownerMemoryAllocator;
+
+  if (!allocator) {
+    return;
+  }
+
+  ivyFreeMemory(allocator, drawList->textures);
+  ivyFreeMemory(allocator, drawList->scratchSortedIndices);
+  ivyFreeMemory(allocator, drawList->sortedIndices);
+  ivyFreeMemory(allocator, drawList->scratchSortKeys);
+  ivyFreeMemory(allocator, drawList->sortKeys);
+  ivyFreeMemory(allocator, drawList->commands);
+
+  IVY_MEMSET(drawList, 0, sizeof(*drawList));
+}
+
+IVY_API void ivyResetDrawList(IvyDrawList *drawList) {
+  drawList->commandCount = 0;
+  drawList->programCount = 0;
+  drawList->textureCount = 0;
+}
+
+IVY_INTERNAL void *ivyReallocateDrawListArray(IvyAnyMemoryAllocator allocator,
+    void *data, uint64_t count, uint64_t elementSize) {
+  return ivyReallocateMemory(allocator, data, count * elementSize);
+}
+
+IVY_INTERNAL IvyCode ivyReserveDrawListCommands(IvyDrawList *drawList,
+    uint32_t capacity) {
+  void *newData;
+  IvyAnyMemoryAllocator allocator = drawList->ownerMemoryAllocator;
+
+  if (capacity <= drawList->commandCapacity) {
+    return IVY_OK;
+  }
+
+  // NOTE: on failure the arrays that did grow are kept, commandCapacity
+  //       only moves once all of them are big enough
+  newData = ivyReallocateDrawListArray(allocator, drawList->commands,
+      capacity, sizeof(*drawList->commands));
+  if (!newData) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+  drawList->commands = newData;
+
+  newData = ivyReallocateDrawListArray(allocator, drawList->sortKeys,
+      capacity, sizeof(*drawList->sortKeys));
+  if (!newData) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+  drawList->sortKeys = newData;
+
+  newData = ivyReallocateDrawListArray(allocator, drawList->scratchSortKeys,
+      capacity, sizeof(*drawList->scratchSortKeys));
+  if (!newData) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+  drawList->scratchSortKeys = newData;
+
+  newData = ivyReallocateDrawListArray(allocator, drawList->sortedIndices,
+      capacity, sizeof(*drawList->sortedIndices));
+  if (!newData) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+  drawList->sortedIndices = newData;
+
+  newData = ivyReallocateDrawListArray(allocator,
+      drawList->scratchSortedIndices, capacity,
+      sizeof(*drawList->scratchSortedIndices));
+  if (!newData) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+  drawList->scratchSortedIndices = newData;
+
+  drawList->commandCapacity = capacity;
+
+  return IVY_OK;
+}
+
+IVY_INTERNAL IvyCode ivyFindDrawListProgramKey(IvyDrawList *drawList,
+    IvyGraphicsProgram *program, uint64_t *key) {
+  uint32_t index;
+
+  for (index = 0; index < drawList->programCount; ++index) {
+    if (drawList->programs[index] == program) {
+      *key = index;
+      return IVY_OK;
+    }
+  }
+
+  if (IVY_MAX_DRAW_LIST_PROGRAMS == drawList->programCount) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+
+  drawList->programs[drawList->programCount] = program;
+  *key = drawList->programCount++;
+
+  return IVY_OK;
+}
+
+// NOTE: searched backwards since draws tend to reuse the texture that was
+//       most recently seen
+IVY_INTERNAL IvyCode ivyFindDrawListTextureKey(IvyDrawList *drawList,
+    IvyGraphicsTexture *texture, uint64_t *key) {
+  uint32_t index;
+
+  for (index = drawList->textureCount; index > 0; --index) {
+    if (drawList->textures[index - 1] == texture) {
+      *key = index - 1;
+      return IVY_OK;
+    }
+  }
+
+  if (IVY_MAX_DRAW_LIST_TEXTURES == drawList->textureCount) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+
+  if (drawList->textureCount == drawList->textureCapacity) {
+    uint32_t newCapacity;
+    IvyGraphicsTexture **newTextures;
+
+    newCapacity = drawList->textureCapacity ? drawList->textureCapacity * 2
+                                            : 16;
+    newTextures = ivyReallocateDrawListArray(drawList->ownerMemoryAllocator,
+        drawList->textures, newCapacity, sizeof(*newTextures));
+    if (!newTextures) {
+      return IVY_ERROR_NO_MEMORY;
+    }
+
+    drawList->textures = newTextures;
+    drawList->textureCapacity = newCapacity;
+  }
+
+  drawList->textures[drawList->textureCount] = texture;
+  *key = drawList->textureCount++;
+
+  return IVY_OK;
+}
+
+IVY_INTERNAL uint64_t ivyQuantizeDrawListDepth(float depth) {
+  if (depth <= 0.0F) {
+    return 0;
+  }
+
+  if (depth >= 1.0F) {
+    return IVY_DRAW_LIST_DEPTH_MASK;
+  }
+
+  return (uint64_t)(depth * (float)IVY_DRAW_LIST_DEPTH_MASK);
+}
+
+IVY_API IvyCode ivyAddDrawListCommand(IvyDrawList *drawList,
+    IvyDrawCommand const *command, float depth, uint16_t material) {
+  IvyCode ivyCode;
+  uint64_t programKey;
+  uint64_t textureKey;
+  uint32_t index = drawList->commandCount;
+
+  IVY_ASSERT(command->program);
+  IVY_ASSERT(command->texture);
+
+  if (drawList->commandCount == drawList->commandCapacity) {
+    ivyCode = ivyReserveDrawListCommands(drawList,
+        drawList->commandCapacity ? drawList->commandCapacity * 2 : 64);
+    IVY_ASSERT(!ivyCode);
+    if (ivyCode) {
+      return ivyCode;
+    }
+  }
+
+  ivyCode = ivyFindDrawListProgramKey(drawList, command->program,
+      &programKey);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    return ivyCode;
+  }
+
+  ivyCode = ivyFindDrawListTextureKey(drawList, command->texture,
+      &textureKey);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    return ivyCode;
+  }
+
+  IVY_MEMCPY(&drawList->commands[index], command, sizeof(*command));
+  drawList->sortKeys[index] =
+      (programKey << IVY_DRAW_LIST_PROGRAM_SHIFT) |
+      (textureKey << IVY_DRAW_LIST_TEXTURE_SHIFT) |
+      (ivyQuantizeDrawListDepth(depth) << IVY_DRAW_LIST_DEPTH_SHIFT) |
+      (material & IVY_DRAW_LIST_MATERIAL_MASK);
+  drawList->sortedIndices[index] = index;
+
+  ++drawList->commandCount;
+
+  return IVY_OK;
+}
+
+// NOTE: LSD radix sort, a byte per pass. All the histograms are built in a
+//       single read of the keys and passes where every key shares the same
+//       byte are skipped, which is the common case for the program bits.
+//       The sort is stable so equal keys keep their submission order
+IVY_API void ivySortDrawList(IvyDrawList *drawList) {
+  uint32_t pass;
+  uint32_t index;
+  uint64_t *swapKeys;
+  uint32_t *swapIndices;
+  uint32_t histograms[IVY_DRAW_LIST_RADIX_PASSES]
+                     [IVY_DRAW_LIST_RADIX_BUCKETS];
+  uint32_t const count = drawList->commandCount;
+
+  if (!count) {
+    return;
+  }
+
+  IVY_MEMSET(histograms, 0, sizeof(histograms));
+
+  for (index = 0; index < count; ++index) {
+    uint64_t key = drawList->sortKeys[index];
+
+    for (pass = 0; pass < IVY_DRAW_LIST_RADIX_PASSES; ++pass) {
+      ++histograms[pass][key & (IVY_DRAW_LIST_RADIX_BUCKETS - 1)];
+      key >>= IVY_DRAW_LIST_RADIX_BITS;
+    }
+  }
+
+  for (pass = 0; pass < IVY_DRAW_LIST_RADIX_PASSES; ++pass) {
+    uint32_t bucket;
+    uint32_t offset;
+    uint32_t *histogram = histograms[pass];
+    uint32_t const shift = pass * IVY_DRAW_LIST_RADIX_BITS;
+
+    if (histogram[(drawList->sortKeys[0] >> shift) &
+                  (IVY_DRAW_LIST_RADIX_BUCKETS - 1)] == count) {
+      continue;
+    }
+
+    for (offset = 0, bucket = 0; bucket < IVY_DRAW_LIST_RADIX_BUCKETS;
+         ++bucket) {
+      uint32_t const bucketCount = histogram[bucket];
+      histogram[bucket] = offset;
+      offset += bucketCount;
+    }
+
+    for (index = 0; index < count; ++index) {
+      uint64_t const key = drawList->sortKeys[index];
+      uint32_t const destination =
+          histogram[(key >> shift) & (IVY_DRAW_LIST_RADIX_BUCKETS - 1)]++;
+
+      drawList->scratchSortKeys[destination] = key;
+      drawList->scratchSortedIndices[destination] =
+          drawList->sortedIndices[index];
+    }
+
+    swapKeys = drawList->sortKeys;
+    drawList->sortKeys = drawList->scratchSortKeys;
+    drawList->scratchSortKeys = swapKeys;
+
+    swapIndices = drawList->sortedIndices;
+    drawList->sortedIndices = drawList->scratchSortedIndices;
+    drawList->scratchSortedIndices = swapIndices;
+  }
+}
+
+// NOTE: indexCount is the count of the command after previous merges
+IVY_INTERNAL IvyBool ivyCanMergeDrawCommands(IvyDrawCommand const *command,
+    uint32_t indexCount, IvyDrawCommand const *nextCommand) {
+  return command->program == nextCommand->program &&
+         command->texture == nextCommand->texture &&
+         command->vertexBuffer == nextCommand->vertexBuffer &&
+         command->vertexBufferOffset == nextCommand->vertexBufferOffset &&
+         command->indexBuffer == nextCommand->indexBuffer &&
+         command->indexBufferOffset == nextCommand->indexBufferOffset &&
+         command->vertexOffset == nextCommand->vertexOffset &&
+         command->firstIndex + indexCount == nextCommand->firstIndex &&
+         !IVY_MEMCMP(&command->model, &nextCommand->model,
+             sizeof(command->model));
+}
+
+IVY_API uint32_t ivyMergeDrawListCommands(IvyDrawList const *drawList,
+    uint32_t index, uint32_t *indexCount) {
+  IvyDrawCommand const *command =
+      &drawList->commands[drawList->sortedIndices[index]];
+
+  *indexCount = command->indexCount;
+  for (++index; index < drawList->commandCount; ++index) {
+    IvyDrawCommand const *nextCommand =
+        &drawList->commands[drawList->sortedIndices[index]];
+
+    if (!ivyCanMergeDrawCommands(command, *indexCount, nextCommand)) {
+      break;
+    }
+
+    *indexCount += nextCommand->indexCount;
+  }
+
+  return index;
+}
+
+IVY_API IvyCode ivySubmitDrawList(IvyRenderer *renderer,
+    IvyDrawList *drawList) {
+  IvyCode ivyCode;
+  uint32_t index;
+  IvyGraphicsTexture *boundTexture = NULL;
+  IvyDrawCommand const *boundVertexCommand = NULL;
+  IvyDrawCommand const *boundIndexCommand = NULL;
+  IvyDrawCommand const *boundModelCommand = NULL;
+  IvyDrawListStatistics *statistics = &drawList->statistics;
+  VkCommandBuffer commandBuffer =
+      ivyGetCurrentGraphicsCommandBuffer(renderer);
+
+  IVY_MEMSET(statistics, 0, sizeof(*statistics));
+  statistics->commandCount = drawList->commandCount;
+
+  if (!drawList->commandCount) {
+    return IVY_OK;
+  }
+
+  // NOTE: anything drawn immediately so far goes before the deferred draws
+  ivyCode = ivyFlushGraphicsQuadBatch(renderer);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    return ivyCode;
+  }
+
+  ivySortDrawList(drawList);
+
+  index = 0;
+  while (index < drawList->commandCount) {
+    uint32_t indexCount;
+    IvyDrawCommand const *command =
+        &drawList->commands[drawList->sortedIndices[index]];
+
+    index = ivyMergeDrawListCommands(drawList, index, &indexCount);
+
+    if (renderer->boundGraphicsProgram != command->program) {
+      ivyBindGraphicsProgram(renderer, command->program);
+      ++statistics->programBindCount;
+    }
+
+    if (boundTexture != command->texture) {
+      vkCmdBindDescriptorSets(commandBuffer,
+          VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->mainPipelineLayout, 1, 1,
+          &command->texture->descriptorSet, 0, NULL);
+      boundTexture = command->texture;
+      ++statistics->textureBindCount;
+    }
+
+    if (!boundVertexCommand ||
+        boundVertexCommand->vertexBuffer != command->vertexBuffer ||
+        boundVertexCommand->vertexBufferOffset !=
+            command->vertexBufferOffset) {
+      vkCmdBindVertexBuffers(commandBuffer, 0, 1,
+          &command->vertexBuffer, &command->vertexBufferOffset);
+      boundVertexCommand = command;
+      ++statistics->vertexBufferBindCount;
+    }
+
+    if (!boundIndexCommand ||
+        boundIndexCommand->indexBuffer != command->indexBuffer ||
+        boundIndexCommand->indexBufferOffset != command->indexBufferOffset) {
+      vkCmdBindIndexBuffer(commandBuffer, command->indexBuffer,
+          command->indexBufferOffset, VK_INDEX_TYPE_UINT32);
+      boundIndexCommand = command;
+      ++statistics->indexBufferBindCount;
+    }
+
+    if (!boundModelCommand ||
+        IVY_MEMCMP(&boundModelCommand->model, &command->model,
+            sizeof(command->model))) {
+      vkCmdPushConstants(commandBuffer, renderer->mainPipelineLayout,
+          VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(command->model),
+          &command->model);
+      boundModelCommand = command;
+      ++statistics->modelPushCount;
+    }
+
+    vkCmdDrawIndexed(commandBuffer, indexCount, 1, command->firstIndex,
+        command->vertexOffset, 0);
+    ++statistics->drawCount;
+  }
+
+  return IVY_OK;
+}
+
+IVY_API void ivyGetDrawListStatistics(IvyDrawList *drawList,
+    IvyDrawListStatistics *statistics) {
+  IVY_MEMCPY(statistics, &drawList->statistics, sizeof(*statistics));
+}
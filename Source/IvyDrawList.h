@@ -0,0 +1,94 @@
+#ifndef IVY_DRAW_LIST_H
+#define IVY_DRAW_LIST_H
+
+#include <vulkan/vulkan.h>
+
+#include "IvyGraphicsProgram.h"
+#include "IvyGraphicsTexture.h"
+#include "IvyMemoryAllocator.h"
+#include "IvyVectorMath.h"
+
+#define IVY_MAX_DRAW_LIST_PROGRAMS 256
+#define IVY_MAX_DRAW_LIST_TEXTURES 65536
+#define IVY_DRAW_LIST_DEPTH_MASK 0xFFFFFFULL
+#define IVY_DRAW_LIST_MATERIAL_MASK 0xFFFFULL
+
+typedef struct IvyRenderer IvyRenderer;
+
+// NOTE: a deferred indexed draw. The buffers are usually temporary buffers,
+//       so they have to stay alive until the draw list is submitted
+typedef struct IvyDrawCommand {
+  IvyGraphicsProgram *program;
+  IvyGraphicsTexture *texture;
+  VkBuffer vertexBuffer;
+  uint64_t vertexBufferOffset;
+  VkBuffer indexBuffer;
+  uint64_t indexBufferOffset;
+  uint32_t indexCount;
+  uint32_t firstIndex;
+  int32_t vertexOffset;
+  IvyM4 model;
+} IvyDrawCommand;
+
+typedef struct IvyDrawListStatistics {
+  uint32_t commandCount;
+  uint32_t drawCount;
+  uint32_t programBindCount;
+  uint32_t textureBindCount;
+  uint32_t vertexBufferBindCount;
+  uint32_t indexBufferBindCount;
+  uint32_t modelPushCount;
+} IvyDrawListStatistics;
+
+// NOTE: sort keys are laid out as (msb to lsb) 8 bits of program, 16 bits
+//       of texture, 24 bits of depth and 16 bits of material. Programs and
+//       textures get their key in the order they are first seen after a
+//       reset, so draws sharing them end up next to each other.
+typedef struct IvyDrawList {
+  IvyAnyMemoryAllocator ownerMemoryAllocator;
+  uint32_t commandCount;
+  uint32_t commandCapacity;
+  IvyDrawCommand *commands;
+  uint64_t *sortKeys;
+  uint64_t *scratchSortKeys;
+  uint32_t *sortedIndices;
+  uint32_t *scratchSortedIndices;
+  uint32_t programCount;
+  IvyGraphicsProgram *programs[IVY_MAX_DRAW_LIST_PROGRAMS];
+  uint32_t textureCount;
+  uint32_t textureCapacity;
+  IvyGraphicsTexture **textures;
+  IvyDrawListStatistics statistics;
+} IvyDrawList;
+
+IVY_API IvyCode ivyCreateDrawList(IvyAnyMemoryAllocator allocator,
+    IvyDrawList *drawList);
+
+IVY_API void ivyDestroyDrawList(IvyDrawList *drawList);
+
+IVY_API void ivyResetDrawList(IvyDrawList *drawList);
+
+// NOTE: depth is expected in [0, 1], smaller depths are drawn first
+IVY_API IvyCode ivyAddDrawListCommand(IvyDrawList *drawList,
+    IvyDrawCommand const *command, float depth, uint16_t material);
+
+// NOTE: sorts sortKeys and sortedIndices. The sort is stable, so commands
+//       with equal keys stay in the order they were added
+IVY_API void ivySortDrawList(IvyDrawList *drawList);
+
+// NOTE: index is a position in sortedIndices. Returns the position after the
+//       last command merged into the one at index, and the index count of
+//       the merged draw
+IVY_API uint32_t ivyMergeDrawListCommands(IvyDrawList const *drawList,
+    uint32_t index, uint32_t *indexCount);
+
+// NOTE: sorts the commands and records them into the current frame. Draws
+//       that share every bind and have contiguous index ranges are merged
+//       into a single vkCmdDrawIndexed
+IVY_API IvyCode ivySubmitDrawList(IvyRenderer *renderer,
+    IvyDrawList *drawList);
+
+IVY_API void ivyGetDrawListStatistics(IvyDrawList *drawList,
+    IvyDrawListStatistics *statistics);
+
+#endif
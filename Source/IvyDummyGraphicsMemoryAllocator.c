@@ -27,7 +27,8 @@ ivyFindEmptyChunkInDummyGraphicsMemoryAllocator(
 
 IVY_INTERNAL IvyCode ivyDummyGraphicsMemoryAllocatorAllocate(
     IvyGraphicsDevice *device, IvyAnyGraphicsMemoryAllocator allocator,
-    uint32_t flags, uint32_t type, uint64_t size, IvyGraphicsMemory *memory) {
+    uint32_t flags, uint32_t type, uint64_t size, uint64_t alignment,
+    IvyGraphicsMemory *memory) {
   IvyCode ivyCode;
   IvyGraphicsMemoryChunk *chunk;
   IvyDummyGraphicsMemoryAllocator *dummyAllocator = allocator;
@@ -36,6 +37,10 @@ IVY_INTERNAL IvyCode ivyDummyGraphicsMemoryAllocatorAllocate(
   IVY_ASSERT(allocator);
   IVY_ASSERT(memory);
 
+  // NOTE: every allocation gets its own chunk at offset 0, which satisfies
+  //       any alignment
+  IVY_UNUSED(alignment);
+
   chunk = ivyFindEmptyChunkInDummyGraphicsMemoryAllocator(dummyAllocator);
   IVY_ASSERT(chunk);
   if (!chunk) {
@@ -55,6 +60,7 @@ IVY_INTERNAL IvyCode ivyDummyGraphicsMemoryAllocatorAllocate(
   memory->flags = chunk->flags;
   memory->type = chunk->type;
   memory->offset = 0;
+  memory->size = size;
   memory->memory = chunk->memory;
 
   return IVY_OK;
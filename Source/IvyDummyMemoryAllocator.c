@@ -1,26 +1,20 @@
 #include "IvyDummyMemoryAllocator.h"
 
-#include "IvyLog.h"
+#include "IvyAtomic.h"
 
 #include <stdlib.h>
 
 IVY_INTERNAL void *ivyDummyMemoryAllocatorAllocate(
     IvyAnyMemoryAllocator allocator, uint64_t size) {
   IvyDummyMemoryAllocator *dummyAllocator = allocator;
-  ++dummyAllocator->aliveAllocationCount;
-  IVY_DEBUG_LOG("dummyAllocator: %p\n  size: %lu\n  "
-                "dummyAllocator->aliveAllocationCount: %i\n",
-      allocator, size, dummyAllocator->aliveAllocationCount);
+  IVY_ATOMIC_ADD(&dummyAllocator->aliveAllocationCount, 1);
   return malloc(size);
 }
 
 IVY_INTERNAL void *ivyDummyMemoryAllocatorAllocateAndZeroMemory(
     IvyAnyMemoryAllocator allocator, uint64_t count, uint64_t elementSize) {
   IvyDummyMemoryAllocator *dummyAllocator = allocator;
-  ++dummyAllocator->aliveAllocationCount;
-  IVY_DEBUG_LOG("dummyAllocator: %p\n  count: %lu\n  elementSize: %lu\n  "
-                "dummyAllocator->aliveAllocationCount: %i\n",
-      allocator, count, elementSize, dummyAllocator->aliveAllocationCount);
+  IVY_ATOMIC_ADD(&dummyAllocator->aliveAllocationCount, 1);
   return calloc(count, elementSize);
 }
 
@@ -28,13 +22,10 @@ IVY_INTERNAL void *ivyDummyMemoryAllocatorReallocate(
     IvyAnyMemoryAllocator allocator, void *data, uint64_t newSize) {
   IvyDummyMemoryAllocator *dummyAllocator = allocator;
   if (!data) {
-    ++dummyAllocator->aliveAllocationCount;
+    IVY_ATOMIC_ADD(&dummyAllocator->aliveAllocationCount, 1);
   }
   IVY_UNUSED(allocator);
   IVY_UNUSED(dummyAllocator);
-  IVY_DEBUG_LOG("dummyAllocator: %p\n  data: %p\n  newSize: %lu\n  "
-                "dummyAllocator->aliveAllocationCount: %i\n",
-      allocator, data, newSize, dummyAllocator->aliveAllocationCount);
   return realloc(data, newSize);
 }
 
@@ -49,13 +40,9 @@ IVY_INTERNAL void ivyDummyMemoryAllocatorFree(IvyAnyMemoryAllocator allocator,
   IvyDummyMemoryAllocator *dummyAllocator = allocator;
 
   if (data) {
-    --dummyAllocator->aliveAllocationCount;
+    IVY_ATOMIC_SUB(&dummyAllocator->aliveAllocationCount, 1);
     free(data);
   }
-
-  IVY_DEBUG_LOG("dummyAllocator: %p\n  data: %p\n  "
-                "dummyAllocator->aliveAllocationCount: %i\n",
-      allocator, data, dummyAllocator->aliveAllocationCount);
 }
 
 IVY_INTERNAL void ivyDestroyDummyMemoryAllocator(
@@ -63,9 +50,7 @@ IVY_INTERNAL void ivyDestroyDummyMemoryAllocator(
   IvyDummyMemoryAllocator *dummyAllocator = allocator;
   IVY_UNUSED(allocator);
   IVY_UNUSED(dummyAllocator);
-  IVY_DEBUG_LOG("dummyAllocator->aliveAllocationCount: %i\n",
-      dummyAllocator->aliveAllocationCount);
-  IVY_ASSERT(!dummyAllocator->aliveAllocationCount);
+  IVY_ASSERT(!IVY_ATOMIC_LOAD(&dummyAllocator->aliveAllocationCount));
 }
 
 IVY_INTERNAL IvyMemoryAllocatorDispatch const dummyMemoryAllocatorDispatch = {
@@ -285,10 +285,11 @@ IVY_API char const *const *ivyGLFWGetRequiredVulkanExtensions(
 }
 
 IVY_API VkResult ivyGLFWCreateVulkanSurface(VkInstance instance,
-    IvyGLFWApplication *application, VkSurfaceKHR *surface) {
+    IvyGLFWApplication *application,
+    VkAllocationCallbacks const *allocationCallbacks, VkSurfaceKHR *surface) {
   IVY_ASSERT(instance);
   IVY_ASSERT(application);
 
   return glfwCreateWindowSurface(instance,
-      application->lastAddedWindow->window, NULL, surface);
+      application->lastAddedWindow->window, allocationCallbacks, surface);
 }
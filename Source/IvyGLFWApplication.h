@@ -53,6 +53,7 @@ IVY_API char const *const *ivyGLFWGetRequiredVulkanExtensions(
     IvyGLFWApplication *application, uint32_t *count);
 
 IVY_API VkResult ivyGLFWCreateVulkanSurface(VkInstance instance,
-    IvyGLFWApplication *application, VkSurfaceKHR *surface);
+    IvyGLFWApplication *application,
+    VkAllocationCallbacks const *allocationCallbacks, VkSurfaceKHR *surface);
 
 #endif
@@ -4,18 +4,14 @@
 #include "IvyRenderer.h"
 #include "IvyVulkanUtilities.h"
 
-typedef struct IvyGraphicsUploadBuffer {
-  VkBuffer buffer;
-  IvyGraphicsMemory memory;
-} IvyGraphicsUploadBuffer;
-
 IVY_INTERNAL void ivyDestroyGraphicsUploadBuffer(IvyGraphicsDevice *device,
     IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator,
     IvyGraphicsUploadBuffer *buffer) {
   ivyFreeGraphicsMemory(device, graphicsMemoryAllocator, &buffer->memory);
 
   if (buffer->buffer) {
-    vkDestroyBuffer(device->logicalDevice, buffer->buffer, NULL);
+    vkDestroyBuffer(device->logicalDevice, buffer->buffer,
+        device->allocationCallbacks);
     buffer->buffer = VK_NULL_HANDLE;
   }
 }
@@ -30,7 +26,8 @@ IVY_INTERNAL IvyCode ivyCreateGraphicsUploadBuffer(IvyGraphicsDevice *device,
   buffer->buffer = VK_NULL_HANDLE;
 
   vulkanResult = ivyCreateVulkanBuffer(device->logicalDevice,
-      VK_BUFFER_USAGE_TRANSFER_SRC_BIT, size, &buffer->buffer);
+      device->allocationCallbacks, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, size,
+      &buffer->buffer);
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
     ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
@@ -39,7 +36,7 @@ IVY_INTERNAL IvyCode ivyCreateGraphicsUploadBuffer(IvyGraphicsDevice *device,
 
   ivyCode =
       ivyAllocateAndBindGraphicsMemoryToBuffer(device, graphicsMemoryAllocator,
-          IVY_CPU_VISIBLE, buffer->buffer, &buffer->memory);
+          IVY_UPLOAD, buffer->buffer, &buffer->memory);
   IVY_ASSERT(!ivyCode);
   if (ivyCode) {
     goto error;
@@ -64,10 +61,536 @@ IVY_INTERNAL uint64_t ivyGetPixelFormatSize(IvyPixelFormat format) {
   }
 }
 
-IVY_API IvyCode ivyUploadDataToVulkanImage(IvyGraphicsDevice *device,
+IVY_INTERNAL uint64_t ivyAlignGraphicsStagingOffset(uint64_t offset) {
+  return (offset + IVY_GRAPHICS_STAGING_ALIGNMENT - 1) &
+         ~(uint64_t)(IVY_GRAPHICS_STAGING_ALIGNMENT - 1);
+}
+
+IVY_INTERNAL IvyBool ivyHasDedicatedTransferQueue(
+    IvyGraphicsDevice const *device) {
+  return device->transferQueueFamilyIndex != device->graphicsQueueFamilyIndex;
+}
+
+IVY_API IvyBool ivyIsGraphicsUploadComplete(IvyGraphicsDevice *device,
+    IvyGraphicsUploadTicket ticket) {
+  uint64_t value;
+
+  if (vkGetSemaphoreCounterValue(device->logicalDevice,
+          device->uploadSemaphore, &value)) {
+    return 0;
+  }
+
+  return value >= ticket;
+}
+
+IVY_API IvyCode ivyWaitForGraphicsUpload(IvyGraphicsDevice *device,
+    IvyGraphicsUploadTicket ticket) {
+  VkResult vulkanResult;
+
+  vulkanResult = ivyWaitForVulkanTimelineSemaphore(device->logicalDevice,
+      device->uploadSemaphore, ticket);
+  IVY_ASSERT(!vulkanResult);
+  return ivyVulkanResultAsIvyCode(vulkanResult);
+}
+
+IVY_INTERNAL VkResult ivyCreateVulkanUploadCommandPool(VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks,
+    uint32_t queueFamilyIndex, VkCommandPool *commandPool) {
+  VkCommandPoolCreateInfo commandPoolCreateInfo;
+
+  commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  commandPoolCreateInfo.pNext = NULL;
+  commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+  commandPoolCreateInfo.queueFamilyIndex = queueFamilyIndex;
+
+  return vkCreateCommandPool(device, &commandPoolCreateInfo,
+      allocationCallbacks, commandPool);
+}
+
+IVY_API IvyCode ivyCreateGraphicsStagingRing(IvyGraphicsDevice *device,
+    IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator, uint64_t size,
+    IvyGraphicsStagingRing *stagingRing) {
+  int index;
+  IvyCode ivyCode;
+  VkResult vulkanResult;
+
+  IVY_ASSERT(device);
+  IVY_ASSERT(graphicsMemoryAllocator);
+  IVY_ASSERT(stagingRing);
+
+  IVY_MEMSET(stagingRing, 0, sizeof(*stagingRing));
+
+  stagingRing->size = size;
+
+  vulkanResult = ivyCreateVulkanBuffer(device->logicalDevice,
+      device->allocationCallbacks, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, size,
+      &stagingRing->buffer);
+  IVY_ASSERT(!vulkanResult);
+  if (vulkanResult) {
+    ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
+    goto error;
+  }
+
+  ivyCode = ivyAllocateAndBindGraphicsMemoryToBuffer(device,
+      graphicsMemoryAllocator, IVY_UPLOAD, stagingRing->buffer,
+      &stagingRing->memory);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
+  vulkanResult = ivyCreateVulkanUploadCommandPool(device->logicalDevice,
+      device->allocationCallbacks, device->transferQueueFamilyIndex,
+      &stagingRing->transferCommandPool);
+  IVY_ASSERT(!vulkanResult);
+  if (vulkanResult) {
+    ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
+    goto error;
+  }
+
+  vulkanResult = ivyCreateVulkanUploadCommandPool(device->logicalDevice,
+      device->allocationCallbacks, device->graphicsQueueFamilyIndex,
+      &stagingRing->acquireCommandPool);
+  IVY_ASSERT(!vulkanResult);
+  if (vulkanResult) {
+    ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
+    goto error;
+  }
+
+  for (index = 0; index < IVY_ARRAY_LENGTH(stagingRing->regions); ++index) {
+    VkFenceCreateInfo fenceCreateInfo;
+
+    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceCreateInfo.pNext = NULL;
+    fenceCreateInfo.flags = 0;
+
+    vulkanResult = vkCreateFence(device->logicalDevice, &fenceCreateInfo,
+        device->allocationCallbacks, &stagingRing->regions[index].fence);
+    IVY_ASSERT(!vulkanResult);
+    if (vulkanResult) {
+      ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
+      goto error;
+    }
+  }
+
+  return IVY_OK;
+
+error:
+  ivyDestroyGraphicsStagingRing(device, graphicsMemoryAllocator, stagingRing);
+  return ivyCode;
+}
+
+IVY_INTERNAL void ivyFreeGraphicsStagingRegionCommandBuffers(
+    IvyGraphicsDevice *device, IvyGraphicsStagingRing *stagingRing,
+    IvyGraphicsStagingRegion *region) {
+  if (region->transferCommandBuffer) {
+    vkFreeCommandBuffers(device->logicalDevice,
+        stagingRing->transferCommandPool, 1, &region->transferCommandBuffer);
+    region->transferCommandBuffer = VK_NULL_HANDLE;
+  }
+
+  if (region->acquireCommandBuffer) {
+    vkFreeCommandBuffers(device->logicalDevice,
+        stagingRing->acquireCommandPool, 1, &region->acquireCommandBuffer);
+    region->acquireCommandBuffer = VK_NULL_HANDLE;
+  }
+}
+
+IVY_INTERNAL void ivyRetireOldestGraphicsStagingRegion(
+    IvyGraphicsDevice *device, IvyGraphicsStagingRing *stagingRing) {
+  IvyGraphicsStagingRegion *region;
+
+  IVY_ASSERT(stagingRing->regionCount);
+
+  region = &stagingRing->regions[stagingRing->firstRegionIndex];
+  ivyFreeGraphicsStagingRegionCommandBuffers(device, stagingRing, region);
+
+  stagingRing->usedSize -= region->size;
+  stagingRing->firstRegionIndex = (stagingRing->firstRegionIndex + 1) %
+                                  IVY_ARRAY_LENGTH(stagingRing->regions);
+  --stagingRing->regionCount;
+
+  if (!stagingRing->regionCount) {
+    IVY_ASSERT(!stagingRing->usedSize);
+    stagingRing->head = 0;
+  }
+}
+
+// NOTE: only valid for the region that was pushed last, used when its
+//       submission failed and nothing will ever signal its fence
+IVY_INTERNAL void ivyDiscardNewestGraphicsStagingRegion(
+    IvyGraphicsDevice *device, IvyGraphicsStagingRing *stagingRing,
+    IvyGraphicsStagingRegion *region) {
+  ivyFreeGraphicsStagingRegionCommandBuffers(device, stagingRing, region);
+  stagingRing->head = region->offset;
+  stagingRing->usedSize -= region->size;
+  --stagingRing->regionCount;
+}
+
+IVY_INTERNAL void ivyRetireCompletedGraphicsStagingRegions(
+    IvyGraphicsDevice *device, IvyGraphicsStagingRing *stagingRing) {
+  while (stagingRing->regionCount) {
+    IvyGraphicsStagingRegion *region =
+        &stagingRing->regions[stagingRing->firstRegionIndex];
+
+    if (VK_SUCCESS != vkGetFenceStatus(device->logicalDevice, region->fence)) {
+      break;
+    }
+
+    ivyRetireOldestGraphicsStagingRegion(device, stagingRing);
+  }
+}
+
+IVY_INTERNAL VkResult ivyWaitForOldestGraphicsStagingRegion(
+    IvyGraphicsDevice *device, IvyGraphicsStagingRing *stagingRing) {
+  VkResult vulkanResult;
+  IvyGraphicsStagingRegion *region;
+
+  IVY_ASSERT(stagingRing->regionCount);
+
+  region = &stagingRing->regions[stagingRing->firstRegionIndex];
+  vulkanResult = vkWaitForFences(device->logicalDevice, 1, &region->fence,
+      VK_TRUE, (uint64_t)-1);
+  if (vulkanResult) {
+    return vulkanResult;
+  }
+
+  ivyRetireOldestGraphicsStagingRegion(device, stagingRing);
+
+  return VK_SUCCESS;
+}
+
+// NOTE: the live regions always span [tail, head) going around the ring, new
+//       regions are carved right after head, wrapping to 0 if the tail end is
+//       too small. Growing the newest region doesn't need a free region slot
+IVY_INTERNAL IvyBool ivyFindGraphicsStagingRingSpace(
+    IvyGraphicsStagingRing const *stagingRing, uint64_t size,
+    IvyBool needsRegion, uint64_t *dataOffset, uint64_t *regionSize) {
+  uint64_t tail;
+  uint64_t alignedHead;
+
+  if (needsRegion && IVY_ARRAY_LENGTH(stagingRing->regions) <=
+                         (long)stagingRing->regionCount) {
+    return 0;
+  }
+
+  if (!stagingRing->regionCount) {
+    if (size > stagingRing->size) {
+      return 0;
+    }
+
+    *dataOffset = 0;
+    *regionSize = size;
+    return 1;
+  }
+
+  tail = stagingRing->regions[stagingRing->firstRegionIndex].offset;
+  alignedHead = ivyAlignGraphicsStagingOffset(stagingRing->head);
+
+  if (stagingRing->head > tail) {
+    if (alignedHead + size <= stagingRing->size) {
+      *dataOffset = alignedHead;
+      *regionSize = alignedHead + size - stagingRing->head;
+      return 1;
+    }
+
+    if (size <= tail) {
+      *dataOffset = 0;
+      *regionSize = stagingRing->size - stagingRing->head + size;
+      return 1;
+    }
+  } else if (stagingRing->head < tail) {
+    if (alignedHead + size <= tail) {
+      *dataOffset = alignedHead;
+      *regionSize = alignedHead + size - stagingRing->head;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+IVY_INTERNAL IvyCode ivyBeginGraphicsStagingUpload(IvyGraphicsDevice *device,
+    IvyGraphicsStagingRing *stagingRing, uint64_t size, void *data,
+    IvyGraphicsStagingRegion **region, uint64_t *dataOffset) {
+  VkResult vulkanResult;
+  uint32_t regionIndex;
+  uint64_t regionSize;
+  IvyGraphicsStagingRegion *currentRegion;
+
+  IVY_ASSERT(size <= stagingRing->size);
+  IVY_ASSERT(!stagingRing->batchRegion);
+
+  ivyRetireCompletedGraphicsStagingRegions(device, stagingRing);
+
+  while (!ivyFindGraphicsStagingRingSpace(stagingRing, size, 1, dataOffset,
+      &regionSize)) {
+    IVY_ASSERT(stagingRing->regionCount);
+    vulkanResult = ivyWaitForOldestGraphicsStagingRegion(device, stagingRing);
+    if (vulkanResult) {
+      return ivyVulkanResultAsIvyCode(vulkanResult);
+    }
+  }
+
+  regionIndex = (stagingRing->firstRegionIndex + stagingRing->regionCount) %
+                IVY_ARRAY_LENGTH(stagingRing->regions);
+  currentRegion = &stagingRing->regions[regionIndex];
+
+  vulkanResult =
+      vkResetFences(device->logicalDevice, 1, &currentRegion->fence);
+  IVY_ASSERT(!vulkanResult);
+  if (vulkanResult) {
+    return ivyVulkanResultAsIvyCode(vulkanResult);
+  }
+
+  vulkanResult = ivyAllocateAndBeginVulkanCommandBuffer(device->logicalDevice,
+      stagingRing->transferCommandPool, &currentRegion->transferCommandBuffer);
+  IVY_ASSERT(!vulkanResult);
+  if (vulkanResult) {
+    return ivyVulkanResultAsIvyCode(vulkanResult);
+  }
+
+  if (ivyHasDedicatedTransferQueue(device)) {
+    vulkanResult = ivyAllocateAndBeginVulkanCommandBuffer(
+        device->logicalDevice, stagingRing->acquireCommandPool,
+        &currentRegion->acquireCommandBuffer);
+    IVY_ASSERT(!vulkanResult);
+    if (vulkanResult) {
+      ivyFreeGraphicsStagingRegionCommandBuffers(device, stagingRing,
+          currentRegion);
+      return ivyVulkanResultAsIvyCode(vulkanResult);
+    }
+  }
+
+  currentRegion->offset = stagingRing->head;
+  currentRegion->size = regionSize;
+
+  stagingRing->head = *dataOffset + size;
+  stagingRing->usedSize += regionSize;
+  ++stagingRing->regionCount;
+
+  IVY_MEMCPY((uint8_t *)stagingRing->memory.data + *dataOffset, data, size);
+
+  *region = currentRegion;
+
+  return IVY_OK;
+}
+
+// NOTE: with a dedicated transfer queue the copy runs there and the acquire
+//       half of the ownership transfer runs on the graphics queue right after
+//       it, both chained through the upload timeline
+IVY_INTERNAL IvyCode ivyEndGraphicsStagingUpload(IvyGraphicsDevice *device,
+    IvyGraphicsStagingRing *stagingRing, IvyGraphicsStagingRegion *region,
+    IvyGraphicsUploadTicket *ticket) {
+  VkResult vulkanResult;
+  uint64_t const transferValue = device->uploadTimelineValue + 1;
+
+  vulkanResult = vkEndCommandBuffer(region->transferCommandBuffer);
+  if (!vulkanResult && region->acquireCommandBuffer) {
+    vulkanResult = vkEndCommandBuffer(region->acquireCommandBuffer);
+  }
+
+  if (!vulkanResult) {
+    vulkanResult = ivySubmitVulkanCommandBuffer(device->transferQueue,
+        region->transferCommandBuffer, device->uploadSemaphore,
+        device->uploadTimelineValue, transferValue,
+        region->acquireCommandBuffer ? VK_NULL_HANDLE : region->fence);
+  }
+
+  if (vulkanResult) {
+    ivyDiscardNewestGraphicsStagingRegion(device, stagingRing, region);
+    return ivyVulkanResultAsIvyCode(vulkanResult);
+  }
+
+  device->uploadTimelineValue = transferValue;
+
+  if (region->acquireCommandBuffer) {
+    vulkanResult = ivySubmitVulkanCommandBuffer(device->graphicsQueue,
+        region->acquireCommandBuffer, device->uploadSemaphore, transferValue,
+        transferValue + 1, region->fence);
+    if (vulkanResult) {
+      ivyWaitForVulkanTimelineSemaphore(device->logicalDevice,
+          device->uploadSemaphore, transferValue);
+      ivyDiscardNewestGraphicsStagingRegion(device, stagingRing, region);
+      return ivyVulkanResultAsIvyCode(vulkanResult);
+    }
+
+    device->uploadTimelineValue = transferValue + 1;
+  }
+
+  if (ticket) {
+    *ticket = device->uploadTimelineValue;
+  }
+
+  return IVY_OK;
+}
+
+IVY_API void ivyDestroyGraphicsStagingRing(IvyGraphicsDevice *device,
+    IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator,
+    IvyGraphicsStagingRing *stagingRing) {
+  int index;
+
+  while (stagingRing->regionCount) {
+    ivyWaitForOldestGraphicsStagingRegion(device, stagingRing);
+  }
+
+  for (index = 0; index < IVY_ARRAY_LENGTH(stagingRing->regions); ++index) {
+    if (stagingRing->regions[index].fence) {
+      vkDestroyFence(device->logicalDevice, stagingRing->regions[index].fence,
+          device->allocationCallbacks);
+      stagingRing->regions[index].fence = VK_NULL_HANDLE;
+    }
+  }
+
+  if (stagingRing->acquireCommandPool) {
+    vkDestroyCommandPool(device->logicalDevice,
+        stagingRing->acquireCommandPool, device->allocationCallbacks);
+    stagingRing->acquireCommandPool = VK_NULL_HANDLE;
+  }
+
+  if (stagingRing->transferCommandPool) {
+    vkDestroyCommandPool(device->logicalDevice,
+        stagingRing->transferCommandPool, device->allocationCallbacks);
+    stagingRing->transferCommandPool = VK_NULL_HANDLE;
+  }
+
+  ivyFreeGraphicsMemory(device, graphicsMemoryAllocator, &stagingRing->memory);
+
+  if (stagingRing->buffer) {
+    vkDestroyBuffer(device->logicalDevice, stagingRing->buffer,
+        device->allocationCallbacks);
+    stagingRing->buffer = VK_NULL_HANDLE;
+  }
+}
+
+IVY_INTERNAL void ivySetupVulkanBufferImageCopy(uint64_t bufferOffset,
+    int32_t width, int32_t height, VkBufferImageCopy *bufferImageCopy) {
+  bufferImageCopy->bufferOffset = bufferOffset;
+  bufferImageCopy->bufferRowLength = 0;
+  bufferImageCopy->bufferImageHeight = 0;
+  bufferImageCopy->imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  bufferImageCopy->imageSubresource.mipLevel = 0;
+  bufferImageCopy->imageSubresource.baseArrayLayer = 0;
+  bufferImageCopy->imageSubresource.layerCount = 1;
+  bufferImageCopy->imageOffset.x = 0;
+  bufferImageCopy->imageOffset.y = 0;
+  bufferImageCopy->imageOffset.z = 0;
+  bufferImageCopy->imageExtent.width = width;
+  bufferImageCopy->imageExtent.height = height;
+  bufferImageCopy->imageExtent.depth = 1;
+}
+
+IVY_INTERNAL void ivySetupVulkanUploadImageMemoryBarrier(VkImage image,
+    uint32_t mipLevels, VkImageMemoryBarrier *imageMemoryBarrier) {
+  imageMemoryBarrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  imageMemoryBarrier->pNext = NULL;
+  imageMemoryBarrier->srcAccessMask = 0;
+  imageMemoryBarrier->dstAccessMask = 0;
+  imageMemoryBarrier->oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  imageMemoryBarrier->newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  imageMemoryBarrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  imageMemoryBarrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  imageMemoryBarrier->image = image;
+  imageMemoryBarrier->subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  imageMemoryBarrier->subresourceRange.baseMipLevel = 0;
+  imageMemoryBarrier->subresourceRange.levelCount = mipLevels;
+  imageMemoryBarrier->subresourceRange.baseArrayLayer = 0;
+  imageMemoryBarrier->subresourceRange.layerCount = 1;
+}
+
+IVY_INTERNAL void ivySetupVulkanUploadBufferMemoryBarrier(VkBuffer buffer,
+    VkBufferMemoryBarrier *bufferMemoryBarrier) {
+  bufferMemoryBarrier->sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  bufferMemoryBarrier->pNext = NULL;
+  bufferMemoryBarrier->srcAccessMask = 0;
+  bufferMemoryBarrier->dstAccessMask = 0;
+  bufferMemoryBarrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  bufferMemoryBarrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  bufferMemoryBarrier->buffer = buffer;
+  bufferMemoryBarrier->offset = 0;
+  bufferMemoryBarrier->size = VK_WHOLE_SIZE;
+}
+
+IVY_INTERNAL void ivyRecordVulkanImageTransferDestinationBarrier(
+    VkCommandBuffer commandBuffer, uint32_t mipLevels, VkImage image) {
+  VkImageMemoryBarrier imageMemoryBarrier;
+
+  ivySetupVulkanUploadImageMemoryBarrier(image, mipLevels,
+      &imageMemoryBarrier);
+  imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+      VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1,
+      &imageMemoryBarrier);
+}
+
+IVY_INTERNAL void ivyRecordVulkanImageOwnershipTransfer(
+    IvyGraphicsDevice *device, IvyGraphicsStagingRegion *region,
+    uint32_t mipLevels, VkImage image) {
+  VkImageMemoryBarrier imageMemoryBarrier;
+
+  ivySetupVulkanUploadImageMemoryBarrier(image, mipLevels,
+      &imageMemoryBarrier);
+  imageMemoryBarrier.srcQueueFamilyIndex = device->transferQueueFamilyIndex;
+  imageMemoryBarrier.dstQueueFamilyIndex = device->graphicsQueueFamilyIndex;
+
+  imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  vkCmdPipelineBarrier(region->transferCommandBuffer,
+      VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+      0, NULL, 0, NULL, 1, &imageMemoryBarrier);
+
+  imageMemoryBarrier.srcAccessMask = 0;
+  imageMemoryBarrier.dstAccessMask =
+      VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+  vkCmdPipelineBarrier(region->acquireCommandBuffer,
+      VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+      NULL, 0, NULL, 1, &imageMemoryBarrier);
+}
+
+IVY_INTERNAL void ivyRecordVulkanBufferOwnershipTransfer(
+    IvyGraphicsDevice *device, IvyGraphicsStagingRegion *region,
+    VkBuffer buffer) {
+  VkBufferMemoryBarrier bufferMemoryBarrier;
+
+  ivySetupVulkanUploadBufferMemoryBarrier(buffer, &bufferMemoryBarrier);
+  bufferMemoryBarrier.srcQueueFamilyIndex = device->transferQueueFamilyIndex;
+  bufferMemoryBarrier.dstQueueFamilyIndex = device->graphicsQueueFamilyIndex;
+
+  bufferMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  vkCmdPipelineBarrier(region->transferCommandBuffer,
+      VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+      0, NULL, 1, &bufferMemoryBarrier, 0, NULL);
+
+  bufferMemoryBarrier.srcAccessMask = 0;
+  bufferMemoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+  vkCmdPipelineBarrier(region->acquireCommandBuffer,
+      VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+      0, 0, NULL, 1, &bufferMemoryBarrier, 0, NULL);
+}
+
+// NOTE: the copy is submitted without waiting, later readers of the buffer
+//       are ordered after it by this barrier
+IVY_INTERNAL void ivyRecordVulkanTransferToReadBarrier(
+    VkCommandBuffer commandBuffer) {
+  VkMemoryBarrier memoryBarrier;
+
+  memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  memoryBarrier.pNext = NULL;
+  memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  memoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memoryBarrier, 0, NULL, 0,
+      NULL);
+}
+
+IVY_INTERNAL IvyCode ivyUploadDataToVulkanImageDirectly(
+    IvyGraphicsDevice *device,
     IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator,
     VkCommandPool commandPool, int32_t width, int32_t height,
-    IvyPixelFormat format, void *data, VkImage image) {
+    uint32_t mipLevels, IvyPixelFormat format, void *data, VkImage image,
+    IvyGraphicsUploadTicket *ticket) {
   IvyCode ivyCode;
   VkResult vulkanResult;
   VkBufferImageCopy bufferImageCopy;
@@ -92,25 +615,18 @@ IVY_API IvyCode ivyUploadDataToVulkanImage(IvyGraphicsDevice *device,
     goto error;
   }
 
-  bufferImageCopy.bufferOffset = 0;
-  bufferImageCopy.bufferRowLength = 0;
-  bufferImageCopy.bufferImageHeight = 0;
-  bufferImageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  bufferImageCopy.imageSubresource.mipLevel = 0;
-  bufferImageCopy.imageSubresource.baseArrayLayer = 0;
-  bufferImageCopy.imageSubresource.layerCount = 1;
-  bufferImageCopy.imageOffset.x = 0;
-  bufferImageCopy.imageOffset.y = 0;
-  bufferImageCopy.imageOffset.z = 0;
-  bufferImageCopy.imageExtent.width = width;
-  bufferImageCopy.imageExtent.height = height;
-  bufferImageCopy.imageExtent.depth = 1;
+  ivyRecordVulkanImageTransferDestinationBarrier(commandBuffer, mipLevels,
+      image);
+
+  ivySetupVulkanBufferImageCopy(0, width, height, &bufferImageCopy);
 
   vkCmdCopyBufferToImage(commandBuffer, uploadBuffer.buffer, image,
       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy);
 
   vulkanResult = ivyEndSubmitAndFreeVulkanCommandBuffer(device->logicalDevice,
-      device->graphicsQueue, commandPool, commandBuffer);
+      device->graphicsQueue, commandPool, commandBuffer,
+      device->uploadSemaphore, &device->uploadTimelineValue);
+  commandBuffer = VK_NULL_HANDLE;
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
     ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
@@ -120,6 +636,10 @@ IVY_API IvyCode ivyUploadDataToVulkanImage(IvyGraphicsDevice *device,
   ivyDestroyGraphicsUploadBuffer(device, graphicsMemoryAllocator,
       &uploadBuffer);
 
+  if (ticket) {
+    *ticket = device->uploadTimelineValue;
+  }
+
   return IVY_OK;
 
 error:
@@ -134,9 +654,11 @@ error:
   return ivyCode;
 }
 
-IVY_API IvyCode ivyUploadDataToVulkanBuffer(IvyGraphicsDevice *device,
+IVY_INTERNAL IvyCode ivyUploadDataToVulkanBufferDirectly(
+    IvyGraphicsDevice *device,
     IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator,
-    VkCommandPool commandPool, uint64_t size, void *data, VkBuffer buffer) {
+    VkCommandPool commandPool, uint64_t size, void *data, VkBuffer buffer,
+    IvyGraphicsUploadTicket *ticket) {
   IvyCode ivyCode = IVY_OK;
   VkResult vulkanResult;
   VkBufferCopy bufferCopy;
@@ -167,8 +689,12 @@ IVY_API IvyCode ivyUploadDataToVulkanBuffer(IvyGraphicsDevice *device,
 
   vkCmdCopyBuffer(commandBuffer, uploadBuffer.buffer, buffer, 1, &bufferCopy);
 
+  ivyRecordVulkanTransferToReadBarrier(commandBuffer);
+
   vulkanResult = ivyEndSubmitAndFreeVulkanCommandBuffer(device->logicalDevice,
-      device->graphicsQueue, commandPool, commandBuffer);
+      device->graphicsQueue, commandPool, commandBuffer,
+      device->uploadSemaphore, &device->uploadTimelineValue);
+  commandBuffer = VK_NULL_HANDLE;
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
     ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
@@ -178,6 +704,10 @@ IVY_API IvyCode ivyUploadDataToVulkanBuffer(IvyGraphicsDevice *device,
   ivyDestroyGraphicsUploadBuffer(device, graphicsMemoryAllocator,
       &uploadBuffer);
 
+  if (ticket) {
+    *ticket = device->uploadTimelineValue;
+  }
+
   return ivyCode;
 
 error:
@@ -191,3 +721,412 @@ error:
 
   return ivyCode;
 }
+
+IVY_API IvyCode ivyUploadDataToVulkanImage(IvyGraphicsDevice *device,
+    IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator,
+    IvyGraphicsStagingRing *stagingRing, VkCommandPool commandPool,
+    int32_t width, int32_t height, uint32_t mipLevels, IvyPixelFormat format,
+    void *data, VkImage image, IvyGraphicsUploadTicket *ticket) {
+  IvyCode ivyCode;
+  uint64_t size;
+  uint64_t dataOffset;
+  VkBufferImageCopy bufferImageCopy;
+  IvyGraphicsStagingRegion *region;
+
+  size = width * height * ivyGetPixelFormatSize(format);
+
+  // NOTE: uploads that don't fit in the ring get their own staging buffer
+  if (!stagingRing || size > stagingRing->size) {
+    return ivyUploadDataToVulkanImageDirectly(device, graphicsMemoryAllocator,
+        commandPool, width, height, mipLevels, format, data, image, ticket);
+  }
+
+  ivyCode = ivyBeginGraphicsStagingUpload(device, stagingRing, size, data,
+      &region, &dataOffset);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    return ivyCode;
+  }
+
+  ivyRecordVulkanImageTransferDestinationBarrier(region->transferCommandBuffer,
+      mipLevels, image);
+
+  ivySetupVulkanBufferImageCopy(dataOffset, width, height, &bufferImageCopy);
+
+  vkCmdCopyBufferToImage(region->transferCommandBuffer, stagingRing->buffer,
+      image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy);
+
+  if (region->acquireCommandBuffer) {
+    ivyRecordVulkanImageOwnershipTransfer(device, region, mipLevels, image);
+  }
+
+  return ivyEndGraphicsStagingUpload(device, stagingRing, region, ticket);
+}
+
+IVY_API IvyCode ivyUploadDataToVulkanBuffer(IvyGraphicsDevice *device,
+    IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator,
+    IvyGraphicsStagingRing *stagingRing, VkCommandPool commandPool,
+    uint64_t size, void *data, VkBuffer buffer,
+    IvyGraphicsUploadTicket *ticket) {
+  IvyCode ivyCode;
+  uint64_t dataOffset;
+  VkBufferCopy bufferCopy;
+  IvyGraphicsStagingRegion *region;
+
+  // NOTE: uploads that don't fit in the ring get their own staging buffer
+  if (!stagingRing || size > stagingRing->size) {
+    return ivyUploadDataToVulkanBufferDirectly(device, graphicsMemoryAllocator,
+        commandPool, size, data, buffer, ticket);
+  }
+
+  ivyCode = ivyBeginGraphicsStagingUpload(device, stagingRing, size, data,
+      &region, &dataOffset);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    return ivyCode;
+  }
+
+  bufferCopy.srcOffset = dataOffset;
+  bufferCopy.dstOffset = 0;
+  bufferCopy.size = size;
+
+  vkCmdCopyBuffer(region->transferCommandBuffer, stagingRing->buffer, buffer,
+      1, &bufferCopy);
+
+  if (region->acquireCommandBuffer) {
+    ivyRecordVulkanBufferOwnershipTransfer(device, region, buffer);
+  } else {
+    ivyRecordVulkanTransferToReadBarrier(region->transferCommandBuffer);
+  }
+
+  return ivyEndGraphicsStagingUpload(device, stagingRing, region, ticket);
+}
+
+IVY_API IvyCode ivyBeginGraphicsUploadBatch(IvyAnyMemoryAllocator allocator,
+    IvyGraphicsDevice *device,
+    IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator,
+    IvyGraphicsStagingRing *stagingRing, VkCommandPool commandPool,
+    IvyGraphicsUploadBatch *batch) {
+  VkResult vulkanResult;
+
+  IVY_ASSERT(device);
+  IVY_ASSERT(graphicsMemoryAllocator);
+  IVY_ASSERT(batch);
+  IVY_ASSERT(!stagingRing || !stagingRing->batchRegion);
+
+  IVY_MEMSET(batch, 0, sizeof(*batch));
+
+  batch->allocator = allocator;
+  batch->device = device;
+  batch->graphicsMemoryAllocator = graphicsMemoryAllocator;
+  batch->stagingRing = stagingRing;
+  batch->commandPool = commandPool;
+
+  vulkanResult = ivyAllocateAndBeginVulkanCommandBuffer(device->logicalDevice,
+      commandPool, &batch->commandBuffer);
+  IVY_ASSERT(!vulkanResult);
+  if (vulkanResult) {
+    return ivyVulkanResultAsIvyCode(vulkanResult);
+  }
+
+  return IVY_OK;
+}
+
+IVY_INTERNAL IvyCode ivyAddGraphicsUploadBatchStagingBuffer(
+    IvyGraphicsUploadBatch *batch, uint64_t size, void *data,
+    IvyGraphicsUploadBuffer **stagingBuffer) {
+  IvyCode ivyCode;
+
+  if (batch->stagingBufferCount == batch->stagingBufferCapacity) {
+    IvyGraphicsUploadBuffer *newStagingBuffers;
+    uint32_t newStagingBufferCapacity =
+        IVY_MAX(8, 2 * batch->stagingBufferCapacity);
+
+    newStagingBuffers = ivyReallocateMemory(batch->allocator,
+        batch->stagingBuffers,
+        newStagingBufferCapacity * sizeof(*newStagingBuffers));
+    if (!newStagingBuffers) {
+      return IVY_ERROR_NO_MEMORY;
+    }
+
+    batch->stagingBuffers = newStagingBuffers;
+    batch->stagingBufferCapacity = newStagingBufferCapacity;
+  }
+
+  *stagingBuffer = &batch->stagingBuffers[batch->stagingBufferCount];
+
+  ivyCode = ivyCreateGraphicsUploadBuffer(batch->device,
+      batch->graphicsMemoryAllocator, size, data, *stagingBuffer);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    return ivyCode;
+  }
+
+  ++batch->stagingBufferCount;
+
+  return IVY_OK;
+}
+
+IVY_INTERNAL void ivyReleaseGraphicsUploadBatchStaging(
+    IvyGraphicsUploadBatch *batch, IvyBool wasSubmitted) {
+  uint32_t index;
+  IvyGraphicsStagingRing *stagingRing = batch->stagingRing;
+
+  // NOTE: a submitted region is retired once its fence signals, like any
+  //       other. One that never made it to the queue is still the newest
+  if (stagingRing && stagingRing->batchRegion) {
+    if (!wasSubmitted) {
+      ivyDiscardNewestGraphicsStagingRegion(batch->device, stagingRing,
+          stagingRing->batchRegion);
+    }
+
+    stagingRing->batchRegion = NULL;
+  }
+
+  for (index = 0; index < batch->stagingBufferCount; ++index) {
+    ivyDestroyGraphicsUploadBuffer(batch->device,
+        batch->graphicsMemoryAllocator, &batch->stagingBuffers[index]);
+  }
+
+  ivyFreeMemory(batch->allocator, batch->stagingBuffers);
+  batch->stagingBuffers = NULL;
+  batch->stagingBufferCount = 0;
+  batch->stagingBufferCapacity = 0;
+}
+
+// NOTE: the staging data can only be released once the copies are done, so
+//       this waits for the batch (and only the batch) to finish. The ring
+//       region's fence is signaled by the same submission
+IVY_INTERNAL IvyCode ivySubmitGraphicsUploadBatch(
+    IvyGraphicsUploadBatch *batch) {
+  VkResult vulkanResult;
+  IvyBool wasSubmitted = 0;
+  VkFence fence = VK_NULL_HANDLE;
+  IvyGraphicsDevice *device = batch->device;
+  IvyGraphicsStagingRing *stagingRing = batch->stagingRing;
+
+  if (stagingRing && stagingRing->batchRegion) {
+    fence = stagingRing->batchRegion->fence;
+  }
+
+  ivyRecordVulkanTransferToReadBarrier(batch->commandBuffer);
+
+  vulkanResult = vkEndCommandBuffer(batch->commandBuffer);
+  if (!vulkanResult) {
+    vulkanResult = ivySubmitVulkanCommandBuffer(device->graphicsQueue,
+        batch->commandBuffer, device->uploadSemaphore,
+        device->uploadTimelineValue, device->uploadTimelineValue + 1, fence);
+  }
+
+  if (!vulkanResult) {
+    wasSubmitted = 1;
+    ++device->uploadTimelineValue;
+    vulkanResult = ivyWaitForVulkanTimelineSemaphore(device->logicalDevice,
+        device->uploadSemaphore, device->uploadTimelineValue);
+  }
+
+  vkFreeCommandBuffers(device->logicalDevice, batch->commandPool, 1,
+      &batch->commandBuffer);
+  batch->commandBuffer = VK_NULL_HANDLE;
+
+  ivyReleaseGraphicsUploadBatchStaging(batch, wasSubmitted);
+
+  IVY_ASSERT(!vulkanResult);
+  return ivyVulkanResultAsIvyCode(vulkanResult);
+}
+
+// NOTE: only called when the batch region is all that's left in the ring and
+//       the next add still doesn't fit
+IVY_INTERNAL IvyCode ivyFlushGraphicsUploadBatch(
+    IvyGraphicsUploadBatch *batch) {
+  IvyCode ivyCode;
+  VkResult vulkanResult;
+
+  ivyCode = ivySubmitGraphicsUploadBatch(batch);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    return ivyCode;
+  }
+
+  ivyRetireCompletedGraphicsStagingRegions(batch->device, batch->stagingRing);
+
+  vulkanResult = ivyAllocateAndBeginVulkanCommandBuffer(
+      batch->device->logicalDevice, batch->commandPool, &batch->commandBuffer);
+  IVY_ASSERT(!vulkanResult);
+  return ivyVulkanResultAsIvyCode(vulkanResult);
+}
+
+// NOTE: the batch stages everything in one region at the ring head that
+//       grows with every add. Older regions are waited on as usual when the
+//       ring is full, the batch's own one by flushing the batch
+IVY_INTERNAL IvyCode ivyStageGraphicsUploadBatchData(
+    IvyGraphicsUploadBatch *batch, uint64_t size, void *data,
+    VkBuffer *buffer, uint64_t *dataOffset) {
+  IvyCode ivyCode;
+  VkResult vulkanResult;
+  uint64_t regionSize;
+  IvyGraphicsDevice *device = batch->device;
+  IvyGraphicsStagingRing *stagingRing = batch->stagingRing;
+
+  // NOTE: uploads that don't fit in the ring get their own staging buffer
+  if (!stagingRing || size > stagingRing->size) {
+    IvyGraphicsUploadBuffer *stagingBuffer;
+
+    ivyCode = ivyAddGraphicsUploadBatchStagingBuffer(batch, size, data,
+        &stagingBuffer);
+    IVY_ASSERT(!ivyCode);
+    if (ivyCode) {
+      return ivyCode;
+    }
+
+    *buffer = stagingBuffer->buffer;
+    *dataOffset = 0;
+    return IVY_OK;
+  }
+
+  ivyRetireCompletedGraphicsStagingRegions(device, stagingRing);
+
+  while (!ivyFindGraphicsStagingRingSpace(stagingRing, size,
+      !stagingRing->batchRegion, dataOffset, &regionSize)) {
+    IvyGraphicsStagingRegion *oldestRegion =
+        &stagingRing->regions[stagingRing->firstRegionIndex];
+
+    IVY_ASSERT(stagingRing->regionCount);
+
+    if (oldestRegion == stagingRing->batchRegion) {
+      ivyCode = ivyFlushGraphicsUploadBatch(batch);
+      IVY_ASSERT(!ivyCode);
+      if (ivyCode) {
+        return ivyCode;
+      }
+
+      continue;
+    }
+
+    vulkanResult = ivyWaitForOldestGraphicsStagingRegion(device, stagingRing);
+    if (vulkanResult) {
+      return ivyVulkanResultAsIvyCode(vulkanResult);
+    }
+  }
+
+  if (!stagingRing->batchRegion) {
+    IvyGraphicsStagingRegion *region;
+    uint32_t const regionIndex =
+        (stagingRing->firstRegionIndex + stagingRing->regionCount) %
+        IVY_ARRAY_LENGTH(stagingRing->regions);
+
+    region = &stagingRing->regions[regionIndex];
+
+    vulkanResult = vkResetFences(device->logicalDevice, 1, &region->fence);
+    IVY_ASSERT(!vulkanResult);
+    if (vulkanResult) {
+      return ivyVulkanResultAsIvyCode(vulkanResult);
+    }
+
+    region->offset = stagingRing->head;
+    region->size = 0;
+    ++stagingRing->regionCount;
+    stagingRing->batchRegion = region;
+  }
+
+  stagingRing->batchRegion->size += regionSize;
+  stagingRing->head = *dataOffset + size;
+  stagingRing->usedSize += regionSize;
+
+  IVY_MEMCPY((uint8_t *)stagingRing->memory.data + *dataOffset, data, size);
+
+  *buffer = stagingRing->buffer;
+
+  return IVY_OK;
+}
+
+IVY_API IvyCode ivyAddBufferToGraphicsUploadBatch(
+    IvyGraphicsUploadBatch *batch, uint64_t size, void *data,
+    VkBuffer buffer) {
+  IvyCode ivyCode;
+  uint64_t dataOffset;
+  VkBuffer stagingBuffer;
+  VkBufferCopy bufferCopy;
+
+  IVY_ASSERT(batch);
+  IVY_ASSERT(batch->commandBuffer);
+
+  ivyCode = ivyStageGraphicsUploadBatchData(batch, size, data,
+      &stagingBuffer, &dataOffset);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    return ivyCode;
+  }
+
+  bufferCopy.srcOffset = dataOffset;
+  bufferCopy.dstOffset = 0;
+  bufferCopy.size = size;
+
+  vkCmdCopyBuffer(batch->commandBuffer, stagingBuffer, buffer, 1,
+      &bufferCopy);
+
+  return IVY_OK;
+}
+
+IVY_API IvyCode ivyAddImageToGraphicsUploadBatch(IvyGraphicsUploadBatch *batch,
+    int32_t width, int32_t height, uint32_t mipLevels, IvyPixelFormat format,
+    void *data, VkImage image) {
+  IvyCode ivyCode;
+  uint64_t dataOffset;
+  VkBuffer stagingBuffer;
+  VkBufferImageCopy bufferImageCopy;
+
+  IVY_ASSERT(batch);
+  IVY_ASSERT(batch->commandBuffer);
+
+  ivyCode = ivyStageGraphicsUploadBatchData(batch,
+      width * height * ivyGetPixelFormatSize(format), data, &stagingBuffer,
+      &dataOffset);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    return ivyCode;
+  }
+
+  ivyRecordVulkanImageTransferDestinationBarrier(batch->commandBuffer,
+      mipLevels, image);
+
+  ivySetupVulkanBufferImageCopy(dataOffset, width, height, &bufferImageCopy);
+
+  vkCmdCopyBufferToImage(batch->commandBuffer, stagingBuffer, image,
+      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy);
+
+  ivyRecordVulkanImageMips(batch->commandBuffer, width, height, mipLevels,
+      image);
+
+  return IVY_OK;
+}
+
+IVY_API IvyCode ivyEndGraphicsUploadBatch(IvyGraphicsUploadBatch *batch,
+    IvyGraphicsUploadTicket *ticket) {
+  IvyCode ivyCode;
+
+  IVY_ASSERT(batch);
+  IVY_ASSERT(batch->commandBuffer);
+
+  ivyCode = ivySubmitGraphicsUploadBatch(batch);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    return ivyCode;
+  }
+
+  if (ticket) {
+    *ticket = batch->device->uploadTimelineValue;
+  }
+
+  return IVY_OK;
+}
+
+IVY_API void ivyDiscardGraphicsUploadBatch(IvyGraphicsUploadBatch *batch) {
+  if (batch->commandBuffer) {
+    vkFreeCommandBuffers(batch->device->logicalDevice, batch->commandPool, 1,
+        &batch->commandBuffer);
+    batch->commandBuffer = VK_NULL_HANDLE;
+  }
+
+  ivyReleaseGraphicsUploadBatchStaging(batch, 0);
+}
@@ -4,15 +4,116 @@
 #include "IvyGraphicsMemoryAllocator.h"
 #include "IvyGraphicsTexture.h"
 
+#define IVY_DEFAULT_GRAPHICS_STAGING_RING_SIZE (32ULL * 1024ULL * 1024ULL)
+#define IVY_MAX_GRAPHICS_STAGING_REGIONS 32
+#define IVY_GRAPHICS_STAGING_ALIGNMENT 16
+
 typedef struct IvyGraphicsDevice IvyGraphicsDevice;
 
+typedef struct IvyGraphicsUploadBuffer {
+  VkBuffer buffer;
+  IvyGraphicsMemory memory;
+} IvyGraphicsUploadBuffer;
+
+// NOTE: a ticket is the value the device upload timeline semaphore reaches
+//       once the upload, including its ownership transfer, is done
+typedef uint64_t IvyGraphicsUploadTicket;
+
+// NOTE: size includes the padding that was skipped at the end of the ring
+//       when the region wrapped around
+typedef struct IvyGraphicsStagingRegion {
+  uint64_t offset;
+  uint64_t size;
+  VkFence fence;
+  VkCommandBuffer transferCommandBuffer;
+  VkCommandBuffer acquireCommandBuffer;
+} IvyGraphicsStagingRegion;
+
+// NOTE: batchRegion is the region of the upload batch that is being
+//       recorded, if any. It grows with every add and is always the newest
+typedef struct IvyGraphicsStagingRing {
+  uint64_t size;
+  uint64_t head;
+  uint64_t usedSize;
+  uint32_t firstRegionIndex;
+  uint32_t regionCount;
+  VkCommandPool transferCommandPool;
+  VkCommandPool acquireCommandPool;
+  VkBuffer buffer;
+  IvyGraphicsMemory memory;
+  IvyGraphicsStagingRegion regions[IVY_MAX_GRAPHICS_STAGING_REGIONS];
+  IvyGraphicsStagingRegion *batchRegion;
+} IvyGraphicsStagingRing;
+
+// NOTE: records the copies, layout transitions and mip blits of many
+//       resources into a single command buffer on the graphics queue. The
+//       data is staged in the ring, only adds bigger than the whole ring get
+//       their own staging buffer. When the ring fills up, what was recorded
+//       so far is submitted early to make room. Everything is released by end
+typedef struct IvyGraphicsUploadBatch {
+  IvyAnyMemoryAllocator allocator;
+  IvyGraphicsDevice *device;
+  IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator;
+  IvyGraphicsStagingRing *stagingRing;
+  VkCommandPool commandPool;
+  VkCommandBuffer commandBuffer;
+  uint32_t stagingBufferCount;
+  uint32_t stagingBufferCapacity;
+  IvyGraphicsUploadBuffer *stagingBuffers;
+} IvyGraphicsUploadBatch;
+
+IVY_API IvyCode ivyCreateGraphicsStagingRing(IvyGraphicsDevice *device,
+    IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator, uint64_t size,
+    IvyGraphicsStagingRing *stagingRing);
+
+IVY_API void ivyDestroyGraphicsStagingRing(IvyGraphicsDevice *device,
+    IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator,
+    IvyGraphicsStagingRing *stagingRing);
+
+IVY_API IvyBool ivyIsGraphicsUploadComplete(IvyGraphicsDevice *device,
+    IvyGraphicsUploadTicket ticket);
+
+IVY_API IvyCode ivyWaitForGraphicsUpload(IvyGraphicsDevice *device,
+    IvyGraphicsUploadTicket ticket);
+
+// NOTE: the image is expected in VK_IMAGE_LAYOUT_UNDEFINED, all mipLevels are
+//       left in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL and owned by the
+//       graphics queue family
 IVY_API IvyCode ivyUploadDataToVulkanImage(IvyGraphicsDevice *device,
     IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator,
-    VkCommandPool commandPool, int32_t width, int32_t height,
-    IvyPixelFormat format, void *data, VkImage image);
+    IvyGraphicsStagingRing *stagingRing, VkCommandPool commandPool,
+    int32_t width, int32_t height, uint32_t mipLevels, IvyPixelFormat format,
+    void *data, VkImage image, IvyGraphicsUploadTicket *ticket);
 
 IVY_API IvyCode ivyUploadDataToVulkanBuffer(IvyGraphicsDevice *device,
     IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator,
-    VkCommandPool commandPool, uint64_t size, void *data, VkBuffer buffer);
+    IvyGraphicsStagingRing *stagingRing, VkCommandPool commandPool,
+    uint64_t size, void *data, VkBuffer buffer,
+    IvyGraphicsUploadTicket *ticket);
+
+// NOTE: stagingRing can be NULL, then every add gets its own staging buffer.
+//       No other upload may go through the ring until the batch is ended or
+//       discarded
+IVY_API IvyCode ivyBeginGraphicsUploadBatch(IvyAnyMemoryAllocator allocator,
+    IvyGraphicsDevice *device,
+    IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator,
+    IvyGraphicsStagingRing *stagingRing, VkCommandPool commandPool,
+    IvyGraphicsUploadBatch *batch);
+
+IVY_API IvyCode ivyAddBufferToGraphicsUploadBatch(
+    IvyGraphicsUploadBatch *batch, uint64_t size, void *data,
+    VkBuffer buffer);
+
+// NOTE: same layout expectations as ivyUploadDataToVulkanImage, but the mips
+//       are generated too, so every level ends up shader readable
+IVY_API IvyCode ivyAddImageToGraphicsUploadBatch(IvyGraphicsUploadBatch *batch,
+    int32_t width, int32_t height, uint32_t mipLevels, IvyPixelFormat format,
+    void *data, VkImage image);
+
+IVY_API IvyCode ivyEndGraphicsUploadBatch(IvyGraphicsUploadBatch *batch,
+    IvyGraphicsUploadTicket *ticket);
+
+// NOTE: throws away everything recorded so far without submitting it
+IVY_API void ivyDiscardGraphicsUploadBatch(IvyGraphicsUploadBatch *batch);
 
 #endif
@@ -0,0 +1,241 @@
+#include "IvyGraphicsDescriptorAllocator.h"
+
+#include "IvyVulkanUtilities.h"
+
+#define IVY_MAX_DESCRIPTOR_POOL_TYPES 7
+
+IVY_INTERNAL VkResult ivyCreateVulkanDescriptorPool(VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks, IvyBool isPersistent,
+    uint32_t setCount, VkDescriptorPool *descriptorPool) {
+  VkDescriptorPoolCreateInfo descriptorPoolCreateInfo;
+  VkDescriptorPoolSize descriptorPoolSizes[IVY_MAX_DESCRIPTOR_POOL_TYPES];
+
+  descriptorPoolSizes[0].descriptorCount = setCount;
+  descriptorPoolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+
+  descriptorPoolSizes[1].descriptorCount = setCount;
+  descriptorPoolSizes[1].type = VK_DESCRIPTOR_TYPE_SAMPLER;
+
+  descriptorPoolSizes[2].descriptorCount = setCount;
+  descriptorPoolSizes[2].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+
+  descriptorPoolSizes[3].descriptorCount = setCount;
+  descriptorPoolSizes[3].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+
+  descriptorPoolSizes[4].descriptorCount = setCount;
+  descriptorPoolSizes[4].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+  descriptorPoolSizes[5].descriptorCount = setCount;
+  descriptorPoolSizes[5].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+
+  descriptorPoolSizes[6].descriptorCount = setCount;
+  descriptorPoolSizes[6].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+
+  descriptorPoolCreateInfo.sType =
+      VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  descriptorPoolCreateInfo.pNext = NULL;
+  if (isPersistent) {
+    descriptorPoolCreateInfo.flags =
+        VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+  } else {
+    descriptorPoolCreateInfo.flags = 0;
+  }
+  descriptorPoolCreateInfo.maxSets = setCount;
+  descriptorPoolCreateInfo.poolSizeCount =
+      IVY_ARRAY_LENGTH(descriptorPoolSizes);
+  descriptorPoolCreateInfo.pPoolSizes = descriptorPoolSizes;
+
+  return vkCreateDescriptorPool(device, &descriptorPoolCreateInfo,
+      allocationCallbacks, descriptorPool);
+}
+
+IVY_INTERNAL IvyCode ivyAddGraphicsDescriptorPool(VkDevice device,
+    IvyGraphicsDescriptorAllocator *descriptorAllocator) {
+  VkResult vulkanResult;
+  VkDescriptorPool *newPools;
+  VkDescriptorPool newPool;
+
+  vulkanResult = ivyCreateVulkanDescriptorPool(device,
+      descriptorAllocator->allocationCallbacks,
+      descriptorAllocator->isPersistent, descriptorAllocator->setsPerPool,
+      &newPool);
+  IVY_ASSERT(!vulkanResult);
+  if (vulkanResult) {
+    return ivyVulkanResultAsIvyCode(vulkanResult);
+  }
+
+  newPools = ivyReallocateMemory(descriptorAllocator->ownerMemoryAllocator,
+      descriptorAllocator->pools,
+      (descriptorAllocator->poolCount + 1) * sizeof(*newPools));
+  if (!newPools) {
+    vkDestroyDescriptorPool(device, newPool,
+        descriptorAllocator->allocationCallbacks);
+    return IVY_ERROR_NO_MEMORY;
+  }
+
+  newPools[descriptorAllocator->poolCount] = newPool;
+
+  descriptorAllocator->pools = newPools;
+  ++descriptorAllocator->poolCount;
+
+  return IVY_OK;
+}
+
+IVY_API IvyCode ivyCreateGraphicsDescriptorAllocator(
+    IvyAnyMemoryAllocator allocator, VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks, IvyBool isPersistent,
+    uint32_t setsPerPool,
+    IvyGraphicsDescriptorAllocator *descriptorAllocator) {
+  IvyCode ivyCode;
+
+  IVY_ASSERT(device);
+  IVY_ASSERT(setsPerPool);
+  IVY_ASSERT(descriptorAllocator);
+
+  descriptorAllocator->ownerMemoryAllocator = allocator;
+  descriptorAllocator->allocationCallbacks = allocationCallbacks;
+  descriptorAllocator->isPersistent = isPersistent;
+  descriptorAllocator->setsPerPool = setsPerPool;
+  descriptorAllocator->currentPoolIndex = 0;
+  descriptorAllocator->poolCount = 0;
+  descriptorAllocator->pools = NULL;
+
+  ivyCode = ivyAddGraphicsDescriptorPool(device, descriptorAllocator);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    ivyDestroyGraphicsDescriptorAllocator(device, descriptorAllocator);
+    return ivyCode;
+  }
+
+  return IVY_OK;
+}
+
+IVY_API void ivyDestroyGraphicsDescriptorAllocator(VkDevice device,
+    IvyGraphicsDescriptorAllocator *descriptorAllocator) {
+  uint32_t index;
+
+  if (!descriptorAllocator->pools) {
+    return;
+  }
+
+  for (index = 0; index < descriptorAllocator->poolCount; ++index) {
+    vkDestroyDescriptorPool(device, descriptorAllocator->pools[index],
+        descriptorAllocator->allocationCallbacks);
+  }
+
+  ivyFreeMemory(descriptorAllocator->ownerMemoryAllocator,
+      descriptorAllocator->pools);
+
+  descriptorAllocator->currentPoolIndex = 0;
+  descriptorAllocator->poolCount = 0;
+  descriptorAllocator->pools = NULL;
+}
+
+IVY_INTERNAL IvyBool ivyIsVulkanDescriptorPoolExhausted(
+    VkResult vulkanResult) {
+  return VK_ERROR_OUT_OF_POOL_MEMORY == vulkanResult ||
+         VK_ERROR_FRAGMENTED_POOL == vulkanResult;
+}
+
+// NOTE: transient allocators only move forward through the chain until they
+//       are reset, persistent ones look at every pool since frees can open up
+//       space anywhere
+IVY_API IvyCode ivyAllocateGraphicsDescriptorSet(VkDevice device,
+    IvyGraphicsDescriptorAllocator *descriptorAllocator,
+    VkDescriptorSetLayout descriptorSetLayout,
+    VkDescriptorPool *descriptorPool, VkDescriptorSet *descriptorSet) {
+  IvyCode ivyCode;
+  uint32_t index;
+
+  IVY_ASSERT(descriptorAllocator);
+  IVY_ASSERT(descriptorSet);
+  IVY_ASSERT(descriptorPool || !descriptorAllocator->isPersistent);
+
+  if (descriptorAllocator->isPersistent) {
+    index = 0;
+  } else {
+    index = descriptorAllocator->currentPoolIndex;
+  }
+
+  for (;; ++index) {
+    VkResult vulkanResult;
+    IvyBool isNewPool = 0;
+
+    if (index == descriptorAllocator->poolCount) {
+      ivyCode = ivyAddGraphicsDescriptorPool(device, descriptorAllocator);
+      IVY_ASSERT(!ivyCode);
+      if (ivyCode) {
+        return ivyCode;
+      }
+
+      isNewPool = 1;
+    }
+
+    vulkanResult = ivyAllocateVulkanDescriptorSet(device,
+        descriptorAllocator->pools[index], descriptorSetLayout,
+        descriptorSet);
+    if (ivyIsVulkanDescriptorPoolExhausted(vulkanResult)) {
+      // NOTE: if an empty pool can't hold the set no later one will either,
+      //       the layout needs more descriptors than a pool has
+      IVY_ASSERT(!isNewPool);
+      if (isNewPool) {
+        return IVY_ERROR_NO_MEMORY;
+      }
+
+      continue;
+    }
+
+    IVY_ASSERT(!vulkanResult);
+    if (vulkanResult) {
+      return ivyVulkanResultAsIvyCode(vulkanResult);
+    }
+
+    if (!descriptorAllocator->isPersistent) {
+      descriptorAllocator->currentPoolIndex = index;
+    }
+
+    if (descriptorPool) {
+      *descriptorPool = descriptorAllocator->pools[index];
+    }
+
+    return IVY_OK;
+  }
+}
+
+IVY_API void ivyFreeGraphicsDescriptorSet(VkDevice device,
+    IvyGraphicsDescriptorAllocator *descriptorAllocator,
+    VkDescriptorPool descriptorPool, VkDescriptorSet *descriptorSet) {
+  IVY_ASSERT(descriptorAllocator->isPersistent);
+
+  if (!*descriptorSet) {
+    return;
+  }
+
+  vkFreeDescriptorSets(device, descriptorPool, 1, descriptorSet);
+  *descriptorSet = VK_NULL_HANDLE;
+}
+
+IVY_API IvyCode ivyResetGraphicsDescriptorAllocator(VkDevice device,
+    IvyGraphicsDescriptorAllocator *descriptorAllocator) {
+  uint32_t index;
+
+  IVY_ASSERT(!descriptorAllocator->isPersistent);
+
+  // NOTE: only the pools that were actually reached need a reset
+  for (index = 0; index < descriptorAllocator->poolCount &&
+                  index <= descriptorAllocator->currentPoolIndex;
+       ++index) {
+    VkResult vulkanResult;
+
+    vulkanResult =
+        vkResetDescriptorPool(device, descriptorAllocator->pools[index], 0);
+    IVY_ASSERT(!vulkanResult);
+    if (vulkanResult) {
+      return ivyVulkanResultAsIvyCode(vulkanResult);
+    }
+  }
+
+  descriptorAllocator->currentPoolIndex = 0;
+
+  return IVY_OK;
+}
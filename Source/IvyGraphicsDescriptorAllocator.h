@@ -0,0 +1,46 @@
+#ifndef IVY_GRAPHICS_DESCRIPTOR_ALLOCATOR_H
+#define IVY_GRAPHICS_DESCRIPTOR_ALLOCATOR_H
+
+#include <vulkan/vulkan.h>
+
+#include "IvyDeclarations.h"
+#include "IvyMemoryAllocator.h"
+
+#define IVY_DEFAULT_DESCRIPTOR_SETS_PER_POOL 256
+
+// NOTE: a chain of descriptor pools that grows on demand. Transient chains
+//       are reset all at once and their pools don't pay for the free bit,
+//       persistent chains free their sets one by one, so every set has to be
+//       returned to the pool it came from.
+typedef struct IvyGraphicsDescriptorAllocator {
+  IvyAnyMemoryAllocator ownerMemoryAllocator;
+  VkAllocationCallbacks const *allocationCallbacks;
+  IvyBool isPersistent;
+  uint32_t setsPerPool;
+  uint32_t currentPoolIndex;
+  uint32_t poolCount;
+  VkDescriptorPool *pools;
+} IvyGraphicsDescriptorAllocator;
+
+IVY_API IvyCode ivyCreateGraphicsDescriptorAllocator(
+    IvyAnyMemoryAllocator allocator, VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks, IvyBool isPersistent,
+    uint32_t setsPerPool, IvyGraphicsDescriptorAllocator *descriptorAllocator);
+
+IVY_API void ivyDestroyGraphicsDescriptorAllocator(VkDevice device,
+    IvyGraphicsDescriptorAllocator *descriptorAllocator);
+
+// NOTE: descriptorPool can be NULL for transient allocators
+IVY_API IvyCode ivyAllocateGraphicsDescriptorSet(VkDevice device,
+    IvyGraphicsDescriptorAllocator *descriptorAllocator,
+    VkDescriptorSetLayout descriptorSetLayout,
+    VkDescriptorPool *descriptorPool, VkDescriptorSet *descriptorSet);
+
+IVY_API void ivyFreeGraphicsDescriptorSet(VkDevice device,
+    IvyGraphicsDescriptorAllocator *descriptorAllocator,
+    VkDescriptorPool descriptorPool, VkDescriptorSet *descriptorSet);
+
+IVY_API IvyCode ivyResetGraphicsDescriptorAllocator(VkDevice device,
+    IvyGraphicsDescriptorAllocator *descriptorAllocator);
+
+#endif
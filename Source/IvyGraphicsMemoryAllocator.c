@@ -26,14 +26,14 @@ IVY_API void ivyDestroyGraphicsMemoryAllocator(IvyGraphicsDevice *device,
 
 IVY_API IvyCode ivyAllocateGraphicsMemory(IvyGraphicsDevice *device,
     IvyAnyGraphicsMemoryAllocator allocator, uint32_t flags, uint32_t type,
-    uint64_t size, IvyGraphicsMemory *memory) {
+    uint64_t size, uint64_t alignment, IvyGraphicsMemory *memory) {
   IvyGraphicsMemoryAllocatorBase *base = allocator;
   IVY_ASSERT(base);
   IVY_ASSERT(IVY_GRAPHICS_MEMORY_ALLOCATOR_MAGIC == base->magic);
   IVY_ASSERT(base->dispatch);
   IVY_ASSERT(base->dispatch->allocate);
   return base->dispatch->allocate(device, allocator, flags, type, size,
-      memory);
+      alignment, memory);
 }
 
 IVY_API void ivyFreeGraphicsMemory(IvyGraphicsDevice *device,
@@ -62,7 +62,8 @@ IVY_API IvyCode ivyAllocateAndBindGraphicsMemoryToBuffer(
       &memoryRequirements);
 
   ivyCode = ivyAllocateGraphicsMemory(device, allocator, flags,
-      memoryRequirements.memoryTypeBits, memoryRequirements.size, memory);
+      memoryRequirements.memoryTypeBits, memoryRequirements.size,
+      memoryRequirements.alignment, memory);
   if (ivyCode) {
     return ivyCode;
   }
@@ -93,7 +94,8 @@ IVY_API IvyCode ivyAllocateAndBindGraphicsMemoryToImage(
       &memoryRequirements);
 
   ivyCode = ivyAllocateGraphicsMemory(device, graphicsMemoryAllocator, flags,
-      memoryRequirements.memoryTypeBits, memoryRequirements.size, allocation);
+      memoryRequirements.memoryTypeBits, memoryRequirements.size,
+      memoryRequirements.alignment, allocation);
   if (ivyCode) {
     return ivyCode;
   }
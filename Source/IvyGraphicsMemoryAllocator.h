@@ -16,12 +16,14 @@ typedef struct IvyGraphicsMemory {
   uint32_t flags;
   uint32_t type;
   uint64_t offset;
+  uint64_t size;
   VkDeviceMemory memory;
 } IvyGraphicsMemory;
 
 typedef IvyCode (*IvyAllocateGraphicsMemoryCallback)(
     IvyGraphicsDevice *context, IvyAnyGraphicsMemoryAllocator allocator,
-    uint32_t flags, uint32_t type, uint64_t size, IvyGraphicsMemory *memory);
+    uint32_t flags, uint32_t type, uint64_t size, uint64_t alignment,
+    IvyGraphicsMemory *memory);
 
 typedef void (*IvyFreeGraphicsMemoryCallback)(IvyGraphicsDevice *context,
     IvyAnyGraphicsMemoryAllocator allocator, IvyGraphicsMemory *memory);
@@ -53,7 +55,7 @@ IVY_API void ivyDestroyGraphicsMemoryAllocator(IvyGraphicsDevice *device,
 
 IVY_API IvyCode ivyAllocateGraphicsMemory(IvyGraphicsDevice *device,
     IvyAnyGraphicsMemoryAllocator allocator, uint32_t flags, uint32_t type,
-    uint64_t size, IvyGraphicsMemory *memory);
+    uint64_t size, uint64_t alignment, IvyGraphicsMemory *memory);
 
 IVY_API void ivyFreeGraphicsMemory(IvyGraphicsDevice *device,
     IvyAnyGraphicsMemoryAllocator allocator, IvyGraphicsMemory *memory);
@@ -3,71 +3,140 @@
 #include "IvyRenderer.h"
 #include "IvyVulkanUtilities.h"
 
-IVY_INTERNAL VkMemoryPropertyFlagBits ivyGetVulkanMemoryProperties(
+IVY_INTERNAL VkMemoryPropertyFlags ivyGetRequiredVulkanMemoryProperties(
     uint32_t flags) {
-  VkMemoryPropertyFlagBits properties = 0;
+  VkMemoryPropertyFlags properties = 0;
 
   if (IVY_GPU_LOCAL & flags) {
     properties |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
   }
 
-  if (IVY_CPU_VISIBLE & flags) {
+  // NOTE: mapped memory is never flushed, so it has to be coherent
+  if (ivyIsGraphicsMemoryCpuVisible(flags)) {
     properties |= VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    properties |= VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
   }
 
   return properties;
 }
 
-IVY_INTERNAL uint32_t ivyFindVulkanMemoryTypeIndex(
-    VkPhysicalDevice physicalDevice, uint32_t flags, uint32_t type) {
-  uint32_t index;
-  VkMemoryPropertyFlagBits memoryProperties;
-  VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
+IVY_INTERNAL VkMemoryPropertyFlags ivyGetPreferredVulkanMemoryProperties(
+    uint32_t flags) {
+  VkMemoryPropertyFlags properties = 0;
+
+  if (IVY_READBACK & flags) {
+    properties |= VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+  }
+
+  // NOTE: device local and host visible (ReBAR) memory lets the CPU write
+  //       straight into VRAM, which is what data written every frame wants
+  if (IVY_DYNAMIC & flags) {
+    properties |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+  }
 
-  vkGetPhysicalDeviceMemoryProperties(physicalDevice,
-      &physicalDeviceMemoryProperties);
+  return properties;
+}
 
-  memoryProperties = ivyGetVulkanMemoryProperties(flags);
+IVY_INTERNAL int32_t ivyCountSetBits(uint32_t bits) {
+  int32_t count = 0;
 
-  index = 0;
-  while (index < physicalDeviceMemoryProperties.memoryTypeCount) {
-    VkPhysicalDeviceMemoryProperties *properties;
-    VkMemoryType *memoryType;
-    uint32_t propertyFlags;
+  while (bits) {
+    bits &= bits - 1;
+    ++count;
+  }
 
-    properties = &physicalDeviceMemoryProperties;
-    memoryType = &properties->memoryTypes[index];
-    propertyFlags = memoryType->propertyFlags;
+  return count;
+}
 
-    if ((propertyFlags & memoryProperties) && (type & (1U << index))) {
-      return index;
+// NOTE: worth more than all the unrequested properties combined, but less
+//       than a single preferred one. Small enough that a valid type never
+//       scores below zero
+#define IVY_SMALL_BAR_HEAP_PENALTY 16
+
+// NOTE: types missing a required property are rejected. Otherwise every
+//       preferred property is worth more than all the unrequested properties
+//       combined, so the closest match wins among types that have the hints.
+//       Staging memory that lands in a device local type eats into the BAR
+//       heap, which can be as small as 256MiB, so it is only picked when no
+//       plain host visible type exists
+IVY_INTERNAL int32_t ivyScoreVulkanMemoryType(
+    VkMemoryPropertyFlags propertyFlags, uint32_t flags) {
+  int32_t score = 0;
+  VkMemoryPropertyFlags required;
+  VkMemoryPropertyFlags preferred;
+  VkMemoryPropertyFlags unrequested;
+
+  required = ivyGetRequiredVulkanMemoryProperties(flags);
+  if ((propertyFlags & required) != required) {
+    return -1;
+  }
+
+  if (VK_MEMORY_PROPERTY_PROTECTED_BIT & propertyFlags) {
+    return -1;
+  }
+
+  preferred = ivyGetPreferredVulkanMemoryProperties(flags) & ~required;
+  unrequested = propertyFlags & ~(required | preferred);
+
+  score += 64 * ivyCountSetBits(propertyFlags & preferred);
+  score += 32 - ivyCountSetBits(unrequested);
+
+  if ((IVY_UPLOAD & flags) &&
+      (VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT & unrequested)) {
+    score -= IVY_SMALL_BAR_HEAP_PENALTY;
+  }
+
+  return score;
+}
+
+IVY_API uint32_t ivyFindVulkanMemoryTypeIndex(
+    VkPhysicalDeviceMemoryProperties const *memoryProperties, uint32_t flags,
+    uint32_t type) {
+  uint32_t index;
+  uint32_t bestIndex = (uint32_t)-1;
+  int32_t bestScore = -1;
+
+  IVY_ASSERT(memoryProperties);
+
+  for (index = 0; index < memoryProperties->memoryTypeCount; ++index) {
+    int32_t score;
+
+    if (!(type & (1U << index))) {
+      continue;
     }
 
-    ++index;
+    score = ivyScoreVulkanMemoryType(
+        memoryProperties->memoryTypes[index].propertyFlags, flags);
+    if (score > bestScore) {
+      bestIndex = index;
+      bestScore = score;
+    }
   }
 
-  return (uint32_t)-1;
+  return bestIndex;
 }
 
-IVY_INTERNAL VkResult ivyAllocateVulkanMemory(VkPhysicalDevice physicalDevice,
-    VkDevice device, uint32_t flags, uint32_t type, uint64_t size,
-    VkDeviceMemory *memory) {
+IVY_INTERNAL VkResult ivyAllocateVulkanMemory(
+    VkPhysicalDeviceMemoryProperties const *memoryProperties, VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks, uint32_t flags,
+    uint32_t type, uint64_t size, VkDeviceMemory *memory) {
   VkMemoryAllocateInfo memoryAllocateInfo;
 
-  IVY_ASSERT(physicalDevice);
+  IVY_ASSERT(memoryProperties);
   IVY_ASSERT(device);
 
   memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
   memoryAllocateInfo.pNext = NULL;
   memoryAllocateInfo.allocationSize = size;
   memoryAllocateInfo.memoryTypeIndex =
-      ivyFindVulkanMemoryTypeIndex(physicalDevice, flags, type);
+      ivyFindVulkanMemoryTypeIndex(memoryProperties, flags, type);
   IVY_ASSERT((uint32_t)-1 != memoryAllocateInfo.memoryTypeIndex);
   if ((uint32_t)-1 == memoryAllocateInfo.memoryTypeIndex) {
     return VK_ERROR_UNKNOWN;
   }
 
-  return vkAllocateMemory(device, &memoryAllocateInfo, NULL, memory);
+  return vkAllocateMemory(device, &memoryAllocateInfo, allocationCallbacks,
+      memory);
 }
 
 IVY_API void ivySetupEmptyGraphicsMemoryChunk(IvyGraphicsMemoryChunk *chunk) {
@@ -90,15 +159,16 @@ IVY_API IvyCode ivyAllocateGraphicsMemoryChunk(IvyGraphicsDevice *device,
   chunk->size = size;
   chunk->owners = 1;
 
-  vulkanResult = ivyAllocateVulkanMemory(device->physicalDevice,
-      device->logicalDevice, flags, type, size, &chunk->memory);
+  vulkanResult = ivyAllocateVulkanMemory(&device->memoryProperties,
+      device->logicalDevice, device->allocationCallbacks, flags, type, size,
+      &chunk->memory);
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
     ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
     goto error;
   }
 
-  if (IVY_CPU_VISIBLE & flags) {
+  if (ivyIsGraphicsMemoryCpuVisible(flags)) {
     vulkanResult = vkMapMemory(device->logicalDevice, chunk->memory, 0, size,
         0, &chunk->data);
     if (vulkanResult) {
@@ -118,12 +188,14 @@ error:
 
 IVY_API void ivyFreeGraphicsMemoryChunk(IvyGraphicsDevice *device,
     IvyGraphicsMemoryChunk *chunk) {
-  if (IVY_CPU_VISIBLE & chunk->flags) {
+  if (chunk->data) {
     vkUnmapMemory(device->logicalDevice, chunk->memory);
   }
 
   if (chunk->memory) {
-    vkFreeMemory(device->logicalDevice, chunk->memory, NULL);
+    vkFreeMemory(device->logicalDevice, chunk->memory,
+        device->allocationCallbacks);
     chunk->memory = VK_NULL_HANDLE;
+    chunk->data = NULL;
   }
 }
@@ -7,12 +7,26 @@
 
 typedef struct IvyGraphicsDevice IvyGraphicsDevice;
 
+// NOTE: IVY_UPLOAD, IVY_READBACK and IVY_DYNAMIC are usage hints, they imply
+//       IVY_CPU_VISIBLE and steer which memory type gets picked
+//         - IVY_UPLOAD: written once by the CPU, e.g. staging buffers
+//         - IVY_READBACK: written by the GPU and read by the CPU
+//         - IVY_DYNAMIC: rewritten by the CPU every frame and read by the GPU
 typedef enum IvyGraphicsMemoryProperty {
   IVY_GPU_LOCAL = 0x0001,
   IVY_CPU_VISIBLE = 0x0002,
+  IVY_UPLOAD = 0x0004,
+  IVY_READBACK = 0x0008,
+  IVY_DYNAMIC = 0x0010
 } IvyGraphicsMemoryChunkProperty;
 typedef uint64_t IvyGraphicsMemoryPropertyFlags;
 
+#define IVY_CPU_ACCESS_MASK                                                   \
+  (IVY_CPU_VISIBLE | IVY_UPLOAD | IVY_READBACK | IVY_DYNAMIC)
+
+#define ivyIsGraphicsMemoryCpuVisible(flags)                                  \
+  (!!(IVY_CPU_ACCESS_MASK & (flags)))
+
 typedef struct IvyGraphicsMemoryChunk {
   void *data;
   IvyGraphicsMemoryPropertyFlags flags;
@@ -22,6 +36,10 @@ typedef struct IvyGraphicsMemoryChunk {
   VkDeviceMemory memory;
 } IvyGraphicsMemoryChunk;
 
+IVY_API uint32_t ivyFindVulkanMemoryTypeIndex(
+    VkPhysicalDeviceMemoryProperties const *memoryProperties, uint32_t flags,
+    uint32_t type);
+
 IVY_API void ivySetupEmptyGraphicsMemoryChunk(IvyGraphicsMemoryChunk *chunk);
 
 IVY_API IvyCode ivyAllocateGraphicsMemoryChunk(IvyGraphicsDevice *device,
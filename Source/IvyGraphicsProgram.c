@@ -54,7 +54,8 @@ error:
 }
 
 IVY_API VkResult ivyCreateVulkanShader(IvyAnyMemoryAllocator allocator,
-    VkDevice device, char const *path, VkShaderModule *shader) {
+    VkDevice device, VkAllocationCallbacks const *allocationCallbacks,
+    char const *path, VkShaderModule *shader) {
   uint64_t shaderCodeSizeInBytes;
   char *shaderCode;
   VkResult vulkanResult;
@@ -72,20 +73,23 @@ IVY_API VkResult ivyCreateVulkanShader(IvyAnyMemoryAllocator allocator,
   shaderCreateInfo.codeSize = shaderCodeSizeInBytes;
   shaderCreateInfo.pCode = (uint32_t *)shaderCode;
 
-  vulkanResult = vkCreateShaderModule(device, &shaderCreateInfo, NULL, shader);
+  vulkanResult = vkCreateShaderModule(device, &shaderCreateInfo,
+      allocationCallbacks, shader);
   ivyFreeMemory(allocator, shaderCode);
   return vulkanResult;
 }
 
 // FIXME(samuel): validate flags
 IVY_API VkResult ivyCreateVulkanPipeline(IvyAnyMemoryAllocator allocator,
-    VkDevice device, int32_t width, int32_t height,
+    VkDevice device, VkAllocationCallbacks const *allocationCallbacks,
+    int32_t width, int32_t height,
     IvyGraphicsProgramPropertyFlags flags, VkSampleCountFlagBits sampleCounts,
     VkRenderPass renderPass, VkPipelineLayout pipelineLayout,
     VkShaderModule vertexShader, VkShaderModule fragmentShader,
     VkPipeline *pipeline) {
   VkResult vulkanResult;
-  VkVertexInputBindingDescription vertexInputBindingDescription;
+  uint32_t vertexInputBindingDescriptionCount = 0;
+  VkVertexInputBindingDescription vertexInputBindingDescriptions[2];
   uint32_t vertexInputAttributesDescriptionCount = 0;
   VkVertexInputAttributeDescription *vertexInputAttributesDescriptions = NULL;
   VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo;
@@ -101,7 +105,12 @@ IVY_API VkResult ivyCreateVulkanPipeline(IvyAnyMemoryAllocator allocator,
   VkPipelineShaderStageCreateInfo shaderStageCreateInfos[2];
   VkGraphicsPipelineCreateInfo pipelineCreateInfo;
 
-  if (IVY_VERTEX_3_ENABLE & flags) {
+  if (IVY_VERTEX_2_INSTANCE_QUAD_ENABLE & flags) {
+    vertexInputAttributesDescriptionCount = 4;
+    vertexInputAttributesDescriptions = ivyAllocateMemory(allocator,
+        vertexInputAttributesDescriptionCount *
+            sizeof(*vertexInputAttributesDescriptions));
+  } else if (IVY_VERTEX_3_ENABLE & flags) {
     vertexInputAttributesDescriptionCount = 1;
     vertexInputAttributesDescriptions = ivyAllocateMemory(allocator,
         vertexInputAttributesDescriptionCount *
@@ -118,13 +127,53 @@ IVY_API VkResult ivyCreateVulkanPipeline(IvyAnyMemoryAllocator allocator,
             sizeof(*vertexInputAttributesDescriptions));
   }
 
-  if (IVY_VERTEX_ENABLE_MASK & flags) {
-    vertexInputBindingDescription.binding = 0;
-    vertexInputBindingDescription.stride = sizeof(IvyGraphicsVertex332);
-    vertexInputBindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+  if (IVY_VERTEX_2_INSTANCE_QUAD_ENABLE & flags) {
+    vertexInputBindingDescriptionCount = 2;
+
+    vertexInputBindingDescriptions[0].binding = 0;
+    vertexInputBindingDescriptions[0].stride = sizeof(IvyGraphicsVertex2);
+    vertexInputBindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    vertexInputBindingDescriptions[1].binding = 1;
+    vertexInputBindingDescriptions[1].stride =
+        sizeof(IvyGraphicsQuadInstance);
+    vertexInputBindingDescriptions[1].inputRate =
+        VK_VERTEX_INPUT_RATE_INSTANCE;
+  } else if (IVY_VERTEX_ENABLE_MASK & flags) {
+    vertexInputBindingDescriptionCount = 1;
+
+    vertexInputBindingDescriptions[0].binding = 0;
+    vertexInputBindingDescriptions[0].stride = sizeof(IvyGraphicsVertex332);
+    vertexInputBindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
   }
 
-  if (IVY_VERTEX_3_ENABLE & flags) {
+  if (IVY_VERTEX_2_INSTANCE_QUAD_ENABLE & flags) {
+    vertexInputAttributesDescriptions[0].binding = 0;
+    vertexInputAttributesDescriptions[0].location = 0;
+    vertexInputAttributesDescriptions[0].format = VK_FORMAT_R32G32_SFLOAT;
+    vertexInputAttributesDescriptions[0].offset =
+        IVY_OFFSETOF(IvyGraphicsVertex2, position);
+
+    vertexInputAttributesDescriptions[1].binding = 1;
+    vertexInputAttributesDescriptions[1].location = 1;
+    vertexInputAttributesDescriptions[1].format =
+        VK_FORMAT_R32G32B32A32_SFLOAT;
+    vertexInputAttributesDescriptions[1].offset =
+        IVY_OFFSETOF(IvyGraphicsQuadInstance, rect);
+
+    vertexInputAttributesDescriptions[2].binding = 1;
+    vertexInputAttributesDescriptions[2].location = 2;
+    vertexInputAttributesDescriptions[2].format =
+        VK_FORMAT_R32G32B32A32_SFLOAT;
+    vertexInputAttributesDescriptions[2].offset =
+        IVY_OFFSETOF(IvyGraphicsQuadInstance, uvRect);
+
+    vertexInputAttributesDescriptions[3].binding = 1;
+    vertexInputAttributesDescriptions[3].location = 3;
+    vertexInputAttributesDescriptions[3].format = VK_FORMAT_R32G32B32_SFLOAT;
+    vertexInputAttributesDescriptions[3].offset =
+        IVY_OFFSETOF(IvyGraphicsQuadInstance, color);
+  } else if (IVY_VERTEX_3_ENABLE & flags) {
     vertexInputAttributesDescriptions[0].binding = 0;
     vertexInputAttributesDescriptions[0].location = 0;
     vertexInputAttributesDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
@@ -199,10 +248,11 @@ IVY_API VkResult ivyCreateVulkanPipeline(IvyAnyMemoryAllocator allocator,
       VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
   vertexInputStateCreateInfo.pNext = NULL;
   vertexInputStateCreateInfo.flags = 0;
-  if (IVY_VERTEX_ENABLE_MASK & flags) {
-    vertexInputStateCreateInfo.vertexBindingDescriptionCount = 1;
+  if (vertexInputBindingDescriptionCount) {
+    vertexInputStateCreateInfo.vertexBindingDescriptionCount =
+        vertexInputBindingDescriptionCount;
     vertexInputStateCreateInfo.pVertexBindingDescriptions =
-        &vertexInputBindingDescription;
+        vertexInputBindingDescriptions;
   } else {
     vertexInputStateCreateInfo.vertexBindingDescriptionCount = 0;
     vertexInputStateCreateInfo.pVertexBindingDescriptions = NULL;
@@ -403,7 +453,7 @@ IVY_API VkResult ivyCreateVulkanPipeline(IvyAnyMemoryAllocator allocator,
   pipelineCreateInfo.basePipelineIndex = -1;
 
   vulkanResult = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1,
-      &pipelineCreateInfo, NULL, pipeline);
+      &pipelineCreateInfo, allocationCallbacks, pipeline);
 
   ivyFreeMemory(allocator, vertexInputAttributesDescriptions);
 
@@ -428,29 +478,32 @@ IVY_API IvyCode ivyCreateGraphicsProgram(IvyAnyMemoryAllocator allocator,
   IVY_MEMSET(program, 0, sizeof(*program));
 
   vulkanResult = ivyCreateVulkanShader(allocator, device->logicalDevice,
-      vertexShaderPath, &vertexShader);
+      device->allocationCallbacks, vertexShaderPath, &vertexShader);
   if (vulkanResult) {
     ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
     goto error;
   }
 
   vulkanResult = ivyCreateVulkanShader(allocator, device->logicalDevice,
-      fragmentShaderPath, &fragmentShader);
+      device->allocationCallbacks, fragmentShaderPath, &fragmentShader);
   if (vulkanResult) {
     ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
     goto error;
   }
 
   vulkanResult = ivyCreateVulkanPipeline(allocator, device->logicalDevice,
-      viewportWidth, viewportHeight, flags, samples, renderPass,
-      pipelineLayout, vertexShader, fragmentShader, &program->pipeline);
+      device->allocationCallbacks, viewportWidth, viewportHeight, flags,
+      samples, renderPass, pipelineLayout, vertexShader, fragmentShader,
+      &program->pipeline);
   if (vulkanResult) {
     ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
     goto error;
   }
 
-  vkDestroyShaderModule(device->logicalDevice, fragmentShader, NULL);
-  vkDestroyShaderModule(device->logicalDevice, vertexShader, NULL);
+  vkDestroyShaderModule(device->logicalDevice, fragmentShader,
+      device->allocationCallbacks);
+  vkDestroyShaderModule(device->logicalDevice, vertexShader,
+      device->allocationCallbacks);
 
   return IVY_OK;
 
@@ -458,11 +511,13 @@ error:
   ivyDestroyGraphicsProgram(device, program);
 
   if (fragmentShader) {
-    vkDestroyShaderModule(device->logicalDevice, fragmentShader, NULL);
+    vkDestroyShaderModule(device->logicalDevice, fragmentShader,
+        device->allocationCallbacks);
   }
 
   if (vertexShader) {
-    vkDestroyShaderModule(device->logicalDevice, vertexShader, NULL);
+    vkDestroyShaderModule(device->logicalDevice, vertexShader,
+        device->allocationCallbacks);
   }
 
   // FIXME: check for when the path was not found
@@ -472,7 +527,8 @@ error:
 IVY_API void ivyDestroyGraphicsProgram(IvyGraphicsDevice *device,
     IvyGraphicsProgram *program) {
   if (program->pipeline) {
-    vkDestroyPipeline(device->logicalDevice, program->pipeline, NULL);
+    vkDestroyPipeline(device->logicalDevice, program->pipeline,
+        device->allocationCallbacks);
     program->pipeline = VK_NULL_HANDLE;
   }
 }
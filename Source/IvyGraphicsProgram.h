@@ -19,6 +19,7 @@ typedef enum IvyGraphicsProgramProperty {
   IVY_FRONT_FACE_COUNTER_CLOCKWISE = 0x00000040,
   IVY_FRONT_FACE_CLOCKWISE = 0x00000080,
 
+  IVY_VERTEX_2_INSTANCE_QUAD_ENABLE = 0x00000100,
   IVY_VERTEX_3_ENABLE = 0x00000200,
   IVY_VERTEX_332_ENABLE = 0x00000400,
   IVY_VERTEX_3322444_ENABLE = 0x00000800,
@@ -29,6 +30,10 @@ typedef uint32_t IvyGraphicsProgramPropertyFlags;
 typedef uint32_t IvyGraphicsProgramIndex;
 typedef struct IvyGraphicsDevice IvyGraphicsDevice;
 
+typedef struct IvyGraphicsVertex2 {
+  IvyV2 position;
+} IvyGraphicsVertex2;
+
 typedef struct IvyGraphicsVertex3 {
   IvyV3 position;
 } IvyGraphicsVertex3;
@@ -49,12 +54,26 @@ typedef struct IvyGraphicsVertex3322444 {
   IvyV4 color0;
 } IvyGraphicsVertex3322444;
 
+// NOTE: per instance data for IVY_VERTEX_2_INSTANCE_QUAD_ENABLE programs.
+//       rect and uvRect are (top left x, top left y, bottom right x, bottom
+//       right y), the unit quad corner picks between the two
+typedef struct IvyGraphicsQuadInstance {
+  IvyV4 rect;
+  IvyV4 uvRect;
+  IvyV3 color;
+} IvyGraphicsQuadInstance;
+
+// NOTE: bound once per frame at set 0
 typedef struct IvyGraphicsProgramUniform {
-  IvyM4 model;
   IvyM4 view;
   IvyM4 projection;
 } IvyGraphicsProgramUniform;
 
+// NOTE: pushed per draw to the vertex stage
+typedef struct IvyGraphicsProgramPushConstants {
+  IvyM4 model;
+} IvyGraphicsProgramPushConstants;
+
 typedef struct IvyGraphicsProgram {
   VkPipeline pipeline;
 } IvyGraphicsProgram;
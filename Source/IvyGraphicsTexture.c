@@ -4,8 +4,8 @@
 #include "IvyRenderer.h"
 #include "IvyVulkanUtilities.h"
 
-// TODO: custom stb_image with custom allocator
 #include <stb_image.h>
+#include <stb_image_allocator.h>
 
 #ifndef IVY_FLOOR
 #include <math.h>
@@ -27,10 +27,9 @@ IVY_INTERNAL uint32_t ivyCalculateMipLevels(int32_t width, int32_t height) {
   return (uint32_t)(IVY_FLOOR(IVY_LOG2(IVY_MAX(width, height))) + 1);
 }
 
-IVY_API VkResult ivyChangeVulkanImageLayout(VkDevice device,
-    VkQueue graphicsQueue, VkCommandPool commandPool, uint32_t mipLevels,
-    VkImage image, VkImageLayout sourceLayout,
-    VkImageLayout destinationLayout) {
+IVY_API VkResult ivyChangeVulkanImageLayout(IvyGraphicsDevice *device,
+    VkCommandPool commandPool, uint32_t mipLevels, VkImage image,
+    VkImageLayout sourceLayout, VkImageLayout destinationLayout) {
 
   VkResult vulkanResult;
   VkImageMemoryBarrier imageMemoryBarrier;
@@ -39,8 +38,8 @@ IVY_API VkResult ivyChangeVulkanImageLayout(VkDevice device,
   VkPipelineStageFlags sourceStage = VK_PIPELINE_STAGE_NONE_KHR;
   VkPipelineStageFlags destinationStage = VK_PIPELINE_STAGE_NONE_KHR;
 
-  vulkanResult = ivyAllocateAndBeginVulkanCommandBuffer(device, commandPool,
-      &commandBuffer);
+  vulkanResult = ivyAllocateAndBeginVulkanCommandBuffer(device->logicalDevice,
+      commandPool, &commandBuffer);
   if (vulkanResult) {
     return vulkanResult;
   }
@@ -111,8 +110,9 @@ IVY_API VkResult ivyChangeVulkanImageLayout(VkDevice device,
   vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0,
       NULL, 0, NULL, 1, &imageMemoryBarrier);
 
-  vulkanResult = ivyEndSubmitAndFreeVulkanCommandBuffer(device, graphicsQueue,
-      commandPool, commandBuffer);
+  vulkanResult = ivyEndSubmitAndFreeVulkanCommandBuffer(device->logicalDevice,
+      device->graphicsQueue, commandPool, commandBuffer,
+      device->uploadSemaphore, &device->uploadTimelineValue);
   if (vulkanResult) {
     return vulkanResult;
   }
@@ -120,23 +120,12 @@ IVY_API VkResult ivyChangeVulkanImageLayout(VkDevice device,
   return VK_SUCCESS;
 }
 
-IVY_INTERNAL VkResult ivyGenerateVulkanImageMips(VkDevice device,
-    VkQueue graphicsQueue, VkCommandPool commandPool, int32_t width,
-    int32_t height, uint32_t mipLevels, VkImage image) {
+// NOTE: expects every mip level in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL with
+//       level 0 holding the image, leaves them all shader readable
+IVY_API void ivyRecordVulkanImageMips(VkCommandBuffer commandBuffer,
+    int32_t width, int32_t height, uint32_t mipLevels, VkImage image) {
   uint32_t index;
-  VkResult vulkanResult;
   VkImageMemoryBarrier imageMemoryBarrier;
-  VkCommandBuffer commandBuffer;
-
-  if (1 == mipLevels || 0 == mipLevels) {
-    return VK_SUCCESS;
-  }
-
-  vulkanResult = ivyAllocateAndBeginVulkanCommandBuffer(device, commandPool,
-      &commandBuffer);
-  if (vulkanResult) {
-    return vulkanResult;
-  }
 
   imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
   imageMemoryBarrier.pNext = NULL;
@@ -209,9 +198,29 @@ IVY_INTERNAL VkResult ivyGenerateVulkanImageMips(VkDevice device,
   vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, 1,
       &imageMemoryBarrier);
+}
+
+IVY_INTERNAL VkResult ivyGenerateVulkanImageMips(IvyGraphicsDevice *device,
+    VkCommandPool commandPool, int32_t width, int32_t height,
+    uint32_t mipLevels, VkImage image) {
+  VkResult vulkanResult;
+  VkCommandBuffer commandBuffer;
+
+  if (1 == mipLevels || 0 == mipLevels) {
+    return VK_SUCCESS;
+  }
+
+  vulkanResult = ivyAllocateAndBeginVulkanCommandBuffer(device->logicalDevice,
+      commandPool, &commandBuffer);
+  if (vulkanResult) {
+    return vulkanResult;
+  }
+
+  ivyRecordVulkanImageMips(commandBuffer, width, height, mipLevels, image);
 
-  vulkanResult = ivyEndSubmitAndFreeVulkanCommandBuffer(device, graphicsQueue,
-      commandPool, commandBuffer);
+  vulkanResult = ivyEndSubmitAndFreeVulkanCommandBuffer(device->logicalDevice,
+      device->graphicsQueue, commandPool, commandBuffer,
+      device->uploadSemaphore, &device->uploadTimelineValue);
   if (vulkanResult) {
     return vulkanResult;
   }
@@ -221,7 +230,7 @@ IVY_INTERNAL VkResult ivyGenerateVulkanImageMips(VkDevice device,
 
 // TODO(Samuel): sampler cache
 IVY_INTERNAL VkResult ivyCreateVulkanSampler(VkDevice device,
-    VkSampler *sampler) {
+    VkAllocationCallbacks const *allocationCallbacks, VkSampler *sampler) {
   VkSamplerCreateInfo samplerCreateInfo;
 
   samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -249,7 +258,8 @@ IVY_INTERNAL VkResult ivyCreateVulkanSampler(VkDevice device,
   samplerCreateInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
   samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
 
-  return vkCreateSampler(device, &samplerCreateInfo, NULL, sampler);
+  return vkCreateSampler(device, &samplerCreateInfo, allocationCallbacks,
+      sampler);
 }
 
 IVY_INTERNAL void ivyWriteVulkanTextureDescriptorSet(VkDevice device,
@@ -277,27 +287,148 @@ IVY_INTERNAL void ivyWriteVulkanTextureDescriptorSet(VkDevice device,
   vkUpdateDescriptorSets(device, 1, writeDescriptorSets, 0, NULL);
 }
 
+IVY_INTERNAL void *ivyAllocateStbImageMemory(void *user, size_t size) {
+  return ivyAllocateMemory(user, size);
+}
+
+// NOTE: stb only reallocates while inflating, doubling the size each time.
+//       Every allocator reallocates (the arena grows the last allocation in
+//       place), so the old size stb passes along isn't needed
+IVY_INTERNAL void *ivyReallocateStbImageMemory(void *user, void *data,
+    size_t oldSize, size_t newSize) {
+  IVY_UNUSED(oldSize);
+  return ivyReallocateMemory(user, data, newSize);
+}
+
+IVY_INTERNAL void ivyFreeStbImageMemory(void *user, void *data) {
+  if (data) {
+    ivyFreeMemory(user, data);
+  }
+}
+
 IVY_API IvyCode ivyCreateGraphicsTextureFromFile(
     IvyAnyMemoryAllocator allocator, IvyRenderer *renderer, char const *path,
     IvyGraphicsTexture **texture) {
-  int width;
-  int height;
-  int channels;
-  void *data = NULL;
+  int32_t width;
+  int32_t height;
+  void *pixels;
   IvyCode ivyCode;
 
   IVY_ASSERT(renderer);
   IVY_ASSERT(path);
 
-  data = stbi_load(path, &width, &height, &channels, STBI_rgb_alpha);
+  ivyCode = ivyDecodeImageFile(allocator, path, &width, &height, &pixels);
+  if (ivyCode) {
+    *texture = NULL;
+    return ivyCode;
+  }
+
+  ivyCode = ivyCreateGraphicsTexture(allocator, renderer, width, height,
+      IVY_RGBA8_SRGB, pixels, texture);
+
+  ivyFreeDecodedImage(allocator, pixels);
+
+  return ivyCode;
+}
+
+IVY_API IvyCode ivyDecodeImageFile(IvyAnyMemoryAllocator allocator,
+    char const *path, int32_t *width, int32_t *height, void **pixels) {
+  int currentWidth;
+  int currentHeight;
+  int channels;
+  void *data;
+  stbi_allocator stbImageAllocator;
+  stbi_allocator const *previousStbImageAllocator;
+
+  IVY_ASSERT(allocator);
+  IVY_ASSERT(path);
+
+  stbImageAllocator.allocate = ivyAllocateStbImageMemory;
+  stbImageAllocator.reallocate = ivyReallocateStbImageMemory;
+  stbImageAllocator.free = ivyFreeStbImageMemory;
+  stbImageAllocator.user = allocator;
+
+  // NOTE: the stb_image allocator is per thread, restored afterwards in case
+  //       this runs inside another decode
+  previousStbImageAllocator = stbi_set_thread_allocator(&stbImageAllocator);
+  data = stbi_load(path, &currentWidth, &currentHeight, &channels,
+      STBI_rgb_alpha);
+  stbi_set_thread_allocator(previousStbImageAllocator);
+
   if (!data) {
+    *width = 0;
+    *height = 0;
+    *pixels = NULL;
     return IVY_ERROR_NO_MEMORY;
   }
 
+  *width = currentWidth;
+  *height = currentHeight;
+  *pixels = data;
+
+  return IVY_OK;
+}
+
+IVY_API void ivyFreeDecodedImage(IvyAnyMemoryAllocator allocator,
+    void *pixels) {
+  ivyFreeStbImageMemory(allocator, pixels);
+}
+
+IVY_API IvyCode ivyCreateGraphicsTextureFromPixelsInUploadBatch(
+    IvyAnyMemoryAllocator allocator, IvyRenderer *renderer,
+    IvyGraphicsUploadBatch *batch, int32_t width, int32_t height,
+    void *pixels, IvyGraphicsTexture **texture) {
+  IvyCode ivyCode;
+  IvyGraphicsTexture *currentTexture;
+
+  IVY_ASSERT(renderer);
+  IVY_ASSERT(batch);
+  IVY_ASSERT(pixels);
+
+  // NOTE: created without data, the batch does the layout transitions, the
+  //       copy and the mips once it's submitted
   ivyCode = ivyCreateGraphicsTexture(allocator, renderer, width, height,
-      IVY_RGBA8_SRGB, data, texture);
+      IVY_RGBA8_SRGB, NULL, &currentTexture);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    *texture = NULL;
+    return ivyCode;
+  }
+
+  ivyCode = ivyAddImageToGraphicsUploadBatch(batch, currentTexture->width,
+      currentTexture->height, currentTexture->mipLevels,
+      currentTexture->format, pixels, currentTexture->image);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    ivyDestroyGraphicsTexture(allocator, renderer, currentTexture);
+    *texture = NULL;
+    return ivyCode;
+  }
+
+  *texture = currentTexture;
+
+  return IVY_OK;
+}
+
+IVY_API IvyCode ivyCreateGraphicsTextureFromFileInUploadBatch(
+    IvyAnyMemoryAllocator allocator, IvyRenderer *renderer,
+    IvyGraphicsUploadBatch *batch, char const *path,
+    IvyGraphicsTexture **texture) {
+  int32_t width;
+  int32_t height;
+  void *pixels;
+  IvyCode ivyCode;
+
+  ivyCode = ivyDecodeImageFile(allocator, path, &width, &height, &pixels);
+  if (ivyCode) {
+    *texture = NULL;
+    return ivyCode;
+  }
+
+  ivyCode = ivyCreateGraphicsTextureFromPixelsInUploadBatch(allocator,
+      renderer, batch, width, height, pixels, texture);
 
-  stbi_image_free(data);
+  ivyFreeDecodedImage(allocator, pixels);
 
   return ivyCode;
 }
@@ -323,6 +454,7 @@ IVY_API IvyCode ivyCreateGraphicsTexture(IvyAnyMemoryAllocator allocator,
   currentTexture->format = format;
 
   vulkanResult = ivyCreateVulkanImage(renderer->device.logicalDevice,
+      renderer->device.allocationCallbacks,
       currentTexture->width, currentTexture->height, currentTexture->mipLevels,
       VK_SAMPLE_COUNT_1_BIT,
       VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
@@ -343,6 +475,7 @@ IVY_API IvyCode ivyCreateGraphicsTexture(IvyAnyMemoryAllocator allocator,
   }
 
   vulkanResult = ivyCreateVulkanImageView(renderer->device.logicalDevice,
+      renderer->device.allocationCallbacks,
       currentTexture->image, VK_IMAGE_ASPECT_COLOR_BIT,
       ivyAsVulkanFormat(currentTexture->format), &currentTexture->imageView);
   IVY_ASSERT(!vulkanResult);
@@ -352,30 +485,22 @@ IVY_API IvyCode ivyCreateGraphicsTexture(IvyAnyMemoryAllocator allocator,
   }
 
   if (data) {
-    vulkanResult = ivyChangeVulkanImageLayout(renderer->device.logicalDevice,
-        renderer->device.graphicsQueue, renderer->transientCommandPool,
-        currentTexture->mipLevels, currentTexture->image,
-        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    IVY_ASSERT(!vulkanResult);
-    if (vulkanResult) {
-      ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
-      goto error;
-    }
-
+    // NOTE: the mips are generated on the graphics queue, which the upload
+    //       timeline already orders after the copy, so no host wait here
     ivyCode = ivyUploadDataToVulkanImage(&renderer->device,
-        &renderer->defaultGraphicsMemoryAllocator,
+        &renderer->defaultGraphicsMemoryAllocator, &renderer->stagingRing,
         renderer->transientCommandPool, currentTexture->width,
-        currentTexture->height, currentTexture->format, data,
-        currentTexture->image);
+        currentTexture->height, currentTexture->mipLevels,
+        currentTexture->format, data, currentTexture->image, NULL);
     IVY_ASSERT(!ivyCode);
     if (ivyCode) {
       goto error;
     }
 
-    vulkanResult = ivyGenerateVulkanImageMips(renderer->device.logicalDevice,
-        renderer->device.graphicsQueue, renderer->transientCommandPool,
-        currentTexture->width, currentTexture->height,
-        currentTexture->mipLevels, currentTexture->image);
+    vulkanResult = ivyGenerateVulkanImageMips(&renderer->device,
+        renderer->transientCommandPool, currentTexture->width,
+        currentTexture->height, currentTexture->mipLevels,
+        currentTexture->image);
     IVY_ASSERT(!vulkanResult);
     if (vulkanResult) {
       ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
@@ -383,18 +508,20 @@ IVY_API IvyCode ivyCreateGraphicsTexture(IvyAnyMemoryAllocator allocator,
     }
   }
 
-  vulkanResult = ivyAllocateVulkanDescriptorSet(renderer->device.logicalDevice,
-      renderer->globalDescriptorPool, renderer->textureDescriptorSetLayout,
+  ivyCode = ivyAllocateGraphicsDescriptorSet(renderer->device.logicalDevice,
+      &renderer->persistentDescriptorAllocator,
+      renderer->textureDescriptorSetLayout, &currentTexture->descriptorPool,
       &currentTexture->descriptorSet);
-  IVY_ASSERT(!vulkanResult);
-  if (vulkanResult) {
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
     goto error;
   }
 
   vulkanResult = ivyCreateVulkanSampler(renderer->device.logicalDevice,
-      &currentTexture->sampler);
+      renderer->device.allocationCallbacks, &currentTexture->sampler);
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
+    ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
     goto error;
   }
 
@@ -423,27 +550,27 @@ IVY_API void ivyDestroyGraphicsTexture(IvyAnyMemoryAllocator allocator,
   }
 
   if (texture->sampler) {
-    vkDestroySampler(renderer->device.logicalDevice, texture->sampler, NULL);
+    vkDestroySampler(renderer->device.logicalDevice, texture->sampler,
+        renderer->device.allocationCallbacks);
     texture->sampler = VK_NULL_HANDLE;
   }
 
-  if (texture->descriptorSet) {
-    vkFreeDescriptorSets(renderer->device.logicalDevice,
-        renderer->globalDescriptorPool, 1, &texture->descriptorSet);
-    texture->descriptorSet = VK_NULL_HANDLE;
-  }
+  ivyFreeGraphicsDescriptorSet(renderer->device.logicalDevice,
+      &renderer->persistentDescriptorAllocator, texture->descriptorPool,
+      &texture->descriptorSet);
 
   ivyFreeGraphicsMemory(&renderer->device,
       &renderer->defaultGraphicsMemoryAllocator, &texture->memory);
 
   if (texture->imageView) {
     vkDestroyImageView(renderer->device.logicalDevice, texture->imageView,
-        NULL);
+        renderer->device.allocationCallbacks);
     texture->imageView = VK_NULL_HANDLE;
   }
 
   if (texture->image) {
-    vkDestroyImage(renderer->device.logicalDevice, texture->image, NULL);
+    vkDestroyImage(renderer->device.logicalDevice, texture->image,
+        renderer->device.allocationCallbacks);
     texture->image = VK_NULL_HANDLE;
   }
 
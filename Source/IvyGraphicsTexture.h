@@ -5,6 +5,7 @@
 #include "IvyMemoryAllocator.h"
 
 typedef struct IvyRenderer IvyRenderer;
+typedef struct IvyGraphicsUploadBatch IvyGraphicsUploadBatch;
 
 typedef enum IvyPixelFormat {
   IVY_RGBA8_SRGB,
@@ -19,6 +20,7 @@ typedef struct IvyGraphicsTexture {
   VkImage image;
   VkImageView imageView;
   IvyGraphicsMemory memory;
+  VkDescriptorPool descriptorPool;
   VkDescriptorSet descriptorSet;
   VkSampler sampler;
 } IvyGraphicsTexture;
@@ -27,10 +29,34 @@ IVY_API IvyCode ivyCreateGraphicsTextureFromFile(
     IvyAnyMemoryAllocator allocator, IvyRenderer *renderer, char const *path,
     IvyGraphicsTexture **texture);
 
+IVY_API IvyCode ivyCreateGraphicsTextureFromFileInUploadBatch(
+    IvyAnyMemoryAllocator allocator, IvyRenderer *renderer,
+    IvyGraphicsUploadBatch *batch, char const *path,
+    IvyGraphicsTexture **texture);
+
+// NOTE: the pixels are tightly packed RGBA8 and have to be released with
+//       ivyFreeDecodedImage. Every allocation stb_image makes while decoding
+//       comes from allocator, so an arena cleared after the load works.
+//       Safe to call from several threads at once as long as each one uses
+//       its own allocator
+IVY_API IvyCode ivyDecodeImageFile(IvyAnyMemoryAllocator allocator,
+    char const *path, int32_t *width, int32_t *height, void **pixels);
+
+IVY_API void ivyFreeDecodedImage(IvyAnyMemoryAllocator allocator,
+    void *pixels);
+
+IVY_API IvyCode ivyCreateGraphicsTextureFromPixelsInUploadBatch(
+    IvyAnyMemoryAllocator allocator, IvyRenderer *renderer,
+    IvyGraphicsUploadBatch *batch, int32_t width, int32_t height,
+    void *pixels, IvyGraphicsTexture **texture);
+
 IVY_API IvyCode ivyCreateGraphicsTexture(IvyAnyMemoryAllocator allocator,
     IvyRenderer *renderer, int32_t width, int32_t height,
     IvyPixelFormat format, void *data, IvyGraphicsTexture **texture);
 
+IVY_API void ivyRecordVulkanImageMips(VkCommandBuffer commandBuffer,
+    int32_t width, int32_t height, uint32_t mipLevels, VkImage image);
+
 IVY_API void ivyDestroyGraphicsTexture(IvyAnyMemoryAllocator allocator,
     IvyRenderer *renderer, IvyGraphicsTexture *texture);
 
@@ -11,7 +11,7 @@ IVY_API IvyCode ivyCreateGraphicsVertexBuffer(IvyAnyMemoryAllocator allocator,
   VkResult vulkanResult;
   IvyGraphicsVertexBuffer *currentBuffer;
 
-  currentBuffer = ivyAllocateMemory(allocator, size);
+  currentBuffer = ivyAllocateMemory(allocator, sizeof(*currentBuffer));
   IVY_ASSERT(currentBuffer);
   if (!currentBuffer) {
     ivyCode = IVY_ERROR_NO_MEMORY;
@@ -21,6 +21,7 @@ IVY_API IvyCode ivyCreateGraphicsVertexBuffer(IvyAnyMemoryAllocator allocator,
   IVY_MEMSET(currentBuffer, 0, sizeof(*currentBuffer));
 
   vulkanResult = ivyCreateVulkanBuffer(renderer->device.logicalDevice,
+      renderer->device.allocationCallbacks,
       VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
       size, &currentBuffer->buffer);
   IVY_ASSERT(!vulkanResult);
@@ -39,13 +40,16 @@ IVY_API IvyCode ivyCreateGraphicsVertexBuffer(IvyAnyMemoryAllocator allocator,
   }
 
   ivyCode = ivyUploadDataToVulkanBuffer(&renderer->device,
-      &renderer->defaultGraphicsMemoryAllocator,
-      renderer->transientCommandPool, size, data, currentBuffer->buffer);
+      &renderer->defaultGraphicsMemoryAllocator, &renderer->stagingRing,
+      renderer->transientCommandPool, size, data, currentBuffer->buffer,
+      NULL);
   IVY_ASSERT(!ivyCode);
   if (ivyCode) {
     goto error;
   }
 
+  *buffer = currentBuffer;
+
   return IVY_OK;
 
 error:
@@ -64,7 +68,8 @@ IVY_API void ivyDestroyGraphicsVertexBuffer(IvyAnyMemoryAllocator allocator,
       &renderer->defaultGraphicsMemoryAllocator, &buffer->memory);
 
   if (buffer->buffer) {
-    vkDestroyBuffer(renderer->device.logicalDevice, buffer->buffer, NULL);
+    vkDestroyBuffer(renderer->device.logicalDevice, buffer->buffer,
+        renderer->device.allocationCallbacks);
     buffer->buffer = VK_NULL_HANDLE;
   }
 
@@ -0,0 +1,350 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "IvyJobSystem.h"
+
+#include <sched.h>
+#include <unistd.h>
+
+#include "IvyAtomic.h"
+
+IVY_API uint32_t ivyGetHardwareThreadCount(void) {
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+  if (count < 1) {
+    return 1;
+  }
+
+  return (uint32_t)count;
+}
+
+IVY_INTERNAL IvyCode ivyCreateJobQueue(IvyAnyMemoryAllocator allocator,
+    uint32_t capacity, IvyJobQueue *queue) {
+  IVY_ASSERT(!(capacity & (capacity - 1)));
+
+  queue->jobs = ivyAllocateMemory(allocator, capacity * sizeof(*queue->jobs));
+  if (!queue->jobs) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+
+  if (pthread_mutex_init(&queue->mutex, NULL)) {
+    ivyFreeMemory(allocator, queue->jobs);
+    queue->jobs = NULL;
+    return IVY_ERROR_UNKNOWN;
+  }
+
+  queue->head = 0;
+  queue->tail = 0;
+  queue->capacity = capacity;
+
+  return IVY_OK;
+}
+
+IVY_INTERNAL void ivyDestroyJobQueue(IvyAnyMemoryAllocator allocator,
+    IvyJobQueue *queue) {
+  if (!queue->jobs) {
+    return;
+  }
+
+  pthread_mutex_destroy(&queue->mutex);
+  ivyFreeMemory(allocator, queue->jobs);
+  queue->jobs = NULL;
+}
+
+IVY_INTERNAL IvyBool ivyPushJob(IvyJobQueue *queue, IvyJob const *job) {
+  IvyBool wasPushed = 0;
+
+  pthread_mutex_lock(&queue->mutex);
+
+  if (queue->tail - queue->head < queue->capacity) {
+    queue->jobs[queue->tail & (queue->capacity - 1)] = *job;
+    ++queue->tail;
+    wasPushed = 1;
+  }
+
+  pthread_mutex_unlock(&queue->mutex);
+
+  return wasPushed;
+}
+
+IVY_INTERNAL IvyBool ivyPopJob(IvyJobQueue *queue, IvyJob *job) {
+  IvyBool wasPopped = 0;
+
+  pthread_mutex_lock(&queue->mutex);
+
+  if (queue->tail != queue->head) {
+    --queue->tail;
+    *job = queue->jobs[queue->tail & (queue->capacity - 1)];
+    wasPopped = 1;
+  }
+
+  pthread_mutex_unlock(&queue->mutex);
+
+  return wasPopped;
+}
+
+IVY_INTERNAL IvyBool ivyStealJob(IvyJobQueue *queue, IvyJob *job) {
+  IvyBool wasStolen = 0;
+
+  pthread_mutex_lock(&queue->mutex);
+
+  if (queue->tail != queue->head) {
+    *job = queue->jobs[queue->head & (queue->capacity - 1)];
+    ++queue->head;
+    wasStolen = 1;
+  }
+
+  pthread_mutex_unlock(&queue->mutex);
+
+  return wasStolen;
+}
+
+IVY_API uint32_t ivyGetCurrentJobQueueIndex(IvyJobSystem *jobSystem) {
+  IvyJobWorker *worker = pthread_getspecific(jobSystem->workerKey);
+
+  if (!worker) {
+    return 0;
+  }
+
+  return worker->index;
+}
+
+// NOTE: tries the queue of the calling thread first and then steals from
+//       the others, starting right after it so thieves spread out
+IVY_INTERNAL IvyBool ivyAcquireJob(IvyJobSystem *jobSystem, IvyJob *job) {
+  uint32_t index;
+  uint32_t const queueIndex = ivyGetCurrentJobQueueIndex(jobSystem);
+
+  if (!IVY_ATOMIC_LOAD(&jobSystem->pendingJobCount)) {
+    return 0;
+  }
+
+  if (ivyPopJob(&jobSystem->queues[queueIndex], job)) {
+    IVY_ATOMIC_SUB(&jobSystem->pendingJobCount, 1);
+    return 1;
+  }
+
+  for (index = 1; index < jobSystem->queueCount; ++index) {
+    uint32_t const victimIndex = (queueIndex + index) % jobSystem->queueCount;
+
+    if (ivyStealJob(&jobSystem->queues[victimIndex], job)) {
+      IVY_ATOMIC_SUB(&jobSystem->pendingJobCount, 1);
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+IVY_INTERNAL void ivyExecuteJob(IvyJob const *job) {
+  job->callback(job->data);
+
+  if (job->counter) {
+    IVY_ATOMIC_SUB(&job->counter->value, 1);
+  }
+}
+
+IVY_INTERNAL void *ivyJobWorkerMain(void *data) {
+  IvyJob job;
+  IvyJobWorker *worker = data;
+  IvyJobSystem *jobSystem = worker->jobSystem;
+
+  pthread_setspecific(jobSystem->workerKey, worker);
+
+  for (;;) {
+    if (ivyAcquireJob(jobSystem, &job)) {
+      ivyExecuteJob(&job);
+      continue;
+    }
+
+    // NOTE: submitters signal with the mutex held after bumping the pending
+    //       count, so checking it here can't miss a wake up
+    pthread_mutex_lock(&jobSystem->sleepMutex);
+
+    while (!IVY_ATOMIC_LOAD(&jobSystem->pendingJobCount) &&
+           !IVY_ATOMIC_LOAD(&jobSystem->shouldQuit)) {
+      pthread_cond_wait(&jobSystem->wakeCondition, &jobSystem->sleepMutex);
+    }
+
+    pthread_mutex_unlock(&jobSystem->sleepMutex);
+
+    if (IVY_ATOMIC_LOAD(&jobSystem->shouldQuit)) {
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+IVY_API IvyCode ivyCreateJobSystem(IvyAnyMemoryAllocator allocator,
+    uint32_t workerCount, IvyJobSystem *jobSystem) {
+  IvyCode ivyCode;
+  uint32_t index;
+  uint32_t startedWorkerCount = 0;
+
+  IVY_MEMSET(jobSystem, 0, sizeof(*jobSystem));
+
+  if (!workerCount) {
+    workerCount = ivyGetHardwareThreadCount() - 1;
+  }
+
+  jobSystem->ownerMemoryAllocator = allocator;
+  jobSystem->queueCount = workerCount + 1;
+
+  if (pthread_key_create(&jobSystem->workerKey, NULL)) {
+    return IVY_ERROR_UNKNOWN;
+  }
+
+  if (pthread_mutex_init(&jobSystem->sleepMutex, NULL)) {
+    pthread_key_delete(jobSystem->workerKey);
+    return IVY_ERROR_UNKNOWN;
+  }
+
+  if (pthread_cond_init(&jobSystem->wakeCondition, NULL)) {
+    pthread_mutex_destroy(&jobSystem->sleepMutex);
+    pthread_key_delete(jobSystem->workerKey);
+    return IVY_ERROR_UNKNOWN;
+  }
+
+  jobSystem->queues = ivyAllocateAndZeroMemory(allocator,
+      jobSystem->queueCount, sizeof(*jobSystem->queues));
+  if (!jobSystem->queues) {
+    ivyCode = IVY_ERROR_NO_MEMORY;
+    goto error;
+  }
+
+  for (index = 0; index < jobSystem->queueCount; ++index) {
+    ivyCode = ivyCreateJobQueue(allocator, IVY_DEFAULT_JOB_QUEUE_CAPACITY,
+        &jobSystem->queues[index]);
+    if (ivyCode) {
+      goto error;
+    }
+  }
+
+  if (workerCount) {
+    jobSystem->workers = ivyAllocateAndZeroMemory(allocator, workerCount,
+        sizeof(*jobSystem->workers));
+    if (!jobSystem->workers) {
+      ivyCode = IVY_ERROR_NO_MEMORY;
+      goto error;
+    }
+  }
+
+  for (index = 0; index < workerCount; ++index) {
+    IvyJobWorker *worker = &jobSystem->workers[index];
+
+    worker->jobSystem = jobSystem;
+    worker->index = index + 1;
+
+    if (pthread_create(&worker->thread, NULL, ivyJobWorkerMain, worker)) {
+      ivyCode = IVY_ERROR_UNKNOWN;
+      goto error;
+    }
+
+    jobSystem->workerCount = ++startedWorkerCount;
+  }
+
+  return IVY_OK;
+
+error:
+  ivyDestroyJobSystem(jobSystem);
+  return ivyCode;
+}
+
+IVY_API void ivyDestroyJobSystem(IvyJobSystem *jobSystem) {
+  uint32_t index;
+  IvyAnyMemoryAllocator allocator = jobSystem->ownerMemoryAllocator;
+
+  if (!allocator) {
+    return;
+  }
+
+  pthread_mutex_lock(&jobSystem->sleepMutex);
+  IVY_ATOMIC_STORE(&jobSystem->shouldQuit, 1);
+  pthread_cond_broadcast(&jobSystem->wakeCondition);
+  pthread_mutex_unlock(&jobSystem->sleepMutex);
+
+  for (index = 0; index < jobSystem->workerCount; ++index) {
+    pthread_join(jobSystem->workers[index].thread, NULL);
+  }
+
+  if (jobSystem->workers) {
+    ivyFreeMemory(allocator, jobSystem->workers);
+  }
+
+  if (jobSystem->queues) {
+    for (index = 0; index < jobSystem->queueCount; ++index) {
+      ivyDestroyJobQueue(allocator, &jobSystem->queues[index]);
+    }
+
+    ivyFreeMemory(allocator, jobSystem->queues);
+  }
+
+  pthread_cond_destroy(&jobSystem->wakeCondition);
+  pthread_mutex_destroy(&jobSystem->sleepMutex);
+  pthread_key_delete(jobSystem->workerKey);
+
+  IVY_MEMSET(jobSystem, 0, sizeof(*jobSystem));
+}
+
+IVY_API void ivyRunJobs(IvyJobSystem *jobSystem, uint32_t jobCount,
+    IvyJob const *jobs, IvyJobCounter *counter) {
+  uint32_t index;
+  uint32_t pushedJobCount = 0;
+  IvyJobQueue *queue =
+      &jobSystem->queues[ivyGetCurrentJobQueueIndex(jobSystem)];
+
+  if (!jobCount) {
+    return;
+  }
+
+  // NOTE: counted up front so a fast job can't bring it to zero while the
+  //       rest are still being pushed
+  if (counter) {
+    IVY_ATOMIC_ADD(&counter->value, (int32_t)jobCount);
+  }
+
+  for (index = 0; index < jobCount; ++index) {
+    IvyJob job = jobs[index];
+
+    job.counter = counter;
+
+    // NOTE: counted before the push so thieves never see it go negative
+    IVY_ATOMIC_ADD(&jobSystem->pendingJobCount, 1);
+
+    if (ivyPushJob(queue, &job)) {
+      ++pushedJobCount;
+    } else {
+      IVY_ATOMIC_SUB(&jobSystem->pendingJobCount, 1);
+      ivyExecuteJob(&job);
+    }
+  }
+
+  if (!pushedJobCount) {
+    return;
+  }
+
+  pthread_mutex_lock(&jobSystem->sleepMutex);
+  if (1 == pushedJobCount) {
+    pthread_cond_signal(&jobSystem->wakeCondition);
+  } else {
+    pthread_cond_broadcast(&jobSystem->wakeCondition);
+  }
+  pthread_mutex_unlock(&jobSystem->sleepMutex);
+}
+
+IVY_API IvyBool ivyIsJobCounterDone(IvyJobCounter *counter) {
+  return !IVY_ATOMIC_LOAD(&counter->value);
+}
+
+IVY_API void ivyWaitForJobCounter(IvyJobSystem *jobSystem,
+    IvyJobCounter *counter) {
+  IvyJob job;
+
+  while (!ivyIsJobCounterDone(counter)) {
+    if (ivyAcquireJob(jobSystem, &job)) {
+      ivyExecuteJob(&job);
+    } else {
+      sched_yield();
+    }
+  }
+}
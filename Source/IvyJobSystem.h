@@ -0,0 +1,85 @@
+#ifndef IVY_JOB_SYSTEM_H
+#define IVY_JOB_SYSTEM_H
+
+#include <pthread.h>
+
+#include "IvyMemoryAllocator.h"
+
+#define IVY_DEFAULT_JOB_QUEUE_CAPACITY 4096
+
+typedef void (*IvyJobCallback)(void *data);
+
+// NOTE: counts the jobs that haven't finished yet. Zero it before handing
+//       it to ivyRunJobs and keep it alive until the wait returns
+typedef struct IvyJobCounter {
+  int32_t value;
+} IvyJobCounter;
+
+// NOTE: counter is filled in by ivyRunJobs
+typedef struct IvyJob {
+  IvyJobCallback callback;
+  void *data;
+  IvyJobCounter *counter;
+} IvyJob;
+
+// NOTE: the owner pushes and pops at the tail, thieves take from the head,
+//       so stolen work is the oldest and usually the biggest
+typedef struct IvyJobQueue {
+  pthread_mutex_t mutex;
+  uint32_t head;
+  uint32_t tail;
+  uint32_t capacity;
+  IvyJob *jobs;
+} IvyJobQueue;
+
+typedef struct IvyJobSystem IvyJobSystem;
+
+typedef struct IvyJobWorker {
+  IvyJobSystem *jobSystem;
+  uint32_t index;
+  pthread_t thread;
+} IvyJobWorker;
+
+// NOTE: queue 0 belongs to the thread that created the job system, and
+//       queues 1 to workerCount to the worker threads. Threads that aren't
+//       part of the system push to queue 0
+struct IvyJobSystem {
+  IvyAnyMemoryAllocator ownerMemoryAllocator;
+  uint32_t workerCount;
+  uint32_t queueCount;
+  IvyJobQueue *queues;
+  IvyJobWorker *workers;
+  pthread_key_t workerKey;
+  pthread_mutex_t sleepMutex;
+  pthread_cond_t wakeCondition;
+  int32_t pendingJobCount;
+  int32_t shouldQuit;
+};
+
+IVY_API uint32_t ivyGetHardwareThreadCount(void);
+
+// NOTE: a workerCount of 0 creates one worker per hardware thread minus
+//       the calling thread
+IVY_API IvyCode ivyCreateJobSystem(IvyAnyMemoryAllocator allocator,
+    uint32_t workerCount, IvyJobSystem *jobSystem);
+
+IVY_API void ivyDestroyJobSystem(IvyJobSystem *jobSystem);
+
+// NOTE: jobs are copied, so the array can be reused right away. When a
+//       queue is full the job runs on the calling thread instead
+IVY_API void ivyRunJobs(IvyJobSystem *jobSystem, uint32_t jobCount,
+    IvyJob const *jobs, IvyJobCounter *counter);
+
+// NOTE: 0 on the thread that created the job system and on threads that
+//       aren't part of it, otherwise the index of the worker's queue. Jobs
+//       can use it to pick per-thread data out of queueCount slots
+IVY_API uint32_t ivyGetCurrentJobQueueIndex(IvyJobSystem *jobSystem);
+
+IVY_API IvyBool ivyIsJobCounterDone(IvyJobCounter *counter);
+
+// NOTE: runs queued jobs while the counter is not zero instead of blocking,
+//       so it can be called from inside a job to wait on its dependencies
+IVY_API void ivyWaitForJobCounter(IvyJobSystem *jobSystem,
+    IvyJobCounter *counter);
+
+#endif
@@ -1,5 +1,10 @@
+#define _POSIX_C_SOURCE 200112L
+
 #include "IvyMemoryAllocator.h"
 
+#include <pthread.h>
+
+#include "IvyAtomic.h"
 #include "IvyDeclarations.h"
 #include "IvyDummyMemoryAllocator.h"
 
@@ -68,9 +73,14 @@ IVY_API void ivyDestroyMemoryAllocator(IvyAnyMemoryAllocator allocator) {
   base->dispatch->destroy(allocator);
 }
 
-IVY_INTERNAL IvyBool createdDefaultAllocator = 0;
+IVY_INTERNAL pthread_once_t defaultMemoryAllocatorOnce = PTHREAD_ONCE_INIT;
+IVY_INTERNAL IvyDummyMemoryAllocator defaultMemoryAllocator;
 IVY_INTERNAL IvyAnyMemoryAllocator globalMemoryAllocator = NULL;
 
+IVY_INTERNAL void ivyCreateDefaultMemoryAllocator(void) {
+  ivyCreateDummyMemoryAllocator(&defaultMemoryAllocator);
+}
+
 IVY_API IvyCode ivySetGlobalMemoryAllocator(IvyAnyMemoryAllocator allocator) {
   IvyMemoryAllocatorBase *base = allocator;
 
@@ -78,22 +88,28 @@ IVY_API IvyCode ivySetGlobalMemoryAllocator(IvyAnyMemoryAllocator allocator) {
     return IVY_ERROR_INVALID_DYNAMIC_DISPATCH;
   }
 
-  globalMemoryAllocator = allocator;
+  IVY_ATOMIC_STORE(&globalMemoryAllocator, allocator);
   return IVY_OK;
 }
 
+// NOTE: threads can race for the first call, the default allocator is only
+//       ever set up once and an allocator set in the meantime wins
 IVY_API IvyAnyMemoryAllocator ivyGetGlobalMemoryAllocator(void) {
-  IVY_LOCAL_PERSIST IvyDummyMemoryAllocator defaultMemoryAllocator;
-
-  if (!globalMemoryAllocator && !createdDefaultAllocator) {
-    ivyCreateDummyMemoryAllocator(&defaultMemoryAllocator);
-    globalMemoryAllocator = &defaultMemoryAllocator;
-    createdDefaultAllocator = 1;
-  } else if (!globalMemoryAllocator && createdDefaultAllocator) {
-    globalMemoryAllocator = &defaultMemoryAllocator;
+  IvyAnyMemoryAllocator allocator;
+
+  allocator = IVY_ATOMIC_LOAD(&globalMemoryAllocator);
+  if (allocator) {
+    return allocator;
+  }
+
+  pthread_once(&defaultMemoryAllocatorOnce, ivyCreateDefaultMemoryAllocator);
+
+  if (IVY_ATOMIC_COMPARE_EXCHANGE(&globalMemoryAllocator, &allocator,
+          (IvyAnyMemoryAllocator)&defaultMemoryAllocator)) {
+    return &defaultMemoryAllocator;
   }
 
-  return globalMemoryAllocator;
+  return allocator;
 }
 
 IVY_API void ivyDestroyGlobalMemoryAllocator(void) {
@@ -54,7 +54,7 @@ void ivyClearMemoryAllocator(IvyAnyMemoryAllocator allocator);
 
 void ivyDestroyMemoryAllocator(IvyAnyMemoryAllocator allocator);
 
-IVY_API IvyCode ivySetGlobalDefaultMemoryAllocator(
+IVY_API IvyCode ivySetGlobalMemoryAllocator(
     IvyAnyMemoryAllocator allocator);
 
 IVY_API IvyAnyMemoryAllocator ivyGetGlobalMemoryAllocator(void);
@@ -3,15 +3,13 @@
 #include <cgltf.h>
 
 #include <stdio.h>
+#include <string.h>
 
+#include "IvyGraphicsDataUploader.h"
 #include "IvyGraphicsTexture.h"
+#include "IvyJobSystem.h"
 #include "IvyRenderer.h"
 
-IVY_INTERNAL void const *ivyResolveGLTFAccessor(cgltf_accessor *accessor) {
-  cgltf_buffer_view const *view = accessor->buffer_view;
-  return ((uint8_t *)view->data) + accessor->offset + view->offset;
-}
-
 // https://www.redhat.com/en/blog/trouble-snprintf
 IVY_INTERNAL IvyCode ivyFixModelURI(char const *assetDirectory,
     char const *uri, uint64_t maxFixedURISize, char *fixedURI) {
@@ -27,13 +25,152 @@ IVY_INTERNAL IvyCode ivyFixModelURI(char const *assetDirectory,
   return IVY_OK;
 }
 
+IVY_INTERNAL void *ivyAllocateGLTFMemory(void *user, cgltf_size size) {
+  return ivyAllocateMemory(user, size);
+}
+
+// NOTE: cgltf_free releases every member, even the ones that were never set
+IVY_INTERNAL void ivyFreeGLTFMemory(void *user, void *data) {
+  if (data) {
+    ivyFreeMemory(user, data);
+  }
+}
+
+// NOTE: the parsed data, the file contents and the buffers all come from
+//       allocator, which has to outlive the data until ivyFreeGLTFFile
+IVY_INTERNAL IvyCode ivyParseGLTFFile(IvyAnyMemoryAllocator allocator,
+    char const *path, cgltf_data **cgltfData) {
+  cgltf_result cgltfResult;
+  cgltf_options cgltfOptions;
+  cgltf_data *currentCGLTFData = NULL;
+
+  IVY_MEMSET(&cgltfOptions, 0, sizeof(cgltfOptions));
+  cgltfOptions.memory.alloc = ivyAllocateGLTFMemory;
+  cgltfOptions.memory.free = ivyFreeGLTFMemory;
+  cgltfOptions.memory.user_data = allocator;
+
+  cgltfResult = cgltf_parse_file(&cgltfOptions, path, &currentCGLTFData);
+  if (cgltf_result_success != cgltfResult) {
+    goto error;
+  }
+
+  cgltfResult = cgltf_load_buffers(&cgltfOptions, currentCGLTFData, path);
+  if (cgltf_result_success != cgltfResult) {
+    goto error;
+  }
+
+  *cgltfData = currentCGLTFData;
+
+  return IVY_OK;
+
+error:
+  cgltf_free(currentCGLTFData);
+  *cgltfData = NULL;
+
+  if (cgltf_result_out_of_memory == cgltfResult) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+
+  return IVY_ERROR_UNKNOWN;
+}
+
+IVY_INTERNAL void ivyFreeGLTFFile(cgltf_data *cgltfData) {
+  cgltf_free(cgltfData);
+}
+
+// NOTE: allocator is the one the pixels were decoded with, picked by the
+//       thread that ran the job
+typedef struct IvyModelImageDecode {
+  IvyJobSystem *jobSystem;
+  IvyAnyMemoryAllocator const *decodeAllocators;
+  IvyAnyMemoryAllocator allocator;
+  char path[256];
+  int32_t width;
+  int32_t height;
+  void *pixels;
+  IvyCode ivyCode;
+} IvyModelImageDecode;
+
+IVY_INTERNAL void ivyDecodeModelImage(void *data) {
+  uint32_t allocatorIndex = 0;
+  IvyModelImageDecode *decode = data;
+
+  if (decode->jobSystem) {
+    allocatorIndex = ivyGetCurrentJobQueueIndex(decode->jobSystem);
+  }
+
+  decode->allocator = decode->decodeAllocators[allocatorIndex];
+  decode->ivyCode = ivyDecodeImageFile(decode->allocator, decode->path,
+      &decode->width, &decode->height, &decode->pixels);
+}
+
+// NOTE: decoding is what dominates, so every image is decoded as its own job
+//       and only the texture creation and the upload stay on this thread.
+//       Without a job system the images are decoded here one by one
+IVY_INTERNAL IvyCode ivyDecodeModelImages(IvyAnyMemoryAllocator allocator,
+    IvyJobSystem *jobSystem, uint32_t imageCount,
+    IvyModelImageDecode *decodes) {
+  uint32_t imageIndex;
+  IvyJob *jobs;
+  IvyJobCounter counter = {0};
+
+  if (!jobSystem) {
+    for (imageIndex = 0; imageIndex < imageCount; ++imageIndex) {
+      ivyDecodeModelImage(&decodes[imageIndex]);
+    }
+
+    return IVY_OK;
+  }
+
+  jobs = ivyAllocateMemory(allocator, imageCount * sizeof(*jobs));
+  if (!jobs) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+
+  for (imageIndex = 0; imageIndex < imageCount; ++imageIndex) {
+    jobs[imageIndex].callback = ivyDecodeModelImage;
+    jobs[imageIndex].data = &decodes[imageIndex];
+  }
+
+  ivyRunJobs(jobSystem, imageCount, jobs, &counter);
+  ivyWaitForJobCounter(jobSystem, &counter);
+
+  ivyFreeMemory(allocator, jobs);
+
+  return IVY_OK;
+}
+
+// NOTE: the decoded pixels come from the allocator of the thread that decoded
+//       them and are released as soon as they are in the upload batch. The
+//       jobs are done by then, so releasing them from here doesn't race
 IVY_INTERNAL IvyCode ivyLoadModelImages(IvyAnyMemoryAllocator allocator,
-    IvyRenderer *renderer, cgltf_data *cgltfData, uint32_t *imageCount,
-    IvyGraphicsTexture ***images) {
+    IvyAnyMemoryAllocator const *decodeAllocators, IvyRenderer *renderer,
+    IvyJobSystem *jobSystem, char const *directory, cgltf_data *cgltfData,
+    uint32_t *imageCount, IvyGraphicsTexture ***images) {
   IvyCode ivyCode;
   uint32_t imageIndex;
   uint32_t currentImageCount;
   IvyGraphicsTexture **currentImages = NULL;
+  IvyModelImageDecode *decodes = NULL;
+  IvyGraphicsUploadBatch uploadBatch;
+
+  if (!cgltfData->images_count) {
+    *imageCount = 0;
+    *images = NULL;
+    return IVY_OK;
+  }
+
+  // NOTE: every image of the model goes out in a single submission
+  ivyCode = ivyBeginGraphicsUploadBatch(allocator, &renderer->device,
+      &renderer->defaultGraphicsMemoryAllocator, &renderer->stagingRing,
+      renderer->transientCommandPool, &uploadBatch);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    ivyDiscardGraphicsUploadBatch(&uploadBatch);
+    *imageCount = 0;
+    *images = NULL;
+    return ivyCode;
+  }
 
   currentImageCount = cgltfData->images_count;
   currentImages =
@@ -45,32 +182,90 @@ IVY_INTERNAL IvyCode ivyLoadModelImages(IvyAnyMemoryAllocator allocator,
 
   IVY_MEMSET(currentImages, 0, currentImageCount * sizeof(*currentImages));
 
+  decodes = ivyAllocateMemory(allocator, currentImageCount * sizeof(*decodes));
+  if (!decodes) {
+    ivyCode = IVY_ERROR_NO_MEMORY;
+    goto error;
+  }
+
+  IVY_MEMSET(decodes, 0, currentImageCount * sizeof(*decodes));
+
   for (imageIndex = 0; imageIndex < currentImageCount; ++imageIndex) {
-    char fixedURI[256];
     cgltf_image const *cgltfImage = &cgltfData->images[imageIndex];
-    IvyGraphicsTexture **image = &currentImages[imageIndex];
 
-    ivyCode = ivyFixModelURI("../Resources/", cgltfImage->uri,
-        sizeof(fixedURI), fixedURI);
+    decodes[imageIndex].jobSystem = jobSystem;
+    decodes[imageIndex].decodeAllocators = decodeAllocators;
+
+    // TODO: images embedded in a buffer view
+    if (!cgltfImage->uri) {
+      ivyCode = IVY_ERROR_UNKNOWN;
+      goto error;
+    }
+
+    ivyCode = ivyFixModelURI(directory, cgltfImage->uri,
+        sizeof(decodes[imageIndex].path), decodes[imageIndex].path);
+    IVY_ASSERT(!ivyCode);
+    if (ivyCode) {
+      goto error;
+    }
+  }
+
+  ivyCode = ivyDecodeModelImages(allocator, jobSystem, currentImageCount,
+      decodes);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
+  for (imageIndex = 0; imageIndex < currentImageCount; ++imageIndex) {
+    IvyModelImageDecode *decode = &decodes[imageIndex];
+
+    ivyCode = decode->ivyCode;
     IVY_ASSERT(!ivyCode);
     if (ivyCode) {
       goto error;
     }
 
-    ivyCode =
-        ivyCreateGraphicsTextureFromFile(allocator, renderer, fixedURI, image);
+    ivyCode = ivyCreateGraphicsTextureFromPixelsInUploadBatch(allocator,
+        renderer, &uploadBatch, decode->width, decode->height, decode->pixels,
+        &currentImages[imageIndex]);
     IVY_ASSERT(!ivyCode);
     if (ivyCode) {
       goto error;
     }
+
+    // NOTE: the batch keeps its own copy in the staging buffer
+    ivyFreeDecodedImage(decode->allocator, decode->pixels);
+    decode->pixels = NULL;
   }
 
+  ivyCode = ivyEndGraphicsUploadBatch(&uploadBatch, NULL);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
+  ivyFreeMemory(allocator, decodes);
+
   *imageCount = currentImageCount;
   *images = currentImages;
 
   return IVY_OK;
 
 error:
+  ivyDiscardGraphicsUploadBatch(&uploadBatch);
+
+  if (decodes) {
+    for (imageIndex = 0; imageIndex < currentImageCount; ++imageIndex) {
+      if (decodes[imageIndex].pixels) {
+        ivyFreeDecodedImage(decodes[imageIndex].allocator,
+            decodes[imageIndex].pixels);
+      }
+    }
+
+    ivyFreeMemory(allocator, decodes);
+  }
+
   if (currentImages) {
     for (imageIndex = 0; imageIndex < currentImageCount; ++imageIndex) {
       ivyDestroyGraphicsTexture(allocator, renderer,
@@ -88,12 +283,17 @@ error:
 IVY_INTERNAL IvyCode ivyLoadModelTextures(IvyAnyMemoryAllocator allocator,
     cgltf_data *cgltfData, uint32_t *textureCount,
     IvyModelTexture **textures) {
-
   uint32_t textureIndex;
   uint32_t currentTextureCount;
   IvyModelTexture *currentTextures;
 
   currentTextureCount = cgltfData->textures_count;
+  if (!currentTextureCount) {
+    *textureCount = 0;
+    *textures = NULL;
+    return IVY_OK;
+  }
+
   currentTextures = ivyAllocateMemory(allocator,
       currentTextureCount * sizeof(*currentTextures));
   if (!currentTextures) {
@@ -104,8 +304,13 @@ IVY_INTERNAL IvyCode ivyLoadModelTextures(IvyAnyMemoryAllocator allocator,
 
   for (textureIndex = 0; textureIndex < currentTextureCount; ++textureIndex) {
     cgltf_texture const *cgltfTexture = &cgltfData->textures[textureIndex];
-    uint32_t imageIndex = (uint32_t)(cgltfTexture->image - cgltfData->images);
-    currentTextures[textureIndex].imageIndex = imageIndex;
+
+    if (cgltfTexture->image) {
+      currentTextures[textureIndex].imageIndex =
+          (int32_t)(cgltfTexture->image - cgltfData->images);
+    } else {
+      currentTextures[textureIndex].imageIndex = -1;
+    }
   }
 
   *textureCount = currentTextureCount;
@@ -122,6 +327,12 @@ IVY_INTERNAL IvyCode ivyLoadModelMaterials(IvyAnyMemoryAllocator allocator,
   IvyModelMaterial *currentMaterials;
 
   currentMaterialCount = cgltfData->materials_count;
+  if (!currentMaterialCount) {
+    *materialCount = 0;
+    *materials = NULL;
+    return IVY_OK;
+  }
+
   currentMaterials = ivyAllocateMemory(allocator,
       currentMaterialCount * sizeof(*currentMaterials));
   if (!currentMaterials) {
@@ -280,5 +491,124 @@ IVY_INTERNAL IvyCode ivyLoadModelMaterials(IvyAnyMemoryAllocator allocator,
     }
   }
 
+  *materialCount = currentMaterialCount;
+  *materials = currentMaterials;
+
+  return IVY_OK;
+}
+
+// NOTE: the directory is everything up to the last separator, images are
+//       looked up relative to it
+IVY_INTERNAL IvyCode ivySetModelPath(char const *path, IvyModel *model) {
+  uint64_t directoryLength;
+  char const *separator;
+  uint64_t const pathLength = strlen(path);
+
+  if (pathLength >= sizeof(model->path)) {
+    return IVY_ERROR_INVALID_VALUE;
+  }
+
+  IVY_MEMCPY(model->path, path, pathLength + 1);
+
+  separator = strrchr(path, '/');
+  if (!separator) {
+    model->directory[0] = '.';
+    model->directory[1] = '\0';
+    return IVY_OK;
+  }
+
+  directoryLength = (uint64_t)(separator - path);
+  IVY_MEMCPY(model->directory, path, directoryLength);
+  model->directory[directoryLength] = '\0';
+
+  return IVY_OK;
+}
+
+IVY_API IvyCode ivyCreateModel(IvyAnyMemoryAllocator allocator,
+    IvyAnyMemoryAllocator const *decodeAllocators, IvyRenderer *renderer,
+    IvyJobSystem *jobSystem, char const *path, IvyModel *model) {
+  IvyCode ivyCode;
+  uint32_t imageCount;
+  uint32_t textureCount;
+  uint32_t materialCount;
+  cgltf_data *cgltfData = NULL;
+
+  IVY_MEMSET(model, 0, sizeof(*model));
+  model->ownerMemoryAllocator = allocator;
+
+  ivyCode = ivySetModelPath(path, model);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
+  ivyCode = ivyParseGLTFFile(allocator, path, &cgltfData);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
+  ivyCode = ivyLoadModelImages(allocator, decodeAllocators, renderer,
+      jobSystem, model->directory, cgltfData, &imageCount, &model->images);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
+  model->imageCount = (int32_t)imageCount;
+
+  ivyCode = ivyLoadModelTextures(allocator, cgltfData, &textureCount,
+      &model->textures);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
+  model->textureCount = (int32_t)textureCount;
+
+  ivyCode = ivyLoadModelMaterials(allocator, cgltfData, &materialCount,
+      &model->materials);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
+  model->materialCount = (int32_t)materialCount;
+
+  ivyFreeGLTFFile(cgltfData);
+
   return IVY_OK;
+
+error:
+  ivyFreeGLTFFile(cgltfData);
+  ivyDestroyModel(renderer, model);
+  return ivyCode;
+}
+
+IVY_API void ivyDestroyModel(IvyRenderer *renderer, IvyModel *model) {
+  int32_t imageIndex;
+  IvyAnyMemoryAllocator allocator = model->ownerMemoryAllocator;
+
+  if (!allocator) {
+    return;
+  }
+
+  if (model->materials) {
+    ivyFreeMemory(allocator, model->materials);
+  }
+
+  if (model->textures) {
+    ivyFreeMemory(allocator, model->textures);
+  }
+
+  if (model->images) {
+    for (imageIndex = 0; imageIndex < model->imageCount; ++imageIndex) {
+      ivyDestroyGraphicsTexture(allocator, renderer,
+          model->images[imageIndex]);
+    }
+
+    ivyFreeMemory(allocator, model->images);
+  }
+
+  IVY_MEMSET(model, 0, sizeof(*model));
 }
@@ -2,9 +2,11 @@
 #define IVY_MODEL_H
 
 #include "IvyGraphicsMemoryAllocator.h"
+#include "IvyJobSystem.h"
 #include "IvyMemoryAllocator.h"
 #include "IvyVectorMath.h"
 
+typedef struct IvyRenderer IvyRenderer;
 typedef struct IvyGraphicsTexture IvyGraphicsTexture;
 typedef struct IvyGraphicsVertexBuffer IvyGraphicsVertexBuffer;
 typedef struct IvyGraphicsIndexBuffer IvyGraphicsIndexBuffer;
@@ -189,4 +191,16 @@ typedef struct IvyModel {
   IvyModelAnimation *animations;
 } IvyModel;
 
+// NOTE: loads a glTF file along with the images, textures and materials it
+//       references. decodeAllocators holds one allocator per job queue, so
+//       jobSystem->queueCount of them, or a single one without a job system.
+//       Each thread only decodes with its own, so they don't need to be
+//       thread safe, and they are empty again once this returns. Call it
+//       from the thread that created the job system
+IVY_API IvyCode ivyCreateModel(IvyAnyMemoryAllocator allocator,
+    IvyAnyMemoryAllocator const *decodeAllocators, IvyRenderer *renderer,
+    IvyJobSystem *jobSystem, char const *path, IvyModel *model);
+
+IVY_API void ivyDestroyModel(IvyRenderer *renderer, IvyModel *model);
+
 #endif
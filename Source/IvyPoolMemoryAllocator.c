@@ -0,0 +1,309 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "IvyPoolMemoryAllocator.h"
+
+#include <stdlib.h>
+
+// NOTE: rounded to a cache line so the first slot starts on one
+#define IVY_POOL_SLAB_HEADER_SIZE                                            \
+  ((sizeof(IvyPoolMemorySlab) + IVY_POOL_CACHE_LINE_SIZE - 1) /              \
+      IVY_POOL_CACHE_LINE_SIZE * IVY_POOL_CACHE_LINE_SIZE)
+
+#define IVY_POOL_LARGE_BLOCK_HEADER_SIZE (IVY_POOL_CACHE_LINE_SIZE / 2)
+
+IVY_INTERNAL uint32_t ivyGetPoolMemorySizeClass(uint64_t size) {
+  uint32_t sizeClass = 0;
+  uint64_t slotSize = IVY_POOL_MIN_SLOT_SIZE;
+
+  if (size > IVY_POOL_MAX_SLOT_SIZE) {
+    return IVY_POOL_LARGE_SIZE_CLASS;
+  }
+
+  while (slotSize < size) {
+    slotSize <<= 1;
+    ++sizeClass;
+  }
+
+  return sizeClass;
+}
+
+IVY_INTERNAL IvyPoolMemorySlab *ivyGetPoolMemorySlab(void *data) {
+  uint64_t const address = (uint64_t)(uintptr_t)data;
+  return (IvyPoolMemorySlab *)(uintptr_t)(address &
+                                          ~(uint64_t)(IVY_POOL_SLAB_SIZE - 1));
+}
+
+IVY_INTERNAL uint8_t *ivyGetPoolMemorySlabData(IvyPoolMemorySlab *slab) {
+  return (uint8_t *)slab + IVY_POOL_SLAB_HEADER_SIZE;
+}
+
+IVY_INTERNAL IvyPoolMemorySlab *ivyCreatePoolMemorySlab(
+    IvyPoolMemoryAllocator *poolAllocator, uint32_t sizeClass,
+    uint64_t slotSize, uint32_t slotCount) {
+  void *data;
+  IvyPoolMemorySlab *slab;
+
+  if (posix_memalign(&data, IVY_POOL_SLAB_SIZE,
+          IVY_POOL_SLAB_HEADER_SIZE + slotSize * slotCount)) {
+    return NULL;
+  }
+
+  slab = data;
+  slab->pool = poolAllocator;
+  slab->previous = NULL;
+  slab->next = poolAllocator->slabs;
+  slab->slotSize = slotSize;
+  slab->sizeClass = sizeClass;
+  slab->slotCount = slotCount;
+
+  if (poolAllocator->slabs) {
+    poolAllocator->slabs->previous = slab;
+  }
+
+  poolAllocator->slabs = slab;
+
+  return slab;
+}
+
+IVY_INTERNAL IvyBool ivyIsPoolMemoryLargeAllocation(void *data) {
+  return 0 != (uintptr_t)data % IVY_POOL_CACHE_LINE_SIZE;
+}
+
+IVY_INTERNAL IvyPoolMemoryLargeBlock *ivyGetPoolMemoryLargeBlock(void *data) {
+  return (IvyPoolMemoryLargeBlock *)((uint8_t *)data -
+                                     IVY_POOL_LARGE_BLOCK_HEADER_SIZE);
+}
+
+IVY_INTERNAL void *ivyAllocatePoolMemoryLargeBlock(
+    IvyPoolMemoryAllocator *poolAllocator, uint64_t size) {
+  void *data;
+  IvyPoolMemoryLargeBlock *block;
+
+  IVY_ASSERT(sizeof(*block) <= IVY_POOL_LARGE_BLOCK_HEADER_SIZE);
+
+  if (posix_memalign(&data, IVY_POOL_CACHE_LINE_SIZE,
+          IVY_POOL_LARGE_BLOCK_HEADER_SIZE + size)) {
+    return NULL;
+  }
+
+  block = data;
+  block->pool = poolAllocator;
+  block->previous = NULL;
+  block->next = poolAllocator->largeBlocks;
+  block->size = size;
+
+  if (poolAllocator->largeBlocks) {
+    poolAllocator->largeBlocks->previous = block;
+  }
+
+  poolAllocator->largeBlocks = block;
+
+  return (uint8_t *)block + IVY_POOL_LARGE_BLOCK_HEADER_SIZE;
+}
+
+IVY_INTERNAL void ivyFreePoolMemoryLargeBlock(
+    IvyPoolMemoryAllocator *poolAllocator, IvyPoolMemoryLargeBlock *block) {
+  if (block->previous) {
+    block->previous->next = block->next;
+  } else {
+    poolAllocator->largeBlocks = block->next;
+  }
+
+  if (block->next) {
+    block->next->previous = block->previous;
+  }
+
+  free(block);
+}
+
+IVY_INTERNAL void ivyDestroyPoolMemorySlab(
+    IvyPoolMemoryAllocator *poolAllocator, IvyPoolMemorySlab *slab) {
+  if (slab->previous) {
+    slab->previous->next = slab->next;
+  } else {
+    poolAllocator->slabs = slab->next;
+  }
+
+  if (slab->next) {
+    slab->next->previous = slab->previous;
+  }
+
+  free(slab);
+}
+
+// NOTE: the whole slab is threaded into the free list in address order, so
+//       consecutive allocations end up next to each other
+IVY_INTERNAL IvyBool ivyRefillPoolMemorySizeClass(
+    IvyPoolMemoryAllocator *poolAllocator, uint32_t sizeClass) {
+  uint32_t index;
+  uint8_t *data;
+  IvyPoolMemorySlab *slab;
+  uint64_t const slotSize = (uint64_t)IVY_POOL_MIN_SLOT_SIZE << sizeClass;
+  uint32_t const slotCount =
+      (uint32_t)((IVY_POOL_SLAB_SIZE - IVY_POOL_SLAB_HEADER_SIZE) / slotSize);
+
+  slab = ivyCreatePoolMemorySlab(poolAllocator, sizeClass, slotSize,
+      slotCount);
+  if (!slab) {
+    return 0;
+  }
+
+  data = ivyGetPoolMemorySlabData(slab);
+  for (index = slotCount; index > 0; --index) {
+    IvyPoolMemorySlot *slot =
+        (IvyPoolMemorySlot *)(data + (index - 1) * slotSize);
+    slot->next = poolAllocator->freeSlots[sizeClass];
+    poolAllocator->freeSlots[sizeClass] = slot;
+  }
+
+  return 1;
+}
+
+IVY_INTERNAL void *ivyPoolMemoryAllocatorAllocate(
+    IvyAnyMemoryAllocator allocator, uint64_t size) {
+  IvyPoolMemorySlot *slot;
+  IvyPoolMemoryAllocator *poolAllocator = allocator;
+  uint32_t const sizeClass = ivyGetPoolMemorySizeClass(size);
+
+  if (IVY_POOL_LARGE_SIZE_CLASS == sizeClass) {
+    void *data = ivyAllocatePoolMemoryLargeBlock(poolAllocator, size);
+    if (!data) {
+      return NULL;
+    }
+
+    ++poolAllocator->aliveAllocationCount;
+    return data;
+  }
+
+  if (!poolAllocator->freeSlots[sizeClass]) {
+    if (!ivyRefillPoolMemorySizeClass(poolAllocator, sizeClass)) {
+      return NULL;
+    }
+  }
+
+  slot = poolAllocator->freeSlots[sizeClass];
+  poolAllocator->freeSlots[sizeClass] = slot->next;
+
+  ++poolAllocator->aliveAllocationCount;
+  return slot;
+}
+
+IVY_INTERNAL void *ivyPoolMemoryAllocatorAllocateAndZeroMemory(
+    IvyAnyMemoryAllocator allocator, uint64_t count, uint64_t elementSize) {
+  uint64_t size = count * elementSize;
+  void *allocation = ivyPoolMemoryAllocatorAllocate(allocator, size);
+  if (allocation) {
+    IVY_MEMSET(allocation, 0, size);
+  }
+  return allocation;
+}
+
+IVY_INTERNAL void ivyPoolMemoryAllocatorFree(IvyAnyMemoryAllocator allocator,
+    void *data) {
+  IvyPoolMemorySlab *slab;
+  IvyPoolMemorySlot *slot;
+  IvyPoolMemoryAllocator *poolAllocator = allocator;
+
+  if (!data) {
+    return;
+  }
+
+  IVY_ASSERT(poolAllocator->aliveAllocationCount);
+
+  --poolAllocator->aliveAllocationCount;
+
+  if (ivyIsPoolMemoryLargeAllocation(data)) {
+    IvyPoolMemoryLargeBlock *block = ivyGetPoolMemoryLargeBlock(data);
+    IVY_ASSERT(block->pool == poolAllocator);
+    ivyFreePoolMemoryLargeBlock(poolAllocator, block);
+    return;
+  }
+
+  slab = ivyGetPoolMemorySlab(data);
+  IVY_ASSERT(slab->pool == poolAllocator);
+
+  slot = data;
+  slot->next = poolAllocator->freeSlots[slab->sizeClass];
+  poolAllocator->freeSlots[slab->sizeClass] = slot;
+}
+
+IVY_INTERNAL void *ivyPoolMemoryAllocatorReallocate(
+    IvyAnyMemoryAllocator allocator, void *data, uint64_t newSize) {
+  void *newData;
+  uint64_t size;
+
+  if (!data) {
+    return ivyPoolMemoryAllocatorAllocate(allocator, newSize);
+  }
+
+  if (ivyIsPoolMemoryLargeAllocation(data)) {
+    size = ivyGetPoolMemoryLargeBlock(data)->size;
+  } else {
+    size = ivyGetPoolMemorySlab(data)->slotSize;
+
+    // NOTE: slots already have room to spare
+    if (newSize <= size) {
+      return data;
+    }
+  }
+
+  newData = ivyPoolMemoryAllocatorAllocate(allocator, newSize);
+  if (!newData) {
+    return NULL;
+  }
+
+  IVY_MEMCPY(newData, data, IVY_MIN(newSize, size));
+  ivyPoolMemoryAllocatorFree(allocator, data);
+
+  return newData;
+}
+
+IVY_INTERNAL void ivyPoolMemoryAllocatorClear(
+    IvyAnyMemoryAllocator allocator) {
+  uint32_t sizeClass;
+  IvyPoolMemoryAllocator *poolAllocator = allocator;
+
+  while (poolAllocator->slabs) {
+    ivyDestroyPoolMemorySlab(poolAllocator, poolAllocator->slabs);
+  }
+
+  while (poolAllocator->largeBlocks) {
+    ivyFreePoolMemoryLargeBlock(poolAllocator, poolAllocator->largeBlocks);
+  }
+
+  for (sizeClass = 0; sizeClass < IVY_POOL_SIZE_CLASS_COUNT; ++sizeClass) {
+    poolAllocator->freeSlots[sizeClass] = NULL;
+  }
+
+  poolAllocator->aliveAllocationCount = 0;
+}
+
+IVY_INTERNAL void ivyPoolMemoryAllocatorDestroy(
+    IvyAnyMemoryAllocator allocator) {
+  IvyPoolMemoryAllocator *poolAllocator = allocator;
+  IVY_ASSERT(!poolAllocator->aliveAllocationCount);
+  ivyPoolMemoryAllocatorClear(allocator);
+}
+
+IVY_INTERNAL IvyMemoryAllocatorDispatch const poolMemoryAllocatorDispatch = {
+    ivyPoolMemoryAllocatorAllocate,
+    ivyPoolMemoryAllocatorAllocateAndZeroMemory,
+    ivyPoolMemoryAllocatorReallocate, ivyPoolMemoryAllocatorFree,
+    ivyPoolMemoryAllocatorClear, ivyPoolMemoryAllocatorDestroy};
+
+IVY_API IvyCode ivyCreatePoolMemoryAllocator(
+    IvyPoolMemoryAllocator *allocator) {
+  uint32_t sizeClass;
+
+  ivySetupMemoryAllocatorBase(&poolMemoryAllocatorDispatch, &allocator->base);
+
+  allocator->aliveAllocationCount = 0;
+  allocator->slabs = NULL;
+  allocator->largeBlocks = NULL;
+
+  for (sizeClass = 0; sizeClass < IVY_POOL_SIZE_CLASS_COUNT; ++sizeClass) {
+    allocator->freeSlots[sizeClass] = NULL;
+  }
+
+  return IVY_OK;
+}
@@ -0,0 +1,55 @@
+#ifndef IVY_POOL_MEMORY_ALLOCATOR_H
+#define IVY_POOL_MEMORY_ALLOCATOR_H
+
+#include "IvyMemoryAllocator.h"
+
+#define IVY_POOL_CACHE_LINE_SIZE 64
+#define IVY_POOL_SLAB_SIZE (64 * 1024)
+#define IVY_POOL_SIZE_CLASS_COUNT 7
+#define IVY_POOL_MIN_SLOT_SIZE IVY_POOL_CACHE_LINE_SIZE
+#define IVY_POOL_MAX_SLOT_SIZE                                               \
+  (IVY_POOL_MIN_SLOT_SIZE << (IVY_POOL_SIZE_CLASS_COUNT - 1))
+#define IVY_POOL_LARGE_SIZE_CLASS IVY_POOL_SIZE_CLASS_COUNT
+
+typedef struct IvyPoolMemoryAllocator IvyPoolMemoryAllocator;
+
+// NOTE: slabs are aligned to IVY_POOL_SLAB_SIZE, so the header of the slab
+//       an allocation belongs to is found by masking its address
+typedef struct IvyPoolMemorySlab {
+  IvyPoolMemoryAllocator *pool;
+  struct IvyPoolMemorySlab *previous;
+  struct IvyPoolMemorySlab *next;
+  uint64_t slotSize;
+  uint32_t sizeClass;
+  uint32_t slotCount;
+} IvyPoolMemorySlab;
+
+// NOTE: requests bigger than IVY_POOL_MAX_SLOT_SIZE go to the heap with this
+//       header in front. The data starts half a cache line into the block,
+//       which no slot ever does, so free can tell both kinds apart
+typedef struct IvyPoolMemoryLargeBlock {
+  IvyPoolMemoryAllocator *pool;
+  struct IvyPoolMemoryLargeBlock *previous;
+  struct IvyPoolMemoryLargeBlock *next;
+  uint64_t size;
+} IvyPoolMemoryLargeBlock;
+
+typedef struct IvyPoolMemorySlot {
+  struct IvyPoolMemorySlot *next;
+} IvyPoolMemorySlot;
+
+// NOTE: one free list per size class, the smallest one is a cache line and
+//       each one after it doubles. Slots never cross a cache line they don't
+//       own. Not thread safe
+struct IvyPoolMemoryAllocator {
+  IvyMemoryAllocatorBase base;
+  int32_t aliveAllocationCount;
+  IvyPoolMemorySlot *freeSlots[IVY_POOL_SIZE_CLASS_COUNT];
+  IvyPoolMemorySlab *slabs;
+  IvyPoolMemoryLargeBlock *largeBlocks;
+};
+
+IVY_API IvyCode ivyCreatePoolMemoryAllocator(
+    IvyPoolMemoryAllocator *allocator);
+
+#endif
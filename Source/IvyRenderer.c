@@ -3,6 +3,7 @@
 #include "IvyApplication.h"
 #include "IvyGraphicsTexture.h"
 #include "IvyLog.h"
+#include "IvyStackMemoryAllocator.h"
 #include "IvyVulkanUtilities.h"
 
 #if defined(IVY_ENABLE_VULKAN_VALIDATION_LAYERS)
@@ -20,7 +21,7 @@ IVY_INTERNAL VkInstanceCreateFlagBits ivyGetVulkanInstanceCreateFlagBits(
 }
 
 IVY_INTERNAL VkResult ivyCreateVulkanInstance(IvyApplication *application,
-    VkInstance *instance) {
+    VkAllocationCallbacks const *allocationCallbacks, VkInstance *instance) {
   VkApplicationInfo applicationInfo;
   VkInstanceCreateInfo instanceCreateInfo;
 
@@ -32,7 +33,7 @@ IVY_INTERNAL VkResult ivyCreateVulkanInstance(IvyApplication *application,
   applicationInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
   applicationInfo.pEngineName = "No Engine";
   applicationInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-  applicationInfo.apiVersion = VK_MAKE_VERSION(1, 0, 0);
+  applicationInfo.apiVersion = VK_MAKE_VERSION(1, 2, 0);
 
   instanceCreateInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
   instanceCreateInfo.pNext = NULL;
@@ -52,7 +53,7 @@ IVY_INTERNAL VkResult ivyCreateVulkanInstance(IvyApplication *application,
     return VK_ERROR_UNKNOWN;
   }
 
-  return vkCreateInstance(&instanceCreateInfo, NULL, instance);
+  return vkCreateInstance(&instanceCreateInfo, allocationCallbacks, instance);
 }
 
 #ifdef IVY_ENABLE_VULKAN_VALIDATION_LAYERS
@@ -96,6 +97,7 @@ static VKAPI_ATTR VKAPI_CALL VkBool32 ivyLogVulkanMessages(
 #endif
 
 IVY_INTERNAL VkResult ivyCreateVulkanDebugMessenger(VkInstance instance,
+    VkAllocationCallbacks const *allocationCallbacks,
     PFN_vkCreateDebugUtilsMessengerEXT *createDebugUtilsMessengerEXT,
     PFN_vkDestroyDebugUtilsMessengerEXT *destroyDebugUtilsMessengerEXT,
     VkDebugUtilsMessengerEXT *messenger) {
@@ -133,7 +135,7 @@ IVY_INTERNAL VkResult ivyCreateVulkanDebugMessenger(VkInstance instance,
   debugMessengerCreateInfo.pUserData = NULL;
 
   return (*createDebugUtilsMessengerEXT)(instance, &debugMessengerCreateInfo,
-      NULL, messenger);
+      allocationCallbacks, messenger);
 #else
   return VK_SUCCESS
 #endif /* IVY_ENABLE_VULKAN_VALIDATION_LAYERS */
@@ -159,19 +161,27 @@ IVY_INTERNAL IvyBool ivyAreVulkanQueueFamilyIndicesValid(
          (uint32_t)-1 != presentQueueFamilyIndex;
 }
 
-IVY_INTERNAL void ivyFindVulkanQueueFamilyIndices(
-    IvyAnyMemoryAllocator allocator, VkPhysicalDevice device,
+IVY_INTERNAL void ivyFindVulkanQueueFamilyIndices(VkPhysicalDevice device,
     VkSurfaceKHR surface, uint32_t *selectedGraphicsQueueFamilyIndex,
     uint32_t *selectedPresentQueueFamilyIndex) {
   uint32_t index;
   uint32_t queueFamilyPropertiesCount;
   VkQueueFamilyProperties *queueFamilyProperties;
+  IvyStackMemoryMarker scratchMarker;
+  IvyStackMemoryAllocator *scratchAllocator =
+      ivyGetThreadScratchMemoryAllocator();
 
   *selectedGraphicsQueueFamilyIndex = (uint32_t)-1;
   *selectedPresentQueueFamilyIndex = (uint32_t)-1;
 
-  queueFamilyProperties = ivyAllocateVulkanQueueFamilyProperties(allocator,
-      device, &queueFamilyPropertiesCount);
+  if (!scratchAllocator) {
+    return;
+  }
+
+  ivyGetStackMemoryMarker(scratchAllocator, &scratchMarker);
+
+  queueFamilyProperties = ivyAllocateVulkanQueueFamilyProperties(
+      scratchAllocator, device, &queueFamilyPropertiesCount);
   if (!queueFamilyProperties) {
     return;
   }
@@ -196,7 +206,50 @@ IVY_INTERNAL void ivyFindVulkanQueueFamilyIndices(
   }
 
 cleanup:
-  ivyFreeMemory(allocator, queueFamilyProperties);
+  ivyFreeStackMemoryToMarker(scratchAllocator, &scratchMarker);
+}
+
+// NOTE: prefers a family that can only transfer (usually a DMA engine), falls
+//       back to the graphics family when the device doesn't expose one
+IVY_INTERNAL uint32_t ivyFindVulkanTransferQueueFamilyIndex(
+    VkPhysicalDevice device, uint32_t graphicsQueueFamilyIndex) {
+  uint32_t index;
+  uint32_t selectedTransferQueueFamilyIndex = graphicsQueueFamilyIndex;
+  uint32_t queueFamilyPropertiesCount;
+  VkQueueFamilyProperties *queueFamilyProperties;
+  IvyStackMemoryMarker scratchMarker;
+  IvyStackMemoryAllocator *scratchAllocator =
+      ivyGetThreadScratchMemoryAllocator();
+
+  if (!scratchAllocator) {
+    return graphicsQueueFamilyIndex;
+  }
+
+  ivyGetStackMemoryMarker(scratchAllocator, &scratchMarker);
+
+  queueFamilyProperties = ivyAllocateVulkanQueueFamilyProperties(
+      scratchAllocator, device, &queueFamilyPropertiesCount);
+  if (!queueFamilyProperties) {
+    return graphicsQueueFamilyIndex;
+  }
+
+  for (index = 0; index < queueFamilyPropertiesCount; ++index) {
+    VkQueueFlags const flags = queueFamilyProperties[index].queueFlags;
+
+    if (!(flags & VK_QUEUE_TRANSFER_BIT)) {
+      continue;
+    }
+
+    if (flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) {
+      continue;
+    }
+
+    selectedTransferQueueFamilyIndex = index;
+    break;
+  }
+
+  ivyFreeStackMemoryToMarker(scratchAllocator, &scratchMarker);
+  return selectedTransferQueueFamilyIndex;
 }
 
 IVY_INTERNAL IvyCode ivyFindAvailableVulkanPhysicalDevices(
@@ -282,22 +335,32 @@ IVY_INTERNAL IvyBool ivyDoAllVulkanRequiredExtensionsExist(
 }
 
 IVY_INTERNAL IvyBool ivyDoesVulkanPhysicalDeviceSupportRequiredExtensions(
-    IvyAnyMemoryAllocator allocator, VkPhysicalDevice physicalDevice,
-    uint32_t requiredExtensionCount, char const *const *requiredExtensions) {
+    VkPhysicalDevice physicalDevice, uint32_t requiredExtensionCount,
+    char const *const *requiredExtensions) {
   IvyBool exist;
   uint32_t availableExtensionCount;
   VkExtensionProperties *availableExtensions;
+  IvyStackMemoryMarker scratchMarker;
+  IvyStackMemoryAllocator *scratchAllocator =
+      ivyGetThreadScratchMemoryAllocator();
+
+  if (!scratchAllocator) {
+    return 0;
+  }
 
-  availableExtensions = ivyAllocateVulkanExtensionsProperties(allocator,
-      physicalDevice, &availableExtensionCount);
+  ivyGetStackMemoryMarker(scratchAllocator, &scratchMarker);
+
+  availableExtensions = ivyAllocateVulkanExtensionsProperties(
+      scratchAllocator, physicalDevice, &availableExtensionCount);
   if (!availableExtensions || !availableExtensionCount) {
+    ivyFreeStackMemoryToMarker(scratchAllocator, &scratchMarker);
     return 0;
   }
 
   exist = ivyDoAllVulkanRequiredExtensionsExist(availableExtensionCount,
       availableExtensions, requiredExtensionCount, requiredExtensions);
 
-  ivyFreeMemory(allocator, availableExtensions);
+  ivyFreeStackMemoryToMarker(scratchAllocator, &scratchMarker);
 
   return exist;
 }
@@ -361,22 +424,32 @@ IVY_INTERNAL IvyBool ivyDoesVulkanFormatExist(uint32_t surfaceFormatCount,
 }
 
 IVY_INTERNAL IvyBool ivyDoesVulkanPhysicalDeviceSupportFormat(
-    IvyAnyMemoryAllocator allocator, VkPhysicalDevice device,
-    VkSurfaceKHR surface, VkFormat format, VkColorSpaceKHR colorSpace) {
+    VkPhysicalDevice device, VkSurfaceKHR surface, VkFormat format,
+    VkColorSpaceKHR colorSpace) {
   IvyBool exist;
   uint32_t surfaceFormatCount;
   VkSurfaceFormatKHR *surfaceFormats;
+  IvyStackMemoryMarker scratchMarker;
+  IvyStackMemoryAllocator *scratchAllocator =
+      ivyGetThreadScratchMemoryAllocator();
+
+  if (!scratchAllocator) {
+    return 0;
+  }
 
-  surfaceFormats = ivyAllocateVulkanSurfaceFormats(allocator, device, surface,
-      &surfaceFormatCount);
+  ivyGetStackMemoryMarker(scratchAllocator, &scratchMarker);
+
+  surfaceFormats = ivyAllocateVulkanSurfaceFormats(scratchAllocator, device,
+      surface, &surfaceFormatCount);
   if (!surfaceFormats || !surfaceFormatCount) {
+    ivyFreeStackMemoryToMarker(scratchAllocator, &scratchMarker);
     return 0;
   }
 
   exist = ivyDoesVulkanFormatExist(surfaceFormatCount, surfaceFormats, format,
       colorSpace);
 
-  ivyFreeMemory(allocator, surfaceFormats);
+  ivyFreeStackMemoryToMarker(scratchAllocator, &scratchMarker);
   return exist;
 }
 
@@ -417,22 +490,32 @@ IVY_INTERNAL VkPresentModeKHR *ivyAllocateVulkanPresentModes(
 }
 
 IVY_INTERNAL IvyBool ivyDoesVulkanPhysicalDeviceSupportPresentMode(
-    IvyAnyMemoryAllocator allocator, VkPhysicalDevice device,
-    VkSurfaceKHR surface, VkPresentModeKHR requiredPresentMode) {
+    VkPhysicalDevice device, VkSurfaceKHR surface,
+    VkPresentModeKHR requiredPresentMode) {
   IvyBool exist;
   uint32_t presentModeCount;
   VkPresentModeKHR *presentModes;
+  IvyStackMemoryMarker scratchMarker;
+  IvyStackMemoryAllocator *scratchAllocator =
+      ivyGetThreadScratchMemoryAllocator();
+
+  if (!scratchAllocator) {
+    return 0;
+  }
 
-  presentModes = ivyAllocateVulkanPresentModes(allocator, device, surface,
-      &presentModeCount);
+  ivyGetStackMemoryMarker(scratchAllocator, &scratchMarker);
+
+  presentModes = ivyAllocateVulkanPresentModes(scratchAllocator, device,
+      surface, &presentModeCount);
   if (!presentModes || !presentModeCount) {
+    ivyFreeStackMemoryToMarker(scratchAllocator, &scratchMarker);
     return 0;
   }
 
   exist = ivyDoesVulkanPresentModeExist(presentModeCount, presentModes,
       requiredPresentMode);
 
-  ivyFreeMemory(allocator, presentModes);
+  ivyFreeStackMemoryToMarker(scratchAllocator, &scratchMarker);
   return exist;
 }
 
@@ -444,6 +527,30 @@ IVY_INTERNAL IvyBool ivyDoesVulkanPhysicalDeviceSupportSampleCount(
          properties.limits.framebufferDepthSampleCounts & samples;
 }
 
+IVY_INTERNAL IvyBool ivyDoesVulkanPhysicalDeviceSupportTimelineSemaphores(
+    VkPhysicalDevice device) {
+  VkPhysicalDeviceProperties properties;
+  VkPhysicalDeviceFeatures2 features;
+  VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures;
+
+  vkGetPhysicalDeviceProperties(device, &properties);
+  if (properties.apiVersion < VK_MAKE_VERSION(1, 2, 0)) {
+    return 0;
+  }
+
+  timelineSemaphoreFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+  timelineSemaphoreFeatures.pNext = NULL;
+  timelineSemaphoreFeatures.timelineSemaphore = VK_FALSE;
+
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  features.pNext = &timelineSemaphoreFeatures;
+
+  vkGetPhysicalDeviceFeatures2(device, &features);
+
+  return timelineSemaphoreFeatures.timelineSemaphore;
+}
+
 IVY_INTERNAL char const *const requiredVulkanExtensions[] = {
     VK_KHR_SWAPCHAIN_EXTENSION_NAME
 #if __APPLE__
@@ -454,8 +561,7 @@ IVY_INTERNAL char const *const requiredVulkanExtensions[] = {
 };
 
 IVY_INTERNAL VkPhysicalDevice ivySelectVulkanPhysicalDevice(
-    IvyAnyMemoryAllocator allocator, VkSurfaceKHR surface,
-    uint32_t availablePhysicalDeviceCount,
+    VkSurfaceKHR surface, uint32_t availablePhysicalDeviceCount,
     VkPhysicalDevice *availablePhysicalDevices, VkFormat requestedFormat,
     VkColorSpaceKHR requestedColorSpace, VkPresentModeKHR requestedPresentMode,
     VkSampleCountFlagBits requestedSampleCount,
@@ -465,13 +571,13 @@ IVY_INTERNAL VkPhysicalDevice ivySelectVulkanPhysicalDevice(
   for (index = 0; index < availablePhysicalDeviceCount; ++index) {
     VkPhysicalDevice device = availablePhysicalDevices[index];
 
-    if (!ivyDoesVulkanPhysicalDeviceSupportRequiredExtensions(allocator,
-            device, IVY_ARRAY_LENGTH(requiredVulkanExtensions),
+    if (!ivyDoesVulkanPhysicalDeviceSupportRequiredExtensions(device,
+            IVY_ARRAY_LENGTH(requiredVulkanExtensions),
             requiredVulkanExtensions)) {
       continue;
     }
 
-    ivyFindVulkanQueueFamilyIndices(allocator, device, surface,
+    ivyFindVulkanQueueFamilyIndices(device, surface,
         selectedGraphicsQueueFamilyIndex, selectedPresentQueueFamilyIndex);
     if (!ivyAreVulkanQueueFamilyIndicesValid(*selectedGraphicsQueueFamilyIndex,
             *selectedPresentQueueFamilyIndex)) {
@@ -483,13 +589,13 @@ IVY_INTERNAL VkPhysicalDevice ivySelectVulkanPhysicalDevice(
       continue;
     }
 
-    if (!ivyDoesVulkanPhysicalDeviceSupportFormat(allocator, device, surface,
+    if (!ivyDoesVulkanPhysicalDeviceSupportFormat(device, surface,
             requestedFormat, requestedColorSpace)) {
       continue;
     }
 
-    if (!ivyDoesVulkanPhysicalDeviceSupportPresentMode(allocator, device,
-            surface, requestedPresentMode)) {
+    if (!ivyDoesVulkanPhysicalDeviceSupportPresentMode(device, surface,
+            requestedPresentMode)) {
       continue;
     }
 
@@ -498,28 +604,38 @@ IVY_INTERNAL VkPhysicalDevice ivySelectVulkanPhysicalDevice(
       continue;
     }
 
+    if (!ivyDoesVulkanPhysicalDeviceSupportTimelineSemaphores(device)) {
+      continue;
+    }
+
     return device;
   }
 
   return VK_NULL_HANDLE;
 }
 
-IVY_INTERNAL VkResult ivyCreateVulkanDevice(IvyAnyMemoryAllocator allocator,
-    VkSurfaceKHR surface, uint32_t availablePhysicalDeviceCount,
+IVY_INTERNAL VkResult ivyCreateVulkanDevice(VkSurfaceKHR surface,
+    uint32_t availablePhysicalDeviceCount,
     VkPhysicalDevice *availablePhysicalDevices, VkFormat requiredFormat,
     VkColorSpaceKHR requiredColorSpace, VkPresentModeKHR requiredPresentMode,
     VkSampleCountFlagBits requiredSampleCount,
     VkPhysicalDevice *selectedPhysicalDevice, VkFormat *selectedDepthFormat,
     uint32_t *selectedGraphicsQueueFamilyIndex,
-    uint32_t *selectedPresentQueueFamilyIndex, VkQueue *createdGraphicsQueue,
-    VkQueue *createdPresentQueue, VkDevice *device) {
+    uint32_t *selectedPresentQueueFamilyIndex,
+    uint32_t *selectedTransferQueueFamilyIndex, VkQueue *createdGraphicsQueue,
+    VkQueue *createdPresentQueue, VkQueue *createdTransferQueue,
+    VkAllocationCallbacks const *allocationCallbacks, VkDevice *device) {
   float const queuePriority = 1.0F;
+  uint32_t index;
+  uint32_t queueCreateInfoCount;
+  uint32_t queueFamilyIndices[3];
   VkResult vulkanResult;
   VkPhysicalDeviceFeatures physicalDeviceFeatures;
-  VkDeviceQueueCreateInfo queueCreateInfos[2];
+  VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures;
+  VkDeviceQueueCreateInfo queueCreateInfos[3];
   VkDeviceCreateInfo deviceCreateInfo;
 
-  *selectedPhysicalDevice = ivySelectVulkanPhysicalDevice(allocator, surface,
+  *selectedPhysicalDevice = ivySelectVulkanPhysicalDevice(surface,
       availablePhysicalDeviceCount, availablePhysicalDevices, requiredFormat,
       requiredColorSpace, requiredPresentMode, requiredSampleCount,
       selectedGraphicsQueueFamilyIndex, selectedPresentQueueFamilyIndex,
@@ -529,31 +645,50 @@ IVY_INTERNAL VkResult ivyCreateVulkanDevice(IvyAnyMemoryAllocator allocator,
     return VK_ERROR_UNKNOWN;
   }
 
-  queueCreateInfos[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-  queueCreateInfos[0].pNext = NULL;
-  queueCreateInfos[0].flags = 0;
-  queueCreateInfos[0].queueFamilyIndex = *selectedGraphicsQueueFamilyIndex;
-  queueCreateInfos[0].queueCount = 1;
-  queueCreateInfos[0].pQueuePriorities = &queuePriority;
+  *selectedTransferQueueFamilyIndex = ivyFindVulkanTransferQueueFamilyIndex(
+      *selectedPhysicalDevice, *selectedGraphicsQueueFamilyIndex);
 
-  queueCreateInfos[1].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-  queueCreateInfos[1].pNext = NULL;
-  queueCreateInfos[1].flags = 0;
-  queueCreateInfos[1].queueFamilyIndex = *selectedPresentQueueFamilyIndex;
-  queueCreateInfos[1].queueCount = 1;
-  queueCreateInfos[1].pQueuePriorities = &queuePriority;
+  queueFamilyIndices[0] = *selectedGraphicsQueueFamilyIndex;
+  queueFamilyIndices[1] = *selectedPresentQueueFamilyIndex;
+  queueFamilyIndices[2] = *selectedTransferQueueFamilyIndex;
+
+  // NOTE: one create info per distinct family
+  queueCreateInfoCount = 0;
+  for (index = 0; index < IVY_ARRAY_LENGTH(queueFamilyIndices); ++index) {
+    uint32_t previousIndex;
+    VkDeviceQueueCreateInfo *queueCreateInfo;
+
+    for (previousIndex = 0; previousIndex < index; ++previousIndex) {
+      if (queueFamilyIndices[previousIndex] == queueFamilyIndices[index]) {
+        break;
+      }
+    }
+
+    if (previousIndex != index) {
+      continue;
+    }
+
+    queueCreateInfo = &queueCreateInfos[queueCreateInfoCount++];
+    queueCreateInfo->sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queueCreateInfo->pNext = NULL;
+    queueCreateInfo->flags = 0;
+    queueCreateInfo->queueFamilyIndex = queueFamilyIndices[index];
+    queueCreateInfo->queueCount = 1;
+    queueCreateInfo->pQueuePriorities = &queuePriority;
+  }
 
   vkGetPhysicalDeviceFeatures(*selectedPhysicalDevice,
       &physicalDeviceFeatures);
 
+  timelineSemaphoreFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+  timelineSemaphoreFeatures.pNext = NULL;
+  timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+
   deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-  deviceCreateInfo.pNext = NULL;
+  deviceCreateInfo.pNext = &timelineSemaphoreFeatures;
   deviceCreateInfo.flags = 0;
-  if (*selectedGraphicsQueueFamilyIndex == *selectedPresentQueueFamilyIndex) {
-    deviceCreateInfo.queueCreateInfoCount = 1;
-  } else {
-    deviceCreateInfo.queueCreateInfoCount = 2;
-  }
+  deviceCreateInfo.queueCreateInfoCount = queueCreateInfoCount;
   deviceCreateInfo.pQueueCreateInfos = queueCreateInfos;
   deviceCreateInfo.enabledLayerCount = 0;      /* deprecated */
   deviceCreateInfo.ppEnabledLayerNames = NULL; /* deprecated */
@@ -562,8 +697,8 @@ IVY_INTERNAL VkResult ivyCreateVulkanDevice(IvyAnyMemoryAllocator allocator,
   deviceCreateInfo.ppEnabledExtensionNames = requiredVulkanExtensions;
   deviceCreateInfo.pEnabledFeatures = &physicalDeviceFeatures;
 
-  vulkanResult =
-      vkCreateDevice(*selectedPhysicalDevice, &deviceCreateInfo, NULL, device);
+  vulkanResult = vkCreateDevice(*selectedPhysicalDevice, &deviceCreateInfo,
+      allocationCallbacks, device);
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
     return vulkanResult;
@@ -573,12 +708,15 @@ IVY_INTERNAL VkResult ivyCreateVulkanDevice(IvyAnyMemoryAllocator allocator,
       createdGraphicsQueue);
   vkGetDeviceQueue(*device, *selectedPresentQueueFamilyIndex, 0,
       createdPresentQueue);
+  vkGetDeviceQueue(*device, *selectedTransferQueueFamilyIndex, 0,
+      createdTransferQueue);
 
   return vulkanResult;
 }
 
 IVY_INTERNAL VkResult ivyCreateVulkanTransientCommandPool(VkDevice device,
-    uint32_t family, VkCommandPool *commandPool) {
+    VkAllocationCallbacks const *allocationCallbacks, uint32_t family,
+    VkCommandPool *commandPool) {
   VkCommandPoolCreateInfo commandPoolCreateInfo;
 
   commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -586,56 +724,13 @@ IVY_INTERNAL VkResult ivyCreateVulkanTransientCommandPool(VkDevice device,
   commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
   commandPoolCreateInfo.queueFamilyIndex = family;
 
-  return vkCreateCommandPool(device, &commandPoolCreateInfo, NULL,
-      commandPool);
-}
-
-#define IVY_MAX_DESCRIPTOR_POOL_TYPES 7
-#define IVY_DEFAULT_DESCRIPTOR_COUNT 256
-
-IVY_INTERNAL VkResult ivyCreateVulkanGlobalDescriptorPool(VkDevice device,
-    VkDescriptorPool *descriptorPool) {
-  VkDescriptorPoolCreateInfo descriptorPoolCreateInfo;
-  VkDescriptorPoolSize descriptorPoolSizes[IVY_MAX_DESCRIPTOR_POOL_TYPES];
-
-  descriptorPoolSizes[0].descriptorCount = IVY_DEFAULT_DESCRIPTOR_COUNT;
-  descriptorPoolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-
-  descriptorPoolSizes[1].descriptorCount = IVY_DEFAULT_DESCRIPTOR_COUNT;
-  descriptorPoolSizes[1].type = VK_DESCRIPTOR_TYPE_SAMPLER;
-
-  descriptorPoolSizes[2].descriptorCount = IVY_DEFAULT_DESCRIPTOR_COUNT;
-  descriptorPoolSizes[2].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-
-  descriptorPoolSizes[3].descriptorCount = IVY_DEFAULT_DESCRIPTOR_COUNT;
-  descriptorPoolSizes[3].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-
-  descriptorPoolSizes[4].descriptorCount = IVY_DEFAULT_DESCRIPTOR_COUNT;
-  descriptorPoolSizes[4].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-
-  descriptorPoolSizes[5].descriptorCount = IVY_DEFAULT_DESCRIPTOR_COUNT;
-  descriptorPoolSizes[5].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-
-  descriptorPoolSizes[6].descriptorCount = IVY_DEFAULT_DESCRIPTOR_COUNT;
-  descriptorPoolSizes[6].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-
-  descriptorPoolCreateInfo.sType =
-      VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-  descriptorPoolCreateInfo.pNext = NULL;
-  descriptorPoolCreateInfo.flags =
-      VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-  descriptorPoolCreateInfo.maxSets =
-      IVY_DEFAULT_DESCRIPTOR_COUNT * IVY_ARRAY_LENGTH(descriptorPoolSizes);
-  descriptorPoolCreateInfo.poolSizeCount =
-      IVY_ARRAY_LENGTH(descriptorPoolSizes);
-  descriptorPoolCreateInfo.pPoolSizes = descriptorPoolSizes;
-
-  return vkCreateDescriptorPool(device, &descriptorPoolCreateInfo, NULL,
-      descriptorPool);
+  return vkCreateCommandPool(device, &commandPoolCreateInfo,
+      allocationCallbacks, commandPool);
 }
 
 IVY_INTERNAL VkResult ivyCreateVulkanSwapchainFramebuffer(VkDevice device,
-    int32_t width, int32_t height, VkRenderPass mainRenderPass,
+    VkAllocationCallbacks const *allocationCallbacks, int32_t width,
+    int32_t height, VkRenderPass mainRenderPass,
     VkImageView swapchainImageView, VkImageView colorAttachmentImageView,
     VkImageView depthAttachmentImageView, VkFramebuffer *framebuffer) {
   VkFramebufferCreateInfo framebufferCreateInfo;
@@ -655,11 +750,12 @@ IVY_INTERNAL VkResult ivyCreateVulkanSwapchainFramebuffer(VkDevice device,
   framebufferCreateInfo.height = height;
   framebufferCreateInfo.layers = 1;
 
-  return vkCreateFramebuffer(device, &framebufferCreateInfo, NULL,
-      framebuffer);
+  return vkCreateFramebuffer(device, &framebufferCreateInfo,
+      allocationCallbacks, framebuffer);
 }
 
 IVY_INTERNAL VkResult ivyCreateVulkanCommandPool(VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks,
     uint32_t graphicsQueueFamilyIndex, VkCommandPoolCreateFlagBits flags,
     VkCommandPool *commandPool) {
   VkCommandPoolCreateInfo commandPoolCreateInfo;
@@ -669,30 +765,31 @@ IVY_INTERNAL VkResult ivyCreateVulkanCommandPool(VkDevice device,
   commandPoolCreateInfo.flags = flags;
   commandPoolCreateInfo.queueFamilyIndex = graphicsQueueFamilyIndex;
 
-  return vkCreateCommandPool(device, &commandPoolCreateInfo, NULL,
-      commandPool);
+  return vkCreateCommandPool(device, &commandPoolCreateInfo,
+      allocationCallbacks, commandPool);
 }
 
 IVY_INTERNAL VkResult ivyCreateVulkanSignaledFence(VkDevice device,
-    VkFence *fence) {
+    VkAllocationCallbacks const *allocationCallbacks, VkFence *fence) {
   VkFenceCreateInfo fenceCreateInfo;
 
   fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
   fenceCreateInfo.pNext = NULL;
   fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-  return vkCreateFence(device, &fenceCreateInfo, NULL, fence);
+  return vkCreateFence(device, &fenceCreateInfo, allocationCallbacks, fence);
 }
 
 IVY_INTERNAL VkResult ivyCreateVulkanSemaphore(VkDevice device,
-    VkSemaphore *semaphore) {
+    VkAllocationCallbacks const *allocationCallbacks, VkSemaphore *semaphore) {
   VkSemaphoreCreateInfo semaphoreCreateInfo;
 
   semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
   semaphoreCreateInfo.pNext = NULL;
   semaphoreCreateInfo.flags = 0;
 
-  return vkCreateSemaphore(device, &semaphoreCreateInfo, NULL, semaphore);
+  return vkCreateSemaphore(device, &semaphoreCreateInfo, allocationCallbacks,
+      semaphore);
 }
 
 IVY_INTERNAL VkImage *ivyAllocateVulkanSwapchainImages(
@@ -726,9 +823,10 @@ IVY_INTERNAL VkImage *ivyAllocateVulkanSwapchainImages(
 IVY_INTERNAL VkResult ivyCreateVulkanSwapchain(VkPhysicalDevice physicalDevice,
     VkSurfaceKHR surface, VkFormat surfaceFormat,
     VkColorSpaceKHR surfaceColorSpace, VkPresentModeKHR presentMode,
-    VkDevice device, uint32_t graphicsQueueFamilyIndex,
-    uint32_t presentQueueFamilyIndex, uint32_t minSwapchainImageCount,
-    int32_t width, int32_t height, VkSwapchainKHR *swapchain) {
+    VkDevice device, VkAllocationCallbacks const *allocationCallbacks,
+    uint32_t graphicsQueueFamilyIndex, uint32_t presentQueueFamilyIndex,
+    uint32_t minSwapchainImageCount, int32_t width, int32_t height,
+    VkSwapchainKHR *swapchain) {
   VkSurfaceCapabilitiesKHR surfaceCapabilities;
   VkSwapchainCreateInfoKHR swapchainCreateInfo;
   uint32_t queueFamilyIndices[2];
@@ -766,14 +864,53 @@ IVY_INTERNAL VkResult ivyCreateVulkanSwapchain(VkPhysicalDevice physicalDevice,
     swapchainCreateInfo.pQueueFamilyIndices = queueFamilyIndices;
   }
 
-  return vkCreateSwapchainKHR(device, &swapchainCreateInfo, NULL, swapchain);
+  return vkCreateSwapchainKHR(device, &swapchainCreateInfo,
+      allocationCallbacks, swapchain);
 }
 
-IVY_INTERNAL void ivyDestroyGraphicsFrames(IvyAnyMemoryAllocator allocator,
+IVY_INTERNAL void ivyDestroyGraphicsRenderBufferChunk(
     IvyGraphicsDevice *device,
     IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator,
-    VkDescriptorPool descriptorPool, uint32_t frameCount,
+    IvyGraphicsRenderBufferChunk *chunk) {
+  ivyFreeGraphicsMemory(device, graphicsMemoryAllocator, &chunk->memory);
+
+  if (chunk->buffer) {
+    vkDestroyBuffer(device->logicalDevice, chunk->buffer,
+        device->allocationCallbacks);
+    chunk->buffer = VK_NULL_HANDLE;
+  }
+
+  // NOTE: descriptor sets belong to the frame descriptor pools
+  chunk->descriptorSet = VK_NULL_HANDLE;
+  chunk->size = 0;
+  chunk->offset = 0;
+}
+
+IVY_INTERNAL void ivyDestroyGraphicsTemporaryBufferPool(
+    IvyAnyMemoryAllocator allocator, IvyGraphicsDevice *device,
+    IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator,
+    IvyGraphicsTemporaryBufferPool *pool) {
+  uint32_t index;
+
+  for (index = 0; index < pool->garbageChunkCount; ++index) {
+    ivyDestroyGraphicsRenderBufferChunk(device, graphicsMemoryAllocator,
+        &pool->garbageChunks[index]);
+  }
+
+  ivyFreeMemory(allocator, pool->garbageChunks);
+  pool->garbageChunks = NULL;
+  pool->garbageChunkCount = 0;
+
+  ivyDestroyGraphicsRenderBufferChunk(device, graphicsMemoryAllocator,
+      &pool->currentChunk);
+}
+
+IVY_INTERNAL void ivyDestroyGraphicsFrames(IvyAnyMemoryAllocator allocator,
+    IvyGraphicsDevice *device,
+    IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator, uint32_t frameCount,
     IvyGraphicsFrame *frames) {
+  int usage;
+  uint32_t index;
   uint32_t frameIndex;
 
   if (!frames) {
@@ -783,59 +920,46 @@ IVY_INTERNAL void ivyDestroyGraphicsFrames(IvyAnyMemoryAllocator allocator,
   for (frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
     IvyGraphicsFrame *frame = &frames[frameIndex];
 
-    if (frame->garbageChunks) {
-      uint32_t garbageChunkIndex;
-      for (garbageChunkIndex = 0; garbageChunkIndex < frame->garbageChunkCount;
-           ++garbageChunkIndex) {
-        IvyGraphicsRenderBufferChunk *chunk =
-            &frame->garbageChunks[garbageChunkIndex];
-
-        ivyFreeGraphicsMemory(device, graphicsMemoryAllocator, &chunk->memory);
-
-        if (chunk->descriptorSet) {
-          vkFreeDescriptorSets(device->logicalDevice, descriptorPool, 1,
-              &chunk->descriptorSet);
-          chunk->descriptorSet = VK_NULL_HANDLE;
-        }
-
-        if (chunk->buffer) {
-          vkDestroyBuffer(device->logicalDevice, chunk->buffer, NULL);
-          chunk->buffer = VK_NULL_HANDLE;
-        }
-      }
-
-      ivyFreeMemory(allocator, frame->garbageChunks);
-    }
-
-    ivyFreeGraphicsMemory(device, graphicsMemoryAllocator,
-        &frame->currentChunk.memory);
-
-    if (frame->currentChunk.descriptorSet) {
-      vkFreeDescriptorSets(device->logicalDevice, descriptorPool, 1,
-          &frame->currentChunk.descriptorSet);
-      frame->currentChunk.descriptorSet = VK_NULL_HANDLE;
+    for (usage = 0; usage < IVY_MAX_TEMPORARY_BUFFER_USAGES; ++usage) {
+      ivyDestroyGraphicsTemporaryBufferPool(allocator, device,
+          graphicsMemoryAllocator, &frame->temporaryBufferPools[usage]);
     }
 
-    if (frame->currentChunk.buffer) {
-      vkDestroyBuffer(device->logicalDevice, frame->currentChunk.buffer, NULL);
-      frame->currentChunk.buffer = VK_NULL_HANDLE;
-    }
+    // NOTE: the descriptor sets of the chunks go away with the pools
+    ivyDestroyGraphicsDescriptorAllocator(device->logicalDevice,
+        &frame->descriptorAllocator);
 
     if (frame->inFlightFence) {
-      vkDestroyFence(device->logicalDevice, frame->inFlightFence, NULL);
+      vkDestroyFence(device->logicalDevice, frame->inFlightFence,
+          device->allocationCallbacks);
       frame->inFlightFence = NULL;
     }
 
     if (frame->framebuffer) {
-      vkDestroyFramebuffer(device->logicalDevice, frame->framebuffer, NULL);
+      vkDestroyFramebuffer(device->logicalDevice, frame->framebuffer,
+          device->allocationCallbacks);
       frame->framebuffer = VK_NULL_HANDLE;
     }
 
     if (frame->imageView) {
-      vkDestroyImageView(device->logicalDevice, frame->imageView, NULL);
+      vkDestroyImageView(device->logicalDevice, frame->imageView,
+          device->allocationCallbacks);
       frame->imageView = VK_NULL_HANDLE;
     }
 
+    for (index = 0; index < IVY_MAX_GRAPHICS_RECORDING_CONTEXTS; ++index) {
+      IvyGraphicsRecordingContext *recordingContext =
+          &frame->recordingContexts[index];
+
+      // NOTE: the command buffer goes away with the pool
+      if (recordingContext->commandPool) {
+        vkDestroyCommandPool(device->logicalDevice,
+            recordingContext->commandPool, device->allocationCallbacks);
+        recordingContext->commandPool = VK_NULL_HANDLE;
+        recordingContext->commandBuffer = VK_NULL_HANDLE;
+      }
+    }
+
     if (frame->commandBuffer) {
       vkFreeCommandBuffers(device->logicalDevice, frame->commandPool, 1,
           &frame->commandBuffer);
@@ -843,7 +967,8 @@ IVY_INTERNAL void ivyDestroyGraphicsFrames(IvyAnyMemoryAllocator allocator,
     }
 
     if (frame->commandPool) {
-      vkDestroyCommandPool(device->logicalDevice, frame->commandPool, NULL);
+      vkDestroyCommandPool(device->logicalDevice, frame->commandPool,
+          device->allocationCallbacks);
       frame->commandPool = VK_NULL_HANDLE;
     }
   }
@@ -851,10 +976,41 @@ IVY_INTERNAL void ivyDestroyGraphicsFrames(IvyAnyMemoryAllocator allocator,
   ivyFreeMemory(allocator, frames);
 }
 
+// NOTE: done up front on the thread creating the frames, so workers never
+//       create Vulkan objects
+IVY_INTERNAL IvyCode ivyCreateGraphicsRecordingContexts(
+    IvyGraphicsDevice *device, IvyGraphicsFrame *frame) {
+  uint32_t index;
+
+  for (index = 0; index < IVY_MAX_GRAPHICS_RECORDING_CONTEXTS; ++index) {
+    VkResult vulkanResult;
+    IvyGraphicsRecordingContext *recordingContext =
+        &frame->recordingContexts[index];
+
+    vulkanResult = ivyCreateVulkanCommandPool(device->logicalDevice,
+        device->allocationCallbacks, device->graphicsQueueFamilyIndex, 0,
+        &recordingContext->commandPool);
+    IVY_ASSERT(!vulkanResult);
+    if (vulkanResult) {
+      return ivyVulkanResultAsIvyCode(vulkanResult);
+    }
+
+    vulkanResult = ivyAllocateVulkanSecondaryCommandBuffer(
+        device->logicalDevice, recordingContext->commandPool,
+        &recordingContext->commandBuffer);
+    IVY_ASSERT(!vulkanResult);
+    if (vulkanResult) {
+      return ivyVulkanResultAsIvyCode(vulkanResult);
+    }
+  }
+
+  return IVY_OK;
+}
+
 IVY_INTERNAL IvyCode ivyCreateGraphicsFrames(IvyAnyMemoryAllocator allocator,
     IvyGraphicsDevice *device,
     IvyAnyGraphicsMemoryAllocator graphicsMemoryAllocator,
-    VkDescriptorPool descriptorPool, VkRenderPass mainRenderPass,
+    VkRenderPass mainRenderPass,
     uint32_t swapchainImageCount, VkImage *swapchainImages,
     VkFormat surfaceFormat, int32_t width, int32_t height,
     VkImageView colorAttachmentImageView, VkImageView depthAttachmentImageView,
@@ -869,14 +1025,15 @@ IVY_INTERNAL IvyCode ivyCreateGraphicsFrames(IvyAnyMemoryAllocator allocator,
     return IVY_ERROR_NO_MEMORY;
   }
 
-  IVY_MEMSET(currentFrames, 0, sizeof(*currentFrames));
+  IVY_MEMSET(currentFrames, 0, swapchainImageCount * sizeof(*currentFrames));
 
   for (frameIndex = 0; frameIndex < swapchainImageCount; ++frameIndex) {
     VkResult vulkanResult;
     IvyGraphicsFrame *frame = &currentFrames[frameIndex];
 
     vulkanResult = ivyCreateVulkanCommandPool(device->logicalDevice,
-        device->graphicsQueueFamilyIndex, 0, &frame->commandPool);
+        device->allocationCallbacks, device->graphicsQueueFamilyIndex, 0,
+        &frame->commandPool);
     IVY_ASSERT(!vulkanResult);
     if (vulkanResult) {
       ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
@@ -891,9 +1048,15 @@ IVY_INTERNAL IvyCode ivyCreateGraphicsFrames(IvyAnyMemoryAllocator allocator,
       goto error;
     }
 
+    ivyCode = ivyCreateGraphicsRecordingContexts(device, frame);
+    IVY_ASSERT(!ivyCode);
+    if (ivyCode) {
+      goto error;
+    }
+
     vulkanResult = ivyCreateVulkanImageView(device->logicalDevice,
-        swapchainImages[frameIndex], VK_IMAGE_ASPECT_COLOR_BIT, surfaceFormat,
-        &frame->imageView);
+        device->allocationCallbacks, swapchainImages[frameIndex],
+        VK_IMAGE_ASPECT_COLOR_BIT, surfaceFormat, &frame->imageView);
     IVY_ASSERT(!vulkanResult);
     if (vulkanResult) {
       ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
@@ -901,8 +1064,9 @@ IVY_INTERNAL IvyCode ivyCreateGraphicsFrames(IvyAnyMemoryAllocator allocator,
     }
 
     vulkanResult =
-        ivyCreateVulkanSwapchainFramebuffer(device->logicalDevice, width,
-            height, mainRenderPass, frame->imageView, colorAttachmentImageView,
+        ivyCreateVulkanSwapchainFramebuffer(device->logicalDevice,
+            device->allocationCallbacks, width, height, mainRenderPass,
+            frame->imageView, colorAttachmentImageView,
             depthAttachmentImageView, &frame->framebuffer);
     IVY_ASSERT(!vulkanResult);
     if (vulkanResult) {
@@ -911,19 +1075,20 @@ IVY_INTERNAL IvyCode ivyCreateGraphicsFrames(IvyAnyMemoryAllocator allocator,
     }
 
     vulkanResult = ivyCreateVulkanSignaledFence(device->logicalDevice,
-        &frame->inFlightFence);
+        device->allocationCallbacks, &frame->inFlightFence);
     IVY_ASSERT(!vulkanResult);
     if (vulkanResult) {
       ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
       goto error;
     }
 
-    frame->currentChunk.buffer = VK_NULL_HANDLE;
-    frame->currentChunk.descriptorSet = VK_NULL_HANDLE;
-    frame->currentChunk.memory.memory = VK_NULL_HANDLE;
-
-    frame->garbageChunkCount = 0;
-    frame->garbageChunks = NULL;
+    ivyCode = ivyCreateGraphicsDescriptorAllocator(allocator,
+        device->logicalDevice, device->allocationCallbacks, 0,
+        IVY_DEFAULT_DESCRIPTOR_SETS_PER_POOL, &frame->descriptorAllocator);
+    IVY_ASSERT(!ivyCode);
+    if (ivyCode) {
+      goto error;
+    }
   }
 
   *frames = currentFrames;
@@ -932,7 +1097,7 @@ IVY_INTERNAL IvyCode ivyCreateGraphicsFrames(IvyAnyMemoryAllocator allocator,
 
 error:
   ivyDestroyGraphicsFrames(allocator, device, graphicsMemoryAllocator,
-      descriptorPool, swapchainImageCount, currentFrames);
+      swapchainImageCount, currentFrames);
   *frames = NULL;
   return ivyCode;
 }
@@ -950,13 +1115,14 @@ IVY_INTERNAL void ivyDestroyGraphicsRenderSemaphores(
     IvyGraphicsRenderSemaphores *semaphore = &semaphores[index];
     if (semaphore->swapchainImageAvailableSemaphore) {
       vkDestroySemaphore(device->logicalDevice,
-          semaphore->swapchainImageAvailableSemaphore, NULL);
+          semaphore->swapchainImageAvailableSemaphore,
+          device->allocationCallbacks);
       semaphore->swapchainImageAvailableSemaphore = VK_NULL_HANDLE;
     }
 
     if (semaphore->renderDoneSemaphore) {
       vkDestroySemaphore(device->logicalDevice, semaphore->renderDoneSemaphore,
-          NULL);
+          device->allocationCallbacks);
       semaphore->renderDoneSemaphore = VK_NULL_HANDLE;
     }
   }
@@ -981,7 +1147,7 @@ IVY_INTERNAL IvyCode ivyCreateGraphicsRenderSemaphores(
     VkResult vulkanResult;
     IvyGraphicsRenderSemaphores *semaphore = &currentSemaphores[index];
     vulkanResult = ivyCreateVulkanSemaphore(device->logicalDevice,
-        &semaphore->renderDoneSemaphore);
+        device->allocationCallbacks, &semaphore->renderDoneSemaphore);
     IVY_ASSERT(!vulkanResult);
     if (vulkanResult) {
       ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
@@ -989,6 +1155,7 @@ IVY_INTERNAL IvyCode ivyCreateGraphicsRenderSemaphores(
     }
 
     vulkanResult = ivyCreateVulkanSemaphore(device->logicalDevice,
+        device->allocationCallbacks,
         &semaphore->swapchainImageAvailableSemaphore);
     IVY_ASSERT(!vulkanResult);
     if (vulkanResult) {
@@ -1009,8 +1176,9 @@ error:
 }
 
 IVY_INTERNAL VkResult ivyCreateVulkanMainRenderPass(VkDevice device,
-    VkFormat colorFormat, VkFormat depthFormat,
-    VkSampleCountFlagBits sampleCount, VkRenderPass *mainRenderPass) {
+    VkAllocationCallbacks const *allocationCallbacks, VkFormat colorFormat,
+    VkFormat depthFormat, VkSampleCountFlagBits sampleCount,
+    VkRenderPass *mainRenderPass) {
   VkAttachmentReference colorAttachmentReference;
   VkAttachmentReference depthAttachmentReference;
   VkAttachmentReference resolveAttachmentReference;
@@ -1103,12 +1271,13 @@ IVY_INTERNAL VkResult ivyCreateVulkanMainRenderPass(VkDevice device,
   renderPassCreateInfo.dependencyCount = 1;
   renderPassCreateInfo.pDependencies = &subpassDependency;
 
-  return vkCreateRenderPass(device, &renderPassCreateInfo, NULL,
-      mainRenderPass);
+  return vkCreateRenderPass(device, &renderPassCreateInfo,
+      allocationCallbacks, mainRenderPass);
 }
 
 IVY_INTERNAL VkResult ivyCreateVulkanUniformDescriptorSetLayout(
-    VkDevice device, VkDescriptorSetLayout *descriptorSetLayout) {
+    VkDevice device, VkAllocationCallbacks const *allocationCallbacks,
+    VkDescriptorSetLayout *descriptorSetLayout) {
   VkDescriptorSetLayoutBinding descriptorSetLayoutBinding;
   VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo;
 
@@ -1133,7 +1302,8 @@ IVY_INTERNAL VkResult ivyCreateVulkanUniformDescriptorSetLayout(
 }
 
 IVY_INTERNAL VkResult ivyCreateVulkanTextureDescriptorSetLayout(
-    VkDevice device, VkDescriptorSetLayout *descriptorSetLayout) {
+    VkDevice device, VkAllocationCallbacks const *allocationCallbacks,
+    VkDescriptorSetLayout *descriptorSetLayout) {
   VkDescriptorSetLayoutBinding descriptorSetLayoutBinding;
   VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo;
 
@@ -1157,15 +1327,21 @@ IVY_INTERNAL VkResult ivyCreateVulkanTextureDescriptorSetLayout(
 }
 
 IVY_INTERNAL VkResult ivyCreateVulkanMainPipelineLayout(VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks,
     VkDescriptorSetLayout uniformDescriptorSetLayout,
     VkDescriptorSetLayout textureDescriptorSetLayout,
     VkPipelineLayout *pipelineLayout) {
+  VkPushConstantRange pushConstantRange;
   VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo;
   VkDescriptorSetLayout descriptorSetLayouts[2];
 
   descriptorSetLayouts[0] = uniformDescriptorSetLayout;
   descriptorSetLayouts[1] = textureDescriptorSetLayout;
 
+  pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+  pushConstantRange.offset = 0;
+  pushConstantRange.size = sizeof(IvyGraphicsProgramPushConstants);
+
   pipelineLayoutCreateInfo.sType =
       VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
   pipelineLayoutCreateInfo.pNext = NULL;
@@ -1173,11 +1349,11 @@ IVY_INTERNAL VkResult ivyCreateVulkanMainPipelineLayout(VkDevice device,
   pipelineLayoutCreateInfo.setLayoutCount =
       IVY_ARRAY_LENGTH(descriptorSetLayouts);
   pipelineLayoutCreateInfo.pSetLayouts = descriptorSetLayouts;
-  pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
-  pipelineLayoutCreateInfo.pPushConstantRanges = NULL;
+  pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+  pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
 
-  return vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, NULL,
-      pipelineLayout);
+  return vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo,
+      allocationCallbacks, pipelineLayout);
 }
 
 IVY_INTERNAL void ivyDestroyGraphicsAttachment(IvyGraphicsDevice *device,
@@ -1186,12 +1362,14 @@ IVY_INTERNAL void ivyDestroyGraphicsAttachment(IvyGraphicsDevice *device,
   ivyFreeGraphicsMemory(device, graphicsMemoryAllocator, &attachment->memory);
 
   if (attachment->imageView) {
-    vkDestroyImageView(device->logicalDevice, attachment->imageView, NULL);
+    vkDestroyImageView(device->logicalDevice, attachment->imageView,
+        device->allocationCallbacks);
     attachment->imageView = VK_NULL_HANDLE;
   }
 
   if (attachment->image) {
-    vkDestroyImage(device->logicalDevice, attachment->image, NULL);
+    vkDestroyImage(device->logicalDevice, attachment->image,
+        device->allocationCallbacks);
     attachment->image = VK_NULL_HANDLE;
   }
 }
@@ -1209,8 +1387,9 @@ IVY_INTERNAL IvyCode ivyCreateGraphicsAttachment(IvyGraphicsDevice *device,
   attachment->width = width;
   attachment->height = height;
 
-  vulkanResult = ivyCreateVulkanImage(device->logicalDevice, width, height, 1,
-      sampleCount, usage, format, &attachment->image);
+  vulkanResult = ivyCreateVulkanImage(device->logicalDevice,
+      device->allocationCallbacks, width, height, 1, sampleCount, usage,
+      format, &attachment->image);
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
     ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
@@ -1226,7 +1405,8 @@ IVY_INTERNAL IvyCode ivyCreateGraphicsAttachment(IvyGraphicsDevice *device,
   }
 
   vulkanResult = ivyCreateVulkanImageView(device->logicalDevice,
-      attachment->image, aspect, format, &attachment->imageView);
+      device->allocationCallbacks, attachment->image, aspect, format,
+      &attachment->imageView);
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
     ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
@@ -1256,11 +1436,102 @@ IVY_INTERNAL void ivyComputeRendererProjectionAndView(IvyRenderer *renderer) {
       &renderer->cameraUp, &renderer->cameraView);
 }
 
+// NOTE: every quad uses the same 6 indices, offset by 4 vertices per quad
+IVY_INTERNAL IvyCode ivyCreateGraphicsQuadIndexBuffer(
+    IvyAnyMemoryAllocator allocator, IvyRenderer *renderer,
+    IvyGraphicsIndexBuffer **buffer) {
+  uint32_t index;
+  IvyCode ivyCode;
+  IvyGraphicsProgramIndex *indices;
+  IvyGraphicsProgramIndex const quadIndices[] = {0, 2, 3, 3, 1, 0};
+  uint64_t const size =
+      IVY_MAX_BATCHED_QUADS * sizeof(quadIndices) * sizeof(*indices) /
+      sizeof(*quadIndices);
+
+  indices = ivyAllocateMemory(allocator, size);
+  if (!indices) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+
+  for (index = 0; index < IVY_MAX_BATCHED_QUADS; ++index) {
+    uint32_t quadIndex;
+
+    for (quadIndex = 0; quadIndex < IVY_ARRAY_LENGTH(quadIndices);
+         ++quadIndex) {
+      indices[index * IVY_ARRAY_LENGTH(quadIndices) + quadIndex] =
+          index * 4 + quadIndices[quadIndex];
+    }
+  }
+
+  ivyCode = ivyCreateGraphicsIndexBuffer(allocator, renderer, size, indices,
+      buffer);
+
+  ivyFreeMemory(allocator, indices);
+
+  return ivyCode;
+}
+
+// NOTE: corners are laid out like the vertices of a batched quad, so the
+//       first 6 indices of the quad index buffer draw it
+IVY_INTERNAL IvyCode ivyCreateGraphicsUnitQuadVertexBuffer(
+    IvyAnyMemoryAllocator allocator, IvyRenderer *renderer,
+    IvyGraphicsVertexBuffer **buffer) {
+  IvyGraphicsVertex2 vertices[4];
+
+  vertices[0].position.x = 0.0F;
+  vertices[0].position.y = 0.0F;
+  vertices[1].position.x = 1.0F;
+  vertices[1].position.y = 0.0F;
+  vertices[2].position.x = 0.0F;
+  vertices[2].position.y = 1.0F;
+  vertices[3].position.x = 1.0F;
+  vertices[3].position.y = 1.0F;
+
+  return ivyCreateGraphicsVertexBuffer(allocator, renderer, sizeof(vertices),
+      vertices, buffer);
+}
+
+// NOTE: the swapchain images are only needed while the frames are created,
+//       so they live on the scratch stack
+IVY_INTERNAL IvyCode ivyCreateGraphicsFramesForSwapchain(
+    IvyAnyMemoryAllocator allocator, IvyRenderer *renderer) {
+  IvyCode ivyCode;
+  VkImage *swapchainImages;
+  IvyStackMemoryMarker scratchMarker;
+  IvyStackMemoryAllocator *scratchAllocator =
+      ivyGetThreadScratchMemoryAllocator();
+
+  if (!scratchAllocator) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+
+  ivyGetStackMemoryMarker(scratchAllocator, &scratchMarker);
+
+  swapchainImages = ivyAllocateVulkanSwapchainImages(scratchAllocator,
+      renderer->device.logicalDevice, renderer->swapchain,
+      &renderer->swapchainImageCount);
+  IVY_ASSERT(swapchainImages);
+  if (!swapchainImages) {
+    ivyFreeStackMemoryToMarker(scratchAllocator, &scratchMarker);
+    return IVY_ERROR_NO_MEMORY;
+  }
+
+  ivyCode = ivyCreateGraphicsFrames(allocator, &renderer->device,
+      &renderer->defaultGraphicsMemoryAllocator, renderer->mainRenderPass,
+      renderer->swapchainImageCount, swapchainImages, renderer->surfaceFormat,
+      renderer->swapchainWidth, renderer->swapchainHeight,
+      renderer->colorAttachment.imageView,
+      renderer->depthAttachment.imageView, &renderer->frames);
+
+  ivyFreeStackMemoryToMarker(scratchAllocator, &scratchMarker);
+
+  return ivyCode;
+}
+
 IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
     IvyApplication *application, IvyRenderer **renderer) {
   IvyCode ivyCode = IVY_OK;
   VkResult vulkanResult;
-  VkImage *swapchainImages = NULL;
   IvyRenderer *currentRenderer;
 
   currentRenderer = ivyAllocateMemory(allocator, sizeof(*currentRenderer));
@@ -1272,15 +1543,33 @@ IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
 
   IVY_MEMSET(currentRenderer, 0, sizeof(*currentRenderer));
 
+  // NOTE: ivyDestroyRenderer always destroys the mutex, so it is created
+  //       before anything that can fail and jump to error
+  if (pthread_mutex_init(&currentRenderer->temporaryBufferMutex, NULL)) {
+    ivyFreeMemory(allocator, currentRenderer);
+    *renderer = NULL;
+    return IVY_ERROR_UNKNOWN;
+  }
+
   currentRenderer->application = application;
   currentRenderer->ownerMemoryAllocator = allocator;
 
+  ivyCode = ivyCreateVulkanHostMemoryAllocator(allocator,
+      &currentRenderer->vulkanHostMemoryAllocator);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
+  currentRenderer->device.allocationCallbacks =
+      &currentRenderer->vulkanHostMemoryAllocator.callbacks;
+
   ivySetV3(0.0F, -1.0F, 0.0F, &currentRenderer->cameraUp);
   ivySetV3(0.0F, 0.0F, -1.0F, &currentRenderer->cameraDirection);
   ivySetV3(0.0F, 0.0F, 3.0F, &currentRenderer->cameraEye);
 
-  vulkanResult =
-      ivyCreateVulkanInstance(application, &currentRenderer->instance);
+  vulkanResult = ivyCreateVulkanInstance(application,
+      currentRenderer->device.allocationCallbacks, &currentRenderer->instance);
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
     ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
@@ -1288,6 +1577,7 @@ IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
   }
 
   vulkanResult = ivyCreateVulkanDebugMessenger(currentRenderer->instance,
+      currentRenderer->device.allocationCallbacks,
       &currentRenderer->createDebugUtilsMessengerEXT,
       &currentRenderer->destroyDebugUtilsMessengerEXT,
       &currentRenderer->debugMessenger);
@@ -1298,7 +1588,7 @@ IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
   }
 
   vulkanResult = ivyCreateVulkanSurface(currentRenderer->instance, application,
-      &currentRenderer->surface);
+      currentRenderer->device.allocationCallbacks, &currentRenderer->surface);
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
     ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
@@ -1319,7 +1609,7 @@ IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
   currentRenderer->presentMode = VK_PRESENT_MODE_FIFO_KHR;
   currentRenderer->attachmentsSampleCounts = VK_SAMPLE_COUNT_2_BIT;
 
-  vulkanResult = ivyCreateVulkanDevice(allocator, currentRenderer->surface,
+  vulkanResult = ivyCreateVulkanDevice(currentRenderer->surface,
       currentRenderer->availablePhysicalDeviceCount,
       currentRenderer->availablePhysicalDevices,
       currentRenderer->surfaceFormat, currentRenderer->surfaceColorspace,
@@ -1327,8 +1617,11 @@ IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
       &currentRenderer->device.physicalDevice, &currentRenderer->depthFormat,
       &currentRenderer->device.graphicsQueueFamilyIndex,
       &currentRenderer->device.presentQueueFamilyIndex,
+      &currentRenderer->device.transferQueueFamilyIndex,
       &currentRenderer->device.graphicsQueue,
       &currentRenderer->device.presentQueue,
+      &currentRenderer->device.transferQueue,
+      currentRenderer->device.allocationCallbacks,
       &currentRenderer->device.logicalDevice);
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
@@ -1336,32 +1629,80 @@ IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
     goto error;
   }
 
-  vulkanResult = ivyCreateVulkanTransientCommandPool(
+  currentRenderer->device.uploadTimelineValue = 0;
+  vulkanResult = ivyCreateVulkanTimelineSemaphore(
       currentRenderer->device.logicalDevice,
-      currentRenderer->device.graphicsQueueFamilyIndex,
-      &currentRenderer->transientCommandPool);
+      currentRenderer->device.allocationCallbacks,
+      currentRenderer->device.uploadTimelineValue,
+      &currentRenderer->device.uploadSemaphore);
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
     ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
     goto error;
   }
 
-  vulkanResult = ivyCreateVulkanGlobalDescriptorPool(
+  vkGetPhysicalDeviceProperties(currentRenderer->device.physicalDevice,
+      &currentRenderer->device.properties);
+  vkGetPhysicalDeviceMemoryProperties(currentRenderer->device.physicalDevice,
+      &currentRenderer->device.memoryProperties);
+
+  vulkanResult = ivyCreateVulkanTransientCommandPool(
       currentRenderer->device.logicalDevice,
-      &currentRenderer->globalDescriptorPool);
+      currentRenderer->device.allocationCallbacks,
+      currentRenderer->device.graphicsQueueFamilyIndex,
+      &currentRenderer->transientCommandPool);
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
     ivyCode = ivyVulkanResultAsIvyCode(vulkanResult);
     goto error;
   }
 
-  ivyCode = ivyCreateDummyGraphicsMemoryAllocator(&currentRenderer->device,
+  ivyCode = ivyCreateGraphicsDescriptorAllocator(allocator,
+      currentRenderer->device.logicalDevice,
+      currentRenderer->device.allocationCallbacks, 1,
+      IVY_DEFAULT_DESCRIPTOR_SETS_PER_POOL,
+      &currentRenderer->persistentDescriptorAllocator);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
+  ivyCode = ivyCreateBlockGraphicsMemoryAllocator(allocator,
+      &currentRenderer->device,
       &currentRenderer->defaultGraphicsMemoryAllocator);
   IVY_ASSERT(!ivyCode);
   if (ivyCode) {
     goto error;
   }
 
+  ivyCode = ivyCreateGraphicsStagingRing(&currentRenderer->device,
+      &currentRenderer->defaultGraphicsMemoryAllocator,
+      IVY_DEFAULT_GRAPHICS_STAGING_RING_SIZE, &currentRenderer->stagingRing);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
+  ivyCode = ivyCreateGraphicsQuadIndexBuffer(allocator, currentRenderer,
+      &currentRenderer->quadIndexBuffer);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
+  ivyCode = ivyCreateGraphicsUnitQuadVertexBuffer(allocator, currentRenderer,
+      &currentRenderer->unitQuadVertexBuffer);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
+  ivyCode = ivyCreateDrawList(allocator, &currentRenderer->drawList);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
   currentRenderer->clearValues[0].color.float32[0] = 0.0F;
   currentRenderer->clearValues[0].color.float32[1] = 0.0F;
   currentRenderer->clearValues[0].color.float32[2] = 0.0F;
@@ -1370,7 +1711,9 @@ IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
   currentRenderer->clearValues[1].depthStencil.stencil = 0.0F;
 
   vulkanResult = ivyCreateVulkanMainRenderPass(
-      currentRenderer->device.logicalDevice, currentRenderer->surfaceFormat,
+      currentRenderer->device.logicalDevice,
+      currentRenderer->device.allocationCallbacks,
+      currentRenderer->surfaceFormat,
       currentRenderer->depthFormat, currentRenderer->attachmentsSampleCounts,
       &currentRenderer->mainRenderPass);
   IVY_ASSERT(!vulkanResult);
@@ -1381,6 +1724,7 @@ IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
 
   vulkanResult = ivyCreateVulkanUniformDescriptorSetLayout(
       currentRenderer->device.logicalDevice,
+      currentRenderer->device.allocationCallbacks,
       &currentRenderer->uniformDescriptorSetLayout);
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
@@ -1390,6 +1734,7 @@ IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
 
   vulkanResult = ivyCreateVulkanTextureDescriptorSetLayout(
       currentRenderer->device.logicalDevice,
+      currentRenderer->device.allocationCallbacks,
       &currentRenderer->textureDescriptorSetLayout);
   IVY_ASSERT(!vulkanResult);
   if (vulkanResult) {
@@ -1399,6 +1744,7 @@ IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
 
   vulkanResult =
       ivyCreateVulkanMainPipelineLayout(currentRenderer->device.logicalDevice,
+          currentRenderer->device.allocationCallbacks,
           currentRenderer->uniformDescriptorSetLayout,
           currentRenderer->textureDescriptorSetLayout,
           &currentRenderer->mainPipelineLayout);
@@ -1439,6 +1785,7 @@ IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
       currentRenderer->device.physicalDevice, currentRenderer->surface,
       currentRenderer->surfaceFormat, currentRenderer->surfaceColorspace,
       currentRenderer->presentMode, currentRenderer->device.logicalDevice,
+      currentRenderer->device.allocationCallbacks,
       currentRenderer->device.graphicsQueueFamilyIndex,
       currentRenderer->device.presentQueueFamilyIndex, 2,
       currentRenderer->swapchainWidth, currentRenderer->swapchainHeight,
@@ -1451,26 +1798,9 @@ IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
 
   ivyComputeRendererProjectionAndView(currentRenderer);
 
-  swapchainImages = ivyAllocateVulkanSwapchainImages(allocator,
-      currentRenderer->device.logicalDevice, currentRenderer->swapchain,
-      &currentRenderer->swapchainImageCount);
-  IVY_ASSERT(swapchainImages);
-  if (swapchainImages) {
-    ivyCode = ivyCreateGraphicsFrames(allocator, &currentRenderer->device,
-        &currentRenderer->defaultGraphicsMemoryAllocator,
-        currentRenderer->globalDescriptorPool, currentRenderer->mainRenderPass,
-        currentRenderer->swapchainImageCount, swapchainImages,
-        currentRenderer->surfaceFormat, currentRenderer->swapchainWidth,
-        currentRenderer->swapchainHeight,
-        currentRenderer->colorAttachment.imageView,
-        currentRenderer->depthAttachment.imageView, &currentRenderer->frames);
-    IVY_ASSERT(!ivyCode);
-    if (ivyCode) {
-      goto error;
-    }
-    ivyFreeMemory(allocator, swapchainImages);
-  } else {
-    ivyCode = IVY_ERROR_NO_MEMORY;
+  ivyCode = ivyCreateGraphicsFramesForSwapchain(allocator, currentRenderer);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
     goto error;
   }
 
@@ -1495,6 +1825,20 @@ IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
     goto error;
   }
 
+  ivyCode = ivyCreateGraphicsProgram(allocator, &currentRenderer->device,
+      currentRenderer->attachmentsSampleCounts,
+      currentRenderer->mainRenderPass, currentRenderer->mainPipelineLayout,
+      currentRenderer->swapchainWidth, currentRenderer->swapchainHeight,
+      "../GLSL/Quad.vert.spv", "../GLSL/Basic.frag.spv",
+      IVY_VERTEX_2_INSTANCE_QUAD_ENABLE | IVY_POLYGON_MODE_FILL |
+          IVY_DEPTH_ENABLE | IVY_BLEND_ENABLE | IVY_CULL_BACK |
+          IVY_FRONT_FACE_COUNTER_CLOCKWISE,
+      &currentRenderer->quadInstanceGraphicsProgram);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
   *renderer = currentRenderer;
 
   return IVY_OK;
@@ -1502,10 +1846,6 @@ IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
 error:
   ivyDestroyRenderer(allocator, currentRenderer);
 
-  if (swapchainImages) {
-    ivyFreeMemory(allocator, swapchainImages);
-  }
-
   *renderer = NULL;
   return ivyCode;
 }
@@ -1520,6 +1860,8 @@ IVY_API void ivyDestroyRenderer(IvyAnyMemoryAllocator allocator,
 
   IVY_ASSERT(renderer->ownerMemoryAllocator == allocator);
 
+  ivyDestroyGraphicsProgram(&renderer->device,
+      &renderer->quadInstanceGraphicsProgram);
   ivyDestroyGraphicsProgram(&renderer->device,
       &renderer->basicGraphicsProgram);
 
@@ -1528,14 +1870,13 @@ IVY_API void ivyDestroyRenderer(IvyAnyMemoryAllocator allocator,
   renderer->renderSemaphores = NULL;
 
   ivyDestroyGraphicsFrames(allocator, &renderer->device,
-      &renderer->defaultGraphicsMemoryAllocator,
-      renderer->globalDescriptorPool, renderer->swapchainImageCount,
+      &renderer->defaultGraphicsMemoryAllocator, renderer->swapchainImageCount,
       renderer->frames);
   renderer->frames = NULL;
 
   if (renderer->swapchain) {
     vkDestroySwapchainKHR(renderer->device.logicalDevice, renderer->swapchain,
-        NULL);
+        renderer->device.allocationCallbacks);
     renderer->swapchain = VK_NULL_HANDLE;
   }
 
@@ -1546,45 +1887,65 @@ IVY_API void ivyDestroyRenderer(IvyAnyMemoryAllocator allocator,
 
   if (renderer->mainPipelineLayout) {
     vkDestroyPipelineLayout(renderer->device.logicalDevice,
-        renderer->mainPipelineLayout, NULL);
+        renderer->mainPipelineLayout, renderer->device.allocationCallbacks);
     renderer->mainPipelineLayout = VK_NULL_HANDLE;
   }
 
   if (renderer->textureDescriptorSetLayout) {
     vkDestroyDescriptorSetLayout(renderer->device.logicalDevice,
-        renderer->textureDescriptorSetLayout, NULL);
+        renderer->textureDescriptorSetLayout,
+        renderer->device.allocationCallbacks);
     renderer->textureDescriptorSetLayout = VK_NULL_HANDLE;
   }
 
   if (renderer->uniformDescriptorSetLayout) {
     vkDestroyDescriptorSetLayout(renderer->device.logicalDevice,
-        renderer->uniformDescriptorSetLayout, NULL);
+        renderer->uniformDescriptorSetLayout,
+        renderer->device.allocationCallbacks);
     renderer->uniformDescriptorSetLayout = VK_NULL_HANDLE;
   }
 
   if (renderer->mainRenderPass) {
     vkDestroyRenderPass(renderer->device.logicalDevice,
-        renderer->mainRenderPass, NULL);
+        renderer->mainRenderPass, renderer->device.allocationCallbacks);
     renderer->mainRenderPass = VK_NULL_HANDLE;
   }
 
+  ivyDestroyDrawList(&renderer->drawList);
+
+  ivyDestroyGraphicsVertexBuffer(allocator, renderer,
+      renderer->unitQuadVertexBuffer);
+  renderer->unitQuadVertexBuffer = NULL;
+
+  ivyDestroyGraphicsIndexBuffer(allocator, renderer,
+      renderer->quadIndexBuffer);
+  renderer->quadIndexBuffer = NULL;
+
+  ivyDestroyGraphicsStagingRing(&renderer->device,
+      &renderer->defaultGraphicsMemoryAllocator, &renderer->stagingRing);
+
   ivyDestroyGraphicsMemoryAllocator(&renderer->device,
       &renderer->defaultGraphicsMemoryAllocator);
 
-  if (renderer->globalDescriptorPool) {
-    vkDestroyDescriptorPool(renderer->device.logicalDevice,
-        renderer->globalDescriptorPool, NULL);
-    renderer->globalDescriptorPool = VK_NULL_HANDLE;
-  }
+  ivyDestroyGraphicsDescriptorAllocator(renderer->device.logicalDevice,
+      &renderer->persistentDescriptorAllocator);
 
   if (renderer->transientCommandPool) {
     vkDestroyCommandPool(renderer->device.logicalDevice,
-        renderer->transientCommandPool, NULL);
+        renderer->transientCommandPool, renderer->device.allocationCallbacks);
     renderer->transientCommandPool = VK_NULL_HANDLE;
   }
 
+  if (renderer->device.uploadSemaphore) {
+    vkDestroySemaphore(renderer->device.logicalDevice,
+        renderer->device.uploadSemaphore,
+        renderer->device.allocationCallbacks);
+    renderer->device.uploadSemaphore = VK_NULL_HANDLE;
+  }
+
   if (renderer->device.logicalDevice) {
-    vkDestroyDevice(renderer->device.logicalDevice, NULL);
+    vkDestroyDevice(renderer->device.logicalDevice,
+        renderer->device.allocationCallbacks);
     renderer->device.logicalDevice = VK_NULL_HANDLE;
   }
 
@@ -1592,23 +1953,32 @@ IVY_API void ivyDestroyRenderer(IvyAnyMemoryAllocator allocator,
   renderer->availablePhysicalDevices = NULL;
 
   if (renderer->surface) {
-    vkDestroySurfaceKHR(renderer->instance, renderer->surface, NULL);
+    vkDestroySurfaceKHR(renderer->instance, renderer->surface,
+        renderer->device.allocationCallbacks);
     renderer->surface = VK_NULL_HANDLE;
   }
 
   if (renderer->debugMessenger) {
     renderer->destroyDebugUtilsMessengerEXT(renderer->instance,
-        renderer->debugMessenger, NULL);
+        renderer->debugMessenger, renderer->device.allocationCallbacks);
     renderer->debugMessenger = VK_NULL_HANDLE;
   }
 
   if (renderer->instance) {
-    vkDestroyInstance(renderer->instance, NULL);
+    vkDestroyInstance(renderer->instance,
+        renderer->device.allocationCallbacks);
     renderer->instance = VK_NULL_HANDLE;
   }
 
-  ivyFreeMemory(allocator, renderer);
-}
+  if (renderer->device.allocationCallbacks) {
+    ivyDestroyVulkanHostMemoryAllocator(&renderer->vulkanHostMemoryAllocator);
+    renderer->device.allocationCallbacks = NULL;
+  }
+
+  pthread_mutex_destroy(&renderer->temporaryBufferMutex);
+
+  ivyFreeMemory(allocator, renderer);
+}
 
 IVY_API IvyGraphicsFrame *ivyGetCurrentGraphicsFrame(IvyRenderer *renderer) {
   return &renderer->frames[renderer->currentSwapchainImageIndex];
@@ -1627,6 +1997,8 @@ IVY_INTERNAL void ivyDestroyGraphicsResourcesForSwapchainRebuild(
     vkDeviceWaitIdle(renderer->device.logicalDevice);
   }
 
+  ivyDestroyGraphicsProgram(&renderer->device,
+      &renderer->quadInstanceGraphicsProgram);
   ivyDestroyGraphicsProgram(&renderer->device,
       &renderer->basicGraphicsProgram);
 
@@ -1639,14 +2011,13 @@ IVY_INTERNAL void ivyDestroyGraphicsResourcesForSwapchainRebuild(
   if (renderer->frames) {
     ivyDestroyGraphicsFrames(allocator, &renderer->device,
         &renderer->defaultGraphicsMemoryAllocator,
-        renderer->globalDescriptorPool, renderer->swapchainImageCount,
-        renderer->frames);
+        renderer->swapchainImageCount, renderer->frames);
     renderer->frames = NULL;
   }
 
   if (renderer->swapchain) {
     vkDestroySwapchainKHR(renderer->device.logicalDevice, renderer->swapchain,
-        NULL);
+        renderer->device.allocationCallbacks);
     renderer->swapchain = VK_NULL_HANDLE;
   }
 
@@ -1662,7 +2033,6 @@ IVY_API IvyCode ivyRebuildGraphicsSwapchain(IvyRenderer *renderer) {
   VkResult vulkanResult;
   IvyCode ivyCode;
   IvyAnyMemoryAllocator allocator = renderer->ownerMemoryAllocator;
-  VkImage *swapchainImages = NULL;
 
   ivyDestroyGraphicsResourcesForSwapchainRebuild(renderer);
 
@@ -1698,6 +2068,7 @@ IVY_API IvyCode ivyRebuildGraphicsSwapchain(IvyRenderer *renderer) {
   vulkanResult = ivyCreateVulkanSwapchain(renderer->device.physicalDevice,
       renderer->surface, renderer->surfaceFormat, renderer->surfaceColorspace,
       renderer->presentMode, renderer->device.logicalDevice,
+      renderer->device.allocationCallbacks,
       renderer->device.graphicsQueueFamilyIndex,
       renderer->device.presentQueueFamilyIndex, 2, renderer->swapchainWidth,
       renderer->swapchainHeight, &renderer->swapchain);
@@ -1707,24 +2078,8 @@ IVY_API IvyCode ivyRebuildGraphicsSwapchain(IvyRenderer *renderer) {
     goto error;
   }
 
-  swapchainImages = ivyAllocateVulkanSwapchainImages(allocator,
-      renderer->device.logicalDevice, renderer->swapchain,
-      &renderer->swapchainImageCount);
-  IVY_ASSERT(swapchainImages);
-  if (swapchainImages) {
-    ivyCode = ivyCreateGraphicsFrames(allocator, &renderer->device,
-        &renderer->defaultGraphicsMemoryAllocator,
-        renderer->globalDescriptorPool, renderer->mainRenderPass,
-        renderer->swapchainImageCount, swapchainImages,
-        renderer->surfaceFormat, renderer->swapchainWidth,
-        renderer->swapchainHeight, renderer->colorAttachment.imageView,
-        renderer->depthAttachment.imageView, &renderer->frames);
-    if (ivyCode) {
-      goto error;
-    }
-    ivyFreeMemory(allocator, swapchainImages);
-  } else {
-    ivyCode = IVY_ERROR_NO_MEMORY;
+  ivyCode = ivyCreateGraphicsFramesForSwapchain(allocator, renderer);
+  if (ivyCode) {
     goto error;
   }
 
@@ -1747,16 +2102,26 @@ IVY_API IvyCode ivyRebuildGraphicsSwapchain(IvyRenderer *renderer) {
     goto error;
   }
 
+  ivyCode = ivyCreateGraphicsProgram(allocator, &renderer->device,
+      renderer->attachmentsSampleCounts, renderer->mainRenderPass,
+      renderer->mainPipelineLayout, renderer->swapchainWidth,
+      renderer->swapchainHeight, "../GLSL/Quad.vert.spv",
+      "../GLSL/Basic.frag.spv",
+      IVY_VERTEX_2_INSTANCE_QUAD_ENABLE | IVY_POLYGON_MODE_FILL |
+          IVY_DEPTH_ENABLE | IVY_BLEND_ENABLE | IVY_CULL_BACK |
+          IVY_FRONT_FACE_COUNTER_CLOCKWISE,
+      &renderer->quadInstanceGraphicsProgram);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    goto error;
+  }
+
   return IVY_OK;
 
 error:
   // FIXME(samuel): try to build before destroying
   ivyDestroyGraphicsResourcesForSwapchainRebuild(renderer);
 
-  if (swapchainImages) {
-    ivyFreeMemory(allocator, swapchainImages);
-  }
-
   return ivyCode;
 }
 
@@ -1788,8 +2153,45 @@ IVY_INTERNAL IvyCode ivyAcquireNextVulkanSwapchainImageIndex(
 
 #define ivyAlignTo(value, to) (((value) + (to)-1) & ~((to)-1))
 
-IVY_INTERNAL uint64_t ivyAlignTo256(uint64_t value) {
-  return ivyAlignTo(value, 256);
+// NOTE: uniforms are bound through dynamic offsets, so they need the device
+//       alignment, vertex and index streams only need their element
+//       alignment (every vertex attribute is made of 32 bit floats)
+IVY_INTERNAL uint64_t ivyGetGraphicsTemporaryBufferAlignment(
+    IvyRenderer *renderer, IvyGraphicsTemporaryBufferUsage usage) {
+  switch (usage) {
+  case IVY_UNIFORM_TEMPORARY_BUFFER:
+    return IVY_MAX(renderer->device.properties.limits
+                       .minUniformBufferOffsetAlignment,
+        sizeof(float));
+
+  case IVY_VERTEX_TEMPORARY_BUFFER:
+    return sizeof(float);
+
+  case IVY_INDEX_TEMPORARY_BUFFER:
+    return sizeof(IvyGraphicsProgramIndex);
+
+  default:
+    IVY_ASSERT(0 && "invalid temporary buffer usage");
+    return 1;
+  }
+}
+
+IVY_INTERNAL VkBufferUsageFlagBits ivyAsVulkanBufferUsage(
+    IvyGraphicsTemporaryBufferUsage usage) {
+  switch (usage) {
+  case IVY_UNIFORM_TEMPORARY_BUFFER:
+    return VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+
+  case IVY_VERTEX_TEMPORARY_BUFFER:
+    return VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+
+  case IVY_INDEX_TEMPORARY_BUFFER:
+    return VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+
+  default:
+    IVY_ASSERT(0 && "invalid temporary buffer usage");
+    return 0;
+  }
 }
 
 IVY_INTERNAL void ivyWriteVulkanUniformDynamicDescriptorSet(VkDevice device,
@@ -1816,87 +2218,198 @@ IVY_INTERNAL void ivyWriteVulkanUniformDynamicDescriptorSet(VkDevice device,
   vkUpdateDescriptorSets(device, 1, &writeDescriptorSet, 0, NULL);
 }
 
-// TODO: cleanup
-IVY_API IvyCode ivyRequestGraphicsTemporaryBuffer(IvyRenderer *renderer,
+IVY_INTERNAL IvyCode ivyCreateGraphicsRenderBufferChunk(IvyRenderer *renderer,
+    IvyGraphicsTemporaryBufferUsage usage, uint64_t size,
+    IvyGraphicsRenderBufferChunk *chunk) {
+  VkResult vulkanResult;
+  IvyCode ivyCode;
+
+  chunk->size = size;
+  chunk->offset = 0;
+  chunk->buffer = VK_NULL_HANDLE;
+  chunk->descriptorSet = VK_NULL_HANDLE;
+  chunk->memory.memory = VK_NULL_HANDLE;
+
+  vulkanResult = ivyCreateVulkanBuffer(renderer->device.logicalDevice,
+      renderer->device.allocationCallbacks, ivyAsVulkanBufferUsage(usage),
+      size, &chunk->buffer);
+  IVY_ASSERT(!vulkanResult);
+  if (vulkanResult) {
+    return ivyVulkanResultAsIvyCode(vulkanResult);
+  }
+
+  ivyCode = ivyAllocateAndBindGraphicsMemoryToBuffer(&renderer->device,
+      &renderer->defaultGraphicsMemoryAllocator, IVY_DYNAMIC, chunk->buffer,
+      &chunk->memory);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    vkDestroyBuffer(renderer->device.logicalDevice, chunk->buffer,
+        renderer->device.allocationCallbacks);
+    chunk->buffer = VK_NULL_HANDLE;
+    return ivyCode;
+  }
+
+  return IVY_OK;
+}
+
+IVY_API uint64_t ivyComputeGraphicsTemporaryBufferConsolidationSize(
+    IvyGraphicsTemporaryBufferStatistics *statistics, uint64_t chunkSize,
+    IvyBool isOutgrown, uint64_t alignment) {
+  uint64_t newSize = 0;
+  uint64_t const peakUsedSize = statistics->peakUsedSize;
+  uint64_t const targetSize =
+      ivyAlignTo(peakUsedSize + peakUsedSize / 4, alignment);
+
+  ++statistics->windowUseCount;
+
+  if (isOutgrown) {
+    newSize = targetSize;
+  } else if (IVY_TEMPORARY_BUFFER_PEAK_WINDOW <= statistics->windowUseCount) {
+    // NOTE: an idle pool keeps its chunk, there is nothing to size it after
+    if (targetSize && chunkSize > 2 * targetSize) {
+      newSize = targetSize;
+    }
+  } else {
+    return 0;
+  }
+
+  statistics->peakUsedSize = 0;
+  statistics->windowUseCount = 0;
+
+  return newSize;
+}
+
+// NOTE: outgrown chunks stay alive until the frame comes around again (the
+//       command buffer still references them), at that point they are all
+//       replaced by a single chunk big enough for the recent high water mark.
+//       A chunk left oversized by a spike is replaced the same way
+IVY_INTERNAL void ivyConsolidateGraphicsTemporaryBufferPool(
+    IvyRenderer *renderer, IvyGraphicsTemporaryBufferUsage usage,
+    IvyGraphicsTemporaryBufferPool *pool) {
+  IvyCode ivyCode;
+  uint64_t newSize;
+  IvyGraphicsTemporaryBufferStatistics *statistics = &pool->statistics;
+
+  newSize = ivyComputeGraphicsTemporaryBufferConsolidationSize(statistics,
+      pool->currentChunk.size, 0 != pool->garbageChunkCount,
+      ivyGetGraphicsTemporaryBufferAlignment(renderer, usage));
+  if (!newSize) {
+    return;
+  }
+
+  ivyDestroyGraphicsTemporaryBufferPool(renderer->ownerMemoryAllocator,
+      &renderer->device, &renderer->defaultGraphicsMemoryAllocator, pool);
+
+  ++statistics->consolidationCount;
+
+  // NOTE: if this fails the next request just creates the chunk on demand
+  ivyCode = ivyCreateGraphicsRenderBufferChunk(renderer, usage, newSize,
+      &pool->currentChunk);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    ivyDestroyGraphicsRenderBufferChunk(&renderer->device,
+        &renderer->defaultGraphicsMemoryAllocator, &pool->currentChunk);
+  }
+}
+
+IVY_INTERNAL void ivyResetGraphicsTemporaryBufferPools(IvyRenderer *renderer,
+    IvyGraphicsFrame *frame) {
+  int usage;
+
+  for (usage = 0; usage < IVY_MAX_TEMPORARY_BUFFER_USAGES; ++usage) {
+    IvyGraphicsTemporaryBufferPool *pool = &frame->temporaryBufferPools[usage];
+
+    ivyConsolidateGraphicsTemporaryBufferPool(renderer,
+        (IvyGraphicsTemporaryBufferUsage)usage, pool);
+
+    pool->currentChunk.offset = 0;
+    pool->currentChunk.descriptorSet = VK_NULL_HANDLE;
+    pool->statistics.usedSize = 0;
+    pool->statistics.chunkCreationCount = 0;
+    pool->statistics.capacity = pool->currentChunk.size;
+  }
+}
+
+// NOTE: the caller holds temporaryBufferMutex if recording contexts are used
+IVY_INTERNAL IvyCode ivyRequestGraphicsTemporaryBufferUnlocked(
+    IvyRenderer *renderer, IvyGraphicsTemporaryBufferUsage usage,
     uint64_t size, IvyGraphicsTemporaryBuffer *temporaryBuffer) {
-  IvyAnyGraphicsMemoryAllocator allocator = renderer->ownerMemoryAllocator;
+  IvyCode ivyCode;
+  uint64_t offset;
+  uint64_t alignment;
+  IvyAnyMemoryAllocator allocator = renderer->ownerMemoryAllocator;
   IvyGraphicsFrame *frame = ivyGetCurrentGraphicsFrame(renderer);
-  IvyGraphicsRenderBufferChunk *currentChunk = &frame->currentChunk;
-  uint64_t const offset = currentChunk->offset;
-  uint64_t const requiredSize = offset + size;
+  IvyGraphicsTemporaryBufferPool *pool = &frame->temporaryBufferPools[usage];
+  IvyGraphicsRenderBufferChunk *currentChunk = &pool->currentChunk;
+  IvyGraphicsTemporaryBufferStatistics *statistics = &pool->statistics;
 
-  if (!frame->currentChunk.buffer || frame->currentChunk.size < requiredSize) {
-    VkResult vulkanResult;
-    IvyCode ivyCode;
-    uint64_t newSize;
-    VkBuffer newBuffer = VK_NULL_HANDLE;
-    VkDescriptorSet newDescriptorSet = VK_NULL_HANDLE;
-    IvyGraphicsMemory newMemory;
+  IVY_ASSERT(0 <= (int)usage && IVY_MAX_TEMPORARY_BUFFER_USAGES > usage);
 
-    newSize = ivyAlignTo256(requiredSize * 2);
+  alignment = ivyGetGraphicsTemporaryBufferAlignment(renderer, usage);
 
-    vulkanResult = ivyCreateVulkanBuffer(renderer->device.logicalDevice,
-        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
-            VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        newSize, &newBuffer);
-    IVY_ASSERT(!vulkanResult);
-    if (vulkanResult) {
-      return ivyVulkanResultAsIvyCode(vulkanResult);
-    }
+  if (!currentChunk->buffer ||
+      currentChunk->size < currentChunk->offset + size) {
+    IvyGraphicsRenderBufferChunk newChunk;
+    uint64_t newSize;
 
-    ivyCode = ivyAllocateAndBindGraphicsMemoryToBuffer(&renderer->device,
-        &renderer->defaultGraphicsMemoryAllocator, IVY_CPU_VISIBLE, newBuffer,
-        &newMemory);
+    newSize = ivyAlignTo(
+        IVY_MAX(statistics->usedSize + size, currentChunk->size) * 2,
+        alignment);
+
+    ivyCode = ivyCreateGraphicsRenderBufferChunk(renderer, usage, newSize,
+        &newChunk);
     IVY_ASSERT(!ivyCode);
     if (ivyCode) {
-      vkDestroyBuffer(renderer->device.logicalDevice, newBuffer, NULL);
+      ivyDestroyGraphicsRenderBufferChunk(&renderer->device,
+          &renderer->defaultGraphicsMemoryAllocator, &newChunk);
       return ivyCode;
     }
 
-    vulkanResult = ivyAllocateVulkanDescriptorSet(
-        renderer->device.logicalDevice, renderer->globalDescriptorPool,
-        renderer->uniformDescriptorSetLayout, &newDescriptorSet);
-    IVY_ASSERT(!vulkanResult);
-    if (vulkanResult) {
-      ivyFreeGraphicsMemory(&renderer->device,
-          &renderer->defaultGraphicsMemoryAllocator, &newMemory);
-      vkDestroyBuffer(renderer->device.logicalDevice, newBuffer, NULL);
-      return ivyVulkanResultAsIvyCode(vulkanResult);
-    }
-
     if (currentChunk->buffer) {
       IvyGraphicsRenderBufferChunk *newGarbageChunks;
-      uint32_t newGarbageChunkCount = frame->garbageChunkCount + 1;
+      uint32_t newGarbageChunkCount = pool->garbageChunkCount + 1;
 
-      newGarbageChunks = ivyReallocateMemory(allocator, frame->garbageChunks,
+      newGarbageChunks = ivyReallocateMemory(allocator, pool->garbageChunks,
           newGarbageChunkCount * sizeof(*newGarbageChunks));
       if (!newGarbageChunks) {
-        ivyFreeGraphicsMemory(&renderer->device,
-            &renderer->defaultGraphicsMemoryAllocator, &newMemory);
-        vkDestroyBuffer(renderer->device.logicalDevice, newBuffer, NULL);
-        vkFreeDescriptorSets(renderer->device.logicalDevice,
-            renderer->globalDescriptorPool, 1, &newDescriptorSet);
+        ivyDestroyGraphicsRenderBufferChunk(&renderer->device,
+            &renderer->defaultGraphicsMemoryAllocator, &newChunk);
         return IVY_ERROR_NO_MEMORY;
       }
 
-      IVY_MEMCPY(&newGarbageChunks[frame->garbageChunkCount], currentChunk,
+      IVY_MEMCPY(&newGarbageChunks[pool->garbageChunkCount], currentChunk,
           sizeof(*currentChunk));
 
-      frame->garbageChunks = newGarbageChunks;
-      frame->garbageChunkCount = newGarbageChunkCount;
+      pool->garbageChunks = newGarbageChunks;
+      pool->garbageChunkCount = newGarbageChunkCount;
+    } else {
+      statistics->capacity = 0;
     }
 
-    ivyWriteVulkanUniformDynamicDescriptorSet(renderer->device.logicalDevice,
-        newBuffer, newDescriptorSet, sizeof(IvyGraphicsProgramUniform));
+    IVY_MEMCPY(currentChunk, &newChunk, sizeof(newChunk));
+
+    statistics->capacity += currentChunk->size;
+    ++statistics->chunkCreationCount;
+  }
+
+  // NOTE: the frame descriptor pools are reset every frame, so the set is
+  //       (re)allocated the first time the chunk is used in a frame
+  if (IVY_UNIFORM_TEMPORARY_BUFFER == usage && !currentChunk->descriptorSet) {
+    ivyCode = ivyAllocateGraphicsDescriptorSet(renderer->device.logicalDevice,
+        &frame->descriptorAllocator, renderer->uniformDescriptorSetLayout,
+        NULL, &currentChunk->descriptorSet);
+    IVY_ASSERT(!ivyCode);
+    if (ivyCode) {
+      return ivyCode;
+    }
 
-    currentChunk->size = newSize;
-    currentChunk->offset = 0;
-    currentChunk->buffer = newBuffer;
-    currentChunk->descriptorSet = newDescriptorSet;
-    IVY_MEMCPY(&currentChunk->memory, &newMemory, sizeof(newMemory));
+    ivyWriteVulkanUniformDynamicDescriptorSet(renderer->device.logicalDevice,
+        currentChunk->buffer, currentChunk->descriptorSet,
+        sizeof(IvyGraphicsProgramUniform));
   }
 
+  offset = currentChunk->offset;
+
   temporaryBuffer->data = ((uint8_t *)currentChunk->memory.data) + offset;
   temporaryBuffer->size = size;
   temporaryBuffer->offsetInU64 = offset;
@@ -1904,17 +2417,377 @@ IVY_API IvyCode ivyRequestGraphicsTemporaryBuffer(IvyRenderer *renderer,
   temporaryBuffer->buffer = currentChunk->buffer;
   temporaryBuffer->descriptorSet = currentChunk->descriptorSet;
 
-  currentChunk->offset = ivyAlignTo256(offset + size);
+  currentChunk->offset = ivyAlignTo(offset + size, alignment);
+
+  statistics->usedSize += currentChunk->offset - offset;
+  statistics->peakUsedSize =
+      IVY_MAX(statistics->peakUsedSize, statistics->usedSize);
 
   return IVY_OK;
 }
 
-IVY_API IvyCode ivyBeginGraphicsFrame(IvyRenderer *renderer) {
+IVY_API IvyCode ivyRequestGraphicsTemporaryBuffer(IvyRenderer *renderer,
+    IvyGraphicsTemporaryBufferUsage usage, uint64_t size,
+    IvyGraphicsTemporaryBuffer *temporaryBuffer) {
+  IvyCode ivyCode;
+
+  if (!renderer->usesRecordingContexts) {
+    return ivyRequestGraphicsTemporaryBufferUnlocked(renderer, usage, size,
+        temporaryBuffer);
+  }
+
+  pthread_mutex_lock(&renderer->temporaryBufferMutex);
+  ivyCode = ivyRequestGraphicsTemporaryBufferUnlocked(renderer, usage, size,
+      temporaryBuffer);
+  pthread_mutex_unlock(&renderer->temporaryBufferMutex);
+
+  return ivyCode;
+}
+
+IVY_API void ivyGetGraphicsTemporaryBufferStatistics(IvyRenderer *renderer,
+    IvyGraphicsTemporaryBufferUsage usage,
+    IvyGraphicsTemporaryBufferStatistics *statistics) {
+  IvyGraphicsFrame *frame = ivyGetCurrentGraphicsFrame(renderer);
+
+  IVY_MEMCPY(statistics, &frame->temporaryBufferPools[usage].statistics,
+      sizeof(*statistics));
+}
+
+// NOTE: view and projection only change between frames, so the camera
+//       uniform is written and bound once right after the render pass begins
+IVY_INTERNAL IvyCode ivyBindGraphicsCameraUniform(IvyRenderer *renderer) {
+  IvyCode ivyCode;
+  IvyGraphicsProgramUniform *uniform;
+  IvyGraphicsTemporaryBuffer uniformBuffer;
+  IvyGraphicsFrame *frame = ivyGetCurrentGraphicsFrame(renderer);
+
+  ivyCode = ivyRequestGraphicsTemporaryBuffer(renderer,
+      IVY_UNIFORM_TEMPORARY_BUFFER, sizeof(*uniform), &uniformBuffer);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    return ivyCode;
+  }
+
+  uniform = uniformBuffer.data;
+  ivyCopyM4(&renderer->cameraView, &uniform->view);
+  ivyCopyM4(&renderer->projection, &uniform->projection);
+
+  // NOTE: kept so recording contexts can bind the same uniform
+  frame->cameraDescriptorSet = uniformBuffer.descriptorSet;
+  frame->cameraUniformOffset = uniformBuffer.offsetInU32;
+
+  vkCmdBindDescriptorSets(ivyGetCurrentGraphicsCommandBuffer(renderer),
+      VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->mainPipelineLayout, 0, 1,
+      &frame->cameraDescriptorSet, 1, &frame->cameraUniformOffset);
+
+  return IVY_OK;
+}
+
+IVY_API VkCommandBuffer ivyGetCurrentGraphicsCommandBuffer(
+    IvyRenderer *renderer) {
+  IvyGraphicsFrame *frame = ivyGetCurrentGraphicsFrame(renderer);
+
+  if (renderer->usesRecordingContexts) {
+    return frame->recordingContexts[0].commandBuffer;
+  }
+
+  return frame->commandBuffer;
+}
+
+IVY_INTERNAL void ivyRecordGraphicsModelMatrix(IvyRenderer *renderer,
+    IvyM4 const *model) {
+  IvyGraphicsProgramPushConstants pushConstants;
+  VkCommandBuffer commandBuffer =
+      ivyGetCurrentGraphicsCommandBuffer(renderer);
+
+  ivyCopyM4(model, &pushConstants.model);
+
+  vkCmdPushConstants(commandBuffer, renderer->mainPipelineLayout,
+      VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pushConstants), &pushConstants);
+}
+
+IVY_INTERNAL void ivyRecordGraphicsTextureBind(IvyRenderer *renderer,
+    IvyGraphicsTexture *texture) {
+  VkCommandBuffer commandBuffer =
+      ivyGetCurrentGraphicsCommandBuffer(renderer);
+  vkCmdBindDescriptorSets(commandBuffer,
+      VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->mainPipelineLayout, 1, 1,
+      &texture->descriptorSet, 0, NULL);
+}
+
+IVY_API void ivyPushGraphicsModelMatrix(IvyRenderer *renderer,
+    IvyM4 const *model) {
+  ivyCopyM4(model, &renderer->pushedModelMatrix);
+  renderer->hasPushedModelMatrix = 1;
+  ivyRecordGraphicsModelMatrix(renderer, model);
+}
+
+IVY_API void ivyBindGraphicsTexture(IvyRenderer *renderer,
+    IvyGraphicsTexture *texture) {
+  renderer->boundGraphicsTexture = texture;
+  ivyRecordGraphicsTextureBind(renderer, texture);
+}
+
+IVY_API IvyCode ivyFlushGraphicsQuadBatch(IvyRenderer *renderer) {
+  uint32_t firstQuad;
+  uint32_t quadCount;
+  IvyM4 model;
+  IvyGraphicsProgram *previousProgram;
+  IvyGraphicsQuadBatch *batch = &renderer->quadBatch;
+  VkCommandBuffer commandBuffer =
+      ivyGetCurrentGraphicsCommandBuffer(renderer);
+
+  if (batch->firstQuad == batch->quadCount) {
+    return IVY_OK;
+  }
+
+  // NOTE: mark the run as drawn before binding the program, as binding a
+  //       different program flushes the batch
+  firstQuad = batch->firstQuad;
+  quadCount = batch->quadCount - batch->firstQuad;
+  batch->firstQuad = batch->quadCount;
+
+  previousProgram = renderer->boundGraphicsProgram;
+  ivyBindGraphicsProgram(renderer, batch->program);
+
+  vkCmdBindVertexBuffers(commandBuffer, 0, 1, &batch->vertexBuffer,
+      &batch->vertexBufferOffset);
+
+  vkCmdBindIndexBuffer(commandBuffer,
+      renderer->quadIndexBuffer->buffer, 0, VK_INDEX_TYPE_UINT32);
+
+  ivyIdentityM4(&model);
+  ivyRecordGraphicsModelMatrix(renderer, &model);
+
+  ivyRecordGraphicsTextureBind(renderer, batch->texture);
+
+  vkCmdDrawIndexed(commandBuffer, quadCount * 6, 1, 0,
+      (int32_t)(firstQuad * 4), 0);
+
+  // NOTE: put back what the caller had, their next draw may not rebind it.
+  //       Vertex and index buffers are not tracked, draws always bind those
+  if (previousProgram && previousProgram != batch->program) {
+    renderer->boundGraphicsProgram = previousProgram;
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+        previousProgram->pipeline);
+  }
+
+  if (renderer->hasPushedModelMatrix) {
+    ivyRecordGraphicsModelMatrix(renderer, &renderer->pushedModelMatrix);
+  }
+
+  if (renderer->boundGraphicsTexture) {
+    ivyRecordGraphicsTextureBind(renderer, renderer->boundGraphicsTexture);
+  }
+
+  return IVY_OK;
+}
+
+IVY_INTERNAL IvyCode ivyBeginGraphicsRecordingContextAtIndex(
+    IvyRenderer *renderer, uint32_t index,
+    IvyGraphicsRecordingContext **recordingContext) {
+  VkResult vulkanResult;
+  VkCommandBufferBeginInfo commandBufferBeginInfo;
+  VkCommandBufferInheritanceInfo inheritanceInfo;
+  IvyGraphicsFrame *frame = ivyGetCurrentGraphicsFrame(renderer);
+  IvyGraphicsRecordingContext *currentRecordingContext =
+      &frame->recordingContexts[index];
+
+  IVY_ASSERT(renderer->usesRecordingContexts);
+  IVY_ASSERT(!currentRecordingContext->isRecording);
+  IVY_ASSERT(!currentRecordingContext->isRecorded);
+
+  // NOTE: the frame fence was waited on, so the last use is done
+  vulkanResult = vkResetCommandPool(renderer->device.logicalDevice,
+      currentRecordingContext->commandPool, 0);
+  IVY_ASSERT(!vulkanResult);
+  if (vulkanResult) {
+    return ivyVulkanResultAsIvyCode(vulkanResult);
+  }
+
+  inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+  inheritanceInfo.pNext = NULL;
+  inheritanceInfo.renderPass = renderer->mainRenderPass;
+  inheritanceInfo.subpass = 0;
+  inheritanceInfo.framebuffer = frame->framebuffer;
+  inheritanceInfo.occlusionQueryEnable = VK_FALSE;
+  inheritanceInfo.queryFlags = 0;
+  inheritanceInfo.pipelineStatistics = 0;
+
+  commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  commandBufferBeginInfo.pNext = NULL;
+  commandBufferBeginInfo.flags =
+      VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+      VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+  commandBufferBeginInfo.pInheritanceInfo = &inheritanceInfo;
+
+  vulkanResult = vkBeginCommandBuffer(currentRecordingContext->commandBuffer,
+      &commandBufferBeginInfo);
+  IVY_ASSERT(!vulkanResult);
+  if (vulkanResult) {
+    return ivyVulkanResultAsIvyCode(vulkanResult);
+  }
+
+  // NOTE: context 0 binds the camera uniform itself when the frame begins
+  if (frame->cameraDescriptorSet) {
+    vkCmdBindDescriptorSets(currentRecordingContext->commandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->mainPipelineLayout, 0, 1,
+        &frame->cameraDescriptorSet, 1, &frame->cameraUniformOffset);
+  }
+
+  currentRecordingContext->isRecording = 1;
+  currentRecordingContext->boundGraphicsProgram = NULL;
+  IVY_MEMSET(currentRecordingContext->temporaryBufferReservations, 0,
+      sizeof(currentRecordingContext->temporaryBufferReservations));
+
+  *recordingContext = currentRecordingContext;
+
+  return IVY_OK;
+}
+
+IVY_API IvyCode ivyBeginGraphicsRecordingContext(IvyRenderer *renderer,
+    uint32_t index, IvyGraphicsRecordingContext **recordingContext) {
+  IVY_ASSERT(index > 0);
+  IVY_ASSERT(index < IVY_MAX_GRAPHICS_RECORDING_CONTEXTS);
+
+  if (!index || IVY_MAX_GRAPHICS_RECORDING_CONTEXTS <= index) {
+    *recordingContext = NULL;
+    return IVY_ERROR_INVALID_VALUE;
+  }
+
+  return ivyBeginGraphicsRecordingContextAtIndex(renderer, index,
+      recordingContext);
+}
+
+IVY_API void ivyBindGraphicsProgramInRecordingContext(
+    IvyGraphicsRecordingContext *recordingContext,
+    IvyGraphicsProgram *program) {
+  if (recordingContext->boundGraphicsProgram == program) {
+    return;
+  }
+
+  recordingContext->boundGraphicsProgram = program;
+  vkCmdBindPipeline(recordingContext->commandBuffer,
+      VK_PIPELINE_BIND_POINT_GRAPHICS, program->pipeline);
+}
+
+IVY_API void ivyBindGraphicsTextureInRecordingContext(IvyRenderer *renderer,
+    IvyGraphicsRecordingContext *recordingContext,
+    IvyGraphicsTexture *texture) {
+  vkCmdBindDescriptorSets(recordingContext->commandBuffer,
+      VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->mainPipelineLayout, 1, 1,
+      &texture->descriptorSet, 0, NULL);
+}
+
+IVY_API void ivyPushGraphicsModelMatrixInRecordingContext(
+    IvyRenderer *renderer, IvyGraphicsRecordingContext *recordingContext,
+    IvyM4 const *model) {
+  IvyGraphicsProgramPushConstants pushConstants;
+
+  ivyCopyM4(model, &pushConstants.model);
+
+  vkCmdPushConstants(recordingContext->commandBuffer,
+      renderer->mainPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0,
+      sizeof(pushConstants), &pushConstants);
+}
+
+IVY_API IvyCode ivyRequestGraphicsTemporaryBufferInRecordingContext(
+    IvyRenderer *renderer, IvyGraphicsRecordingContext *recordingContext,
+    IvyGraphicsTemporaryBufferUsage usage, uint64_t size,
+    IvyGraphicsTemporaryBuffer *temporaryBuffer) {
+  uint64_t alignment;
+  uint64_t alignedSize;
+  IvyGraphicsTemporaryBuffer *reservation;
+
+  IVY_ASSERT(0 <= (int)usage && IVY_MAX_TEMPORARY_BUFFER_USAGES > usage);
+  IVY_ASSERT(recordingContext->isRecording);
+
+  reservation = &recordingContext->temporaryBufferReservations[usage];
+  alignment = ivyGetGraphicsTemporaryBufferAlignment(renderer, usage);
+  alignedSize = ivyAlignTo(size, alignment);
+
+  if (reservation->size < alignedSize) {
+    IvyCode ivyCode = ivyRequestGraphicsTemporaryBuffer(renderer, usage,
+        IVY_MAX(alignedSize, IVY_GRAPHICS_RECORDING_CONTEXT_RESERVATION_SIZE),
+        reservation);
+    IVY_ASSERT(!ivyCode);
+    if (ivyCode) {
+      reservation->size = 0;
+      return ivyCode;
+    }
+  }
+
+  temporaryBuffer->data = reservation->data;
+  temporaryBuffer->size = size;
+  temporaryBuffer->offsetInU64 = reservation->offsetInU64;
+  temporaryBuffer->offsetInU32 = reservation->offsetInU32;
+  temporaryBuffer->buffer = reservation->buffer;
+  temporaryBuffer->descriptorSet = reservation->descriptorSet;
+
+  reservation->data = (uint8_t *)reservation->data + alignedSize;
+  reservation->size -= alignedSize;
+  reservation->offsetInU64 += alignedSize;
+  reservation->offsetInU32 += (uint32_t)alignedSize;
+
+  return IVY_OK;
+}
+
+IVY_API IvyCode ivyEndGraphicsRecordingContext(IvyRenderer *renderer,
+    IvyGraphicsRecordingContext *recordingContext) {
+  VkResult vulkanResult;
+
+  IVY_UNUSED(renderer);
+  IVY_ASSERT(recordingContext->isRecording);
+
+  vulkanResult = vkEndCommandBuffer(recordingContext->commandBuffer);
+  IVY_ASSERT(!vulkanResult);
+  if (vulkanResult) {
+    return ivyVulkanResultAsIvyCode(vulkanResult);
+  }
+
+  recordingContext->isRecording = 0;
+  recordingContext->isRecorded = 1;
+
+  return IVY_OK;
+}
+
+// NOTE: executes the recorded contexts in index order so the result doesn't
+//       depend on which worker finished first
+IVY_INTERNAL void ivyExecuteGraphicsRecordingContexts(IvyRenderer *renderer,
+    IvyGraphicsFrame *frame) {
+  uint32_t index;
+  uint32_t commandBufferCount = 0;
+  VkCommandBuffer commandBuffers[IVY_MAX_GRAPHICS_RECORDING_CONTEXTS];
+
+  IVY_UNUSED(renderer);
+
+  for (index = 0; index < IVY_MAX_GRAPHICS_RECORDING_CONTEXTS; ++index) {
+    IvyGraphicsRecordingContext *recordingContext =
+        &frame->recordingContexts[index];
+
+    IVY_ASSERT(!recordingContext->isRecording);
+    if (!recordingContext->isRecorded) {
+      continue;
+    }
+
+    commandBuffers[commandBufferCount++] = recordingContext->commandBuffer;
+    recordingContext->isRecorded = 0;
+  }
+
+  if (commandBufferCount) {
+    vkCmdExecuteCommands(frame->commandBuffer, commandBufferCount,
+        commandBuffers);
+  }
+}
+
+IVY_INTERNAL IvyCode ivyBeginGraphicsFrameWithSubpassContents(
+    IvyRenderer *renderer, VkSubpassContents subpassContents) {
   IvyCode ivyCode;
   VkResult vulkanResult;
   VkCommandBufferBeginInfo commandBufferBeginInfo;
   VkRenderPassBeginInfo renderPassBeginInfo;
   IvyGraphicsFrame *frame;
+  IvyGraphicsRecordingContext *recordingContext;
 
   IVY_UNUSED(ivyCode);
   IVY_UNUSED(vulkanResult);
@@ -1943,7 +2816,15 @@ IVY_API IvyCode ivyBeginGraphicsFrame(IvyRenderer *renderer) {
       frame->commandPool, 0);
   IVY_ASSERT(!vulkanResult);
 
-  frame->currentChunk.offset = 0;
+  ivyCode = ivyResetGraphicsDescriptorAllocator(
+      renderer->device.logicalDevice, &frame->descriptorAllocator);
+  IVY_ASSERT(!ivyCode);
+
+  ivyResetGraphicsTemporaryBufferPools(renderer, frame);
+
+  IVY_MEMSET(&renderer->quadBatch, 0, sizeof(renderer->quadBatch));
+
+  ivyResetDrawList(&renderer->drawList);
 
   commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
   commandBufferBeginInfo.pNext = NULL;
@@ -1967,12 +2848,43 @@ IVY_API IvyCode ivyBeginGraphicsFrame(IvyRenderer *renderer) {
   renderPassBeginInfo.pClearValues = renderer->clearValues;
 
   vkCmdBeginRenderPass(frame->commandBuffer, &renderPassBeginInfo,
-      VK_SUBPASS_CONTENTS_INLINE);
+      subpassContents);
+
+  frame->cameraDescriptorSet = VK_NULL_HANDLE;
+  renderer->usesRecordingContexts =
+      VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS == subpassContents;
+
+  if (renderer->usesRecordingContexts) {
+    ivyCode = ivyBeginGraphicsRecordingContextAtIndex(renderer, 0,
+        &recordingContext);
+    IVY_ASSERT(!ivyCode);
+    if (ivyCode) {
+      return ivyCode;
+    }
+  }
+
+  ivyCode = ivyBindGraphicsCameraUniform(renderer);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    return ivyCode;
+  }
 
   return IVY_OK;
 }
 
+IVY_API IvyCode ivyBeginGraphicsFrame(IvyRenderer *renderer) {
+  return ivyBeginGraphicsFrameWithSubpassContents(renderer,
+      VK_SUBPASS_CONTENTS_INLINE);
+}
+
+IVY_API IvyCode ivyBeginGraphicsFrameWithRecordingContexts(
+    IvyRenderer *renderer) {
+  return ivyBeginGraphicsFrameWithSubpassContents(renderer,
+      VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+}
+
 IVY_API IvyCode ivyEndGraphicsFrame(IvyRenderer *renderer) {
+  IvyCode ivyCode;
   VkResult vulkanResult;
   VkSubmitInfo submitInfo;
   VkPresentInfoKHR presentInfo;
@@ -1980,11 +2892,26 @@ IVY_API IvyCode ivyEndGraphicsFrame(IvyRenderer *renderer) {
   IvyGraphicsFrame *frame;
   IvyGraphicsRenderSemaphores *semaphores;
 
+  IVY_UNUSED(ivyCode);
   IVY_UNUSED(vulkanResult);
 
   frame = ivyGetCurrentGraphicsFrame(renderer);
   semaphores = ivyGetCurrentGraphicsRenderSemaphores(renderer);
 
+  ivyCode = ivyFlushGraphicsQuadBatch(renderer);
+  IVY_ASSERT(!ivyCode);
+
+  ivyCode = ivySubmitDrawList(renderer, &renderer->drawList);
+  IVY_ASSERT(!ivyCode);
+
+  if (renderer->usesRecordingContexts) {
+    ivyCode = ivyEndGraphicsRecordingContext(renderer,
+        &frame->recordingContexts[0]);
+    IVY_ASSERT(!ivyCode);
+
+    ivyExecuteGraphicsRecordingContexts(renderer, frame);
+  }
+
   vkCmdEndRenderPass(frame->commandBuffer);
   vulkanResult = vkEndCommandBuffer(frame->commandBuffer);
   IVY_ASSERT(!vulkanResult);
@@ -2028,19 +2955,29 @@ IVY_API IvyCode ivyEndGraphicsFrame(IvyRenderer *renderer) {
   }
 
   renderer->boundGraphicsProgram = NULL;
+  renderer->boundGraphicsTexture = NULL;
+  renderer->hasPushedModelMatrix = 0;
 
   return IVY_OK;
 }
 
 IVY_API void ivyBindGraphicsProgram(IvyRenderer *renderer,
     IvyGraphicsProgram *program) {
-  IvyGraphicsFrame *frame = ivyGetCurrentGraphicsFrame(renderer);
+  if (renderer->boundGraphicsProgram == program) {
+    return;
+  }
+
+  // NOTE: whatever was batched with the previous program goes first. The
+  //       program is about to change, so the flush shouldn't put it back
+  renderer->boundGraphicsProgram = NULL;
+  ivyFlushGraphicsQuadBatch(renderer);
 
+  // NOTE: the batch may have been drawn with this very program
   if (renderer->boundGraphicsProgram == program) {
     return;
   }
 
   renderer->boundGraphicsProgram = program;
-  vkCmdBindPipeline(frame->commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-      program->pipeline);
+  vkCmdBindPipeline(ivyGetCurrentGraphicsCommandBuffer(renderer),
+      VK_PIPELINE_BIND_POINT_GRAPHICS, program->pipeline);
 }
@@ -1,21 +1,43 @@
 #ifndef IVY_RENDERER_H
 #define IVY_RENDERER_H
 
+#include <pthread.h>
+
 #include "IvyApplication.h"
-#include "IvyDummyGraphicsMemoryAllocator.h"
+#include "IvyBlockGraphicsMemoryAllocator.h"
+#include "IvyDrawList.h"
+#include "IvyGraphicsDataUploader.h"
+#include "IvyGraphicsDescriptorAllocator.h"
+#include "IvyGraphicsIndexBuffer.h"
 #include "IvyGraphicsProgram.h"
+#include "IvyGraphicsTexture.h"
+#include "IvyGraphicsVertexBuffer.h"
 #include "IvyMemoryAllocator.h"
 #include "IvyVectorMath.h"
+#include "IvyVulkanHostMemoryAllocator.h"
 
 #define IVY_MAX_SWAPCHAIN_IMAGES 8
+#define IVY_MAX_BATCHED_QUADS 256
+#define IVY_MAX_GRAPHICS_RECORDING_CONTEXTS 8
+#define IVY_GRAPHICS_RECORDING_CONTEXT_RESERVATION_SIZE (16 * 1024)
+#define IVY_TEMPORARY_BUFFER_PEAK_WINDOW 256
 
 typedef struct IvyGraphicsDevice {
   VkPhysicalDevice physicalDevice;
   VkDevice logicalDevice;
+  // NOTE: handed to every call that takes a pAllocator, NULL once the
+  //       renderer's host allocator is gone
+  VkAllocationCallbacks const *allocationCallbacks;
   uint32_t graphicsQueueFamilyIndex;
   uint32_t presentQueueFamilyIndex;
   VkQueue graphicsQueue;
   VkQueue presentQueue;
+  uint32_t transferQueueFamilyIndex;
+  VkQueue transferQueue;
+  VkSemaphore uploadSemaphore;
+  uint64_t uploadTimelineValue;
+  VkPhysicalDeviceProperties properties;
+  VkPhysicalDeviceMemoryProperties memoryProperties;
 } IvyGraphicsDevice;
 
 typedef struct IvyGraphicsAttachment {
@@ -43,18 +65,77 @@ typedef struct IvyGraphicsTemporaryBuffer {
   VkDescriptorSet descriptorSet;
 } IvyGraphicsTemporaryBuffer;
 
+// NOTE: usedSize and chunkCreationCount cover the frame being recorded,
+//       peakUsedSize is the high water mark since the last consolidation,
+//       over at most IVY_TEMPORARY_BUFFER_PEAK_WINDOW uses of the frame.
+//       Once the frame has settled chunkCreationCount should stay at 0.
+typedef struct IvyGraphicsTemporaryBufferStatistics {
+  uint64_t usedSize;
+  uint64_t peakUsedSize;
+  uint64_t capacity;
+  uint32_t chunkCreationCount;
+  uint32_t consolidationCount;
+  uint32_t windowUseCount;
+} IvyGraphicsTemporaryBufferStatistics;
+
+typedef enum IvyGraphicsTemporaryBufferUsage {
+  IVY_UNIFORM_TEMPORARY_BUFFER,
+  IVY_VERTEX_TEMPORARY_BUFFER,
+  IVY_INDEX_TEMPORARY_BUFFER,
+  IVY_MAX_TEMPORARY_BUFFER_USAGES
+} IvyGraphicsTemporaryBufferUsage;
+
+typedef struct IvyGraphicsTemporaryBufferPool {
+  IvyGraphicsRenderBufferChunk currentChunk;
+  uint32_t garbageChunkCount;
+  IvyGraphicsRenderBufferChunk *garbageChunks;
+  IvyGraphicsTemporaryBufferStatistics statistics;
+} IvyGraphicsTemporaryBufferPool;
+
+// NOTE: a command pool and secondary command buffer owned by one thread for
+//       the frame. Context 0 belongs to the thread that began the frame, the
+//       rest are handed to workers. The pools are created with the frames.
+//       Temporary buffers are carved out of reservations taken from the
+//       frame pools, so workers only take the lock when one runs out
+typedef struct IvyGraphicsRecordingContext {
+  VkCommandPool commandPool;
+  VkCommandBuffer commandBuffer;
+  IvyBool isRecording;
+  IvyBool isRecorded;
+  IvyGraphicsProgram *boundGraphicsProgram;
+  IvyGraphicsTemporaryBuffer
+      temporaryBufferReservations[IVY_MAX_TEMPORARY_BUFFER_USAGES];
+} IvyGraphicsRecordingContext;
+
 typedef struct IvyGraphicsFrame {
   VkCommandPool commandPool;
   VkCommandBuffer commandBuffer;
+  VkDescriptorSet cameraDescriptorSet;
+  uint32_t cameraUniformOffset;
+  IvyGraphicsRecordingContext
+      recordingContexts[IVY_MAX_GRAPHICS_RECORDING_CONTEXTS];
   VkImage image;
   VkImageView imageView;
   VkFramebuffer framebuffer;
   VkFence inFlightFence;
-  IvyGraphicsRenderBufferChunk currentChunk;
-  uint32_t garbageChunkCount;
-  IvyGraphicsRenderBufferChunk *garbageChunks;
+  IvyGraphicsDescriptorAllocator descriptorAllocator;
+  IvyGraphicsTemporaryBufferPool
+      temporaryBufferPools[IVY_MAX_TEMPORARY_BUFFER_USAGES];
 } IvyGraphicsFrame;
 
+// NOTE: quads are written straight into a region of the frame vertex stream
+//       reserved for IVY_MAX_BATCHED_QUADS quads. [firstQuad, quadCount) is
+//       the run that shares program and texture and hasn't been drawn yet
+typedef struct IvyGraphicsQuadBatch {
+  IvyGraphicsProgram *program;
+  IvyGraphicsTexture *texture;
+  uint32_t firstQuad;
+  uint32_t quadCount;
+  VkBuffer vertexBuffer;
+  uint64_t vertexBufferOffset;
+  IvyGraphicsVertex332 *vertices;
+} IvyGraphicsQuadBatch;
+
 typedef struct IvyGraphicsRenderSemaphores {
   VkSemaphore renderDoneSemaphore;
   VkSemaphore swapchainImageAvailableSemaphore;
@@ -87,6 +168,7 @@ typedef struct IvyRenderer {
   IvyV3 cameraEye;
   IvyApplication *application;
   IvyAnyMemoryAllocator ownerMemoryAllocator;
+  IvyVulkanHostMemoryAllocator vulkanHostMemoryAllocator;
   VkInstance instance;
   PFN_vkCreateDebugUtilsMessengerEXT createDebugUtilsMessengerEXT;
   PFN_vkDestroyDebugUtilsMessengerEXT destroyDebugUtilsMessengerEXT;
@@ -101,8 +183,9 @@ typedef struct IvyRenderer {
   VkPhysicalDevice *availablePhysicalDevices;
   IvyGraphicsDevice device;
   VkCommandPool transientCommandPool;
-  VkDescriptorPool globalDescriptorPool;
-  IvyDummyGraphicsMemoryAllocator defaultGraphicsMemoryAllocator;
+  IvyGraphicsDescriptorAllocator persistentDescriptorAllocator;
+  IvyBlockGraphicsMemoryAllocator defaultGraphicsMemoryAllocator;
+  IvyGraphicsStagingRing stagingRing;
   VkClearValue clearValues[2];
   VkRenderPass mainRenderPass;
   VkDescriptorSetLayout uniformDescriptorSetLayout;
@@ -121,7 +204,21 @@ typedef struct IvyRenderer {
   IvyGraphicsFrame *frames;
   IvyGraphicsRenderSemaphores *renderSemaphores;
   IvyGraphicsProgram basicGraphicsProgram;
+  IvyGraphicsProgram quadInstanceGraphicsProgram;
   IvyGraphicsProgram *boundGraphicsProgram;
+  // NOTE: what the caller last bound and pushed this frame, the quad batch
+  //       puts it back after drawing
+  IvyGraphicsTexture *boundGraphicsTexture;
+  IvyBool hasPushedModelMatrix;
+  IvyM4 pushedModelMatrix;
+  IvyBool usesRecordingContexts;
+  // NOTE: guards the frame temporary buffer pools while recording contexts
+  //       are in use
+  pthread_mutex_t temporaryBufferMutex;
+  IvyGraphicsIndexBuffer *quadIndexBuffer;
+  IvyGraphicsVertexBuffer *unitQuadVertexBuffer;
+  IvyGraphicsQuadBatch quadBatch;
+  IvyDrawList drawList;
 } IvyRenderer;
 
 IVY_API IvyCode ivyCreateRenderer(IvyAnyMemoryAllocator allocator,
@@ -134,13 +231,84 @@ IVY_API IvyGraphicsFrame *ivyGetCurrentGraphicsFrame(IvyRenderer *renderer);
 
 IVY_API IvyCode ivyRebuildGraphicsSwapchain(IvyRenderer *renderer);
 
+// NOTE: takes temporaryBufferMutex while recording contexts are in use, so
+//       the thread that began the frame can request buffers while workers
+//       record. Workers request through their recording context instead
 IVY_API IvyCode ivyRequestGraphicsTemporaryBuffer(IvyRenderer *renderer,
-    uint64_t size, IvyGraphicsTemporaryBuffer *temporaryBuffer);
+    IvyGraphicsTemporaryBufferUsage usage, uint64_t size,
+    IvyGraphicsTemporaryBuffer *temporaryBuffer);
+
+// NOTE: called once per use of the frame, before its pools are reset.
+//       Returns the size the pool should be consolidated to, or 0 to keep
+//       its chunk. Outgrown pools are always consolidated, pools whose chunk
+//       is more than twice what the window needed are shrunk once the window
+//       ends. The peak starts over after either
+IVY_API uint64_t ivyComputeGraphicsTemporaryBufferConsolidationSize(
+    IvyGraphicsTemporaryBufferStatistics *statistics, uint64_t chunkSize,
+    IvyBool isOutgrown, uint64_t alignment);
+
+IVY_API void ivyGetGraphicsTemporaryBufferStatistics(IvyRenderer *renderer,
+    IvyGraphicsTemporaryBufferUsage usage,
+    IvyGraphicsTemporaryBufferStatistics *statistics);
 
 IVY_API void ivyBindGraphicsProgram(IvyRenderer *renderer,
     IvyGraphicsProgram *program);
 
+// NOTE: returns the command buffer draws of the thread that began the frame
+//       go to, which is recording context 0 when recording contexts are used
+IVY_API VkCommandBuffer ivyGetCurrentGraphicsCommandBuffer(
+    IvyRenderer *renderer);
+
+IVY_API void ivyPushGraphicsModelMatrix(IvyRenderer *renderer,
+    IvyM4 const *model);
+
+IVY_API void ivyBindGraphicsTexture(IvyRenderer *renderer,
+    IvyGraphicsTexture *texture);
+
+// NOTE: draws the rectangles batched since the last flush. Called whenever
+//       the program or texture changes and before the render pass ends, so
+//       it can run in between the caller's own draws. The batch draws with
+//       an identity model matrix and its own texture. Afterwards the program,
+//       model matrix and texture last set through the calls above are
+//       recorded again. Vertex and index buffers are not restored
+IVY_API IvyCode ivyFlushGraphicsQuadBatch(IvyRenderer *renderer);
+
 IVY_API IvyCode ivyBeginGraphicsFrame(IvyRenderer *renderer);
+
+// NOTE: like ivyBeginGraphicsFrame, but the main render pass only executes
+//       secondary command buffers, so other threads can record draws through
+//       recording contexts. They are executed in index order at frame end
+IVY_API IvyCode ivyBeginGraphicsFrameWithRecordingContexts(
+    IvyRenderer *renderer);
+
 IVY_API IvyCode ivyEndGraphicsFrame(IvyRenderer *renderer);
 
+// NOTE: index has to be in [1, IVY_MAX_GRAPHICS_RECORDING_CONTEXTS) and each
+//       index can only be used by one thread at a time. The context starts
+//       with the camera uniform bound
+IVY_API IvyCode ivyBeginGraphicsRecordingContext(IvyRenderer *renderer,
+    uint32_t index, IvyGraphicsRecordingContext **recordingContext);
+
+IVY_API void ivyBindGraphicsProgramInRecordingContext(
+    IvyGraphicsRecordingContext *recordingContext,
+    IvyGraphicsProgram *program);
+
+IVY_API void ivyBindGraphicsTextureInRecordingContext(IvyRenderer *renderer,
+    IvyGraphicsRecordingContext *recordingContext,
+    IvyGraphicsTexture *texture);
+
+IVY_API void ivyPushGraphicsModelMatrixInRecordingContext(
+    IvyRenderer *renderer, IvyGraphicsRecordingContext *recordingContext,
+    IvyM4 const *model);
+
+// NOTE: safe to call from the thread that owns the context while other
+//       threads record. The buffer lives until the frame comes around again
+IVY_API IvyCode ivyRequestGraphicsTemporaryBufferInRecordingContext(
+    IvyRenderer *renderer, IvyGraphicsRecordingContext *recordingContext,
+    IvyGraphicsTemporaryBufferUsage usage, uint64_t size,
+    IvyGraphicsTemporaryBuffer *temporaryBuffer);
+
+IVY_API IvyCode ivyEndGraphicsRecordingContext(IvyRenderer *renderer,
+    IvyGraphicsRecordingContext *recordingContext);
+
 #endif
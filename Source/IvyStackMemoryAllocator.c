@@ -0,0 +1,237 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "IvyStackMemoryAllocator.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+IVY_INTERNAL uint64_t ivyAlignStackMemorySize(uint64_t size,
+    uint64_t alignment) {
+  return ((size + alignment - 1) / alignment) * alignment;
+}
+
+IVY_INTERNAL void *ivyStackMemoryAllocatorAllocate(
+    IvyAnyMemoryAllocator allocator, uint64_t size) {
+  uint64_t position;
+  uint64_t newPosition;
+  IvyStackMemoryAllocator *stackAllocator = allocator;
+
+  position = stackAllocator->position;
+  if (position + size > stackAllocator->capacity) {
+    return NULL;
+  }
+
+  newPosition =
+      position + ivyAlignStackMemorySize(size, stackAllocator->alignment);
+  if (newPosition > stackAllocator->capacity) {
+    newPosition = stackAllocator->capacity;
+  }
+
+  stackAllocator->position = newPosition;
+
+  ++stackAllocator->aliveAllocationCount;
+  return stackAllocator->previousAllocation =
+             (uint8_t *)stackAllocator->data + position;
+}
+
+IVY_INTERNAL void *ivyStackMemoryAllocatorAllocateAndZeroMemory(
+    IvyAnyMemoryAllocator allocator, uint64_t count, uint64_t elementSize) {
+  uint64_t size = count * elementSize;
+  void *allocation = ivyStackMemoryAllocatorAllocate(allocator, size);
+  if (allocation) {
+    IVY_MEMSET(allocation, 0, size);
+  }
+  return allocation;
+}
+
+IVY_INTERNAL void *ivyStackMemoryAllocatorReallocate(
+    IvyAnyMemoryAllocator allocator, void *data, uint64_t newSize) {
+  void *newData;
+  uint64_t offset;
+  uint64_t copySize;
+  IvyStackMemoryAllocator *stackAllocator = allocator;
+
+  if (!data) {
+    return ivyStackMemoryAllocatorAllocate(allocator, newSize);
+  }
+
+  offset = (uint8_t *)data - (uint8_t *)stackAllocator->data;
+
+  // NOTE: the top allocation just moves the position
+  if (data == stackAllocator->previousAllocation) {
+    uint64_t newPosition;
+
+    if (offset + newSize > stackAllocator->capacity) {
+      return NULL;
+    }
+
+    newPosition =
+        offset + ivyAlignStackMemorySize(newSize, stackAllocator->alignment);
+    if (newPosition > stackAllocator->capacity) {
+      newPosition = stackAllocator->capacity;
+    }
+
+    stackAllocator->position = newPosition;
+    return data;
+  }
+
+  // NOTE: the size isn't stored, but the old allocation can't go further
+  //       than the top of the stack
+  copySize = stackAllocator->position - offset;
+  if (copySize > newSize) {
+    copySize = newSize;
+  }
+
+  newData = ivyStackMemoryAllocatorAllocate(allocator, newSize);
+  if (!newData) {
+    return NULL;
+  }
+
+  IVY_MEMCPY(newData, data, copySize);
+  --stackAllocator->aliveAllocationCount;
+
+  return newData;
+}
+
+IVY_INTERNAL void ivyStackMemoryAllocatorFree(IvyAnyMemoryAllocator allocator,
+    void *data) {
+  IvyStackMemoryAllocator *stackAllocator = allocator;
+
+  if (!data) {
+    return;
+  }
+
+  IVY_ASSERT(stackAllocator->aliveAllocationCount);
+
+  if (data == stackAllocator->previousAllocation) {
+    stackAllocator->position =
+        (uint8_t *)data - (uint8_t *)stackAllocator->data;
+    stackAllocator->previousAllocation = NULL;
+  }
+
+  if (stackAllocator->aliveAllocationCount) {
+    --stackAllocator->aliveAllocationCount;
+  }
+
+  if (!stackAllocator->aliveAllocationCount) {
+    stackAllocator->position = 0;
+  }
+}
+
+IVY_INTERNAL void ivyStackMemoryAllocatorClear(
+    IvyAnyMemoryAllocator allocator) {
+  IvyStackMemoryAllocator *stackAllocator = allocator;
+  stackAllocator->position = 0;
+  stackAllocator->previousAllocation = NULL;
+  stackAllocator->aliveAllocationCount = 0;
+}
+
+IVY_INTERNAL void ivyStackMemoryAllocatorDestroy(
+    IvyAnyMemoryAllocator allocator) {
+  IvyStackMemoryAllocator *stackAllocator = allocator;
+  IVY_ASSERT(!stackAllocator->aliveAllocationCount);
+  free(stackAllocator->data);
+  stackAllocator->data = NULL;
+}
+
+IVY_INTERNAL IvyMemoryAllocatorDispatch const stackMemoryAllocatorDispatch = {
+    ivyStackMemoryAllocatorAllocate,
+    ivyStackMemoryAllocatorAllocateAndZeroMemory,
+    ivyStackMemoryAllocatorReallocate, ivyStackMemoryAllocatorFree,
+    ivyStackMemoryAllocatorClear, ivyStackMemoryAllocatorDestroy};
+
+IVY_API IvyCode ivyCreateStackMemoryAllocator(uint64_t size,
+    IvyStackMemoryAllocator *allocator) {
+  ivySetupMemoryAllocatorBase(&stackMemoryAllocatorDispatch, &allocator->base);
+
+  allocator->capacity = size;
+  allocator->position = 0;
+  allocator->alignment = sizeof(void *);
+  allocator->aliveAllocationCount = 0;
+  allocator->previousAllocation = NULL;
+  allocator->data = malloc(allocator->capacity);
+  if (!allocator->data) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+
+  return IVY_OK;
+}
+
+IVY_API void ivyGetStackMemoryMarker(IvyStackMemoryAllocator *allocator,
+    IvyStackMemoryMarker *marker) {
+  marker->position = allocator->position;
+  marker->aliveAllocationCount = allocator->aliveAllocationCount;
+}
+
+IVY_API void ivyFreeStackMemoryToMarker(IvyStackMemoryAllocator *allocator,
+    IvyStackMemoryMarker const *marker) {
+  IVY_ASSERT(marker->position <= allocator->position);
+  IVY_ASSERT(marker->aliveAllocationCount <= allocator->aliveAllocationCount);
+
+  allocator->position = marker->position;
+  allocator->previousAllocation = NULL;
+  allocator->aliveAllocationCount = marker->aliveAllocationCount;
+}
+
+IVY_INTERNAL pthread_key_t scratchMemoryAllocatorKey;
+IVY_INTERNAL pthread_once_t scratchMemoryAllocatorKeyOnce = PTHREAD_ONCE_INIT;
+
+IVY_INTERNAL void ivyReleaseThreadScratchMemoryAllocator(void *data) {
+  IvyStackMemoryAllocator *allocator = data;
+
+  // NOTE: whatever is still on the stack dies with the thread
+  ivyStackMemoryAllocatorClear(allocator);
+  ivyStackMemoryAllocatorDestroy(allocator);
+  free(allocator);
+}
+
+IVY_INTERNAL void ivyCreateScratchMemoryAllocatorKey(void) {
+  pthread_key_create(&scratchMemoryAllocatorKey,
+      ivyReleaseThreadScratchMemoryAllocator);
+}
+
+IVY_API IvyStackMemoryAllocator *ivyGetThreadScratchMemoryAllocator(void) {
+  IvyStackMemoryAllocator *allocator;
+
+  pthread_once(&scratchMemoryAllocatorKeyOnce,
+      ivyCreateScratchMemoryAllocatorKey);
+
+  allocator = pthread_getspecific(scratchMemoryAllocatorKey);
+  if (allocator) {
+    return allocator;
+  }
+
+  allocator = malloc(sizeof(*allocator));
+  if (!allocator) {
+    return NULL;
+  }
+
+  if (ivyCreateStackMemoryAllocator(IVY_DEFAULT_SCRATCH_MEMORY_SIZE,
+          allocator)) {
+    free(allocator);
+    return NULL;
+  }
+
+  if (pthread_setspecific(scratchMemoryAllocatorKey, allocator)) {
+    ivyStackMemoryAllocatorDestroy(allocator);
+    free(allocator);
+    return NULL;
+  }
+
+  return allocator;
+}
+
+IVY_API void ivyDestroyThreadScratchMemoryAllocator(void) {
+  IvyStackMemoryAllocator *allocator;
+
+  pthread_once(&scratchMemoryAllocatorKeyOnce,
+      ivyCreateScratchMemoryAllocatorKey);
+
+  allocator = pthread_getspecific(scratchMemoryAllocatorKey);
+  if (!allocator) {
+    return;
+  }
+
+  pthread_setspecific(scratchMemoryAllocatorKey, NULL);
+  ivyReleaseThreadScratchMemoryAllocator(allocator);
+}
@@ -0,0 +1,47 @@
+#ifndef IVY_STACK_MEMORY_ALLOCATOR_H
+#define IVY_STACK_MEMORY_ALLOCATOR_H
+
+#include "IvyMemoryAllocator.h"
+
+#define IVY_DEFAULT_SCRATCH_MEMORY_SIZE (256 * 1024)
+
+// NOTE: a fixed buffer where allocations are pushed on top of each other.
+//       Freeing the top allocation pops it, anything below it is only
+//       released when rolling back to a marker or clearing
+typedef struct IvyStackMemoryAllocator {
+  IvyMemoryAllocatorBase base;
+  uint64_t capacity;
+  uint64_t position;
+  uint64_t alignment;
+  int32_t aliveAllocationCount;
+  void *previousAllocation;
+  void *data;
+} IvyStackMemoryAllocator;
+
+typedef struct IvyStackMemoryMarker {
+  uint64_t position;
+  int32_t aliveAllocationCount;
+} IvyStackMemoryMarker;
+
+IVY_API IvyCode ivyCreateStackMemoryAllocator(uint64_t size,
+    IvyStackMemoryAllocator *allocator);
+
+IVY_API void ivyGetStackMemoryMarker(IvyStackMemoryAllocator *allocator,
+    IvyStackMemoryMarker *marker);
+
+// NOTE: everything allocated after the marker was taken is released.
+//       Markers have to be freed in reverse order
+IVY_API void ivyFreeStackMemoryToMarker(IvyStackMemoryAllocator *allocator,
+    IvyStackMemoryMarker const *marker);
+
+// NOTE: a stack of IVY_DEFAULT_SCRATCH_MEMORY_SIZE bytes owned by the
+//       calling thread, created the first time it's asked for. Meant for
+//       short lived allocations inside a single function, always roll back
+//       to a marker before returning. NULL if it couldn't be created
+IVY_API IvyStackMemoryAllocator *ivyGetThreadScratchMemoryAllocator(void);
+
+// NOTE: threads release their scratch when they exit, the main thread has
+//       to call this before shutting down
+IVY_API void ivyDestroyThreadScratchMemoryAllocator(void);
+
+#endif
@@ -0,0 +1,543 @@
+#define _DEFAULT_SOURCE
+
+#include "IvyTLSFMemoryAllocator.h"
+
+#include <sys/mman.h>
+
+#define IVY_TLSF_BLOCK_FREE_BIT ((uint64_t)1)
+#define IVY_TLSF_BLOCK_PREVIOUS_FREE_BIT ((uint64_t)2)
+#define IVY_TLSF_BLOCK_FLAGS_MASK                                            \
+  (IVY_TLSF_BLOCK_FREE_BIT | IVY_TLSF_BLOCK_PREVIOUS_FREE_BIT)
+#define IVY_TLSF_BLOCK_HEADER_SIZE ((uint64_t)sizeof(IvyTLSFMemoryBlock))
+#define IVY_TLSF_MIN_BLOCK_SIZE ((uint64_t)sizeof(IvyTLSFMemoryFreeLinks))
+
+IVY_INTERNAL uint32_t ivyFindLastBitSet(uint64_t value) {
+  return 63 - (uint32_t)__builtin_clzll(value);
+}
+
+IVY_INTERNAL uint32_t ivyFindFirstBitSet(uint32_t value) {
+  return (uint32_t)__builtin_ctz(value);
+}
+
+IVY_INTERNAL uint64_t ivyAlignTLSFSize(uint64_t size) {
+  return (size + IVY_TLSF_ALIGNMENT - 1) & ~(uint64_t)(IVY_TLSF_ALIGNMENT - 1);
+}
+
+IVY_INTERNAL uint64_t ivyGetTLSFBlockSize(IvyTLSFMemoryBlock const *block) {
+  return block->size & ~IVY_TLSF_BLOCK_FLAGS_MASK;
+}
+
+IVY_INTERNAL void ivySetTLSFBlockSize(IvyTLSFMemoryBlock *block,
+    uint64_t size) {
+  block->size = size | (block->size & IVY_TLSF_BLOCK_FLAGS_MASK);
+}
+
+IVY_INTERNAL IvyBool ivyIsTLSFBlockFree(IvyTLSFMemoryBlock const *block) {
+  return !!(block->size & IVY_TLSF_BLOCK_FREE_BIT);
+}
+
+IVY_INTERNAL IvyBool ivyIsPreviousTLSFBlockFree(
+    IvyTLSFMemoryBlock const *block) {
+  return !!(block->size & IVY_TLSF_BLOCK_PREVIOUS_FREE_BIT);
+}
+
+IVY_INTERNAL void *ivyGetTLSFBlockPayload(IvyTLSFMemoryBlock *block) {
+  return (uint8_t *)block + IVY_TLSF_BLOCK_HEADER_SIZE;
+}
+
+IVY_INTERNAL IvyTLSFMemoryBlock *ivyGetTLSFBlockFromPayload(void *data) {
+  return (IvyTLSFMemoryBlock *)((uint8_t *)data - IVY_TLSF_BLOCK_HEADER_SIZE);
+}
+
+IVY_INTERNAL IvyTLSFMemoryFreeLinks *ivyGetTLSFBlockFreeLinks(
+    IvyTLSFMemoryBlock *block) {
+  return ivyGetTLSFBlockPayload(block);
+}
+
+IVY_INTERNAL IvyTLSFMemoryBlock *ivyGetNextPhysicalTLSFBlock(
+    IvyTLSFMemoryBlock *block) {
+  return (IvyTLSFMemoryBlock *)((uint8_t *)ivyGetTLSFBlockPayload(block) +
+                                ivyGetTLSFBlockSize(block));
+}
+
+IVY_INTERNAL void ivyMarkTLSFBlockAsFree(IvyTLSFMemoryBlock *block) {
+  IvyTLSFMemoryBlock *nextBlock = ivyGetNextPhysicalTLSFBlock(block);
+
+  block->size |= IVY_TLSF_BLOCK_FREE_BIT;
+  nextBlock->size |= IVY_TLSF_BLOCK_PREVIOUS_FREE_BIT;
+  nextBlock->previousPhysicalBlock = block;
+}
+
+IVY_INTERNAL void ivyMarkTLSFBlockAsUsed(IvyTLSFMemoryBlock *block) {
+  IvyTLSFMemoryBlock *nextBlock = ivyGetNextPhysicalTLSFBlock(block);
+
+  block->size &= ~IVY_TLSF_BLOCK_FREE_BIT;
+  nextBlock->size &= ~IVY_TLSF_BLOCK_PREVIOUS_FREE_BIT;
+}
+
+IVY_INTERNAL void ivyMapTLSFSize(uint64_t size, uint32_t *firstLevel,
+    uint32_t *secondLevel) {
+  uint32_t lastBit;
+
+  if (size < IVY_TLSF_SMALL_BLOCK_SIZE) {
+    *firstLevel = 0;
+    *secondLevel = (uint32_t)(size / (IVY_TLSF_SMALL_BLOCK_SIZE /
+                                         IVY_TLSF_SECOND_LEVEL_COUNT));
+    return;
+  }
+
+  lastBit = ivyFindLastBitSet(size);
+  *secondLevel =
+      (uint32_t)(size >> (lastBit - IVY_TLSF_SECOND_LEVEL_COUNT_LOG2)) ^
+      IVY_TLSF_SECOND_LEVEL_COUNT;
+  *firstLevel = lastBit - (IVY_TLSF_FIRST_LEVEL_SHIFT - 1);
+}
+
+// NOTE: rounds the size up to the next list so any block found there fits,
+//       which is what keeps the search to a couple of bit scans
+IVY_INTERNAL void ivyMapTLSFSearchSize(uint64_t size, uint32_t *firstLevel,
+    uint32_t *secondLevel) {
+  if (size >= IVY_TLSF_SMALL_BLOCK_SIZE) {
+    size += ((uint64_t)1 << (ivyFindLastBitSet(size) -
+                                IVY_TLSF_SECOND_LEVEL_COUNT_LOG2)) -
+            1;
+  }
+
+  ivyMapTLSFSize(size, firstLevel, secondLevel);
+}
+
+IVY_INTERNAL IvyTLSFMemoryBlock *ivyFindSuitableTLSFBlock(
+    IvyTLSFMemoryAllocator *tlsfAllocator, uint32_t *firstLevel,
+    uint32_t *secondLevel) {
+  uint32_t secondLevelMap;
+
+  secondLevelMap = tlsfAllocator->secondLevelBitmaps[*firstLevel] &
+                   (~(uint32_t)0 << *secondLevel);
+  if (!secondLevelMap) {
+    uint32_t const firstLevelMap =
+        tlsfAllocator->firstLevelBitmap & (~(uint32_t)0 << (*firstLevel + 1));
+    if (!firstLevelMap) {
+      return NULL;
+    }
+
+    *firstLevel = ivyFindFirstBitSet(firstLevelMap);
+    secondLevelMap = tlsfAllocator->secondLevelBitmaps[*firstLevel];
+  }
+
+  *secondLevel = ivyFindFirstBitSet(secondLevelMap);
+  return tlsfAllocator->freeBlocks[*firstLevel][*secondLevel];
+}
+
+IVY_INTERNAL void ivyRemoveTLSFFreeBlockFromList(
+    IvyTLSFMemoryAllocator *tlsfAllocator, IvyTLSFMemoryBlock *block,
+    uint32_t firstLevel, uint32_t secondLevel) {
+  IvyTLSFMemoryFreeLinks *links = ivyGetTLSFBlockFreeLinks(block);
+  IvyTLSFMemoryBlock *nextFreeBlock = links->nextFreeBlock;
+  IvyTLSFMemoryBlock *previousFreeBlock = links->previousFreeBlock;
+
+  if (nextFreeBlock) {
+    ivyGetTLSFBlockFreeLinks(nextFreeBlock)->previousFreeBlock =
+        previousFreeBlock;
+  }
+
+  if (previousFreeBlock) {
+    ivyGetTLSFBlockFreeLinks(previousFreeBlock)->nextFreeBlock =
+        nextFreeBlock;
+    return;
+  }
+
+  tlsfAllocator->freeBlocks[firstLevel][secondLevel] = nextFreeBlock;
+  if (nextFreeBlock) {
+    return;
+  }
+
+  tlsfAllocator->secondLevelBitmaps[firstLevel] &=
+      ~((uint32_t)1 << secondLevel);
+  if (!tlsfAllocator->secondLevelBitmaps[firstLevel]) {
+    tlsfAllocator->firstLevelBitmap &= ~((uint32_t)1 << firstLevel);
+  }
+}
+
+IVY_INTERNAL void ivyRemoveTLSFFreeBlock(
+    IvyTLSFMemoryAllocator *tlsfAllocator, IvyTLSFMemoryBlock *block) {
+  uint32_t firstLevel;
+  uint32_t secondLevel;
+
+  ivyMapTLSFSize(ivyGetTLSFBlockSize(block), &firstLevel, &secondLevel);
+  ivyRemoveTLSFFreeBlockFromList(tlsfAllocator, block, firstLevel,
+      secondLevel);
+}
+
+IVY_INTERNAL void ivyInsertTLSFFreeBlock(
+    IvyTLSFMemoryAllocator *tlsfAllocator, IvyTLSFMemoryBlock *block) {
+  uint32_t firstLevel;
+  uint32_t secondLevel;
+  IvyTLSFMemoryBlock *headBlock;
+  IvyTLSFMemoryFreeLinks *links = ivyGetTLSFBlockFreeLinks(block);
+
+  ivyMapTLSFSize(ivyGetTLSFBlockSize(block), &firstLevel, &secondLevel);
+
+  headBlock = tlsfAllocator->freeBlocks[firstLevel][secondLevel];
+  links->nextFreeBlock = headBlock;
+  links->previousFreeBlock = NULL;
+  if (headBlock) {
+    ivyGetTLSFBlockFreeLinks(headBlock)->previousFreeBlock = block;
+  }
+
+  tlsfAllocator->freeBlocks[firstLevel][secondLevel] = block;
+  tlsfAllocator->firstLevelBitmap |= (uint32_t)1 << firstLevel;
+  tlsfAllocator->secondLevelBitmaps[firstLevel] |= (uint32_t)1 << secondLevel;
+}
+
+IVY_INTERNAL IvyBool ivyCanSplitTLSFBlock(IvyTLSFMemoryBlock const *block,
+    uint64_t size) {
+  return ivyGetTLSFBlockSize(block) >=
+         size + IVY_TLSF_BLOCK_HEADER_SIZE + IVY_TLSF_MIN_BLOCK_SIZE;
+}
+
+// NOTE: the remaining block is returned without any flags, the caller is in
+//       charge of marking it
+IVY_INTERNAL IvyTLSFMemoryBlock *ivySplitTLSFBlock(IvyTLSFMemoryBlock *block,
+    uint64_t size) {
+  IvyTLSFMemoryBlock *remainingBlock =
+      (IvyTLSFMemoryBlock *)((uint8_t *)ivyGetTLSFBlockPayload(block) + size);
+
+  remainingBlock->size =
+      ivyGetTLSFBlockSize(block) - size - IVY_TLSF_BLOCK_HEADER_SIZE;
+  remainingBlock->previousPhysicalBlock = block;
+  ivySetTLSFBlockSize(block, size);
+
+  return remainingBlock;
+}
+
+IVY_INTERNAL void ivyAbsorbTLSFBlock(IvyTLSFMemoryBlock *block,
+    IvyTLSFMemoryBlock *nextBlock) {
+  ivySetTLSFBlockSize(block, ivyGetTLSFBlockSize(block) +
+                                 IVY_TLSF_BLOCK_HEADER_SIZE +
+                                 ivyGetTLSFBlockSize(nextBlock));
+  ivyGetNextPhysicalTLSFBlock(block)->previousPhysicalBlock = block;
+}
+
+IVY_INTERNAL IvyTLSFMemoryBlock *ivyMergePreviousTLSFBlock(
+    IvyTLSFMemoryAllocator *tlsfAllocator, IvyTLSFMemoryBlock *block) {
+  IvyTLSFMemoryBlock *previousBlock;
+
+  if (!ivyIsPreviousTLSFBlockFree(block)) {
+    return block;
+  }
+
+  previousBlock = block->previousPhysicalBlock;
+  ivyRemoveTLSFFreeBlock(tlsfAllocator, previousBlock);
+  ivyAbsorbTLSFBlock(previousBlock, block);
+
+  return previousBlock;
+}
+
+IVY_INTERNAL void ivyMergeNextTLSFBlock(IvyTLSFMemoryAllocator *tlsfAllocator,
+    IvyTLSFMemoryBlock *block) {
+  IvyTLSFMemoryBlock *nextBlock = ivyGetNextPhysicalTLSFBlock(block);
+
+  if (!ivyIsTLSFBlockFree(nextBlock)) {
+    return;
+  }
+
+  ivyRemoveTLSFFreeBlock(tlsfAllocator, nextBlock);
+  ivyAbsorbTLSFBlock(block, nextBlock);
+}
+
+// NOTE: gives the tail of a used block back to the free lists
+IVY_INTERNAL void ivyTrimUsedTLSFBlock(IvyTLSFMemoryAllocator *tlsfAllocator,
+    IvyTLSFMemoryBlock *block, uint64_t size) {
+  IvyTLSFMemoryBlock *remainingBlock;
+
+  if (!ivyCanSplitTLSFBlock(block, size)) {
+    return;
+  }
+
+  remainingBlock = ivySplitTLSFBlock(block, size);
+  ivyMergeNextTLSFBlock(tlsfAllocator, remainingBlock);
+  ivyMarkTLSFBlockAsFree(remainingBlock);
+  ivyInsertTLSFFreeBlock(tlsfAllocator, remainingBlock);
+}
+
+IVY_INTERNAL uint64_t ivyAdjustTLSFRequestSize(uint64_t size) {
+  if (size < IVY_TLSF_MIN_BLOCK_SIZE) {
+    return IVY_TLSF_MIN_BLOCK_SIZE;
+  }
+
+  return ivyAlignTLSFSize(size);
+}
+
+IVY_INTERNAL void *ivyTLSFMemoryAllocatorAllocate(
+    IvyAnyMemoryAllocator allocator, uint64_t size) {
+  uint32_t firstLevel;
+  uint32_t secondLevel;
+  IvyTLSFMemoryBlock *block;
+  IvyTLSFMemoryAllocator *tlsfAllocator = allocator;
+  uint64_t const adjustedSize = ivyAdjustTLSFRequestSize(size);
+
+  if (adjustedSize >= IVY_TLSF_MAX_BLOCK_SIZE) {
+    return NULL;
+  }
+
+  ivyMapTLSFSearchSize(adjustedSize, &firstLevel, &secondLevel);
+  if (firstLevel >= IVY_TLSF_FIRST_LEVEL_COUNT) {
+    return NULL;
+  }
+
+  block = ivyFindSuitableTLSFBlock(tlsfAllocator, &firstLevel, &secondLevel);
+  if (!block) {
+    return NULL;
+  }
+
+  ivyRemoveTLSFFreeBlockFromList(tlsfAllocator, block, firstLevel,
+      secondLevel);
+
+  if (ivyCanSplitTLSFBlock(block, adjustedSize)) {
+    IvyTLSFMemoryBlock *remainingBlock =
+        ivySplitTLSFBlock(block, adjustedSize);
+    ivyMarkTLSFBlockAsFree(remainingBlock);
+    ivyInsertTLSFFreeBlock(tlsfAllocator, remainingBlock);
+  }
+
+  ivyMarkTLSFBlockAsUsed(block);
+
+  tlsfAllocator->usedSize += ivyGetTLSFBlockSize(block);
+  ++tlsfAllocator->aliveAllocationCount;
+
+  return ivyGetTLSFBlockPayload(block);
+}
+
+IVY_INTERNAL void *ivyTLSFMemoryAllocatorAllocateAndZeroMemory(
+    IvyAnyMemoryAllocator allocator, uint64_t count, uint64_t elementSize) {
+  uint64_t size = count * elementSize;
+  void *allocation = ivyTLSFMemoryAllocatorAllocate(allocator, size);
+  if (allocation) {
+    IVY_MEMSET(allocation, 0, size);
+  }
+  return allocation;
+}
+
+IVY_INTERNAL void ivyTLSFMemoryAllocatorFree(IvyAnyMemoryAllocator allocator,
+    void *data) {
+  IvyTLSFMemoryBlock *block;
+  IvyTLSFMemoryAllocator *tlsfAllocator = allocator;
+
+  if (!data) {
+    return;
+  }
+
+  block = ivyGetTLSFBlockFromPayload(data);
+  IVY_ASSERT(!ivyIsTLSFBlockFree(block));
+  IVY_ASSERT(tlsfAllocator->aliveAllocationCount);
+
+  tlsfAllocator->usedSize -= ivyGetTLSFBlockSize(block);
+  --tlsfAllocator->aliveAllocationCount;
+
+  block = ivyMergePreviousTLSFBlock(tlsfAllocator, block);
+  ivyMergeNextTLSFBlock(tlsfAllocator, block);
+  ivyMarkTLSFBlockAsFree(block);
+  ivyInsertTLSFFreeBlock(tlsfAllocator, block);
+}
+
+IVY_INTERNAL void *ivyTLSFMemoryAllocatorReallocate(
+    IvyAnyMemoryAllocator allocator, void *data, uint64_t newSize) {
+  void *newData;
+  uint64_t currentSize;
+  uint64_t adjustedSize;
+  IvyTLSFMemoryBlock *block;
+  IvyTLSFMemoryBlock *nextBlock;
+  IvyTLSFMemoryAllocator *tlsfAllocator = allocator;
+
+  if (!data) {
+    return ivyTLSFMemoryAllocatorAllocate(allocator, newSize);
+  }
+
+  adjustedSize = ivyAdjustTLSFRequestSize(newSize);
+  if (adjustedSize >= IVY_TLSF_MAX_BLOCK_SIZE) {
+    return NULL;
+  }
+
+  block = ivyGetTLSFBlockFromPayload(data);
+  nextBlock = ivyGetNextPhysicalTLSFBlock(block);
+  currentSize = ivyGetTLSFBlockSize(block);
+
+  // NOTE: grows into the next block when it's free and big enough, shrinks
+  //       by splitting the tail off, only moves when neither works
+  if (adjustedSize > currentSize) {
+    if (!ivyIsTLSFBlockFree(nextBlock) ||
+        currentSize + IVY_TLSF_BLOCK_HEADER_SIZE +
+                ivyGetTLSFBlockSize(nextBlock) <
+            adjustedSize) {
+      newData = ivyTLSFMemoryAllocatorAllocate(allocator, newSize);
+      if (!newData) {
+        return NULL;
+      }
+
+      IVY_MEMCPY(newData, data, currentSize);
+      ivyTLSFMemoryAllocatorFree(allocator, data);
+
+      return newData;
+    }
+
+    ivyRemoveTLSFFreeBlock(tlsfAllocator, nextBlock);
+    ivyAbsorbTLSFBlock(block, nextBlock);
+    ivyMarkTLSFBlockAsUsed(block);
+  }
+
+  ivyTrimUsedTLSFBlock(tlsfAllocator, block, adjustedSize);
+
+  tlsfAllocator->usedSize += ivyGetTLSFBlockSize(block);
+  tlsfAllocator->usedSize -= currentSize;
+
+  return data;
+}
+
+IVY_INTERNAL void ivySetupTLSFRegion(IvyTLSFMemoryAllocator *tlsfAllocator) {
+  uint32_t firstLevel;
+  uint32_t secondLevel;
+  uint64_t start;
+  uint64_t end;
+  uint64_t firstBlockSize;
+  IvyTLSFMemoryBlock *firstBlock;
+  IvyTLSFMemoryBlock *sentinelBlock;
+
+  tlsfAllocator->aliveAllocationCount = 0;
+  tlsfAllocator->usedSize = 0;
+  tlsfAllocator->firstLevelBitmap = 0;
+
+  for (firstLevel = 0; firstLevel < IVY_TLSF_FIRST_LEVEL_COUNT;
+       ++firstLevel) {
+    tlsfAllocator->secondLevelBitmaps[firstLevel] = 0;
+
+    for (secondLevel = 0; secondLevel < IVY_TLSF_SECOND_LEVEL_COUNT;
+         ++secondLevel) {
+      tlsfAllocator->freeBlocks[firstLevel][secondLevel] = NULL;
+    }
+  }
+
+  start = ivyAlignTLSFSize((uint64_t)(uintptr_t)tlsfAllocator->region);
+  end = ((uint64_t)(uintptr_t)tlsfAllocator->region +
+            tlsfAllocator->regionSize) &
+        ~(uint64_t)(IVY_TLSF_ALIGNMENT - 1);
+
+  // NOTE: a zero sized used block at the end stops merges from running off
+  //       the region
+  firstBlockSize = end - start - 2 * IVY_TLSF_BLOCK_HEADER_SIZE;
+  if (firstBlockSize >= IVY_TLSF_MAX_BLOCK_SIZE) {
+    firstBlockSize = IVY_TLSF_MAX_BLOCK_SIZE - IVY_TLSF_ALIGNMENT;
+  }
+
+  firstBlock = (IvyTLSFMemoryBlock *)(uintptr_t)start;
+  firstBlock->previousPhysicalBlock = NULL;
+  firstBlock->size = firstBlockSize;
+
+  sentinelBlock = ivyGetNextPhysicalTLSFBlock(firstBlock);
+  sentinelBlock->size = 0;
+
+  ivyMarkTLSFBlockAsFree(firstBlock);
+  ivyInsertTLSFFreeBlock(tlsfAllocator, firstBlock);
+
+  tlsfAllocator->firstBlock = firstBlock;
+}
+
+IVY_INTERNAL void ivyTLSFMemoryAllocatorClear(
+    IvyAnyMemoryAllocator allocator) {
+  ivySetupTLSFRegion(allocator);
+}
+
+IVY_INTERNAL void ivyTLSFMemoryAllocatorDestroy(
+    IvyAnyMemoryAllocator allocator) {
+  IvyTLSFMemoryAllocator *tlsfAllocator = allocator;
+
+  IVY_ASSERT(!tlsfAllocator->aliveAllocationCount);
+
+  if (tlsfAllocator->ownsRegion && tlsfAllocator->region) {
+    munmap(tlsfAllocator->region, tlsfAllocator->regionSize);
+  }
+
+  tlsfAllocator->region = NULL;
+  tlsfAllocator->firstBlock = NULL;
+}
+
+IVY_INTERNAL IvyMemoryAllocatorDispatch const tlsfMemoryAllocatorDispatch = {
+    ivyTLSFMemoryAllocatorAllocate,
+    ivyTLSFMemoryAllocatorAllocateAndZeroMemory,
+    ivyTLSFMemoryAllocatorReallocate, ivyTLSFMemoryAllocatorFree,
+    ivyTLSFMemoryAllocatorClear, ivyTLSFMemoryAllocatorDestroy};
+
+IVY_API IvyCode ivyCreateTLSFMemoryAllocatorFromRegion(void *region,
+    uint64_t size, IvyTLSFMemoryAllocator *allocator) {
+  IVY_ASSERT(region);
+
+  // NOTE: the first block, the sentinel and alignment slack
+  if (size < 2 * IVY_TLSF_BLOCK_HEADER_SIZE + IVY_TLSF_MIN_BLOCK_SIZE +
+                 IVY_TLSF_ALIGNMENT) {
+    return IVY_ERROR_INVALID_VALUE;
+  }
+
+  ivySetupMemoryAllocatorBase(&tlsfMemoryAllocatorDispatch, &allocator->base);
+
+  allocator->ownsRegion = 0;
+  allocator->region = region;
+  allocator->regionSize = size;
+
+  ivySetupTLSFRegion(allocator);
+
+  return IVY_OK;
+}
+
+IVY_API IvyCode ivyCreateTLSFMemoryAllocator(uint64_t size,
+    IvyTLSFMemoryAllocator *allocator) {
+  IvyCode ivyCode;
+  void *region;
+
+  region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON,
+      -1, 0);
+  if (MAP_FAILED == region) {
+    return IVY_ERROR_NO_MEMORY;
+  }
+
+  ivyCode = ivyCreateTLSFMemoryAllocatorFromRegion(region, size, allocator);
+  if (ivyCode) {
+    munmap(region, size);
+    return ivyCode;
+  }
+
+  allocator->ownsRegion = 1;
+
+  return IVY_OK;
+}
+
+IVY_API void ivyGetTLSFMemoryStatistics(IvyTLSFMemoryAllocator *allocator,
+    IvyTLSFMemoryStatistics *statistics) {
+  IvyTLSFMemoryBlock *block;
+
+  IVY_MEMSET(statistics, 0, sizeof(*statistics));
+
+  statistics->regionSize = allocator->regionSize;
+  statistics->usedSize = allocator->usedSize;
+
+  for (block = allocator->firstBlock; ivyGetTLSFBlockSize(block);
+       block = ivyGetNextPhysicalTLSFBlock(block)) {
+    uint64_t const size = ivyGetTLSFBlockSize(block);
+
+    if (!ivyIsTLSFBlockFree(block)) {
+      ++statistics->usedBlockCount;
+      continue;
+    }
+
+    ++statistics->freeBlockCount;
+    statistics->freeSize += size;
+
+    if (size > statistics->largestFreeBlockSize) {
+      statistics->largestFreeBlockSize = size;
+    }
+  }
+
+  if (statistics->freeSize) {
+    statistics->fragmentation =
+        1.0F - (float)statistics->largestFreeBlockSize /
+                   (float)statistics->freeSize;
+  }
+}
@@ -0,0 +1,76 @@
+#ifndef IVY_TLSF_MEMORY_ALLOCATOR_H
+#define IVY_TLSF_MEMORY_ALLOCATOR_H
+
+#include "IvyMemoryAllocator.h"
+
+#define IVY_TLSF_ALIGNMENT_LOG2 3
+#define IVY_TLSF_ALIGNMENT (1 << IVY_TLSF_ALIGNMENT_LOG2)
+#define IVY_TLSF_SECOND_LEVEL_COUNT_LOG2 5
+#define IVY_TLSF_SECOND_LEVEL_COUNT (1 << IVY_TLSF_SECOND_LEVEL_COUNT_LOG2)
+#define IVY_TLSF_FIRST_LEVEL_SHIFT                                           \
+  (IVY_TLSF_SECOND_LEVEL_COUNT_LOG2 + IVY_TLSF_ALIGNMENT_LOG2)
+#define IVY_TLSF_FIRST_LEVEL_MAX 32
+#define IVY_TLSF_FIRST_LEVEL_COUNT                                           \
+  (IVY_TLSF_FIRST_LEVEL_MAX - IVY_TLSF_FIRST_LEVEL_SHIFT + 1)
+#define IVY_TLSF_SMALL_BLOCK_SIZE (1 << IVY_TLSF_FIRST_LEVEL_SHIFT)
+#define IVY_TLSF_MAX_BLOCK_SIZE ((uint64_t)1 << IVY_TLSF_FIRST_LEVEL_MAX)
+
+// NOTE: the header is followed by the payload. While the block is free the
+//       payload holds the free list links, so the smallest payload is two
+//       pointers. The low bits of size hold the free flags
+typedef struct IvyTLSFMemoryBlock {
+  struct IvyTLSFMemoryBlock *previousPhysicalBlock;
+  uint64_t size;
+} IvyTLSFMemoryBlock;
+
+typedef struct IvyTLSFMemoryFreeLinks {
+  IvyTLSFMemoryBlock *nextFreeBlock;
+  IvyTLSFMemoryBlock *previousFreeBlock;
+} IvyTLSFMemoryFreeLinks;
+
+typedef struct IvyTLSFMemoryStatistics {
+  uint64_t regionSize;
+  uint64_t usedSize;
+  uint64_t freeSize;
+  uint64_t largestFreeBlockSize;
+  uint32_t freeBlockCount;
+  uint32_t usedBlockCount;
+  // NOTE: 1 - largestFreeBlockSize / freeSize, 0 when all the free memory is
+  //       a single block
+  float fragmentation;
+} IvyTLSFMemoryStatistics;
+
+// NOTE: two level segregated fit. The first level splits free blocks by
+//       power of two and the second one splits each power of two in
+//       IVY_TLSF_SECOND_LEVEL_COUNT linear ranges. A bitmap per level finds
+//       a fitting list with a couple of bit scans, so allocate, free and
+//       reallocate take bounded time no matter what state the heap is in.
+//       Not thread safe
+typedef struct IvyTLSFMemoryAllocator {
+  IvyMemoryAllocatorBase base;
+  int32_t aliveAllocationCount;
+  IvyBool ownsRegion;
+  uint64_t regionSize;
+  uint64_t usedSize;
+  void *region;
+  IvyTLSFMemoryBlock *firstBlock;
+  uint32_t firstLevelBitmap;
+  uint32_t secondLevelBitmaps[IVY_TLSF_FIRST_LEVEL_COUNT];
+  IvyTLSFMemoryBlock *freeBlocks[IVY_TLSF_FIRST_LEVEL_COUNT]
+                                [IVY_TLSF_SECOND_LEVEL_COUNT];
+} IvyTLSFMemoryAllocator;
+
+// NOTE: reserves size bytes with mmap, the pages are only backed once they
+//       are touched
+IVY_API IvyCode ivyCreateTLSFMemoryAllocator(uint64_t size,
+    IvyTLSFMemoryAllocator *allocator);
+
+// NOTE: the region has to outlive the allocator and is not freed by it
+IVY_API IvyCode ivyCreateTLSFMemoryAllocatorFromRegion(void *region,
+    uint64_t size, IvyTLSFMemoryAllocator *allocator);
+
+// NOTE: walks every block, meant for debugging and soak tests
+IVY_API void ivyGetTLSFMemoryStatistics(IvyTLSFMemoryAllocator *allocator,
+    IvyTLSFMemoryStatistics *statistics);
+
+#endif
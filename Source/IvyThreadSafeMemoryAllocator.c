@@ -0,0 +1,470 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "IvyThreadSafeMemoryAllocator.h"
+
+#include "IvyAtomic.h"
+
+#define IVY_THREAD_SAFE_HEADER_SIZE                                          \
+  ((uint64_t)sizeof(IvyThreadSafeMemoryHeader))
+
+IVY_INTERNAL uint32_t ivyGetThreadSafeMemorySizeClass(uint64_t size) {
+  uint32_t sizeClass = 0;
+  uint64_t classSize = IVY_THREAD_SAFE_MIN_CACHED_SIZE;
+
+  if (size > IVY_THREAD_SAFE_MAX_CACHED_SIZE) {
+    return IVY_THREAD_SAFE_LARGE_SIZE_CLASS;
+  }
+
+  while (classSize < size) {
+    classSize <<= 1;
+    ++sizeClass;
+  }
+
+  return sizeClass;
+}
+
+IVY_INTERNAL uint64_t ivyGetThreadSafeMemoryClassSize(uint32_t sizeClass) {
+  return (uint64_t)IVY_THREAD_SAFE_MIN_CACHED_SIZE << sizeClass;
+}
+
+IVY_INTERNAL IvyThreadSafeMemoryHeader *ivyGetThreadSafeMemoryHeader(
+    void *data) {
+  return (IvyThreadSafeMemoryHeader *)((uint8_t *)data -
+                                       IVY_THREAD_SAFE_HEADER_SIZE);
+}
+
+IVY_INTERNAL IvyThreadSafeMemoryCache *ivyGetThreadSafeMemoryCache(
+    IvyThreadSafeMemoryAllocator *threadSafeAllocator) {
+  IvyThreadSafeMemoryCache *cache;
+
+  cache = pthread_getspecific(threadSafeAllocator->cacheKey);
+  if (cache) {
+    return cache;
+  }
+
+  pthread_mutex_lock(&threadSafeAllocator->mutex);
+
+  cache = ivyAllocateAndZeroMemory(threadSafeAllocator->backendMemoryAllocator,
+      1, sizeof(*cache));
+  if (!cache) {
+    pthread_mutex_unlock(&threadSafeAllocator->mutex);
+    return NULL;
+  }
+
+  if (pthread_setspecific(threadSafeAllocator->cacheKey, cache)) {
+    ivyFreeMemory(threadSafeAllocator->backendMemoryAllocator, cache);
+    pthread_mutex_unlock(&threadSafeAllocator->mutex);
+    return NULL;
+  }
+
+  cache->allocator = threadSafeAllocator;
+  cache->previous = NULL;
+  cache->next = threadSafeAllocator->caches;
+  if (threadSafeAllocator->caches) {
+    threadSafeAllocator->caches->previous = cache;
+  }
+  threadSafeAllocator->caches = cache;
+
+  pthread_mutex_unlock(&threadSafeAllocator->mutex);
+
+  return cache;
+}
+
+// NOTE: expects the lock to be held
+IVY_INTERNAL void ivyUnlinkThreadSafeMemoryCache(
+    IvyThreadSafeMemoryAllocator *threadSafeAllocator,
+    IvyThreadSafeMemoryCache *cache) {
+  if (cache->previous) {
+    cache->previous->next = cache->next;
+  } else {
+    threadSafeAllocator->caches = cache->next;
+  }
+
+  if (cache->next) {
+    cache->next->previous = cache->previous;
+  }
+}
+
+// NOTE: expects the lock to be held
+IVY_INTERNAL IvyBool ivyAllocateThreadSafeMemoryChunk(
+    IvyThreadSafeMemoryAllocator *threadSafeAllocator, uint32_t sizeClass) {
+  uint32_t index;
+  uint8_t *blocks;
+  IvyThreadSafeMemoryChunk *chunk;
+  uint64_t const blockSize = IVY_THREAD_SAFE_HEADER_SIZE +
+                             ivyGetThreadSafeMemoryClassSize(sizeClass);
+
+  chunk = ivyAllocateMemory(threadSafeAllocator->backendMemoryAllocator,
+      sizeof(*chunk) + IVY_THREAD_SAFE_CACHE_BATCH_SIZE * blockSize);
+  if (!chunk) {
+    return 0;
+  }
+
+  chunk->next = threadSafeAllocator->chunks;
+  threadSafeAllocator->chunks = chunk;
+
+  blocks = (uint8_t *)(chunk + 1);
+  for (index = 0; index < IVY_THREAD_SAFE_CACHE_BATCH_SIZE; ++index) {
+    IvyThreadSafeMemoryHeader *header =
+        (IvyThreadSafeMemoryHeader *)(blocks + index * blockSize);
+    IvyThreadSafeMemoryFreeBlock *freeBlock =
+        (IvyThreadSafeMemoryFreeBlock *)(header + 1);
+
+    header->sizeClass = sizeClass;
+    header->padding = 0;
+    header->size = ivyGetThreadSafeMemoryClassSize(sizeClass);
+
+    freeBlock->next = threadSafeAllocator->sharedFreeBlocks[sizeClass];
+    threadSafeAllocator->sharedFreeBlocks[sizeClass] = freeBlock;
+  }
+
+  return 1;
+}
+
+IVY_INTERNAL IvyBool ivyRefillThreadSafeMemoryCache(
+    IvyThreadSafeMemoryCache *cache, uint32_t sizeClass) {
+  uint32_t count;
+  IvyThreadSafeMemoryAllocator *threadSafeAllocator = cache->allocator;
+
+  pthread_mutex_lock(&threadSafeAllocator->mutex);
+
+  if (!threadSafeAllocator->sharedFreeBlocks[sizeClass]) {
+    if (!ivyAllocateThreadSafeMemoryChunk(threadSafeAllocator, sizeClass)) {
+      pthread_mutex_unlock(&threadSafeAllocator->mutex);
+      return 0;
+    }
+  }
+
+  for (count = 0; count < IVY_THREAD_SAFE_CACHE_BATCH_SIZE &&
+                  threadSafeAllocator->sharedFreeBlocks[sizeClass];
+       ++count) {
+    IvyThreadSafeMemoryFreeBlock *freeBlock =
+        threadSafeAllocator->sharedFreeBlocks[sizeClass];
+
+    threadSafeAllocator->sharedFreeBlocks[sizeClass] = freeBlock->next;
+    freeBlock->next = cache->freeBlocks[sizeClass];
+    cache->freeBlocks[sizeClass] = freeBlock;
+  }
+
+  pthread_mutex_unlock(&threadSafeAllocator->mutex);
+
+  cache->freeBlockCounts[sizeClass] += count;
+
+  return 1;
+}
+
+IVY_INTERNAL void ivySpillThreadSafeMemoryCache(
+    IvyThreadSafeMemoryCache *cache, uint32_t sizeClass, uint32_t count) {
+  uint32_t index;
+  IvyThreadSafeMemoryFreeBlock *firstBlock;
+  IvyThreadSafeMemoryFreeBlock *lastBlock;
+  IvyThreadSafeMemoryAllocator *threadSafeAllocator = cache->allocator;
+
+  if (!count) {
+    return;
+  }
+
+  // NOTE: the blocks are unlinked first so the lock only covers the splice
+  firstBlock = cache->freeBlocks[sizeClass];
+  lastBlock = firstBlock;
+  for (index = 1; index < count; ++index) {
+    lastBlock = lastBlock->next;
+  }
+
+  cache->freeBlocks[sizeClass] = lastBlock->next;
+  cache->freeBlockCounts[sizeClass] -= count;
+
+  pthread_mutex_lock(&threadSafeAllocator->mutex);
+  lastBlock->next = threadSafeAllocator->sharedFreeBlocks[sizeClass];
+  threadSafeAllocator->sharedFreeBlocks[sizeClass] = firstBlock;
+  pthread_mutex_unlock(&threadSafeAllocator->mutex);
+}
+
+IVY_INTERNAL void ivyFlushThreadSafeMemoryCache(
+    IvyThreadSafeMemoryCache *cache) {
+  uint32_t sizeClass;
+
+  for (sizeClass = 0; sizeClass < IVY_THREAD_SAFE_SIZE_CLASS_COUNT;
+       ++sizeClass) {
+    ivySpillThreadSafeMemoryCache(cache, sizeClass,
+        cache->freeBlockCounts[sizeClass]);
+  }
+}
+
+IVY_INTERNAL void ivyReleaseThreadSafeMemoryCache(void *data) {
+  IvyThreadSafeMemoryCache *cache = data;
+  IvyThreadSafeMemoryAllocator *threadSafeAllocator = cache->allocator;
+
+  ivyFlushThreadSafeMemoryCache(cache);
+
+  pthread_mutex_lock(&threadSafeAllocator->mutex);
+  ivyUnlinkThreadSafeMemoryCache(threadSafeAllocator, cache);
+  ivyFreeMemory(threadSafeAllocator->backendMemoryAllocator, cache);
+  pthread_mutex_unlock(&threadSafeAllocator->mutex);
+}
+
+IVY_INTERNAL void *ivyAllocateLargeThreadSafeMemory(
+    IvyThreadSafeMemoryAllocator *threadSafeAllocator, uint64_t size) {
+  IvyThreadSafeMemoryHeader *header;
+
+  pthread_mutex_lock(&threadSafeAllocator->mutex);
+  header = ivyAllocateMemory(threadSafeAllocator->backendMemoryAllocator,
+      IVY_THREAD_SAFE_HEADER_SIZE + size);
+  pthread_mutex_unlock(&threadSafeAllocator->mutex);
+
+  if (!header) {
+    return NULL;
+  }
+
+  header->sizeClass = IVY_THREAD_SAFE_LARGE_SIZE_CLASS;
+  header->padding = 0;
+  header->size = size;
+
+  return header + 1;
+}
+
+IVY_INTERNAL void *ivyThreadSafeMemoryAllocatorAllocate(
+    IvyAnyMemoryAllocator allocator, uint64_t size) {
+  void *data;
+  IvyThreadSafeMemoryCache *cache;
+  IvyThreadSafeMemoryFreeBlock *freeBlock;
+  IvyThreadSafeMemoryAllocator *threadSafeAllocator = allocator;
+  uint32_t const sizeClass = ivyGetThreadSafeMemorySizeClass(size);
+
+  if (IVY_THREAD_SAFE_LARGE_SIZE_CLASS == sizeClass) {
+    data = ivyAllocateLargeThreadSafeMemory(threadSafeAllocator, size);
+    if (data) {
+      IVY_ATOMIC_ADD(&threadSafeAllocator->aliveAllocationCount, 1);
+    }
+    return data;
+  }
+
+  cache = ivyGetThreadSafeMemoryCache(threadSafeAllocator);
+  if (!cache) {
+    return NULL;
+  }
+
+  if (!cache->freeBlocks[sizeClass]) {
+    if (!ivyRefillThreadSafeMemoryCache(cache, sizeClass)) {
+      return NULL;
+    }
+  }
+
+  freeBlock = cache->freeBlocks[sizeClass];
+  cache->freeBlocks[sizeClass] = freeBlock->next;
+  --cache->freeBlockCounts[sizeClass];
+
+  IVY_ATOMIC_ADD(&threadSafeAllocator->aliveAllocationCount, 1);
+  return freeBlock;
+}
+
+IVY_INTERNAL void *ivyThreadSafeMemoryAllocatorAllocateAndZeroMemory(
+    IvyAnyMemoryAllocator allocator, uint64_t count, uint64_t elementSize) {
+  uint64_t size = count * elementSize;
+  void *allocation = ivyThreadSafeMemoryAllocatorAllocate(allocator, size);
+  if (allocation) {
+    IVY_MEMSET(allocation, 0, size);
+  }
+  return allocation;
+}
+
+IVY_INTERNAL void ivyThreadSafeMemoryAllocatorFree(
+    IvyAnyMemoryAllocator allocator, void *data) {
+  IvyThreadSafeMemoryCache *cache;
+  IvyThreadSafeMemoryHeader *header;
+  IvyThreadSafeMemoryFreeBlock *freeBlock;
+  IvyThreadSafeMemoryAllocator *threadSafeAllocator = allocator;
+
+  if (!data) {
+    return;
+  }
+
+  IVY_ATOMIC_SUB(&threadSafeAllocator->aliveAllocationCount, 1);
+
+  header = ivyGetThreadSafeMemoryHeader(data);
+  if (IVY_THREAD_SAFE_LARGE_SIZE_CLASS == header->sizeClass) {
+    pthread_mutex_lock(&threadSafeAllocator->mutex);
+    ivyFreeMemory(threadSafeAllocator->backendMemoryAllocator, header);
+    pthread_mutex_unlock(&threadSafeAllocator->mutex);
+    return;
+  }
+
+  freeBlock = data;
+
+  // NOTE: blocks freed by a thread end up in its own cache, no matter which
+  //       thread allocated them
+  cache = ivyGetThreadSafeMemoryCache(threadSafeAllocator);
+  if (!cache) {
+    pthread_mutex_lock(&threadSafeAllocator->mutex);
+    freeBlock->next = threadSafeAllocator->sharedFreeBlocks[header->sizeClass];
+    threadSafeAllocator->sharedFreeBlocks[header->sizeClass] = freeBlock;
+    pthread_mutex_unlock(&threadSafeAllocator->mutex);
+    return;
+  }
+
+  freeBlock->next = cache->freeBlocks[header->sizeClass];
+  cache->freeBlocks[header->sizeClass] = freeBlock;
+  ++cache->freeBlockCounts[header->sizeClass];
+
+  if (cache->freeBlockCounts[header->sizeClass] >
+      IVY_THREAD_SAFE_MAX_CACHED_COUNT) {
+    ivySpillThreadSafeMemoryCache(cache, header->sizeClass,
+        IVY_THREAD_SAFE_CACHE_BATCH_SIZE);
+  }
+}
+
+IVY_INTERNAL void *ivyThreadSafeMemoryAllocatorReallocate(
+    IvyAnyMemoryAllocator allocator, void *data, uint64_t newSize) {
+  void *newData;
+  IvyThreadSafeMemoryHeader *header;
+  IvyThreadSafeMemoryAllocator *threadSafeAllocator = allocator;
+
+  if (!data) {
+    return ivyThreadSafeMemoryAllocatorAllocate(allocator, newSize);
+  }
+
+  header = ivyGetThreadSafeMemoryHeader(data);
+
+  if (IVY_THREAD_SAFE_LARGE_SIZE_CLASS == header->sizeClass &&
+      IVY_THREAD_SAFE_LARGE_SIZE_CLASS ==
+          ivyGetThreadSafeMemorySizeClass(newSize)) {
+    pthread_mutex_lock(&threadSafeAllocator->mutex);
+    header = ivyReallocateMemory(threadSafeAllocator->backendMemoryAllocator,
+        header, IVY_THREAD_SAFE_HEADER_SIZE + newSize);
+    pthread_mutex_unlock(&threadSafeAllocator->mutex);
+
+    if (!header) {
+      return NULL;
+    }
+
+    header->size = newSize;
+    return header + 1;
+  }
+
+  if (IVY_THREAD_SAFE_LARGE_SIZE_CLASS != header->sizeClass &&
+      newSize <= header->size) {
+    return data;
+  }
+
+  newData = ivyThreadSafeMemoryAllocatorAllocate(allocator, newSize);
+  if (!newData) {
+    return NULL;
+  }
+
+  IVY_MEMCPY(newData, data, IVY_MIN(header->size, newSize));
+  ivyThreadSafeMemoryAllocatorFree(allocator, data);
+
+  return newData;
+}
+
+// NOTE: every thread has to be done with the allocator. The caches of the
+//       other threads stay registered but are emptied, as the blocks they
+//       held go away with the chunks
+IVY_INTERNAL void ivyThreadSafeMemoryAllocatorClear(
+    IvyAnyMemoryAllocator allocator) {
+  uint32_t sizeClass;
+  IvyThreadSafeMemoryCache *cache;
+  IvyThreadSafeMemoryAllocator *threadSafeAllocator = allocator;
+
+  pthread_mutex_lock(&threadSafeAllocator->mutex);
+
+  for (cache = threadSafeAllocator->caches; cache; cache = cache->next) {
+    for (sizeClass = 0; sizeClass < IVY_THREAD_SAFE_SIZE_CLASS_COUNT;
+         ++sizeClass) {
+      cache->freeBlockCounts[sizeClass] = 0;
+      cache->freeBlocks[sizeClass] = NULL;
+    }
+  }
+
+  while (threadSafeAllocator->chunks) {
+    IvyThreadSafeMemoryChunk *next = threadSafeAllocator->chunks->next;
+    ivyFreeMemory(threadSafeAllocator->backendMemoryAllocator,
+        threadSafeAllocator->chunks);
+    threadSafeAllocator->chunks = next;
+  }
+
+  for (sizeClass = 0; sizeClass < IVY_THREAD_SAFE_SIZE_CLASS_COUNT;
+       ++sizeClass) {
+    threadSafeAllocator->sharedFreeBlocks[sizeClass] = NULL;
+  }
+
+  pthread_mutex_unlock(&threadSafeAllocator->mutex);
+
+  IVY_ATOMIC_STORE(&threadSafeAllocator->aliveAllocationCount, 0);
+}
+
+// NOTE: threads that are still alive keep a dangling pointer in their slot,
+//       but the key is deleted right after, so it's never read again and
+//       their exit doesn't release the cache a second time
+IVY_INTERNAL void ivyThreadSafeMemoryAllocatorDestroy(
+    IvyAnyMemoryAllocator allocator) {
+  IvyThreadSafeMemoryAllocator *threadSafeAllocator = allocator;
+
+  IVY_ASSERT(!IVY_ATOMIC_LOAD(&threadSafeAllocator->aliveAllocationCount));
+
+  ivyThreadSafeMemoryAllocatorClear(allocator);
+
+  pthread_setspecific(threadSafeAllocator->cacheKey, NULL);
+
+  while (threadSafeAllocator->caches) {
+    IvyThreadSafeMemoryCache *next = threadSafeAllocator->caches->next;
+    ivyFreeMemory(threadSafeAllocator->backendMemoryAllocator,
+        threadSafeAllocator->caches);
+    threadSafeAllocator->caches = next;
+  }
+
+  pthread_key_delete(threadSafeAllocator->cacheKey);
+  pthread_mutex_destroy(&threadSafeAllocator->mutex);
+}
+
+IVY_INTERNAL IvyMemoryAllocatorDispatch const
+    threadSafeMemoryAllocatorDispatch = {ivyThreadSafeMemoryAllocatorAllocate,
+        ivyThreadSafeMemoryAllocatorAllocateAndZeroMemory,
+        ivyThreadSafeMemoryAllocatorReallocate,
+        ivyThreadSafeMemoryAllocatorFree, ivyThreadSafeMemoryAllocatorClear,
+        ivyThreadSafeMemoryAllocatorDestroy};
+
+IVY_API IvyCode ivyCreateThreadSafeMemoryAllocator(
+    IvyAnyMemoryAllocator backendMemoryAllocator,
+    IvyThreadSafeMemoryAllocator *allocator) {
+  uint32_t sizeClass;
+
+  IVY_ASSERT(backendMemoryAllocator);
+
+  ivySetupMemoryAllocatorBase(&threadSafeMemoryAllocatorDispatch,
+      &allocator->base);
+
+  allocator->backendMemoryAllocator = backendMemoryAllocator;
+  allocator->aliveAllocationCount = 0;
+  allocator->chunks = NULL;
+  allocator->caches = NULL;
+
+  for (sizeClass = 0; sizeClass < IVY_THREAD_SAFE_SIZE_CLASS_COUNT;
+       ++sizeClass) {
+    allocator->sharedFreeBlocks[sizeClass] = NULL;
+  }
+
+  if (pthread_mutex_init(&allocator->mutex, NULL)) {
+    return IVY_ERROR_UNKNOWN;
+  }
+
+  if (pthread_key_create(&allocator->cacheKey,
+          ivyReleaseThreadSafeMemoryCache)) {
+    pthread_mutex_destroy(&allocator->mutex);
+    return IVY_ERROR_UNKNOWN;
+  }
+
+  return IVY_OK;
+}
+
+IVY_API void ivyFlushThreadSafeMemoryAllocatorCache(
+    IvyThreadSafeMemoryAllocator *allocator) {
+  IvyThreadSafeMemoryCache *cache = pthread_getspecific(allocator->cacheKey);
+
+  if (!cache) {
+    return;
+  }
+
+  pthread_setspecific(allocator->cacheKey, NULL);
+  ivyReleaseThreadSafeMemoryCache(cache);
+}
@@ -0,0 +1,79 @@
+#ifndef IVY_THREAD_SAFE_MEMORY_ALLOCATOR_H
+#define IVY_THREAD_SAFE_MEMORY_ALLOCATOR_H
+
+#include <pthread.h>
+
+#include "IvyMemoryAllocator.h"
+
+#define IVY_THREAD_SAFE_SIZE_CLASS_COUNT 5
+#define IVY_THREAD_SAFE_MIN_CACHED_SIZE 16
+#define IVY_THREAD_SAFE_MAX_CACHED_SIZE                                      \
+  (IVY_THREAD_SAFE_MIN_CACHED_SIZE << (IVY_THREAD_SAFE_SIZE_CLASS_COUNT - 1))
+#define IVY_THREAD_SAFE_LARGE_SIZE_CLASS IVY_THREAD_SAFE_SIZE_CLASS_COUNT
+#define IVY_THREAD_SAFE_CACHE_BATCH_SIZE 32
+#define IVY_THREAD_SAFE_MAX_CACHED_COUNT (2 * IVY_THREAD_SAFE_CACHE_BATCH_SIZE)
+
+typedef struct IvyThreadSafeMemoryAllocator IvyThreadSafeMemoryAllocator;
+
+// NOTE: every allocation starts with this, it's 16 bytes so the payload
+//       keeps the alignment of the backend. While a small block sits in a
+//       free list the payload holds the link to the next one
+typedef struct IvyThreadSafeMemoryHeader {
+  uint32_t sizeClass;
+  uint32_t padding;
+  uint64_t size;
+} IvyThreadSafeMemoryHeader;
+
+typedef struct IvyThreadSafeMemoryFreeBlock {
+  struct IvyThreadSafeMemoryFreeBlock *next;
+} IvyThreadSafeMemoryFreeBlock;
+
+// NOTE: small blocks are carved out of chunks of
+//       IVY_THREAD_SAFE_CACHE_BATCH_SIZE blocks, allocated from the backend
+//       in one go. The header keeps the blocks 16 byte aligned
+typedef struct IvyThreadSafeMemoryChunk {
+  struct IvyThreadSafeMemoryChunk *next;
+  uint64_t padding;
+} IvyThreadSafeMemoryChunk;
+
+// NOTE: every live cache is linked into the allocator's list, so clearing
+//       and destroying can reach the ones of other threads
+typedef struct IvyThreadSafeMemoryCache {
+  IvyThreadSafeMemoryAllocator *allocator;
+  struct IvyThreadSafeMemoryCache *previous;
+  struct IvyThreadSafeMemoryCache *next;
+  uint32_t freeBlockCounts[IVY_THREAD_SAFE_SIZE_CLASS_COUNT];
+  IvyThreadSafeMemoryFreeBlock *freeBlocks[IVY_THREAD_SAFE_SIZE_CLASS_COUNT];
+} IvyThreadSafeMemoryCache;
+
+// NOTE: makes any allocator usable from several threads. Small requests are
+//       served from a cache owned by the calling thread without locking, the
+//       cache refills from and spills to the shared lists
+//       IVY_THREAD_SAFE_CACHE_BATCH_SIZE blocks at a time. Everything else
+//       goes to the backend under the lock. Small blocks are only returned
+//       to the backend when the allocator is cleared or destroyed, which
+//       can't happen while other threads still use it. Threads don't have to
+//       exit first, destroying frees the caches they still hold
+struct IvyThreadSafeMemoryAllocator {
+  IvyMemoryAllocatorBase base;
+  IvyAnyMemoryAllocator backendMemoryAllocator;
+  pthread_mutex_t mutex;
+  pthread_key_t cacheKey;
+  int32_t aliveAllocationCount;
+  IvyThreadSafeMemoryFreeBlock *sharedFreeBlocks
+      [IVY_THREAD_SAFE_SIZE_CLASS_COUNT];
+  IvyThreadSafeMemoryChunk *chunks;
+  IvyThreadSafeMemoryCache *caches;
+};
+
+IVY_API IvyCode ivyCreateThreadSafeMemoryAllocator(
+    IvyAnyMemoryAllocator backendMemoryAllocator,
+    IvyThreadSafeMemoryAllocator *allocator);
+
+// NOTE: hands the blocks cached by the calling thread back to the shared
+//       lists and releases its cache, the next allocation from this thread
+//       creates a new one. Threads do it on their own when they exit
+IVY_API void ivyFlushThreadSafeMemoryAllocatorCache(
+    IvyThreadSafeMemoryAllocator *allocator);
+
+#endif
@@ -0,0 +1,206 @@
+#include "IvyTrackingMemoryAllocator.h"
+
+#define IVY_TRACKING_HEADER_SIZE                                             \
+  ((uint64_t)sizeof(IvyTrackingMemoryHeader))
+
+IVY_INTERNAL uint32_t ivyGetMemorySizeHistogramBucket(uint64_t size) {
+  uint32_t bucket = 0;
+  uint64_t bucketSize = IVY_MEMORY_SIZE_HISTOGRAM_MIN_SIZE;
+
+  while (bucketSize < size &&
+         bucket < IVY_MEMORY_SIZE_HISTOGRAM_BUCKET_COUNT - 1) {
+    bucketSize <<= 1;
+    ++bucket;
+  }
+
+  return bucket;
+}
+
+IVY_INTERNAL void ivyAddMemoryTagStatsAllocation(IvyMemoryTagStats *stats,
+    uint64_t size) {
+  ++stats->allocationCount;
+  ++stats->aliveAllocationCount;
+  stats->allocatedSize += size;
+  stats->aliveSize += size;
+  stats->peakAliveSize = IVY_MAX(stats->peakAliveSize, stats->aliveSize);
+}
+
+IVY_INTERNAL void ivyRemoveMemoryTagStatsAllocation(IvyMemoryTagStats *stats,
+    uint64_t size) {
+  IVY_ASSERT(stats->aliveAllocationCount);
+  IVY_ASSERT(stats->aliveSize >= size);
+  --stats->aliveAllocationCount;
+  stats->aliveSize -= size;
+}
+
+IVY_INTERNAL void ivyRecordTrackingMemoryAllocation(
+    IvyTrackingMemoryAllocator *trackingAllocator,
+    IvyTrackingMemoryHeader *header, uint64_t size) {
+  IvyMemoryAllocatorStats *stats = trackingAllocator->stats;
+
+  header->size = size;
+  header->tag = trackingAllocator->tag;
+  header->padding = 0;
+
+  ivyAddMemoryTagStatsAllocation(&stats->total, size);
+  ivyAddMemoryTagStatsAllocation(&stats->tags[header->tag], size);
+  ++stats->sizeHistogram[ivyGetMemorySizeHistogramBucket(size)];
+}
+
+IVY_INTERNAL void ivyRecordTrackingMemoryFree(
+    IvyTrackingMemoryAllocator *trackingAllocator,
+    IvyTrackingMemoryHeader *header) {
+  IvyMemoryAllocatorStats *stats = trackingAllocator->stats;
+
+  IVY_ASSERT(header->tag < IVY_MEMORY_TAG_COUNT);
+
+  ivyRemoveMemoryTagStatsAllocation(&stats->total, header->size);
+  ivyRemoveMemoryTagStatsAllocation(&stats->tags[header->tag], header->size);
+}
+
+IVY_INTERNAL void *ivyTrackingMemoryAllocatorAllocate(
+    IvyAnyMemoryAllocator allocator, uint64_t size) {
+  IvyTrackingMemoryHeader *header;
+  IvyTrackingMemoryAllocator *trackingAllocator = allocator;
+
+  header = ivyAllocateMemory(trackingAllocator->backendMemoryAllocator,
+      IVY_TRACKING_HEADER_SIZE + size);
+  if (!header) {
+    return NULL;
+  }
+
+  ivyRecordTrackingMemoryAllocation(trackingAllocator, header, size);
+
+  return header + 1;
+}
+
+IVY_INTERNAL void *ivyTrackingMemoryAllocatorAllocateAndZeroMemory(
+    IvyAnyMemoryAllocator allocator, uint64_t count, uint64_t elementSize) {
+  uint64_t size = count * elementSize;
+  void *allocation = ivyTrackingMemoryAllocatorAllocate(allocator, size);
+  if (allocation) {
+    IVY_MEMSET(allocation, 0, size);
+  }
+  return allocation;
+}
+
+IVY_INTERNAL void *ivyTrackingMemoryAllocatorReallocate(
+    IvyAnyMemoryAllocator allocator, void *data, uint64_t newSize) {
+  IvyTrackingMemoryHeader *header;
+  IvyTrackingMemoryHeader *newHeader;
+  IvyTrackingMemoryAllocator *trackingAllocator = allocator;
+
+  if (!data) {
+    return ivyTrackingMemoryAllocatorAllocate(allocator, newSize);
+  }
+
+  header = (IvyTrackingMemoryHeader *)data - 1;
+  newHeader = ivyReallocateMemory(trackingAllocator->backendMemoryAllocator,
+      header, IVY_TRACKING_HEADER_SIZE + newSize);
+  if (!newHeader) {
+    return NULL;
+  }
+
+  // NOTE: counted as a free of the old size plus an allocation of the new
+  //       one, under the tag of whoever reallocated it
+  ivyRecordTrackingMemoryFree(trackingAllocator, newHeader);
+  ivyRecordTrackingMemoryAllocation(trackingAllocator, newHeader, newSize);
+
+  return newHeader + 1;
+}
+
+IVY_INTERNAL void ivyTrackingMemoryAllocatorFree(
+    IvyAnyMemoryAllocator allocator, void *data) {
+  IvyTrackingMemoryHeader *header;
+  IvyTrackingMemoryAllocator *trackingAllocator = allocator;
+
+  if (!data) {
+    return;
+  }
+
+  header = (IvyTrackingMemoryHeader *)data - 1;
+  ivyRecordTrackingMemoryFree(trackingAllocator, header);
+  ivyFreeMemory(trackingAllocator->backendMemoryAllocator, header);
+}
+
+// NOTE: the backend drops every allocation, the ones made through other
+//       tracking allocators sharing it included
+IVY_INTERNAL void ivyTrackingMemoryAllocatorClear(
+    IvyAnyMemoryAllocator allocator) {
+  uint32_t tag;
+  IvyTrackingMemoryAllocator *trackingAllocator = allocator;
+  IvyMemoryAllocatorStats *stats = trackingAllocator->stats;
+
+  ivyClearMemoryAllocator(trackingAllocator->backendMemoryAllocator);
+
+  stats->total.aliveAllocationCount = 0;
+  stats->total.aliveSize = 0;
+
+  for (tag = 0; tag < IVY_MEMORY_TAG_COUNT; ++tag) {
+    stats->tags[tag].aliveAllocationCount = 0;
+    stats->tags[tag].aliveSize = 0;
+  }
+}
+
+// NOTE: the backend is not destroyed, other tracking allocators may still
+//       be using it
+IVY_INTERNAL void ivyTrackingMemoryAllocatorDestroy(
+    IvyAnyMemoryAllocator allocator) {
+  IvyTrackingMemoryAllocator *trackingAllocator = allocator;
+  IVY_UNUSED(trackingAllocator);
+  IVY_ASSERT(!trackingAllocator->stats->tags[trackingAllocator->tag]
+                  .aliveAllocationCount);
+}
+
+IVY_INTERNAL IvyMemoryAllocatorDispatch const
+    trackingMemoryAllocatorDispatch = {ivyTrackingMemoryAllocatorAllocate,
+        ivyTrackingMemoryAllocatorAllocateAndZeroMemory,
+        ivyTrackingMemoryAllocatorReallocate, ivyTrackingMemoryAllocatorFree,
+        ivyTrackingMemoryAllocatorClear, ivyTrackingMemoryAllocatorDestroy};
+
+IVY_API IvyCode ivyCreateTrackingMemoryAllocator(
+    IvyAnyMemoryAllocator backendMemoryAllocator, IvyMemoryTag tag,
+    IvyMemoryAllocatorStats *stats, IvyTrackingMemoryAllocator *allocator) {
+  IVY_ASSERT(backendMemoryAllocator);
+  IVY_ASSERT(stats);
+
+  if (tag >= IVY_MEMORY_TAG_COUNT) {
+    return IVY_ERROR_INVALID_VALUE;
+  }
+
+  ivySetupMemoryAllocatorBase(&trackingMemoryAllocatorDispatch,
+      &allocator->base);
+
+  allocator->backendMemoryAllocator = backendMemoryAllocator;
+  allocator->tag = tag;
+  allocator->stats = stats;
+
+  return IVY_OK;
+}
+
+IVY_API void ivyGetMemoryAllocatorStats(IvyTrackingMemoryAllocator *allocator,
+    IvyMemoryAllocatorStats *stats) {
+  IVY_MEMCPY(stats, allocator->stats, sizeof(*stats));
+}
+
+IVY_API char const *ivyGetMemoryTagName(IvyMemoryTag tag) {
+  switch (tag) {
+  case IVY_MEMORY_TAG_UNKNOWN:
+    return "unknown";
+
+  case IVY_MEMORY_TAG_RENDERER:
+    return "renderer";
+
+  case IVY_MEMORY_TAG_MODEL:
+    return "model";
+
+  case IVY_MEMORY_TAG_TEXTURE:
+    return "texture";
+
+  case IVY_MEMORY_TAG_FRAME:
+    return "frame";
+
+  default:
+    return "invalid";
+  }
+}
@@ -0,0 +1,63 @@
+#ifndef IVY_TRACKING_MEMORY_ALLOCATOR_H
+#define IVY_TRACKING_MEMORY_ALLOCATOR_H
+
+#include "IvyMemoryAllocator.h"
+
+// NOTE: bucket 0 counts allocations up to 16 bytes, every following one
+//       doubles the limit and the last one takes everything bigger
+#define IVY_MEMORY_SIZE_HISTOGRAM_MIN_SIZE 16
+#define IVY_MEMORY_SIZE_HISTOGRAM_BUCKET_COUNT 20
+
+typedef enum IvyMemoryTag {
+  IVY_MEMORY_TAG_UNKNOWN,
+  IVY_MEMORY_TAG_RENDERER,
+  IVY_MEMORY_TAG_MODEL,
+  IVY_MEMORY_TAG_TEXTURE,
+  IVY_MEMORY_TAG_FRAME,
+  IVY_MEMORY_TAG_COUNT
+} IvyMemoryTag;
+
+typedef struct IvyMemoryTagStats {
+  uint64_t allocationCount;
+  uint64_t aliveAllocationCount;
+  uint64_t allocatedSize;
+  uint64_t aliveSize;
+  uint64_t peakAliveSize;
+} IvyMemoryTagStats;
+
+typedef struct IvyMemoryAllocatorStats {
+  IvyMemoryTagStats total;
+  IvyMemoryTagStats tags[IVY_MEMORY_TAG_COUNT];
+  uint64_t sizeHistogram[IVY_MEMORY_SIZE_HISTOGRAM_BUCKET_COUNT];
+} IvyMemoryAllocatorStats;
+
+// NOTE: every allocation starts with this, it's 16 bytes so the payload
+//       keeps the alignment of the backend
+typedef struct IvyTrackingMemoryHeader {
+  uint64_t size;
+  uint32_t tag;
+  uint32_t padding;
+} IvyTrackingMemoryHeader;
+
+// NOTE: forwards everything to the backend and records it in stats. Several
+//       tracking allocators with different tags can share the same stats
+//       and backend, allocations remember their tag so they can be freed
+//       through any of them. Not thread safe, stats is shared as is
+typedef struct IvyTrackingMemoryAllocator {
+  IvyMemoryAllocatorBase base;
+  IvyAnyMemoryAllocator backendMemoryAllocator;
+  IvyMemoryTag tag;
+  IvyMemoryAllocatorStats *stats;
+} IvyTrackingMemoryAllocator;
+
+// NOTE: stats has to start zeroed and outlive the allocator
+IVY_API IvyCode ivyCreateTrackingMemoryAllocator(
+    IvyAnyMemoryAllocator backendMemoryAllocator, IvyMemoryTag tag,
+    IvyMemoryAllocatorStats *stats, IvyTrackingMemoryAllocator *allocator);
+
+IVY_API void ivyGetMemoryAllocatorStats(IvyTrackingMemoryAllocator *allocator,
+    IvyMemoryAllocatorStats *stats);
+
+IVY_API char const *ivyGetMemoryTagName(IvyMemoryTag tag);
+
+#endif
@@ -0,0 +1,263 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "IvyVulkanHostMemoryAllocator.h"
+
+#include "IvyAtomic.h"
+
+#define IVY_VULKAN_HOST_MEMORY_MIN_ALIGNMENT 16
+
+IVY_INTERNAL IvyBool ivyIsVulkanHostMemoryScopePooled(uint32_t scope) {
+  return VK_SYSTEM_ALLOCATION_SCOPE_COMMAND == scope ||
+         VK_SYSTEM_ALLOCATION_SCOPE_OBJECT == scope;
+}
+
+IVY_INTERNAL void *ivyAllocateVulkanHostMemoryFromBackend(
+    IvyVulkanHostMemoryAllocator *hostAllocator, uint32_t scope,
+    uint64_t size) {
+  void *allocation;
+
+  if (ivyIsVulkanHostMemoryScopePooled(scope)) {
+    return ivyAllocateMemory(&hostAllocator->objectMemoryAllocator, size);
+  }
+
+  pthread_mutex_lock(&hostAllocator->heapMutex);
+  allocation = ivyAllocateMemory(hostAllocator->heapMemoryAllocator, size);
+  pthread_mutex_unlock(&hostAllocator->heapMutex);
+
+  return allocation;
+}
+
+IVY_INTERNAL void ivyFreeVulkanHostMemoryToBackend(
+    IvyVulkanHostMemoryAllocator *hostAllocator, uint32_t scope,
+    void *allocation) {
+  if (ivyIsVulkanHostMemoryScopePooled(scope)) {
+    ivyFreeMemory(&hostAllocator->objectMemoryAllocator, allocation);
+    return;
+  }
+
+  pthread_mutex_lock(&hostAllocator->heapMutex);
+  ivyFreeMemory(hostAllocator->heapMemoryAllocator, allocation);
+  pthread_mutex_unlock(&hostAllocator->heapMutex);
+}
+
+IVY_INTERNAL void ivyRecordVulkanHostMemoryAllocation(
+    IvyVulkanHostMemoryStatistics *statistics, uint32_t scope,
+    uint64_t size) {
+  uint64_t peakAliveSize;
+  uint64_t const aliveSize = IVY_ATOMIC_ADD(&statistics->aliveSize, size);
+
+  IVY_ATOMIC_ADD(&statistics->allocationCount, 1);
+  IVY_ATOMIC_ADD(&statistics->aliveSizes[scope], size);
+  IVY_ATOMIC_ADD(&statistics->aliveAllocationCounts[scope], 1);
+
+  peakAliveSize = IVY_ATOMIC_LOAD(&statistics->peakAliveSize);
+  while (peakAliveSize < aliveSize &&
+         !IVY_ATOMIC_COMPARE_EXCHANGE(&statistics->peakAliveSize,
+             &peakAliveSize, aliveSize)) {
+  }
+}
+
+IVY_INTERNAL void ivyRecordVulkanHostMemoryFree(
+    IvyVulkanHostMemoryStatistics *statistics, uint32_t scope,
+    uint64_t size) {
+  IVY_ATOMIC_SUB(&statistics->aliveSize, size);
+  IVY_ATOMIC_SUB(&statistics->aliveSizes[scope], size);
+  IVY_ATOMIC_SUB(&statistics->aliveAllocationCounts[scope], 1);
+}
+
+IVY_INTERNAL IvyVulkanHostMemoryHeader *ivyGetVulkanHostMemoryHeader(
+    void *data) {
+  return (IvyVulkanHostMemoryHeader *)data - 1;
+}
+
+static VKAPI_ATTR void *VKAPI_CALL ivyAllocateVulkanHostMemory(void *user,
+    size_t size, size_t alignment, VkSystemAllocationScope scope) {
+  uint8_t *allocation;
+  uintptr_t address;
+  IvyVulkanHostMemoryHeader *header;
+  IvyVulkanHostMemoryAllocator *hostAllocator = user;
+
+  IVY_ASSERT((uint32_t)scope < IVY_VULKAN_HOST_MEMORY_SCOPE_COUNT);
+
+  if (alignment < IVY_VULKAN_HOST_MEMORY_MIN_ALIGNMENT) {
+    alignment = IVY_VULKAN_HOST_MEMORY_MIN_ALIGNMENT;
+  }
+
+  allocation = ivyAllocateVulkanHostMemoryFromBackend(hostAllocator, scope,
+      sizeof(*header) + alignment - 1 + size);
+  if (!allocation) {
+    return NULL;
+  }
+
+  address = (uintptr_t)(allocation + sizeof(*header));
+  address = (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+  header = ivyGetVulkanHostMemoryHeader((void *)address);
+  header->allocation = allocation;
+  header->size = size;
+  header->scope = scope;
+  header->padding = 0;
+
+  ivyRecordVulkanHostMemoryAllocation(&hostAllocator->statistics, scope,
+      size);
+
+  return (void *)address;
+}
+
+static VKAPI_ATTR void VKAPI_CALL ivyFreeVulkanHostMemory(void *user,
+    void *data) {
+  IvyVulkanHostMemoryHeader *header;
+  IvyVulkanHostMemoryAllocator *hostAllocator = user;
+
+  if (!data) {
+    return;
+  }
+
+  header = ivyGetVulkanHostMemoryHeader(data);
+
+  ivyRecordVulkanHostMemoryFree(&hostAllocator->statistics, header->scope,
+      header->size);
+  ivyFreeVulkanHostMemoryToBackend(hostAllocator, header->scope,
+      header->allocation);
+}
+
+// NOTE: the new allocation may have a different scope than the old one, so
+//       this always moves it
+static VKAPI_ATTR void *VKAPI_CALL ivyReallocateVulkanHostMemory(void *user,
+    void *data, size_t size, size_t alignment,
+    VkSystemAllocationScope scope) {
+  void *newData;
+  IvyVulkanHostMemoryHeader *header;
+
+  if (!data) {
+    return ivyAllocateVulkanHostMemory(user, size, alignment, scope);
+  }
+
+  if (!size) {
+    ivyFreeVulkanHostMemory(user, data);
+    return NULL;
+  }
+
+  newData = ivyAllocateVulkanHostMemory(user, size, alignment, scope);
+  if (!newData) {
+    return NULL;
+  }
+
+  header = ivyGetVulkanHostMemoryHeader(data);
+  IVY_MEMCPY(newData, data, IVY_MIN(header->size, (uint64_t)size));
+  ivyFreeVulkanHostMemory(user, data);
+
+  return newData;
+}
+
+static VKAPI_ATTR void VKAPI_CALL ivyNotifyVulkanInternalAllocation(
+    void *user, size_t size, VkInternalAllocationType type,
+    VkSystemAllocationScope scope) {
+  IvyVulkanHostMemoryAllocator *hostAllocator = user;
+  IVY_UNUSED(type);
+  IVY_UNUSED(scope);
+  IVY_ATOMIC_ADD(&hostAllocator->statistics.internalAliveSize, size);
+}
+
+static VKAPI_ATTR void VKAPI_CALL ivyNotifyVulkanInternalFree(void *user,
+    size_t size, VkInternalAllocationType type,
+    VkSystemAllocationScope scope) {
+  IvyVulkanHostMemoryAllocator *hostAllocator = user;
+  IVY_UNUSED(type);
+  IVY_UNUSED(scope);
+  IVY_ATOMIC_SUB(&hostAllocator->statistics.internalAliveSize, size);
+}
+
+IVY_API IvyCode ivyCreateVulkanHostMemoryAllocator(
+    IvyAnyMemoryAllocator heapMemoryAllocator,
+    IvyVulkanHostMemoryAllocator *allocator) {
+  IvyCode ivyCode;
+
+  IVY_ASSERT(heapMemoryAllocator);
+
+  IVY_MEMSET(&allocator->statistics, 0, sizeof(allocator->statistics));
+
+  allocator->heapMemoryAllocator = heapMemoryAllocator;
+
+  allocator->callbacks.pUserData = allocator;
+  allocator->callbacks.pfnAllocation = ivyAllocateVulkanHostMemory;
+  allocator->callbacks.pfnReallocation = ivyReallocateVulkanHostMemory;
+  allocator->callbacks.pfnFree = ivyFreeVulkanHostMemory;
+  allocator->callbacks.pfnInternalAllocation =
+      ivyNotifyVulkanInternalAllocation;
+  allocator->callbacks.pfnInternalFree = ivyNotifyVulkanInternalFree;
+
+  if (pthread_mutex_init(&allocator->heapMutex, NULL)) {
+    return IVY_ERROR_UNKNOWN;
+  }
+
+  ivyCode = ivyCreatePoolMemoryAllocator(&allocator->poolMemoryAllocator);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    pthread_mutex_destroy(&allocator->heapMutex);
+    return ivyCode;
+  }
+
+  ivyCode = ivyCreateThreadSafeMemoryAllocator(
+      &allocator->poolMemoryAllocator, &allocator->objectMemoryAllocator);
+  IVY_ASSERT(!ivyCode);
+  if (ivyCode) {
+    ivyDestroyMemoryAllocator(&allocator->poolMemoryAllocator);
+    pthread_mutex_destroy(&allocator->heapMutex);
+    return ivyCode;
+  }
+
+  return IVY_OK;
+}
+
+IVY_API void ivyDestroyVulkanHostMemoryAllocator(
+    IvyVulkanHostMemoryAllocator *allocator) {
+  IVY_ASSERT(!IVY_ATOMIC_LOAD(&allocator->statistics.aliveSize));
+
+  ivyDestroyMemoryAllocator(&allocator->objectMemoryAllocator);
+  ivyDestroyMemoryAllocator(&allocator->poolMemoryAllocator);
+  pthread_mutex_destroy(&allocator->heapMutex);
+}
+
+IVY_API void ivyGetVulkanHostMemoryStatistics(
+    IvyVulkanHostMemoryAllocator *allocator,
+    IvyVulkanHostMemoryStatistics *statistics) {
+  uint32_t scope;
+  IvyVulkanHostMemoryStatistics *source = &allocator->statistics;
+
+  statistics->allocationCount = IVY_ATOMIC_LOAD(&source->allocationCount);
+  statistics->aliveSize = IVY_ATOMIC_LOAD(&source->aliveSize);
+  statistics->peakAliveSize = IVY_ATOMIC_LOAD(&source->peakAliveSize);
+  statistics->internalAliveSize =
+      IVY_ATOMIC_LOAD(&source->internalAliveSize);
+
+  for (scope = 0; scope < IVY_VULKAN_HOST_MEMORY_SCOPE_COUNT; ++scope) {
+    statistics->aliveSizes[scope] =
+        IVY_ATOMIC_LOAD(&source->aliveSizes[scope]);
+    statistics->aliveAllocationCounts[scope] =
+        IVY_ATOMIC_LOAD(&source->aliveAllocationCounts[scope]);
+  }
+}
+
+IVY_API char const *ivyGetVulkanHostMemoryScopeName(
+    VkSystemAllocationScope scope) {
+  switch (scope) {
+  case VK_SYSTEM_ALLOCATION_SCOPE_COMMAND:
+    return "command";
+
+  case VK_SYSTEM_ALLOCATION_SCOPE_OBJECT:
+    return "object";
+
+  case VK_SYSTEM_ALLOCATION_SCOPE_CACHE:
+    return "cache";
+
+  case VK_SYSTEM_ALLOCATION_SCOPE_DEVICE:
+    return "device";
+
+  case VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE:
+    return "instance";
+
+  default:
+    return "invalid";
+  }
+}
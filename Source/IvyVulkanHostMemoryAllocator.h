@@ -0,0 +1,67 @@
+#ifndef IVY_VULKAN_HOST_MEMORY_ALLOCATOR_H
+#define IVY_VULKAN_HOST_MEMORY_ALLOCATOR_H
+
+#include <pthread.h>
+#include <vulkan/vulkan.h>
+
+#include "IvyMemoryAllocator.h"
+#include "IvyPoolMemoryAllocator.h"
+#include "IvyThreadSafeMemoryAllocator.h"
+
+#define IVY_VULKAN_HOST_MEMORY_SCOPE_COUNT                                   \
+  (VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1)
+
+// NOTE: sits right before the pointer handed to the driver, allocation is
+//       what the backend returned before aligning
+typedef struct IvyVulkanHostMemoryHeader {
+  void *allocation;
+  uint64_t size;
+  uint32_t scope;
+  uint32_t padding;
+} IvyVulkanHostMemoryHeader;
+
+// NOTE: aliveSizes and aliveAllocationCounts are indexed by
+//       VkSystemAllocationScope. internalAliveSize is what the driver
+//       reports allocating on its own through the internal notifications
+typedef struct IvyVulkanHostMemoryStatistics {
+  uint64_t allocationCount;
+  uint64_t aliveSize;
+  uint64_t peakAliveSize;
+  uint64_t internalAliveSize;
+  uint64_t aliveSizes[IVY_VULKAN_HOST_MEMORY_SCOPE_COUNT];
+  uint64_t aliveAllocationCounts[IVY_VULKAN_HOST_MEMORY_SCOPE_COUNT];
+} IvyVulkanHostMemoryStatistics;
+
+// NOTE: builds the VkAllocationCallbacks handed to every vkCreate* and
+//       vkAllocateMemory call. Command and object scoped allocations are
+//       short lived and small, they go to a pool behind the thread safe
+//       front-end. Cache, device and instance scoped ones go to the heap
+//       allocator, one call at a time. The driver may call in from any
+//       thread that uses Vulkan
+typedef struct IvyVulkanHostMemoryAllocator {
+  VkAllocationCallbacks callbacks;
+  IvyAnyMemoryAllocator heapMemoryAllocator;
+  pthread_mutex_t heapMutex;
+  IvyPoolMemoryAllocator poolMemoryAllocator;
+  IvyThreadSafeMemoryAllocator objectMemoryAllocator;
+  IvyVulkanHostMemoryStatistics statistics;
+} IvyVulkanHostMemoryAllocator;
+
+IVY_API IvyCode ivyCreateVulkanHostMemoryAllocator(
+    IvyAnyMemoryAllocator heapMemoryAllocator,
+    IvyVulkanHostMemoryAllocator *allocator);
+
+// NOTE: every Vulkan object created with the callbacks has to be destroyed
+//       before this. Threads the driver allocated from may still be alive,
+//       their cached blocks are released here as well
+IVY_API void ivyDestroyVulkanHostMemoryAllocator(
+    IvyVulkanHostMemoryAllocator *allocator);
+
+IVY_API void ivyGetVulkanHostMemoryStatistics(
+    IvyVulkanHostMemoryAllocator *allocator,
+    IvyVulkanHostMemoryStatistics *statistics);
+
+IVY_API char const *ivyGetVulkanHostMemoryScopeName(
+    VkSystemAllocationScope scope);
+
+#endif
@@ -9,7 +9,8 @@ IVY_API IvyCode ivyVulkanResultAsIvyCode(VkResult vulkanResult) {
   }
 }
 
-IVY_API VkResult ivyCreateVulkanImage(VkDevice device, int32_t width,
+IVY_API VkResult ivyCreateVulkanImage(VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks, int32_t width,
     int32_t height, uint32_t mipLevels, VkSampleCountFlagBits samples,
     VkImageUsageFlags usage, VkFormat format, VkImage *image) {
   VkImageCreateInfo imageCreateInfo;
@@ -32,10 +33,11 @@ IVY_API VkResult ivyCreateVulkanImage(VkDevice device, int32_t width,
   imageCreateInfo.pQueueFamilyIndices = NULL;
   imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-  return vkCreateImage(device, &imageCreateInfo, NULL, image);
+  return vkCreateImage(device, &imageCreateInfo, allocationCallbacks, image);
 }
 
-IVY_API VkResult ivyCreateVulkanImageView(VkDevice device, VkImage image,
+IVY_API VkResult ivyCreateVulkanImageView(VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks, VkImage image,
     VkImageAspectFlags aspect, VkFormat format, VkImageView *imageView) {
   VkImageViewCreateInfo imageViewCreateInfo;
 
@@ -55,10 +57,12 @@ IVY_API VkResult ivyCreateVulkanImageView(VkDevice device, VkImage image,
   imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
   imageViewCreateInfo.subresourceRange.layerCount = 1;
 
-  return vkCreateImageView(device, &imageViewCreateInfo, NULL, imageView);
+  return vkCreateImageView(device, &imageViewCreateInfo, allocationCallbacks,
+      imageView);
 }
 
 IVY_API VkResult ivyCreateVulkanBuffer(VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks,
     VkBufferUsageFlagBits flags, uint64_t size, VkBuffer *buffer) {
   VkBufferCreateInfo bufferCreateInfo;
 
@@ -71,7 +75,8 @@ IVY_API VkResult ivyCreateVulkanBuffer(VkDevice device,
   bufferCreateInfo.queueFamilyIndexCount = 0;
   bufferCreateInfo.pQueueFamilyIndices = NULL;
 
-  return vkCreateBuffer(device, &bufferCreateInfo, NULL, buffer);
+  return vkCreateBuffer(device, &bufferCreateInfo, allocationCallbacks,
+      buffer);
 }
 
 IVY_API VkResult ivyAllocateVulkanDescriptorSet(VkDevice device,
@@ -105,6 +110,21 @@ IVY_API VkResult ivyAllocateVulkanCommandBuffer(VkDevice device,
       commandBuffer);
 }
 
+IVY_API VkResult ivyAllocateVulkanSecondaryCommandBuffer(VkDevice device,
+    VkCommandPool commandPool, VkCommandBuffer *commandBuffer) {
+  VkCommandBufferAllocateInfo commandBufferAllocateInfo;
+
+  commandBufferAllocateInfo.sType =
+      VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  commandBufferAllocateInfo.pNext = NULL;
+  commandBufferAllocateInfo.commandPool = commandPool;
+  commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+  commandBufferAllocateInfo.commandBufferCount = 1;
+
+  return vkAllocateCommandBuffers(device, &commandBufferAllocateInfo,
+      commandBuffer);
+}
+
 IVY_API VkResult ivyAllocateAndBeginVulkanCommandBuffer(VkDevice device,
     VkCommandPool commandPool, VkCommandBuffer *commandBuffer) {
   VkResult vulkanResult;
@@ -128,41 +148,91 @@ IVY_API VkResult ivyAllocateAndBeginVulkanCommandBuffer(VkDevice device,
   vulkanResult = vkBeginCommandBuffer(*commandBuffer, &beginInfo);
   if (vulkanResult) {
     vkFreeCommandBuffers(device, commandPool, 1, commandBuffer);
+    *commandBuffer = VK_NULL_HANDLE;
     return vulkanResult;
   }
 
   return VK_SUCCESS;
 }
 
-IVY_API VkResult ivyEndSubmitAndFreeVulkanCommandBuffer(VkDevice device,
-    VkQueue graphicsQueue, VkCommandPool commandPool,
-    VkCommandBuffer commandBuffer) {
-  VkResult vulkanResult;
+// NOTE: every submission waits for the previous value of the timeline and
+//       signals the next one, so work submitted to different queues still
+//       executes in submission order
+IVY_API VkResult ivySubmitVulkanCommandBuffer(VkQueue queue,
+    VkCommandBuffer commandBuffer, VkSemaphore timelineSemaphore,
+    uint64_t waitValue, uint64_t signalValue, VkFence fence) {
   VkSubmitInfo submitInfo;
+  VkTimelineSemaphoreSubmitInfo timelineSubmitInfo;
+  VkPipelineStageFlags const waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
 
-  IVY_ASSERT(device);
-  IVY_ASSERT(commandPool);
+  IVY_ASSERT(queue);
   IVY_ASSERT(commandBuffer);
+  IVY_ASSERT(timelineSemaphore);
+  IVY_ASSERT(waitValue < signalValue);
 
-  vkEndCommandBuffer(commandBuffer);
+  timelineSubmitInfo.sType =
+      VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  timelineSubmitInfo.pNext = NULL;
+  timelineSubmitInfo.waitSemaphoreValueCount = 1;
+  timelineSubmitInfo.pWaitSemaphoreValues = &waitValue;
+  timelineSubmitInfo.signalSemaphoreValueCount = 1;
+  timelineSubmitInfo.pSignalSemaphoreValues = &signalValue;
 
   submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  submitInfo.pNext = NULL;
-  submitInfo.waitSemaphoreCount = 0;
-  submitInfo.pWaitSemaphores = NULL;
-  submitInfo.pWaitDstStageMask = NULL;
+  submitInfo.pNext = &timelineSubmitInfo;
+  submitInfo.waitSemaphoreCount = 1;
+  submitInfo.pWaitSemaphores = &timelineSemaphore;
+  submitInfo.pWaitDstStageMask = &waitStage;
   submitInfo.commandBufferCount = 1;
   submitInfo.pCommandBuffers = &commandBuffer;
-  submitInfo.signalSemaphoreCount = 0;
-  submitInfo.pSignalSemaphores = NULL;
+  submitInfo.signalSemaphoreCount = 1;
+  submitInfo.pSignalSemaphores = &timelineSemaphore;
+
+  return vkQueueSubmit(queue, 1, &submitInfo, fence);
+}
+
+IVY_API VkResult ivyWaitForVulkanTimelineSemaphore(VkDevice device,
+    VkSemaphore timelineSemaphore, uint64_t value) {
+  VkSemaphoreWaitInfo waitInfo;
+
+  waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+  waitInfo.pNext = NULL;
+  waitInfo.flags = 0;
+  waitInfo.semaphoreCount = 1;
+  waitInfo.pSemaphores = &timelineSemaphore;
+  waitInfo.pValues = &value;
 
-  vulkanResult = vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
+  return vkWaitSemaphores(device, &waitInfo, (uint64_t)-1);
+}
+
+// NOTE: only waits for this submission to finish, the queue keeps running
+IVY_API VkResult ivyEndSubmitAndFreeVulkanCommandBuffer(VkDevice device,
+    VkQueue queue, VkCommandPool commandPool, VkCommandBuffer commandBuffer,
+    VkSemaphore timelineSemaphore, uint64_t *timelineValue) {
+  VkResult vulkanResult;
+
+  IVY_ASSERT(device);
+  IVY_ASSERT(commandPool);
+  IVY_ASSERT(commandBuffer);
+  IVY_ASSERT(timelineValue);
+
+  vulkanResult = vkEndCommandBuffer(commandBuffer);
+  if (vulkanResult) {
+    vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+    return vulkanResult;
+  }
+
+  vulkanResult = ivySubmitVulkanCommandBuffer(queue, commandBuffer,
+      timelineSemaphore, *timelineValue, *timelineValue + 1, VK_NULL_HANDLE);
   if (vulkanResult) {
     vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
     return vulkanResult;
   }
 
-  vulkanResult = vkQueueWaitIdle(graphicsQueue);
+  ++*timelineValue;
+
+  vulkanResult = ivyWaitForVulkanTimelineSemaphore(device, timelineSemaphore,
+      *timelineValue);
   if (vulkanResult) {
     vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
     return vulkanResult;
@@ -172,3 +242,22 @@ IVY_API VkResult ivyEndSubmitAndFreeVulkanCommandBuffer(VkDevice device,
 
   return VK_SUCCESS;
 }
+
+IVY_API VkResult ivyCreateVulkanTimelineSemaphore(VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks, uint64_t initialValue,
+    VkSemaphore *semaphore) {
+  VkSemaphoreCreateInfo semaphoreCreateInfo;
+  VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo;
+
+  semaphoreTypeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+  semaphoreTypeCreateInfo.pNext = NULL;
+  semaphoreTypeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  semaphoreTypeCreateInfo.initialValue = initialValue;
+
+  semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+  semaphoreCreateInfo.pNext = &semaphoreTypeCreateInfo;
+  semaphoreCreateInfo.flags = 0;
+
+  return vkCreateSemaphore(device, &semaphoreCreateInfo, allocationCallbacks,
+      semaphore);
+}
@@ -7,11 +7,13 @@
 
 IVY_API IvyCode ivyVulkanResultAsIvyCode(VkResult vulkanResult);
 
-IVY_API VkResult ivyCreateVulkanImage(VkDevice device, int32_t width,
+IVY_API VkResult ivyCreateVulkanImage(VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks, int32_t width,
     int32_t height, uint32_t mipLevels, VkSampleCountFlagBits samples,
     VkImageUsageFlags usage, VkFormat format, VkImage *image);
 
-IVY_API VkResult ivyCreateVulkanImageView(VkDevice device, VkImage image,
+IVY_API VkResult ivyCreateVulkanImageView(VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks, VkImage image,
     VkImageAspectFlags aspect, VkFormat format, VkImageView *imageView);
 
 IVY_API VkResult ivyAllocateVulkanDescriptorSet(VkDevice device,
@@ -22,13 +24,28 @@ IVY_API VkResult ivyAllocateVulkanCommandBuffer(VkDevice device,
     VkCommandPool commandPool, VkCommandBuffer *commandBuffer);
 
 IVY_API VkResult ivyCreateVulkanBuffer(VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks,
     VkBufferUsageFlagBits flags, uint64_t size, VkBuffer *buffer);
 
+IVY_API VkResult ivyAllocateVulkanSecondaryCommandBuffer(VkDevice device,
+    VkCommandPool commandPool, VkCommandBuffer *commandBuffer);
+
 IVY_API VkResult ivyAllocateAndBeginVulkanCommandBuffer(VkDevice device,
     VkCommandPool commandPool, VkCommandBuffer *commandBuffer);
 
+IVY_API VkResult ivySubmitVulkanCommandBuffer(VkQueue queue,
+    VkCommandBuffer commandBuffer, VkSemaphore timelineSemaphore,
+    uint64_t waitValue, uint64_t signalValue, VkFence fence);
+
+IVY_API VkResult ivyWaitForVulkanTimelineSemaphore(VkDevice device,
+    VkSemaphore timelineSemaphore, uint64_t value);
+
 IVY_API VkResult ivyEndSubmitAndFreeVulkanCommandBuffer(VkDevice device,
-    VkQueue graphicsQueue, VkCommandPool commandPool,
-    VkCommandBuffer commandBuffer);
+    VkQueue queue, VkCommandPool commandPool, VkCommandBuffer commandBuffer,
+    VkSemaphore timelineSemaphore, uint64_t *timelineValue);
+
+IVY_API VkResult ivyCreateVulkanTimelineSemaphore(VkDevice device,
+    VkAllocationCallbacks const *allocationCallbacks, uint64_t initialValue,
+    VkSemaphore *semaphore);
 
 #endif
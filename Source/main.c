@@ -1,24 +1,118 @@
 #include "IvyApplication.h"
 #include "IvyDraw.h"
 #include "IvyGraphicsTexture.h"
+#include "IvyJobSystem.h"
 #include "IvyMemoryAllocator.h"
+#include "IvyPoolMemoryAllocator.h"
 #include "IvyRenderer.h"
+#include "IvyStackMemoryAllocator.h"
+#include "IvyTrackingMemoryAllocator.h"
 
 #include <stdio.h>
 
 IvyAnyMemoryAllocator allocator;
+IvyAnyMemoryAllocator rendererAllocator;
+IvyAnyMemoryAllocator textureAllocator;
 IvyApplication *application = NULL;
 IvyWindow *window = NULL;
 IvyRenderer *renderer = NULL;
 IvyGraphicsTexture *texture = NULL;
+IvyPoolMemoryAllocator texturePoolAllocator;
+IvyJobSystem jobSystem;
+float workerRed = 1.0F;
+
+#ifdef IVY_ENABLE_MEMORY_TRACKING
+IvyMemoryAllocatorStats memoryStats;
+IvyTrackingMemoryAllocator rendererTrackingAllocator;
+IvyTrackingMemoryAllocator textureTrackingAllocator;
+
+void printMemoryStats(void) {
+  int tag;
+  IvyMemoryAllocatorStats stats;
+
+  ivyGetMemoryAllocatorStats(&rendererTrackingAllocator, &stats);
+
+  printf("memory: %lu allocations, %lu bytes, %lu peak\n",
+      (unsigned long)stats.total.allocationCount,
+      (unsigned long)stats.total.allocatedSize,
+      (unsigned long)stats.total.peakAliveSize);
+
+  for (tag = 0; tag < IVY_MEMORY_TAG_COUNT; ++tag) {
+    printf("  %s: %lu allocations, %lu alive bytes, %lu peak\n",
+        ivyGetMemoryTagName((IvyMemoryTag)tag),
+        (unsigned long)stats.tags[tag].allocationCount,
+        (unsigned long)stats.tags[tag].aliveSize,
+        (unsigned long)stats.tags[tag].peakAliveSize);
+  }
+}
+
+void printVulkanHostMemoryStats(void) {
+  uint32_t scope;
+  IvyVulkanHostMemoryStatistics statistics;
+
+  ivyGetVulkanHostMemoryStatistics(&renderer->vulkanHostMemoryAllocator,
+      &statistics);
+
+  printf("driver host memory: %lu allocations, %lu alive bytes, %lu peak, "
+         "%lu internal\n",
+      (unsigned long)statistics.allocationCount,
+      (unsigned long)statistics.aliveSize,
+      (unsigned long)statistics.peakAliveSize,
+      (unsigned long)statistics.internalAliveSize);
+
+  for (scope = 0; scope < IVY_VULKAN_HOST_MEMORY_SCOPE_COUNT; ++scope) {
+    printf("  %s: %lu alive allocations, %lu alive bytes\n",
+        ivyGetVulkanHostMemoryScopeName((VkSystemAllocationScope)scope),
+        (unsigned long)statistics.aliveAllocationCounts[scope],
+        (unsigned long)statistics.aliveSizes[scope]);
+  }
+}
+#endif /* IVY_ENABLE_MEMORY_TRACKING */
+
+// NOTE: runs on a worker while the main thread records into context 0
+void recordWorkerRectangle(void *data) {
+  IvyCode ivyCode;
+  IvyGraphicsRecordingContext *recordingContext;
+
+  IVY_UNUSED(data);
+
+  ivyCode = ivyBeginGraphicsRecordingContext(renderer, 1, &recordingContext);
+  if (ivyCode) {
+    printf("failed to begin recording context\n");
+    return;
+  }
+
+  ivyDrawRectangleInRecordingContext(renderer, recordingContext, 0, 0, 1, 1,
+      workerRed, 1, workerRed, texture);
+
+  ivyEndGraphicsRecordingContext(renderer, recordingContext);
+}
 
 int main(void) {
   int iterationDirection = 1;
   int iteration = 0;
   float r = 1.0F;
   IvyCode ivyCode;
+  IvyJob workerJob;
+  IvyJobCounter workerCounter;
   allocator = ivyGetGlobalMemoryAllocator();
 
+  // NOTE: textures are small objects created and destroyed in bulk, keep
+  //       them off the system heap
+  ivyCreatePoolMemoryAllocator(&texturePoolAllocator);
+
+#ifdef IVY_ENABLE_MEMORY_TRACKING
+  ivyCreateTrackingMemoryAllocator(allocator, IVY_MEMORY_TAG_RENDERER,
+      &memoryStats, &rendererTrackingAllocator);
+  ivyCreateTrackingMemoryAllocator(&texturePoolAllocator,
+      IVY_MEMORY_TAG_TEXTURE, &memoryStats, &textureTrackingAllocator);
+  rendererAllocator = &rendererTrackingAllocator;
+  textureAllocator = &textureTrackingAllocator;
+#else
+  rendererAllocator = allocator;
+  textureAllocator = &texturePoolAllocator;
+#endif /* IVY_ENABLE_MEMORY_TRACKING */
+
   ivyCode = ivyCreateApplication(allocator, &application);
   if (ivyCode) {
     printf("failed to create application\n");
@@ -31,21 +125,30 @@ int main(void) {
     goto error;
   }
 
-  ivyCode = ivyCreateRenderer(allocator, application, &renderer);
+  ivyCode = ivyCreateRenderer(rendererAllocator, application, &renderer);
   if (ivyCode) {
     printf("failed to create renderer, %i\n", ivyCode);
     goto error;
   }
 
-  ivyCode = ivyCreateGraphicsTextureFromFile(allocator, renderer,
+  ivyCode = ivyCreateGraphicsTextureFromFile(textureAllocator, renderer,
       "../Resources/Ivy.jpg", &texture);
   if (ivyCode) {
     printf("failed to create texture\n");
     goto error;
   }
 
+  ivyCode = ivyCreateJobSystem(allocator, 1, &jobSystem);
+  if (ivyCode) {
+    printf("failed to create job system\n");
+    goto error;
+  }
+
+  workerJob.callback = recordWorkerRectangle;
+  workerJob.data = NULL;
+
   while (!ivyShouldApplicationClose(application)) {
-    ivyBeginGraphicsFrame(renderer);
+    ivyBeginGraphicsFrameWithRecordingContexts(renderer);
 
     iteration += iterationDirection;
     if (iteration == 60)
@@ -54,18 +157,38 @@ int main(void) {
       iterationDirection *= -1;
 
     r = ((float)iteration) / 60.0F;
+    workerRed = r;
+
+    workerCounter.value = 0;
+    ivyRunJobs(&jobSystem, 1, &workerJob, &workerCounter);
 
     ivyDrawRectangle(renderer, -1, -1, 0, 0, r, 1, 1, texture);
-    ivyDrawRectangle(renderer, 0, 0, 1, 1, r, 1, r, texture);
+
+    ivyWaitForJobCounter(&jobSystem, &workerCounter);
 
     ivyEndGraphicsFrame(renderer);
     ivyPollApplicationEvents(application);
   }
 
+#ifdef IVY_ENABLE_MEMORY_TRACKING
+  printVulkanHostMemoryStats();
+#endif /* IVY_ENABLE_MEMORY_TRACKING */
+
 error:
-  ivyDestroyGraphicsTexture(allocator, renderer, texture);
-  ivyDestroyRenderer(allocator, renderer);
+  ivyDestroyJobSystem(&jobSystem);
+  ivyDestroyGraphicsTexture(textureAllocator, renderer, texture);
+  ivyDestroyRenderer(rendererAllocator, renderer);
   ivyDestroyApplication(allocator, application);
+  ivyDestroyThreadScratchMemoryAllocator();
+
+#ifdef IVY_ENABLE_MEMORY_TRACKING
+  printMemoryStats();
+  ivyDestroyMemoryAllocator(&textureTrackingAllocator);
+  ivyDestroyMemoryAllocator(&rendererTrackingAllocator);
+#endif /* IVY_ENABLE_MEMORY_TRACKING */
+
+  ivyDestroyMemoryAllocator(&texturePoolAllocator);
+
   ivyDestroyGlobalMemoryAllocator();
 
   return 0;
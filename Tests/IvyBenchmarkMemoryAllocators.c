@@ -0,0 +1,513 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <IvyArenaMemoryAllocator.h>
+#include <IvyAtomicArenaMemoryAllocator.h>
+#include <IvyDummyMemoryAllocator.h>
+#include <IvyPoolMemoryAllocator.h>
+#include <IvyStackMemoryAllocator.h>
+#include <IvyTLSFMemoryAllocator.h>
+#include <IvyThreadSafeMemoryAllocator.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// NOTE: runs every allocator through every workload it supports, each run
+//       in a child process so the peak RSS belongs to that run alone.
+//       Prints one CSV line per run to stdout. fragmentation is the share
+//       of the RSS growth that wasn't live requested memory at the peak
+
+#define IVY_BENCHMARK_CAN_CLEAR 0x1
+#define IVY_BENCHMARK_GENERAL_PURPOSE 0x2
+#define IVY_BENCHMARK_THREAD_SAFE 0x4
+
+#define IVY_BENCHMARK_FRAME_COUNT 2000
+#define IVY_BENCHMARK_FRAME_ALLOCATION_COUNT 256
+#define IVY_BENCHMARK_OBJECT_COUNT 10000
+#define IVY_BENCHMARK_OBJECT_ROUND_COUNT 100
+#define IVY_BENCHMARK_GROWTH_REPEAT_COUNT 200
+#define IVY_BENCHMARK_GROWTH_BUFFER_COUNT 8
+#define IVY_BENCHMARK_GROWTH_MAX_SIZE (1024 * 1024)
+#define IVY_BENCHMARK_THREAD_COUNT 4
+#define IVY_BENCHMARK_THREAD_OPERATION_COUNT 100000
+#define IVY_BENCHMARK_THREAD_SLOT_COUNT 64
+
+typedef IvyCode (*IvyCreateBenchmarkMemoryAllocatorCallback)(
+    IvyAnyMemoryAllocator allocator);
+
+typedef struct IvyBenchmarkMemoryAllocator {
+  char const *name;
+  IvyCreateBenchmarkMemoryAllocatorCallback create;
+  uint32_t flags;
+} IvyBenchmarkMemoryAllocator;
+
+typedef struct IvyBenchmarkResult {
+  uint64_t operationCount;
+  uint64_t peakLiveSize;
+} IvyBenchmarkResult;
+
+typedef IvyBool (*IvyRunBenchmarkWorkloadCallback)(
+    IvyAnyMemoryAllocator allocator, uint32_t flags,
+    IvyBenchmarkResult *result);
+
+typedef struct IvyBenchmarkWorkload {
+  char const *name;
+  IvyRunBenchmarkWorkloadCallback run;
+  uint32_t requiredFlags;
+} IvyBenchmarkWorkload;
+
+typedef struct IvyBenchmarkThread {
+  pthread_t thread;
+  IvyAnyMemoryAllocator allocator;
+  uint32_t seed;
+  IvyBool isStarted;
+  IvyBool failed;
+  uint64_t peakLiveSize;
+} IvyBenchmarkThread;
+
+typedef union IvyBenchmarkMemoryAllocatorStorage {
+  IvyMemoryAllocatorBase base;
+  IvyDummyMemoryAllocator dummy;
+  IvyArenaMemoryAllocator arena;
+  IvyStackMemoryAllocator stack;
+  IvyPoolMemoryAllocator pool;
+  IvyTLSFMemoryAllocator tlsf;
+  IvyThreadSafeMemoryAllocator threadSafe;
+  IvyAtomicArenaMemoryAllocator atomicArena;
+} IvyBenchmarkMemoryAllocatorStorage;
+
+IVY_INTERNAL IvyDummyMemoryAllocator benchmarkBackendMemoryAllocator;
+
+IVY_INTERNAL uint32_t ivyNextBenchmarkRandom(uint32_t *state) {
+  uint32_t value = *state;
+  value ^= value << 13;
+  value ^= value >> 17;
+  value ^= value << 5;
+  return *state = value;
+}
+
+IVY_INTERNAL uint64_t ivyGetBenchmarkRandomSize(uint32_t *state,
+    uint64_t minSize, uint64_t maxSize) {
+  return minSize + ivyNextBenchmarkRandom(state) % (maxSize - minSize + 1);
+}
+
+IVY_INTERNAL uint64_t ivyGetBenchmarkTime(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (uint64_t)time.tv_sec * 1000000000 + (uint64_t)time.tv_nsec;
+}
+
+IVY_INTERNAL uint64_t ivyGetBenchmarkPeakResidentSize(void) {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return (uint64_t)usage.ru_maxrss;
+#else
+  return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+IVY_INTERNAL IvyCode ivyCreateBenchmarkDummyMemoryAllocator(
+    IvyAnyMemoryAllocator allocator) {
+  return ivyCreateDummyMemoryAllocator(allocator);
+}
+
+IVY_INTERNAL IvyCode ivyCreateBenchmarkArenaMemoryAllocator(
+    IvyAnyMemoryAllocator allocator) {
+  return ivyCreateGrowableArenaMemoryAllocator(1024 * 1024, allocator);
+}
+
+IVY_INTERNAL IvyCode ivyCreateBenchmarkVirtualArenaMemoryAllocator(
+    IvyAnyMemoryAllocator allocator) {
+  return ivyCreateVirtualArenaMemoryAllocator((uint64_t)1 << 30,
+      4 * 1024 * 1024, 0, allocator);
+}
+
+IVY_INTERNAL IvyCode ivyCreateBenchmarkStackMemoryAllocator(
+    IvyAnyMemoryAllocator allocator) {
+  return ivyCreateStackMemoryAllocator(64 * 1024 * 1024, allocator);
+}
+
+IVY_INTERNAL IvyCode ivyCreateBenchmarkPoolMemoryAllocator(
+    IvyAnyMemoryAllocator allocator) {
+  return ivyCreatePoolMemoryAllocator(allocator);
+}
+
+IVY_INTERNAL IvyCode ivyCreateBenchmarkTLSFMemoryAllocator(
+    IvyAnyMemoryAllocator allocator) {
+  return ivyCreateTLSFMemoryAllocator(256 * 1024 * 1024, allocator);
+}
+
+IVY_INTERNAL IvyCode ivyCreateBenchmarkThreadSafeMemoryAllocator(
+    IvyAnyMemoryAllocator allocator) {
+  ivyCreateDummyMemoryAllocator(&benchmarkBackendMemoryAllocator);
+  return ivyCreateThreadSafeMemoryAllocator(&benchmarkBackendMemoryAllocator,
+      allocator);
+}
+
+IVY_INTERNAL IvyCode ivyCreateBenchmarkAtomicArenaMemoryAllocator(
+    IvyAnyMemoryAllocator allocator) {
+  return ivyCreateAtomicArenaMemoryAllocator(256 * 1024 * 1024, allocator);
+}
+
+IVY_INTERNAL IvyBenchmarkMemoryAllocator const benchmarkMemoryAllocators[] = {
+    {"dummy", ivyCreateBenchmarkDummyMemoryAllocator,
+        IVY_BENCHMARK_GENERAL_PURPOSE | IVY_BENCHMARK_THREAD_SAFE},
+    {"arena", ivyCreateBenchmarkArenaMemoryAllocator,
+        IVY_BENCHMARK_CAN_CLEAR},
+    {"virtualArena", ivyCreateBenchmarkVirtualArenaMemoryAllocator,
+        IVY_BENCHMARK_CAN_CLEAR},
+    {"stack", ivyCreateBenchmarkStackMemoryAllocator,
+        IVY_BENCHMARK_CAN_CLEAR},
+    {"pool", ivyCreateBenchmarkPoolMemoryAllocator,
+        IVY_BENCHMARK_GENERAL_PURPOSE},
+    {"tlsf", ivyCreateBenchmarkTLSFMemoryAllocator,
+        IVY_BENCHMARK_GENERAL_PURPOSE},
+    {"threadSafe", ivyCreateBenchmarkThreadSafeMemoryAllocator,
+        IVY_BENCHMARK_GENERAL_PURPOSE | IVY_BENCHMARK_THREAD_SAFE},
+    {"atomicArena", ivyCreateBenchmarkAtomicArenaMemoryAllocator,
+        IVY_BENCHMARK_CAN_CLEAR | IVY_BENCHMARK_THREAD_SAFE}};
+
+// NOTE: what a renderer does with its per frame memory, a few hundred
+//       short lived allocations dropped all at once
+IVY_INTERNAL IvyBool ivyRunFrameScratchBenchmark(
+    IvyAnyMemoryAllocator allocator, uint32_t flags,
+    IvyBenchmarkResult *result) {
+  int frame;
+  int index;
+  uint32_t random = 0x9E3779B9;
+  void *allocations[IVY_BENCHMARK_FRAME_ALLOCATION_COUNT];
+
+  for (frame = 0; frame < IVY_BENCHMARK_FRAME_COUNT; ++frame) {
+    uint64_t liveSize = 0;
+
+    for (index = 0; index < IVY_BENCHMARK_FRAME_ALLOCATION_COUNT; ++index) {
+      uint64_t const size = ivyGetBenchmarkRandomSize(&random, 16, 2048);
+
+      allocations[index] = ivyAllocateMemory(allocator, size);
+      if (!allocations[index]) {
+        return 0;
+      }
+
+      IVY_MEMSET(allocations[index], index, size);
+      liveSize += size;
+      ++result->operationCount;
+    }
+
+    result->peakLiveSize = IVY_MAX(result->peakLiveSize, liveSize);
+
+    if (flags & IVY_BENCHMARK_CAN_CLEAR) {
+      ivyClearMemoryAllocator(allocator);
+      ++result->operationCount;
+    } else {
+      for (index = IVY_BENCHMARK_FRAME_ALLOCATION_COUNT; index > 0;
+           --index) {
+        ivyFreeMemory(allocator, allocations[index - 1]);
+        ++result->operationCount;
+      }
+    }
+  }
+
+  return 1;
+}
+
+// NOTE: a large set of small objects where random halves get replaced,
+//       only meaningful for allocators that reuse freed memory
+IVY_INTERNAL IvyBool ivyRunManySmallObjectsBenchmark(
+    IvyAnyMemoryAllocator allocator, uint32_t flags,
+    IvyBenchmarkResult *result) {
+  int round;
+  int index;
+  uint64_t liveSize = 0;
+  uint32_t random = 0x2545F491;
+  IvyBool failed = 0;
+  IVY_LOCAL_PERSIST void *objects[IVY_BENCHMARK_OBJECT_COUNT];
+  IVY_LOCAL_PERSIST uint64_t sizes[IVY_BENCHMARK_OBJECT_COUNT];
+
+  IVY_UNUSED(flags);
+
+  IVY_MEMSET(objects, 0, sizeof(objects));
+  IVY_MEMSET(sizes, 0, sizeof(sizes));
+
+  for (round = 0; round < IVY_BENCHMARK_OBJECT_ROUND_COUNT && !failed;
+       ++round) {
+    for (index = 0; index < IVY_BENCHMARK_OBJECT_COUNT; ++index) {
+      if (objects[index] && ivyNextBenchmarkRandom(&random) % 2) {
+        continue;
+      }
+
+      if (objects[index]) {
+        ivyFreeMemory(allocator, objects[index]);
+        liveSize -= sizes[index];
+        ++result->operationCount;
+      }
+
+      sizes[index] = ivyGetBenchmarkRandomSize(&random, 16, 256);
+      objects[index] = ivyAllocateMemory(allocator, sizes[index]);
+      if (!objects[index]) {
+        failed = 1;
+        break;
+      }
+
+      IVY_MEMSET(objects[index], index, sizes[index]);
+      liveSize += sizes[index];
+      ++result->operationCount;
+    }
+
+    result->peakLiveSize = IVY_MAX(result->peakLiveSize, liveSize);
+  }
+
+  for (index = 0; index < IVY_BENCHMARK_OBJECT_COUNT; ++index) {
+    ivyFreeMemory(allocator, objects[index]);
+  }
+
+  return !failed;
+}
+
+// NOTE: a handful of arrays growing 1.5x at a time, interleaved so only
+//       one of them is ever on top of a stack like allocator
+IVY_INTERNAL IvyBool ivyRunReallocGrowthBenchmark(
+    IvyAnyMemoryAllocator allocator, uint32_t flags,
+    IvyBenchmarkResult *result) {
+  int repeat;
+  int index;
+  void *buffers[IVY_BENCHMARK_GROWTH_BUFFER_COUNT];
+  uint64_t sizes[IVY_BENCHMARK_GROWTH_BUFFER_COUNT];
+
+  for (repeat = 0; repeat < IVY_BENCHMARK_GROWTH_REPEAT_COUNT; ++repeat) {
+    IvyBool isGrowing = 1;
+
+    for (index = 0; index < IVY_BENCHMARK_GROWTH_BUFFER_COUNT; ++index) {
+      buffers[index] = NULL;
+      sizes[index] = 64;
+    }
+
+    while (isGrowing) {
+      isGrowing = 0;
+
+      for (index = 0; index < IVY_BENCHMARK_GROWTH_BUFFER_COUNT; ++index) {
+        void *buffer;
+        uint64_t const size = sizes[index] + sizes[index] / 2;
+
+        if (size > IVY_BENCHMARK_GROWTH_MAX_SIZE) {
+          continue;
+        }
+
+        buffer = ivyReallocateMemory(allocator, buffers[index], size);
+        if (!buffer) {
+          return 0;
+        }
+
+        IVY_MEMSET((uint8_t *)buffer + sizes[index] / 2, index,
+            size - sizes[index] / 2);
+
+        buffers[index] = buffer;
+        sizes[index] = size;
+        isGrowing = 1;
+        ++result->operationCount;
+      }
+    }
+
+    result->peakLiveSize = IVY_MAX(result->peakLiveSize,
+        IVY_BENCHMARK_GROWTH_BUFFER_COUNT * IVY_BENCHMARK_GROWTH_MAX_SIZE);
+
+    if (flags & IVY_BENCHMARK_CAN_CLEAR) {
+      ivyClearMemoryAllocator(allocator);
+      ++result->operationCount;
+    } else {
+      for (index = IVY_BENCHMARK_GROWTH_BUFFER_COUNT; index > 0; --index) {
+        ivyFreeMemory(allocator, buffers[index - 1]);
+        ++result->operationCount;
+      }
+    }
+  }
+
+  return 1;
+}
+
+IVY_INTERNAL void *ivyRunBenchmarkChurnThread(void *data) {
+  int index;
+  uint64_t liveSize = 0;
+  IvyBenchmarkThread *thread = data;
+  void *allocations[IVY_BENCHMARK_THREAD_SLOT_COUNT];
+  uint64_t sizes[IVY_BENCHMARK_THREAD_SLOT_COUNT];
+
+  IVY_MEMSET(allocations, 0, sizeof(allocations));
+  IVY_MEMSET(sizes, 0, sizeof(sizes));
+
+  for (index = 0; index < IVY_BENCHMARK_THREAD_OPERATION_COUNT; ++index) {
+    uint32_t const slot = ivyNextBenchmarkRandom(&thread->seed) %
+                          IVY_BENCHMARK_THREAD_SLOT_COUNT;
+
+    if (allocations[slot]) {
+      ivyFreeMemory(thread->allocator, allocations[slot]);
+      liveSize -= sizes[slot];
+    }
+
+    sizes[slot] = ivyGetBenchmarkRandomSize(&thread->seed, 16, 512);
+    allocations[slot] = ivyAllocateMemory(thread->allocator, sizes[slot]);
+    if (!allocations[slot]) {
+      thread->failed = 1;
+      break;
+    }
+
+    IVY_MEMSET(allocations[slot], slot, sizes[slot]);
+    liveSize += sizes[slot];
+    thread->peakLiveSize = IVY_MAX(thread->peakLiveSize, liveSize);
+  }
+
+  for (index = 0; index < IVY_BENCHMARK_THREAD_SLOT_COUNT; ++index) {
+    ivyFreeMemory(thread->allocator, allocations[index]);
+  }
+
+  return NULL;
+}
+
+// NOTE: every thread frees and allocates random sizes from a small set of
+//       slots, a stand in for loaders and jobs sharing one allocator
+IVY_INTERNAL IvyBool ivyRunMultiThreadedChurnBenchmark(
+    IvyAnyMemoryAllocator allocator, uint32_t flags,
+    IvyBenchmarkResult *result) {
+  int index;
+  IvyBool failed = 0;
+  IvyBenchmarkThread threads[IVY_BENCHMARK_THREAD_COUNT];
+
+  for (index = 0; index < IVY_BENCHMARK_THREAD_COUNT; ++index) {
+    threads[index].allocator = allocator;
+    threads[index].seed = 0x9E3779B9 + (uint32_t)index * 0x85EBCA6B;
+    threads[index].failed = 0;
+    threads[index].peakLiveSize = 0;
+    threads[index].isStarted = !pthread_create(&threads[index].thread, NULL,
+        ivyRunBenchmarkChurnThread, &threads[index]);
+  }
+
+  for (index = 0; index < IVY_BENCHMARK_THREAD_COUNT; ++index) {
+    if (threads[index].isStarted) {
+      pthread_join(threads[index].thread, NULL);
+    }
+
+    failed = failed || !threads[index].isStarted || threads[index].failed;
+    result->peakLiveSize += threads[index].peakLiveSize;
+    result->operationCount += 2 * IVY_BENCHMARK_THREAD_OPERATION_COUNT;
+  }
+
+  if (flags & IVY_BENCHMARK_CAN_CLEAR) {
+    ivyClearMemoryAllocator(allocator);
+  }
+
+  return !failed;
+}
+
+IVY_INTERNAL IvyBenchmarkWorkload const benchmarkWorkloads[] = {
+    {"frameScratch", ivyRunFrameScratchBenchmark, 0},
+    {"manySmallObjects", ivyRunManySmallObjectsBenchmark,
+        IVY_BENCHMARK_GENERAL_PURPOSE},
+    {"reallocGrowth", ivyRunReallocGrowthBenchmark, 0},
+    {"multiThreadedChurn", ivyRunMultiThreadedChurnBenchmark,
+        IVY_BENCHMARK_THREAD_SAFE}};
+
+IVY_INTERNAL int ivyRunBenchmark(
+    IvyBenchmarkMemoryAllocator const *benchmarkAllocator,
+    IvyBenchmarkWorkload const *workload) {
+  IvyBool succeeded;
+  uint64_t beginTime;
+  uint64_t endTime;
+  uint64_t residentSize;
+  double fragmentation = 0.0;
+  IvyBenchmarkResult result;
+  IvyBenchmarkMemoryAllocatorStorage allocator;
+  uint64_t const baseResidentSize = ivyGetBenchmarkPeakResidentSize();
+
+  if (benchmarkAllocator->create(&allocator)) {
+    fprintf(stderr, "%s: failed to create the allocator\n",
+        benchmarkAllocator->name);
+    return 1;
+  }
+
+  result.operationCount = 0;
+  result.peakLiveSize = 0;
+
+  beginTime = ivyGetBenchmarkTime();
+  succeeded =
+      workload->run(&allocator, benchmarkAllocator->flags, &result);
+  endTime = ivyGetBenchmarkTime();
+
+  residentSize = ivyGetBenchmarkPeakResidentSize() - baseResidentSize;
+
+  if (!succeeded) {
+    fprintf(stderr, "%s,%s: ran out of memory\n", benchmarkAllocator->name,
+        workload->name);
+    return 1;
+  }
+
+  if (residentSize > result.peakLiveSize) {
+    fragmentation = 1.0 - (double)result.peakLiveSize / (double)residentSize;
+  }
+
+  printf("%s,%s,%lu,%.2f,%lu,%.3f\n", benchmarkAllocator->name,
+      workload->name, (unsigned long)result.operationCount,
+      (double)(endTime - beginTime) / (double)result.operationCount,
+      (unsigned long)(residentSize / 1024), fragmentation);
+  fflush(stdout);
+
+  ivyDestroyMemoryAllocator(&allocator);
+  if (ivyCreateBenchmarkThreadSafeMemoryAllocator ==
+      benchmarkAllocator->create) {
+    ivyDestroyMemoryAllocator(&benchmarkBackendMemoryAllocator);
+  }
+
+  return 0;
+}
+
+int main(void) {
+  long allocatorIndex;
+  long workloadIndex;
+  int failureCount = 0;
+
+  printf("allocator,workload,operations,nsPerOperation,peakResidentKiB,"
+         "fragmentation\n");
+  fflush(stdout);
+
+  for (allocatorIndex = 0;
+       allocatorIndex < IVY_ARRAY_LENGTH(benchmarkMemoryAllocators);
+       ++allocatorIndex) {
+    IvyBenchmarkMemoryAllocator const *benchmarkAllocator =
+        &benchmarkMemoryAllocators[allocatorIndex];
+
+    for (workloadIndex = 0;
+         workloadIndex < IVY_ARRAY_LENGTH(benchmarkWorkloads);
+         ++workloadIndex) {
+      pid_t child;
+      int status;
+      IvyBenchmarkWorkload const *workload =
+          &benchmarkWorkloads[workloadIndex];
+
+      if ((benchmarkAllocator->flags & workload->requiredFlags) !=
+          workload->requiredFlags) {
+        continue;
+      }
+
+      child = fork();
+      if (child < 0) {
+        ++failureCount;
+        continue;
+      }
+
+      if (!child) {
+        _exit(ivyRunBenchmark(benchmarkAllocator, workload));
+      }
+
+      if (waitpid(child, &status, 0) < 0 || !WIFEXITED(status) ||
+          WEXITSTATUS(status)) {
+        fprintf(stderr, "%s,%s: failed\n", benchmarkAllocator->name,
+            workload->name);
+        ++failureCount;
+      }
+    }
+  }
+
+  return failureCount ? 1 : 0;
+}
@@ -79,6 +79,214 @@ void testMultipleFrees(void) {
   ivyDestroyMemoryAllocator(&allocator);
 }
 
+void testGrowableArenaChainsBlocks(void) {
+  void *data1;
+  void *data2;
+  void *data3;
+  IvyCode ivyCode;
+  IvyArenaMemoryAllocator allocator;
+
+  ivyCode = ivyCreateGrowableArenaMemoryAllocator(1024, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data1 = ivyAllocateMemory(&allocator, 1024);
+  TEST_ASSERT_NOT_NULL(data1);
+
+  data2 = ivyAllocateMemory(&allocator, 1024);
+  TEST_ASSERT_NOT_NULL(data2);
+
+  // NOTE: bigger than a block, gets a block of its own
+  data3 = ivyAllocateMemory(&allocator, 4096);
+  TEST_ASSERT_NOT_NULL(data3);
+
+  IVY_MEMSET(data1, 1, 1024);
+  IVY_MEMSET(data2, 2, 1024);
+  IVY_MEMSET(data3, 3, 4096);
+
+  TEST_ASSERT_EQUAL_INT(1, ((uint8_t *)data1)[1023]);
+  TEST_ASSERT_EQUAL_INT(2, ((uint8_t *)data2)[1023]);
+
+  ivyClearMemoryAllocator(&allocator);
+
+  // NOTE: only the largest block is kept
+  TEST_ASSERT_EQUAL_INT(4096, allocator.capacity);
+  TEST_ASSERT_NULL(allocator.currentBlock->previous);
+
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testReallocateGrowsTopAllocationInPlace(void) {
+  uint8_t *data1;
+  uint8_t *data2;
+  IvyCode ivyCode;
+  IvyArenaMemoryAllocator allocator;
+
+  ivyCode = ivyCreateArenaMemoryAllocator(1024, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data1 = ivyAllocateMemory(&allocator, 16);
+  TEST_ASSERT_NOT_NULL(data1);
+  IVY_MEMSET(data1, 7, 16);
+
+  data2 = ivyReallocateMemory(&allocator, data1, 512);
+  TEST_ASSERT_EQUAL_PTR(data1, data2);
+  TEST_ASSERT_EQUAL_INT(512, allocator.position);
+
+  data2 = ivyReallocateMemory(&allocator, data1, 2048);
+  TEST_ASSERT_NULL(data2);
+
+  ivyFreeMemory(&allocator, data1);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testReallocateMovesAllocationBelowTop(void) {
+  uint8_t *data1;
+  uint8_t *data2;
+  uint8_t *data3;
+  IvyCode ivyCode;
+  IvyArenaMemoryAllocator allocator;
+
+  ivyCode = ivyCreateGrowableArenaMemoryAllocator(256, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data1 = ivyAllocateMemory(&allocator, 64);
+  TEST_ASSERT_NOT_NULL(data1);
+  IVY_MEMSET(data1, 9, 64);
+
+  data2 = ivyAllocateMemory(&allocator, 64);
+  TEST_ASSERT_NOT_NULL(data2);
+
+  data3 = ivyReallocateMemory(&allocator, data1, 512);
+  TEST_ASSERT_NOT_NULL(data3);
+  TEST_ASSERT_TRUE(data1 != data3);
+  TEST_ASSERT_EQUAL_INT(9, data3[0]);
+  TEST_ASSERT_EQUAL_INT(9, data3[63]);
+  TEST_ASSERT_EQUAL_INT(2, allocator.aliveAllocationCount);
+
+  ivyFreeMemory(&allocator, data3);
+  ivyFreeMemory(&allocator, data2);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testFreeToMarker(void) {
+  void *data;
+  IvyCode ivyCode;
+  IvyArenaMemoryMarker marker;
+  IvyArenaMemoryAllocator allocator;
+
+  ivyCode = ivyCreateGrowableArenaMemoryAllocator(1024, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data = ivyAllocateMemory(&allocator, 128);
+  TEST_ASSERT_NOT_NULL(data);
+
+  ivyGetArenaMemoryMarker(&allocator, &marker);
+
+  TEST_ASSERT_NOT_NULL(ivyAllocateMemory(&allocator, 768));
+  TEST_ASSERT_NOT_NULL(ivyAllocateMemory(&allocator, 768));
+  TEST_ASSERT_NOT_NULL(ivyAllocateMemory(&allocator, 2048));
+
+  ivyFreeArenaMemoryToMarker(&allocator, &marker);
+
+  TEST_ASSERT_EQUAL_PTR(marker.block, allocator.currentBlock);
+  TEST_ASSERT_EQUAL_INT(128, allocator.position);
+  TEST_ASSERT_EQUAL_INT(1, allocator.aliveAllocationCount);
+
+  ivyFreeMemory(&allocator, data);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testFreeToMarkerAfterLastFree(void) {
+  void *data;
+  IvyCode ivyCode;
+  IvyArenaMemoryMarker marker;
+  IvyArenaMemoryAllocator allocator;
+
+  ivyCode = ivyCreateGrowableArenaMemoryAllocator(256, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyGetArenaMemoryMarker(&allocator, &marker);
+
+  data = ivyAllocateMemory(&allocator, 2048);
+  TEST_ASSERT_NOT_NULL(data);
+  TEST_ASSERT_TRUE(marker.block != allocator.currentBlock);
+
+  ivyFreeMemory(&allocator, data);
+  TEST_ASSERT_EQUAL_INT(0, allocator.aliveAllocationCount);
+
+  ivyFreeArenaMemoryToMarker(&allocator, &marker);
+
+  TEST_ASSERT_EQUAL_PTR(marker.block, allocator.currentBlock);
+  TEST_ASSERT_EQUAL_INT(0, allocator.position);
+
+  data = ivyAllocateMemory(&allocator, 128);
+  TEST_ASSERT_NOT_NULL(data);
+
+  ivyFreeMemory(&allocator, data);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testVirtualArenaCommitsLazily(void) {
+  uint8_t *data1;
+  uint8_t *data2;
+  IvyCode ivyCode;
+  IvyArenaMemoryAllocator allocator;
+  uint64_t const reserveSize = (uint64_t)1 << 32;
+
+  ivyCode = ivyCreateVirtualArenaMemoryAllocator(reserveSize,
+      IVY_ARENA_COMMIT_GRANULARITY, 0, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+  TEST_ASSERT_TRUE(allocator.capacity >= reserveSize);
+  TEST_ASSERT_TRUE(allocator.committedSize < 1024 * 1024);
+
+  data1 = ivyAllocateMemory(&allocator, 16);
+  TEST_ASSERT_NOT_NULL(data1);
+
+  data2 = ivyAllocateMemory(&allocator, 8 * 1024 * 1024);
+  TEST_ASSERT_NOT_NULL(data2);
+  TEST_ASSERT_TRUE(allocator.committedSize >= 8 * 1024 * 1024);
+  TEST_ASSERT_TRUE(allocator.committedSize < 9 * 1024 * 1024);
+
+  IVY_MEMSET(data2, 7, 8 * 1024 * 1024);
+  TEST_ASSERT_EQUAL_INT(7, data2[8 * 1024 * 1024 - 1]);
+
+  ivyClearMemoryAllocator(&allocator);
+
+  // NOTE: everything past the retained size is decommitted
+  TEST_ASSERT_TRUE(allocator.committedSize <=
+                   2 * allocator.commitGranularity);
+
+  data1 = ivyAllocateMemory(&allocator, 4 * 1024 * 1024);
+  TEST_ASSERT_NOT_NULL(data1);
+  TEST_ASSERT_EQUAL_INT(0, data1[4 * 1024 * 1024 - 1]);
+
+  ivyFreeMemory(&allocator, data1);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testVirtualArenaWithHugePages(void) {
+  uint8_t *data;
+  IvyCode ivyCode;
+  IvyArenaMemoryAllocator allocator;
+
+  // NOTE: falls back to regular pages when the system has no huge pages
+  ivyCode = ivyCreateVirtualArenaMemoryAllocator(64 * 1024 * 1024, 0, 1,
+      &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+  TEST_ASSERT_EQUAL_INT(IVY_ARENA_HUGE_PAGE_SIZE,
+      allocator.commitGranularity);
+
+  data = ivyAllocateMemory(&allocator, 3 * 1024 * 1024);
+  TEST_ASSERT_NOT_NULL(data);
+  TEST_ASSERT_EQUAL_INT(0, allocator.committedSize % IVY_ARENA_HUGE_PAGE_SIZE);
+
+  IVY_MEMSET(data, 1, 3 * 1024 * 1024);
+
+  ivyFreeMemory(&allocator, data);
+  TEST_ASSERT_EQUAL_INT(IVY_ARENA_HUGE_PAGE_SIZE, allocator.committedSize);
+
+  ivyDestroyMemoryAllocator(&allocator);
+}
 
 int main(void) {
   UNITY_BEGIN();
@@ -87,6 +295,13 @@ int main(void) {
   RUN_TEST(testRequestSingleAllocation);
   RUN_TEST(testRequestTooMuchMemoryDoubleAllocation);
   RUN_TEST(testMultipleFrees);
+  RUN_TEST(testGrowableArenaChainsBlocks);
+  RUN_TEST(testReallocateGrowsTopAllocationInPlace);
+  RUN_TEST(testReallocateMovesAllocationBelowTop);
+  RUN_TEST(testFreeToMarker);
+  RUN_TEST(testFreeToMarkerAfterLastFree);
+  RUN_TEST(testVirtualArenaCommitsLazily);
+  RUN_TEST(testVirtualArenaWithHugePages);
  
   return UNITY_END();
 }
@@ -0,0 +1,170 @@
+#include <IvyDrawList.h>
+#include <IvyDummyMemoryAllocator.h>
+#include <unity.h>
+
+void setUp(void) {
+    // set stuff up here
+}
+
+void tearDown(void) {
+    // clean stuff up here
+}
+
+IVY_INTERNAL void ivySetupTestDrawCommand(IvyGraphicsProgram *program,
+    IvyGraphicsTexture *texture, uint32_t firstIndex, uint32_t indexCount,
+    IvyDrawCommand *command) {
+  IVY_MEMSET(command, 0, sizeof(*command));
+  command->program = program;
+  command->texture = texture;
+  command->vertexBuffer = VK_NULL_HANDLE;
+  command->indexBuffer = VK_NULL_HANDLE;
+  command->firstIndex = firstIndex;
+  command->indexCount = indexCount;
+  ivyIdentityM4(&command->model);
+}
+
+void testSortKeyPacking(void) {
+  IvyCode ivyCode;
+  IvyDrawList drawList;
+  IvyDrawCommand command;
+  IvyGraphicsProgram programs[2];
+  IvyGraphicsTexture textures[2];
+  IvyDummyMemoryAllocator allocator;
+
+  ivyCode = ivyCreateDummyMemoryAllocator(&allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateDrawList(&allocator, &drawList);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivySetupTestDrawCommand(&programs[0], &textures[0], 0, 6, &command);
+  ivyCode = ivyAddDrawListCommand(&drawList, &command, 0.5F, 7);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivySetupTestDrawCommand(&programs[1], &textures[1], 0, 6, &command);
+  ivyCode = ivyAddDrawListCommand(&drawList, &command, 2.0F, 0xFFFF);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  // NOTE: keys come from the order programs and textures are first seen
+  ivySetupTestDrawCommand(&programs[1], &textures[0], 0, 6, &command);
+  ivyCode = ivyAddDrawListCommand(&drawList, &command, -1.0F, 0);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  TEST_ASSERT_EQUAL_INT(3, drawList.commandCount);
+  TEST_ASSERT_EQUAL_INT(2, drawList.programCount);
+  TEST_ASSERT_EQUAL_INT(2, drawList.textureCount);
+
+  TEST_ASSERT_TRUE(((uint64_t)0x7FFFFF << 16 | 7) == drawList.sortKeys[0]);
+  TEST_ASSERT_TRUE(((uint64_t)1 << 56 | (uint64_t)1 << 40 |
+                       IVY_DRAW_LIST_DEPTH_MASK << 16 | 0xFFFF) ==
+                   drawList.sortKeys[1]);
+  TEST_ASSERT_TRUE((uint64_t)1 << 56 == drawList.sortKeys[2]);
+
+  ivyDestroyDrawList(&drawList);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testSortIsStable(void) {
+  uint32_t index;
+  IvyCode ivyCode;
+  IvyDrawList drawList;
+  IvyDrawCommand command;
+  IvyGraphicsProgram programs[2];
+  IvyGraphicsTexture textures[2];
+  IvyDummyMemoryAllocator allocator;
+  uint32_t const expectedOrder[] = {4, 0, 2, 5, 3, 1};
+
+  ivyCode = ivyCreateDummyMemoryAllocator(&allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateDrawList(&allocator, &drawList);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivySetupTestDrawCommand(&programs[0], &textures[0], 0, 6, &command);
+  ivyAddDrawListCommand(&drawList, &command, 0.5F, 0);
+  ivySetupTestDrawCommand(&programs[1], &textures[1], 0, 6, &command);
+  ivyAddDrawListCommand(&drawList, &command, 0.1F, 0);
+  ivySetupTestDrawCommand(&programs[0], &textures[0], 6, 6, &command);
+  ivyAddDrawListCommand(&drawList, &command, 0.5F, 0);
+  ivySetupTestDrawCommand(&programs[0], &textures[1], 0, 6, &command);
+  ivyAddDrawListCommand(&drawList, &command, 0.1F, 0);
+  ivySetupTestDrawCommand(&programs[0], &textures[0], 12, 6, &command);
+  ivyAddDrawListCommand(&drawList, &command, 0.2F, 0);
+  ivySetupTestDrawCommand(&programs[0], &textures[0], 18, 6, &command);
+  ivyAddDrawListCommand(&drawList, &command, 0.5F, 0);
+
+  ivySortDrawList(&drawList);
+
+  for (index = 0; index < IVY_ARRAY_LENGTH(expectedOrder); ++index) {
+    TEST_ASSERT_EQUAL_INT(expectedOrder[index],
+        drawList.sortedIndices[index]);
+  }
+
+  for (index = 1; index < drawList.commandCount; ++index) {
+    TEST_ASSERT_TRUE(drawList.sortKeys[index - 1] <=
+                     drawList.sortKeys[index]);
+  }
+
+  ivyDestroyDrawList(&drawList);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testContiguousDrawsAreMerged(void) {
+  uint32_t index;
+  uint32_t indexCount;
+  IvyCode ivyCode;
+  IvyDrawList drawList;
+  IvyDrawCommand command;
+  IvyGraphicsProgram program;
+  IvyGraphicsTexture texture;
+  IvyDummyMemoryAllocator allocator;
+
+  ivyCode = ivyCreateDummyMemoryAllocator(&allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateDrawList(&allocator, &drawList);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivySetupTestDrawCommand(&program, &texture, 0, 6, &command);
+  ivyAddDrawListCommand(&drawList, &command, 0.5F, 0);
+  ivySetupTestDrawCommand(&program, &texture, 6, 6, &command);
+  ivyAddDrawListCommand(&drawList, &command, 0.5F, 0);
+  ivySetupTestDrawCommand(&program, &texture, 12, 3, &command);
+  ivyAddDrawListCommand(&drawList, &command, 0.5F, 0);
+
+  // NOTE: leaves a gap in the index range
+  ivySetupTestDrawCommand(&program, &texture, 30, 6, &command);
+  ivyAddDrawListCommand(&drawList, &command, 0.5F, 0);
+
+  // NOTE: contiguous, but with a different model matrix
+  ivySetupTestDrawCommand(&program, &texture, 36, 6, &command);
+  command.model.a[3][0] = 1.0F;
+  ivyAddDrawListCommand(&drawList, &command, 0.5F, 0);
+
+  ivySortDrawList(&drawList);
+
+  index = ivyMergeDrawListCommands(&drawList, 0, &indexCount);
+  TEST_ASSERT_EQUAL_INT(3, index);
+  TEST_ASSERT_EQUAL_INT(15, indexCount);
+
+  index = ivyMergeDrawListCommands(&drawList, index, &indexCount);
+  TEST_ASSERT_EQUAL_INT(4, index);
+  TEST_ASSERT_EQUAL_INT(6, indexCount);
+
+  index = ivyMergeDrawListCommands(&drawList, index, &indexCount);
+  TEST_ASSERT_EQUAL_INT(5, index);
+  TEST_ASSERT_EQUAL_INT(6, indexCount);
+
+  ivyDestroyDrawList(&drawList);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testSortKeyPacking);
+  RUN_TEST(testSortIsStable);
+  RUN_TEST(testContiguousDrawsAreMerged);
+
+  return UNITY_END();
+}
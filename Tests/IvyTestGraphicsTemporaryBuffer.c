@@ -0,0 +1,97 @@
+#include <IvyRenderer.h>
+#include <unity.h>
+
+#define IVY_TEST_ALIGNMENT 256
+
+void setUp(void) {
+    // set stuff up here
+}
+
+void tearDown(void) {
+    // clean stuff up here
+}
+
+// NOTE: mimics a use of the frame, the pool is sized after the previous
+//       ones and then used for usedSize bytes
+IVY_INTERNAL uint64_t ivyUseTestTemporaryBufferPool(
+    IvyGraphicsTemporaryBufferStatistics *statistics, uint64_t *chunkSize,
+    uint64_t usedSize) {
+  uint64_t newSize;
+  IvyBool const isOutgrown = *chunkSize < statistics->usedSize;
+
+  newSize = ivyComputeGraphicsTemporaryBufferConsolidationSize(statistics,
+      *chunkSize, isOutgrown, IVY_TEST_ALIGNMENT);
+  if (newSize) {
+    *chunkSize = newSize;
+  }
+
+  statistics->usedSize = usedSize;
+  statistics->peakUsedSize = IVY_MAX(statistics->peakUsedSize, usedSize);
+
+  return newSize;
+}
+
+void testOutgrownPoolIsConsolidated(void) {
+  uint64_t chunkSize = 1024;
+  IvyGraphicsTemporaryBufferStatistics statistics;
+
+  IVY_MEMSET(&statistics, 0, sizeof(statistics));
+
+  ivyUseTestTemporaryBufferPool(&statistics, &chunkSize, 4000);
+  TEST_ASSERT_EQUAL_INT(5120,
+      ivyUseTestTemporaryBufferPool(&statistics, &chunkSize, 4000));
+  TEST_ASSERT_EQUAL_INT(5120, chunkSize);
+  TEST_ASSERT_EQUAL_INT(0, statistics.windowUseCount);
+}
+
+void testPoolShrinksAfterSpike(void) {
+  int index;
+  uint64_t chunkSize = 8192;
+  IvyGraphicsTemporaryBufferStatistics statistics;
+
+  IVY_MEMSET(&statistics, 0, sizeof(statistics));
+
+  ivyUseTestTemporaryBufferPool(&statistics, &chunkSize, 1000000);
+  ivyUseTestTemporaryBufferPool(&statistics, &chunkSize, 4000);
+  TEST_ASSERT_EQUAL_INT(1250048, chunkSize);
+
+  // NOTE: the spike was consolidated, so the peak starts over
+  TEST_ASSERT_EQUAL_INT(4000, statistics.peakUsedSize);
+
+  for (index = 1; index < IVY_TEMPORARY_BUFFER_PEAK_WINDOW; ++index) {
+    TEST_ASSERT_EQUAL_INT(0,
+        ivyUseTestTemporaryBufferPool(&statistics, &chunkSize, 4000));
+  }
+
+  TEST_ASSERT_EQUAL_INT(1250048, chunkSize);
+
+  TEST_ASSERT_EQUAL_INT(5120,
+      ivyUseTestTemporaryBufferPool(&statistics, &chunkSize, 4000));
+  TEST_ASSERT_EQUAL_INT(5120, chunkSize);
+}
+
+void testSettledPoolKeepsItsChunk(void) {
+  int index;
+  uint64_t chunkSize = 8192;
+  IvyGraphicsTemporaryBufferStatistics statistics;
+
+  IVY_MEMSET(&statistics, 0, sizeof(statistics));
+
+  for (index = 0; index < 4 * IVY_TEMPORARY_BUFFER_PEAK_WINDOW; ++index) {
+    TEST_ASSERT_EQUAL_INT(0,
+        ivyUseTestTemporaryBufferPool(&statistics, &chunkSize, 6000));
+  }
+
+  TEST_ASSERT_EQUAL_INT(8192, chunkSize);
+  TEST_ASSERT_EQUAL_INT(6000, statistics.peakUsedSize);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testOutgrownPoolIsConsolidated);
+  RUN_TEST(testPoolShrinksAfterSpike);
+  RUN_TEST(testSettledPoolKeepsItsChunk);
+
+  return UNITY_END();
+}
@@ -0,0 +1,185 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <IvyAtomic.h>
+#include <IvyDummyMemoryAllocator.h>
+#include <IvyJobSystem.h>
+#include <unity.h>
+
+#include <stdio.h>
+#include <time.h>
+
+#define IVY_TEST_JOB_COUNT 1000
+#define IVY_TEST_BENCHMARK_JOB_COUNT 4000
+#define IVY_TEST_BENCHMARK_ITERATIONS 20000
+
+IvyJobSystem jobSystem;
+IvyDummyMemoryAllocator allocator;
+
+void setUp(void) {
+  IvyCode ivyCode;
+
+  ivyCode = ivyCreateDummyMemoryAllocator(&allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateJobSystem(&allocator, 4, &jobSystem);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+}
+
+void tearDown(void) {
+  ivyDestroyJobSystem(&jobSystem);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void ivyTestIncrement(void *data) {
+  IVY_ATOMIC_ADD((int32_t *)data, 1);
+}
+
+typedef struct IvyTestParentJobData {
+  int32_t *total;
+} IvyTestParentJobData;
+
+// NOTE: fans out children and waits on them from inside the job
+void ivyTestParentJob(void *data) {
+  int index;
+  IvyJob jobs[8];
+  IvyJobCounter counter = {0};
+  IvyTestParentJobData *parentData = data;
+
+  for (index = 0; index < IVY_ARRAY_LENGTH(jobs); ++index) {
+    jobs[index].callback = ivyTestIncrement;
+    jobs[index].data = parentData->total;
+  }
+
+  ivyRunJobs(&jobSystem, IVY_ARRAY_LENGTH(jobs), jobs, &counter);
+  ivyWaitForJobCounter(&jobSystem, &counter);
+}
+
+void ivyTestBusyJob(void *data) {
+  int index;
+  uint32_t value = 0;
+
+  for (index = 0; index < IVY_TEST_BENCHMARK_ITERATIONS; ++index) {
+    value = value * 1664525U + 1013904223U;
+  }
+
+  IVY_ATOMIC_ADD((uint32_t *)data, value & 1);
+}
+
+void testRunsEveryJob(void) {
+  int index;
+  int32_t total = 0;
+  IvyJob jobs[IVY_TEST_JOB_COUNT];
+  IvyJobCounter counter = {0};
+
+  for (index = 0; index < IVY_TEST_JOB_COUNT; ++index) {
+    jobs[index].callback = ivyTestIncrement;
+    jobs[index].data = &total;
+  }
+
+  ivyRunJobs(&jobSystem, IVY_TEST_JOB_COUNT, jobs, &counter);
+  ivyWaitForJobCounter(&jobSystem, &counter);
+
+  TEST_ASSERT_TRUE(ivyIsJobCounterDone(&counter));
+  TEST_ASSERT_EQUAL_INT(IVY_TEST_JOB_COUNT, total);
+}
+
+void testRunsMoreJobsThanQueueCapacity(void) {
+  int index;
+  int32_t total = 0;
+  IvyJob job;
+  IvyJobCounter counter = {0};
+
+  job.callback = ivyTestIncrement;
+  job.data = &total;
+
+  for (index = 0; index < IVY_DEFAULT_JOB_QUEUE_CAPACITY * 2; ++index) {
+    ivyRunJobs(&jobSystem, 1, &job, &counter);
+  }
+
+  ivyWaitForJobCounter(&jobSystem, &counter);
+
+  TEST_ASSERT_EQUAL_INT(IVY_DEFAULT_JOB_QUEUE_CAPACITY * 2, total);
+}
+
+void testWaitsOnNestedJobs(void) {
+  int index;
+  int32_t total = 0;
+  IvyJob jobs[32];
+  IvyTestParentJobData parentData;
+  IvyJobCounter counter = {0};
+
+  parentData.total = &total;
+
+  for (index = 0; index < IVY_ARRAY_LENGTH(jobs); ++index) {
+    jobs[index].callback = ivyTestParentJob;
+    jobs[index].data = &parentData;
+  }
+
+  ivyRunJobs(&jobSystem, IVY_ARRAY_LENGTH(jobs), jobs, &counter);
+  ivyWaitForJobCounter(&jobSystem, &counter);
+
+  TEST_ASSERT_EQUAL_INT(IVY_ARRAY_LENGTH(jobs) * 8, total);
+}
+
+void testWithSingleWorker(void) {
+  IvyCode ivyCode;
+  int32_t total = 0;
+  IvyJob job;
+  IvyJobSystem singleWorkerJobSystem;
+  IvyJobCounter counter = {0};
+
+  ivyCode = ivyCreateJobSystem(&allocator, 1, &singleWorkerJobSystem);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  job.callback = ivyTestIncrement;
+  job.data = &total;
+
+  ivyRunJobs(&singleWorkerJobSystem, 1, &job, &counter);
+  ivyWaitForJobCounter(&singleWorkerJobSystem, &counter);
+
+  TEST_ASSERT_EQUAL_INT(1, total);
+
+  ivyDestroyJobSystem(&singleWorkerJobSystem);
+}
+
+IVY_INTERNAL double ivyTestGetSeconds(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (double)time.tv_sec + (double)time.tv_nsec / 1000000000.0;
+}
+
+void testBenchmarkBusyJobs(void) {
+  int index;
+  double start;
+  uint32_t total = 0;
+  IvyJobCounter counter = {0};
+  IvyJob jobs[IVY_TEST_BENCHMARK_JOB_COUNT];
+
+  for (index = 0; index < IVY_TEST_BENCHMARK_JOB_COUNT; ++index) {
+    jobs[index].callback = ivyTestBusyJob;
+    jobs[index].data = &total;
+  }
+
+  start = ivyTestGetSeconds();
+
+  ivyRunJobs(&jobSystem, IVY_TEST_BENCHMARK_JOB_COUNT, jobs, &counter);
+  ivyWaitForJobCounter(&jobSystem, &counter);
+
+  printf("%i busy jobs on %u workers: %.3f seconds\n",
+      IVY_TEST_BENCHMARK_JOB_COUNT, jobSystem.workerCount,
+      ivyTestGetSeconds() - start);
+
+  TEST_ASSERT_TRUE(ivyIsJobCounterDone(&counter));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testRunsEveryJob);
+  RUN_TEST(testRunsMoreJobsThanQueueCapacity);
+  RUN_TEST(testWaitsOnNestedJobs);
+  RUN_TEST(testWithSingleWorker);
+  RUN_TEST(testBenchmarkBusyJobs);
+
+  return UNITY_END();
+}
@@ -0,0 +1,89 @@
+#include <IvyDummyMemoryAllocator.h>
+#include <IvyModel.h>
+#include <IvyTrackingMemoryAllocator.h>
+#include <unity.h>
+
+#include <stdio.h>
+
+#define IVY_TEST_MODEL_PATH "IvyTestModel.gltf"
+
+void setUp(void) {
+    // set stuff up here
+}
+
+void tearDown(void) {
+    // clean stuff up here
+}
+
+// NOTE: no images, so neither the renderer nor the decode allocators are
+//       touched. The buffer is a data URI, which cgltf decodes with the
+//       memory callbacks as well
+IVY_INTERNAL void ivyWriteTestModel(void) {
+  FILE *file = fopen(IVY_TEST_MODEL_PATH, "w");
+  TEST_ASSERT_NOT_NULL(file);
+
+  fputs("{\"asset\":{\"version\":\"2.0\"},"
+        "\"buffers\":[{\"byteLength\":4,"
+        "\"uri\":\"data:application/octet-stream;base64,AAAAAA==\"}],"
+        "\"materials\":[{\"doubleSided\":true,\"alphaCutoff\":0.25}]}",
+      file);
+
+  fclose(file);
+}
+
+void testGLTFAllocationsGoThroughAllocator(void) {
+  IvyCode ivyCode;
+  IvyModel model;
+  IvyMemoryAllocatorStats sharedStats;
+  IvyMemoryAllocatorStats stats;
+  IvyDummyMemoryAllocator backendAllocator;
+  IvyTrackingMemoryAllocator allocator;
+
+  ivyWriteTestModel();
+
+  IVY_MEMSET(&sharedStats, 0, sizeof(sharedStats));
+
+  ivyCode = ivyCreateDummyMemoryAllocator(&backendAllocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateTrackingMemoryAllocator(&backendAllocator,
+      IVY_MEMORY_TAG_MODEL, &sharedStats, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateModel(&allocator, NULL, NULL, NULL, IVY_TEST_MODEL_PATH,
+      &model);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+  TEST_ASSERT_EQUAL_STRING(".", model.directory);
+  TEST_ASSERT_EQUAL_INT(0, model.imageCount);
+  TEST_ASSERT_EQUAL_INT(0, model.textureCount);
+  TEST_ASSERT_EQUAL_INT(1, model.materialCount);
+  TEST_ASSERT_EQUAL_INT(1, model.materials[0].isDoubleSided);
+  TEST_ASSERT_EQUAL_FLOAT(0.25F, model.materials[0].alphaCutoff);
+
+  // NOTE: only the materials outlive the parse, everything cgltf allocated
+  //       went through the tracking allocator and is already back
+  ivyGetMemoryAllocatorStats(&allocator, &stats);
+  TEST_ASSERT_GREATER_THAN_INT(1, stats.total.allocationCount);
+  TEST_ASSERT_EQUAL_INT(1, stats.total.aliveAllocationCount);
+  TEST_ASSERT_GREATER_THAN_INT(stats.total.aliveSize,
+      stats.total.peakAliveSize);
+
+  ivyDestroyModel(NULL, &model);
+
+  ivyGetMemoryAllocatorStats(&allocator, &stats);
+  TEST_ASSERT_EQUAL_INT(0, stats.total.aliveAllocationCount);
+  TEST_ASSERT_EQUAL_INT(0, stats.total.aliveSize);
+
+  ivyDestroyMemoryAllocator(&allocator);
+  ivyDestroyMemoryAllocator(&backendAllocator);
+
+  remove(IVY_TEST_MODEL_PATH);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testGLTFAllocationsGoThroughAllocator);
+
+  return UNITY_END();
+}
@@ -0,0 +1,166 @@
+#include <IvyPoolMemoryAllocator.h>
+#include <unity.h>
+
+void setUp(void) {
+    // set stuff up here
+}
+
+void tearDown(void) {
+    // clean stuff up here
+}
+
+void testSlotsAreCacheLineAligned(void) {
+  void *data1;
+  void *data2;
+  IvyCode ivyCode;
+  IvyPoolMemoryAllocator allocator;
+
+  ivyCode = ivyCreatePoolMemoryAllocator(&allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data1 = ivyAllocateMemory(&allocator, 24);
+  TEST_ASSERT_NOT_NULL(data1);
+  TEST_ASSERT_EQUAL_INT(0, (uintptr_t)data1 % IVY_POOL_CACHE_LINE_SIZE);
+
+  data2 = ivyAllocateMemory(&allocator, 200);
+  TEST_ASSERT_NOT_NULL(data2);
+  TEST_ASSERT_EQUAL_INT(0, (uintptr_t)data2 % IVY_POOL_CACHE_LINE_SIZE);
+
+  ivyFreeMemory(&allocator, data2);
+  ivyFreeMemory(&allocator, data1);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testFreedSlotIsReused(void) {
+  void *data1;
+  void *data2;
+  IvyCode ivyCode;
+  IvyPoolMemoryAllocator allocator;
+
+  ivyCode = ivyCreatePoolMemoryAllocator(&allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data1 = ivyAllocateMemory(&allocator, 100);
+  TEST_ASSERT_NOT_NULL(data1);
+
+  ivyFreeMemory(&allocator, data1);
+
+  data2 = ivyAllocateMemory(&allocator, 128);
+  TEST_ASSERT_EQUAL_PTR(data1, data2);
+
+  ivyFreeMemory(&allocator, data2);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testManyAllocations(void) {
+  int index;
+  IvyCode ivyCode;
+  void *allocations[2048];
+  IvyPoolMemoryAllocator allocator;
+
+  ivyCode = ivyCreatePoolMemoryAllocator(&allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  for (index = 0; index < IVY_ARRAY_LENGTH(allocations); ++index) {
+    allocations[index] = ivyAllocateMemory(&allocator, 1 + index % 512);
+    TEST_ASSERT_NOT_NULL(allocations[index]);
+    IVY_MEMSET(allocations[index], index & 0xFF, 1 + index % 512);
+  }
+
+  for (index = 0; index < IVY_ARRAY_LENGTH(allocations); ++index) {
+    TEST_ASSERT_EQUAL_INT(index & 0xFF,
+        ((uint8_t *)allocations[index])[index % 512]);
+  }
+
+  for (index = 0; index < IVY_ARRAY_LENGTH(allocations); ++index) {
+    ivyFreeMemory(&allocator, allocations[index]);
+  }
+
+  TEST_ASSERT_EQUAL_INT(0, allocator.aliveAllocationCount);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testLargeAllocationAndReallocate(void) {
+  uint8_t *data1;
+  uint8_t *data2;
+  IvyCode ivyCode;
+  IvyPoolMemoryAllocator allocator;
+
+  ivyCode = ivyCreatePoolMemoryAllocator(&allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data1 = ivyAllocateMemory(&allocator, 48);
+  TEST_ASSERT_NOT_NULL(data1);
+  IVY_MEMSET(data1, 5, 48);
+
+  // NOTE: still fits in the slot
+  data2 = ivyReallocateMemory(&allocator, data1, 64);
+  TEST_ASSERT_EQUAL_PTR(data1, data2);
+
+  data2 = ivyReallocateMemory(&allocator, data1, 100000);
+  TEST_ASSERT_NOT_NULL(data2);
+  TEST_ASSERT_EQUAL_INT(5, data2[47]);
+  TEST_ASSERT_EQUAL_INT(1, allocator.aliveAllocationCount);
+
+  IVY_MEMSET(data2, 6, 100000);
+
+  ivyFreeMemory(&allocator, data2);
+  TEST_ASSERT_NULL(allocator.slabs->next);
+  TEST_ASSERT_NULL(allocator.largeBlocks);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testLargeAllocationsSkipSlabs(void) {
+  int index;
+  uint8_t *data;
+  IvyCode ivyCode;
+  void *allocations[8];
+  IvyPoolMemoryAllocator allocator;
+
+  ivyCode = ivyCreatePoolMemoryAllocator(&allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  for (index = 0; index < IVY_ARRAY_LENGTH(allocations); ++index) {
+    allocations[index] =
+        ivyAllocateMemory(&allocator, IVY_POOL_MAX_SLOT_SIZE + 1 + index);
+    TEST_ASSERT_NOT_NULL(allocations[index]);
+    TEST_ASSERT_EQUAL_INT(0, (uintptr_t)allocations[index] % 16);
+    IVY_MEMSET(allocations[index], index, IVY_POOL_MAX_SLOT_SIZE + 1);
+  }
+
+  TEST_ASSERT_NULL(allocator.slabs);
+  TEST_ASSERT_NOT_NULL(allocator.largeBlocks);
+
+  // NOTE: shrinking a large allocation below the slot size moves it to a slot
+  data = ivyReallocateMemory(&allocator, allocations[3], 32);
+  TEST_ASSERT_NOT_NULL(data);
+  TEST_ASSERT_EQUAL_INT(0, (uintptr_t)data % IVY_POOL_CACHE_LINE_SIZE);
+  TEST_ASSERT_EQUAL_INT(3, data[31]);
+  allocations[3] = data;
+
+  for (index = 0; index < IVY_ARRAY_LENGTH(allocations); ++index) {
+    ivyFreeMemory(&allocator, allocations[index]);
+  }
+
+  TEST_ASSERT_EQUAL_INT(0, allocator.aliveAllocationCount);
+  TEST_ASSERT_NULL(allocator.largeBlocks);
+
+  // NOTE: clear releases large blocks that are still alive
+  TEST_ASSERT_NOT_NULL(ivyAllocateMemory(&allocator, 100000));
+  ivyClearMemoryAllocator(&allocator);
+  TEST_ASSERT_NULL(allocator.largeBlocks);
+
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testSlotsAreCacheLineAligned);
+  RUN_TEST(testFreedSlotIsReused);
+  RUN_TEST(testManyAllocations);
+  RUN_TEST(testLargeAllocationAndReallocate);
+  RUN_TEST(testLargeAllocationsSkipSlabs);
+
+  return UNITY_END();
+}
@@ -0,0 +1,126 @@
+#include <IvyStackMemoryAllocator.h>
+#include <unity.h>
+
+void setUp(void) {
+    // set stuff up here
+}
+
+void tearDown(void) {
+    // clean stuff up here
+}
+
+void testRequestTooMuchMemory(void) {
+  void *data;
+  IvyCode ivyCode;
+  IvyStackMemoryAllocator allocator;
+
+  ivyCode = ivyCreateStackMemoryAllocator(1024, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data = ivyAllocateMemory(&allocator, 1025);
+  TEST_ASSERT_NULL(data);
+
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testFreeTopAllocationPops(void) {
+  void *data1;
+  void *data2;
+  IvyCode ivyCode;
+  IvyStackMemoryAllocator allocator;
+
+  ivyCode = ivyCreateStackMemoryAllocator(1024, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data1 = ivyAllocateMemory(&allocator, 100);
+  TEST_ASSERT_NOT_NULL(data1);
+
+  data2 = ivyAllocateMemory(&allocator, 100);
+  TEST_ASSERT_NOT_NULL(data2);
+
+  ivyFreeMemory(&allocator, data2);
+  TEST_ASSERT_EQUAL_INT(104, allocator.position);
+
+  data2 = ivyAllocateMemory(&allocator, 100);
+  TEST_ASSERT_EQUAL_PTR((uint8_t *)data1 + 104, data2);
+
+  ivyFreeMemory(&allocator, data2);
+  ivyFreeMemory(&allocator, data1);
+  TEST_ASSERT_EQUAL_INT(0, allocator.position);
+
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testFreeToMarker(void) {
+  void *data;
+  IvyCode ivyCode;
+  IvyStackMemoryMarker marker;
+  IvyStackMemoryAllocator allocator;
+
+  ivyCode = ivyCreateStackMemoryAllocator(1024, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data = ivyAllocateMemory(&allocator, 64);
+  TEST_ASSERT_NOT_NULL(data);
+
+  ivyGetStackMemoryMarker(&allocator, &marker);
+
+  TEST_ASSERT_NOT_NULL(ivyAllocateMemory(&allocator, 128));
+  TEST_ASSERT_NOT_NULL(ivyAllocateMemory(&allocator, 256));
+
+  ivyFreeStackMemoryToMarker(&allocator, &marker);
+  TEST_ASSERT_EQUAL_INT(64, allocator.position);
+  TEST_ASSERT_EQUAL_INT(1, allocator.aliveAllocationCount);
+
+  ivyFreeMemory(&allocator, data);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testReallocateTopAllocationInPlace(void) {
+  uint8_t *data1;
+  uint8_t *data2;
+  IvyCode ivyCode;
+  IvyStackMemoryAllocator allocator;
+
+  ivyCode = ivyCreateStackMemoryAllocator(1024, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data1 = ivyAllocateMemory(&allocator, 16);
+  TEST_ASSERT_NOT_NULL(data1);
+
+  data2 = ivyReallocateMemory(&allocator, data1, 512);
+  TEST_ASSERT_EQUAL_PTR(data1, data2);
+  TEST_ASSERT_EQUAL_INT(512, allocator.position);
+
+  ivyFreeMemory(&allocator, data2);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testThreadScratchIsReused(void) {
+  IvyStackMemoryMarker marker;
+  IvyStackMemoryAllocator *scratchAllocator;
+
+  scratchAllocator = ivyGetThreadScratchMemoryAllocator();
+  TEST_ASSERT_NOT_NULL(scratchAllocator);
+  TEST_ASSERT_EQUAL_PTR(scratchAllocator,
+      ivyGetThreadScratchMemoryAllocator());
+
+  ivyGetStackMemoryMarker(scratchAllocator, &marker);
+  TEST_ASSERT_NOT_NULL(ivyAllocateMemory(scratchAllocator, 4096));
+  ivyFreeStackMemoryToMarker(scratchAllocator, &marker);
+  TEST_ASSERT_EQUAL_INT(0, scratchAllocator->position);
+
+  ivyDestroyThreadScratchMemoryAllocator();
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testRequestTooMuchMemory);
+  RUN_TEST(testFreeTopAllocationPops);
+  RUN_TEST(testFreeToMarker);
+  RUN_TEST(testReallocateTopAllocationInPlace);
+  RUN_TEST(testThreadScratchIsReused);
+
+  return UNITY_END();
+}
@@ -0,0 +1,189 @@
+#include <IvyTLSFMemoryAllocator.h>
+#include <unity.h>
+
+#define IVY_TEST_REGION_SIZE (1024 * 1024)
+#define IVY_TEST_SOAK_SLOT_COUNT 256
+#define IVY_TEST_SOAK_ITERATION_COUNT 20000
+
+void setUp(void) {
+    // set stuff up here
+}
+
+void tearDown(void) {
+    // clean stuff up here
+}
+
+void testAllocateAndFreeCoalesces(void) {
+  void *data1;
+  void *data2;
+  void *data3;
+  IvyCode ivyCode;
+  IvyTLSFMemoryAllocator allocator;
+  IvyTLSFMemoryStatistics statistics;
+
+  ivyCode = ivyCreateTLSFMemoryAllocator(IVY_TEST_REGION_SIZE, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data1 = ivyAllocateMemory(&allocator, 100);
+  data2 = ivyAllocateMemory(&allocator, 200);
+  data3 = ivyAllocateMemory(&allocator, 300);
+  TEST_ASSERT_NOT_NULL(data1);
+  TEST_ASSERT_NOT_NULL(data2);
+  TEST_ASSERT_NOT_NULL(data3);
+  TEST_ASSERT_EQUAL_INT(0, (uintptr_t)data1 % IVY_TLSF_ALIGNMENT);
+
+  ivyFreeMemory(&allocator, data2);
+
+  ivyGetTLSFMemoryStatistics(&allocator, &statistics);
+  TEST_ASSERT_EQUAL_INT(2, statistics.freeBlockCount);
+  TEST_ASSERT_EQUAL_INT(2, statistics.usedBlockCount);
+  TEST_ASSERT_TRUE(statistics.fragmentation > 0.0F);
+
+  ivyFreeMemory(&allocator, data1);
+  ivyFreeMemory(&allocator, data3);
+
+  ivyGetTLSFMemoryStatistics(&allocator, &statistics);
+  TEST_ASSERT_EQUAL_INT(1, statistics.freeBlockCount);
+  TEST_ASSERT_EQUAL_INT(0, statistics.usedBlockCount);
+  TEST_ASSERT_EQUAL_INT(0, statistics.usedSize);
+  TEST_ASSERT_TRUE(0.0F == statistics.fragmentation);
+
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testReallocateGrowsInPlace(void) {
+  uint8_t *data1;
+  uint8_t *data2;
+  IvyCode ivyCode;
+  IvyTLSFMemoryAllocator allocator;
+
+  ivyCode = ivyCreateTLSFMemoryAllocator(IVY_TEST_REGION_SIZE, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data1 = ivyAllocateMemory(&allocator, 64);
+  TEST_ASSERT_NOT_NULL(data1);
+  IVY_MEMSET(data1, 3, 64);
+
+  data2 = ivyReallocateMemory(&allocator, data1, 4096);
+  TEST_ASSERT_EQUAL_PTR(data1, data2);
+  TEST_ASSERT_EQUAL_INT(3, data2[63]);
+
+  data2 = ivyReallocateMemory(&allocator, data1, 32);
+  TEST_ASSERT_EQUAL_PTR(data1, data2);
+  TEST_ASSERT_EQUAL_INT(32, allocator.usedSize);
+
+  ivyFreeMemory(&allocator, data2);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testRegionExhaustion(void) {
+  void *data;
+  IvyCode ivyCode;
+  uint8_t region[4096];
+  IvyTLSFMemoryAllocator allocator;
+
+  ivyCode = ivyCreateTLSFMemoryAllocatorFromRegion(region, sizeof(region),
+      &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data = ivyAllocateMemory(&allocator, 8192);
+  TEST_ASSERT_NULL(data);
+
+  data = ivyAllocateMemory(&allocator, 1024);
+  TEST_ASSERT_NOT_NULL(data);
+
+  ivyFreeMemory(&allocator, data);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+// NOTE: a fixed seed keeps the sequence, and with it the heap layout, the
+//       same on every run
+IVY_INTERNAL uint32_t ivyNextTestRandom(uint32_t *state) {
+  *state = *state * 1664525U + 1013904223U;
+  return *state >> 8;
+}
+
+void testSoak(void) {
+  int index;
+  IvyCode ivyCode;
+  uint32_t state = 1;
+  uint8_t *allocations[IVY_TEST_SOAK_SLOT_COUNT];
+  uint32_t sizes[IVY_TEST_SOAK_SLOT_COUNT];
+  IvyTLSFMemoryAllocator allocator;
+  IvyTLSFMemoryStatistics statistics;
+
+  ivyCode = ivyCreateTLSFMemoryAllocator(8 * IVY_TEST_REGION_SIZE,
+      &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  IVY_MEMSET(allocations, 0, sizeof(allocations));
+  IVY_MEMSET(sizes, 0, sizeof(sizes));
+
+  for (index = 0; index < IVY_TEST_SOAK_ITERATION_COUNT; ++index) {
+    uint32_t const slot =
+        ivyNextTestRandom(&state) % IVY_TEST_SOAK_SLOT_COUNT;
+    uint32_t const size = 1 + ivyNextTestRandom(&state) % 8192;
+
+    if (allocations[slot]) {
+      TEST_ASSERT_EQUAL_INT(slot & 0xFF, allocations[slot][0]);
+      TEST_ASSERT_EQUAL_INT(slot & 0xFF, allocations[slot][sizes[slot] - 1]);
+    }
+
+    if (allocations[slot] && ivyNextTestRandom(&state) % 2) {
+      ivyFreeMemory(&allocator, allocations[slot]);
+      allocations[slot] = NULL;
+      continue;
+    }
+
+    allocations[slot] =
+        ivyReallocateMemory(&allocator, allocations[slot], size);
+    TEST_ASSERT_NOT_NULL(allocations[slot]);
+    sizes[slot] = size;
+    IVY_MEMSET(allocations[slot], slot & 0xFF, size);
+  }
+
+  ivyGetTLSFMemoryStatistics(&allocator, &statistics);
+  TEST_ASSERT_EQUAL_INT(allocator.aliveAllocationCount,
+      statistics.usedBlockCount);
+
+  for (index = 0; index < IVY_TEST_SOAK_SLOT_COUNT; ++index) {
+    ivyFreeMemory(&allocator, allocations[index]);
+  }
+
+  ivyGetTLSFMemoryStatistics(&allocator, &statistics);
+  TEST_ASSERT_EQUAL_INT(1, statistics.freeBlockCount);
+  TEST_ASSERT_EQUAL_INT(0, statistics.usedSize);
+
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+void testAsGlobalMemoryAllocator(void) {
+  void *data;
+  IvyCode ivyCode;
+  IvyTLSFMemoryAllocator allocator;
+
+  ivyCode = ivyCreateTLSFMemoryAllocator(IVY_TEST_REGION_SIZE, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivySetGlobalMemoryAllocator(&allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+  TEST_ASSERT_EQUAL_PTR(&allocator, ivyGetGlobalMemoryAllocator());
+
+  data = ivyAllocateMemory(ivyGetGlobalMemoryAllocator(), 128);
+  TEST_ASSERT_NOT_NULL(data);
+  ivyFreeMemory(ivyGetGlobalMemoryAllocator(), data);
+
+  ivyDestroyGlobalMemoryAllocator();
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testAllocateAndFreeCoalesces);
+  RUN_TEST(testReallocateGrowsInPlace);
+  RUN_TEST(testRegionExhaustion);
+  RUN_TEST(testSoak);
+  RUN_TEST(testAsGlobalMemoryAllocator);
+
+  return UNITY_END();
+}
@@ -0,0 +1,319 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <IvyAtomicArenaMemoryAllocator.h>
+#include <IvyDummyMemoryAllocator.h>
+#include <IvyThreadSafeMemoryAllocator.h>
+#include <pthread.h>
+#include <unity.h>
+
+#define IVY_TEST_THREAD_COUNT 4
+#define IVY_TEST_ITERATION_COUNT 2000
+#define IVY_TEST_LIVE_ALLOCATION_COUNT 32
+
+void setUp(void) {
+    // set stuff up here
+}
+
+void tearDown(void) {
+    // clean stuff up here
+}
+
+void testSmallAllocationsAreReused(void) {
+  void *data1;
+  void *data2;
+  IvyCode ivyCode;
+  IvyDummyMemoryAllocator backendAllocator;
+  IvyThreadSafeMemoryAllocator allocator;
+
+  ivyCode = ivyCreateDummyMemoryAllocator(&backendAllocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateThreadSafeMemoryAllocator(&backendAllocator, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data1 = ivyAllocateMemory(&allocator, 24);
+  TEST_ASSERT_NOT_NULL(data1);
+  TEST_ASSERT_EQUAL_INT(0, (uintptr_t)data1 % 16);
+
+  ivyFreeMemory(&allocator, data1);
+
+  data2 = ivyAllocateMemory(&allocator, 30);
+  TEST_ASSERT_EQUAL_PTR(data1, data2);
+
+  data2 = ivyReallocateMemory(&allocator, data2, 32);
+  TEST_ASSERT_EQUAL_PTR(data1, data2);
+
+  ivyFreeMemory(&allocator, data2);
+  TEST_ASSERT_EQUAL_INT(0, allocator.aliveAllocationCount);
+
+  ivyDestroyMemoryAllocator(&allocator);
+  ivyDestroyMemoryAllocator(&backendAllocator);
+}
+
+void testReallocateAcrossSizeClasses(void) {
+  int index;
+  uint8_t *data;
+  IvyCode ivyCode;
+  IvyDummyMemoryAllocator backendAllocator;
+  IvyThreadSafeMemoryAllocator allocator;
+
+  ivyCode = ivyCreateDummyMemoryAllocator(&backendAllocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateThreadSafeMemoryAllocator(&backendAllocator, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data = ivyAllocateMemory(&allocator, 16);
+  TEST_ASSERT_NOT_NULL(data);
+
+  for (index = 0; index < 16; ++index) {
+    data[index] = (uint8_t)index;
+  }
+
+  data = ivyReallocateMemory(&allocator, data, 200);
+  TEST_ASSERT_NOT_NULL(data);
+
+  data = ivyReallocateMemory(&allocator, data, 5000);
+  TEST_ASSERT_NOT_NULL(data);
+
+  data = ivyReallocateMemory(&allocator, data, 10000);
+  TEST_ASSERT_NOT_NULL(data);
+
+  for (index = 0; index < 16; ++index) {
+    TEST_ASSERT_EQUAL_INT(index, data[index]);
+  }
+
+  TEST_ASSERT_EQUAL_INT(1, allocator.aliveAllocationCount);
+
+  ivyFreeMemory(&allocator, data);
+  ivyDestroyMemoryAllocator(&allocator);
+  ivyDestroyMemoryAllocator(&backendAllocator);
+}
+
+IVY_INTERNAL void *ivyTestThreadSafeMemoryAllocatorThread(void *data) {
+  int index;
+  uint8_t *allocations[IVY_TEST_LIVE_ALLOCATION_COUNT];
+  IvyThreadSafeMemoryAllocator *allocator = data;
+
+  IVY_MEMSET(allocations, 0, sizeof(allocations));
+
+  for (index = 0; index < IVY_TEST_ITERATION_COUNT; ++index) {
+    int const slot = index % IVY_TEST_LIVE_ALLOCATION_COUNT;
+    uint64_t const size = 1 + (index * 37) % 600;
+
+    if (allocations[slot]) {
+      if (allocations[slot][0] != (uint8_t)slot) {
+        return allocator;
+      }
+
+      ivyFreeMemory(allocator, allocations[slot]);
+    }
+
+    allocations[slot] = ivyAllocateMemory(allocator, size);
+    if (!allocations[slot]) {
+      return allocator;
+    }
+
+    IVY_MEMSET(allocations[slot], slot, size);
+  }
+
+  for (index = 0; index < IVY_TEST_LIVE_ALLOCATION_COUNT; ++index) {
+    ivyFreeMemory(allocator, allocations[index]);
+  }
+
+  return NULL;
+}
+
+void testConcurrentAllocations(void) {
+  int index;
+  IvyCode ivyCode;
+  void *result;
+  pthread_t threads[IVY_TEST_THREAD_COUNT];
+  IvyDummyMemoryAllocator backendAllocator;
+  IvyThreadSafeMemoryAllocator allocator;
+
+  ivyCode = ivyCreateDummyMemoryAllocator(&backendAllocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateThreadSafeMemoryAllocator(&backendAllocator, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  for (index = 0; index < IVY_TEST_THREAD_COUNT; ++index) {
+    TEST_ASSERT_EQUAL_INT(0,
+        pthread_create(&threads[index], NULL,
+            ivyTestThreadSafeMemoryAllocatorThread, &allocator));
+  }
+
+  for (index = 0; index < IVY_TEST_THREAD_COUNT; ++index) {
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(threads[index], &result));
+    TEST_ASSERT_NULL(result);
+  }
+
+  TEST_ASSERT_EQUAL_INT(0, allocator.aliveAllocationCount);
+
+  ivyDestroyMemoryAllocator(&allocator);
+  ivyDestroyMemoryAllocator(&backendAllocator);
+}
+
+// NOTE: a worker that used the allocator and then stays alive until it's
+//       told to go, so the allocator is destroyed with its cache still
+//       registered
+typedef struct IvyTestLingeringThread {
+  IvyThreadSafeMemoryAllocator *allocator;
+  IvyBool shouldFlush;
+  IvyBool isReady;
+  IvyBool shouldExit;
+  pthread_mutex_t mutex;
+  pthread_cond_t condition;
+} IvyTestLingeringThread;
+
+IVY_INTERNAL void *ivyTestLingeringThread(void *data) {
+  void *allocation;
+  IvyTestLingeringThread *lingeringThread = data;
+
+  allocation = ivyAllocateMemory(lingeringThread->allocator, 64);
+  if (!allocation) {
+    return lingeringThread;
+  }
+
+  ivyFreeMemory(lingeringThread->allocator, allocation);
+
+  if (lingeringThread->shouldFlush) {
+    ivyFlushThreadSafeMemoryAllocatorCache(lingeringThread->allocator);
+  }
+
+  pthread_mutex_lock(&lingeringThread->mutex);
+  lingeringThread->isReady = 1;
+  pthread_cond_broadcast(&lingeringThread->condition);
+  while (!lingeringThread->shouldExit) {
+    pthread_cond_wait(&lingeringThread->condition, &lingeringThread->mutex);
+  }
+  pthread_mutex_unlock(&lingeringThread->mutex);
+
+  return NULL;
+}
+
+IVY_INTERNAL void ivyTestDestroyWithLingeringThread(IvyBool shouldFlush) {
+  IvyCode ivyCode;
+  void *result;
+  pthread_t thread;
+  IvyTestLingeringThread lingeringThread;
+  IvyDummyMemoryAllocator backendAllocator;
+  IvyThreadSafeMemoryAllocator allocator;
+
+  ivyCode = ivyCreateDummyMemoryAllocator(&backendAllocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateThreadSafeMemoryAllocator(&backendAllocator, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  lingeringThread.allocator = &allocator;
+  lingeringThread.shouldFlush = shouldFlush;
+  lingeringThread.isReady = 0;
+  lingeringThread.shouldExit = 0;
+  pthread_mutex_init(&lingeringThread.mutex, NULL);
+  pthread_cond_init(&lingeringThread.condition, NULL);
+
+  TEST_ASSERT_EQUAL_INT(0,
+      pthread_create(&thread, NULL, ivyTestLingeringThread,
+          &lingeringThread));
+
+  pthread_mutex_lock(&lingeringThread.mutex);
+  while (!lingeringThread.isReady) {
+    pthread_cond_wait(&lingeringThread.condition, &lingeringThread.mutex);
+  }
+  pthread_mutex_unlock(&lingeringThread.mutex);
+
+  // NOTE: clearing first must not leave the worker's cache pointing into
+  //       the freed chunks
+  ivyClearMemoryAllocator(&allocator);
+  TEST_ASSERT_EQUAL_INT(0, allocator.aliveAllocationCount);
+
+  ivyDestroyMemoryAllocator(&allocator);
+  TEST_ASSERT_EQUAL_INT(0, backendAllocator.aliveAllocationCount);
+
+  pthread_mutex_lock(&lingeringThread.mutex);
+  lingeringThread.shouldExit = 1;
+  pthread_cond_broadcast(&lingeringThread.condition);
+  pthread_mutex_unlock(&lingeringThread.mutex);
+
+  TEST_ASSERT_EQUAL_INT(0, pthread_join(thread, &result));
+  TEST_ASSERT_NULL(result);
+
+  pthread_cond_destroy(&lingeringThread.condition);
+  pthread_mutex_destroy(&lingeringThread.mutex);
+
+  ivyDestroyMemoryAllocator(&backendAllocator);
+}
+
+void testDestroyWithLingeringThread(void) {
+  ivyTestDestroyWithLingeringThread(0);
+}
+
+void testDestroyWithLingeringFlushedThread(void) {
+  ivyTestDestroyWithLingeringThread(1);
+}
+
+IVY_INTERNAL void *ivyTestAtomicArenaMemoryAllocatorThread(void *data) {
+  int index;
+  IvyAtomicArenaMemoryAllocator *allocator = data;
+
+  for (index = 0; index < IVY_TEST_ITERATION_COUNT; ++index) {
+    uint64_t *allocation = ivyAllocateMemory(allocator, sizeof(*allocation));
+    if (!allocation) {
+      return allocator;
+    }
+
+    *allocation = (uint64_t)index;
+  }
+
+  return NULL;
+}
+
+void testAtomicArenaConcurrentAllocations(void) {
+  int index;
+  IvyCode ivyCode;
+  void *result;
+  pthread_t threads[IVY_TEST_THREAD_COUNT];
+  IvyAtomicArenaMemoryAllocator allocator;
+  // NOTE: each allocation takes a 16 byte header and 16 bytes of data
+  uint64_t const size = IVY_TEST_THREAD_COUNT * IVY_TEST_ITERATION_COUNT * 32;
+
+  ivyCode = ivyCreateAtomicArenaMemoryAllocator(size, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  for (index = 0; index < IVY_TEST_THREAD_COUNT; ++index) {
+    TEST_ASSERT_EQUAL_INT(0,
+        pthread_create(&threads[index], NULL,
+            ivyTestAtomicArenaMemoryAllocatorThread, &allocator));
+  }
+
+  for (index = 0; index < IVY_TEST_THREAD_COUNT; ++index) {
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(threads[index], &result));
+    TEST_ASSERT_NULL(result);
+  }
+
+  TEST_ASSERT_TRUE(size == ivyGetAtomicArenaMemoryUsedSize(&allocator));
+  TEST_ASSERT_EQUAL_INT(IVY_TEST_THREAD_COUNT * IVY_TEST_ITERATION_COUNT,
+      allocator.aliveAllocationCount);
+  TEST_ASSERT_NULL(ivyAllocateMemory(&allocator, 1));
+
+  ivyClearMemoryAllocator(&allocator);
+  TEST_ASSERT_NOT_NULL(ivyAllocateMemory(&allocator, 1));
+
+  ivyClearMemoryAllocator(&allocator);
+  ivyDestroyMemoryAllocator(&allocator);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testSmallAllocationsAreReused);
+  RUN_TEST(testReallocateAcrossSizeClasses);
+  RUN_TEST(testConcurrentAllocations);
+  RUN_TEST(testDestroyWithLingeringThread);
+  RUN_TEST(testDestroyWithLingeringFlushedThread);
+  RUN_TEST(testAtomicArenaConcurrentAllocations);
+
+  return UNITY_END();
+}
@@ -0,0 +1,131 @@
+#include <IvyDummyMemoryAllocator.h>
+#include <IvyTrackingMemoryAllocator.h>
+#include <unity.h>
+
+void setUp(void) {
+    // set stuff up here
+}
+
+void tearDown(void) {
+    // clean stuff up here
+}
+
+void testCountsAndPeak(void) {
+  void *data1;
+  void *data2;
+  IvyCode ivyCode;
+  IvyMemoryAllocatorStats sharedStats;
+  IvyMemoryAllocatorStats stats;
+  IvyDummyMemoryAllocator backendAllocator;
+  IvyTrackingMemoryAllocator allocator;
+
+  IVY_MEMSET(&sharedStats, 0, sizeof(sharedStats));
+
+  ivyCode = ivyCreateDummyMemoryAllocator(&backendAllocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateTrackingMemoryAllocator(&backendAllocator,
+      IVY_MEMORY_TAG_MODEL, &sharedStats, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data1 = ivyAllocateMemory(&allocator, 100);
+  TEST_ASSERT_NOT_NULL(data1);
+  TEST_ASSERT_EQUAL_INT(0, (uintptr_t)data1 % 16);
+
+  data2 = ivyAllocateAndZeroMemory(&allocator, 4, 50);
+  TEST_ASSERT_NOT_NULL(data2);
+
+  ivyFreeMemory(&allocator, data1);
+
+  ivyGetMemoryAllocatorStats(&allocator, &stats);
+  TEST_ASSERT_EQUAL_INT(2, stats.total.allocationCount);
+  TEST_ASSERT_EQUAL_INT(1, stats.total.aliveAllocationCount);
+  TEST_ASSERT_EQUAL_INT(300, stats.total.allocatedSize);
+  TEST_ASSERT_EQUAL_INT(200, stats.total.aliveSize);
+  TEST_ASSERT_EQUAL_INT(300, stats.total.peakAliveSize);
+  TEST_ASSERT_EQUAL_INT(200, stats.tags[IVY_MEMORY_TAG_MODEL].aliveSize);
+  TEST_ASSERT_EQUAL_INT(0, stats.tags[IVY_MEMORY_TAG_TEXTURE].aliveSize);
+
+  // NOTE: 100 goes in the 128 bucket and 200 in the 256 one
+  TEST_ASSERT_EQUAL_INT(1, stats.sizeHistogram[3]);
+  TEST_ASSERT_EQUAL_INT(1, stats.sizeHistogram[4]);
+
+  ivyFreeMemory(&allocator, data2);
+
+  ivyGetMemoryAllocatorStats(&allocator, &stats);
+  TEST_ASSERT_EQUAL_INT(0, stats.total.aliveAllocationCount);
+  TEST_ASSERT_EQUAL_INT(0, stats.total.aliveSize);
+  TEST_ASSERT_EQUAL_INT(300, stats.total.peakAliveSize);
+
+  ivyDestroyMemoryAllocator(&allocator);
+  ivyDestroyMemoryAllocator(&backendAllocator);
+}
+
+void testTagsSharingStats(void) {
+  int index;
+  uint8_t *data1;
+  uint8_t *data2;
+  IvyCode ivyCode;
+  IvyMemoryAllocatorStats sharedStats;
+  IvyDummyMemoryAllocator backendAllocator;
+  IvyTrackingMemoryAllocator rendererAllocator;
+  IvyTrackingMemoryAllocator textureAllocator;
+
+  IVY_MEMSET(&sharedStats, 0, sizeof(sharedStats));
+
+  ivyCode = ivyCreateDummyMemoryAllocator(&backendAllocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateTrackingMemoryAllocator(&backendAllocator,
+      IVY_MEMORY_TAG_RENDERER, &sharedStats, &rendererAllocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateTrackingMemoryAllocator(&backendAllocator,
+      IVY_MEMORY_TAG_TEXTURE, &sharedStats, &textureAllocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  data1 = ivyAllocateMemory(&rendererAllocator, 64);
+  TEST_ASSERT_NOT_NULL(data1);
+
+  data2 = ivyAllocateMemory(&textureAllocator, 16);
+  TEST_ASSERT_NOT_NULL(data2);
+
+  for (index = 0; index < 16; ++index) {
+    data2[index] = (uint8_t)index;
+  }
+
+  data2 = ivyReallocateMemory(&textureAllocator, data2, 4096);
+  TEST_ASSERT_NOT_NULL(data2);
+
+  for (index = 0; index < 16; ++index) {
+    TEST_ASSERT_EQUAL_INT(index, data2[index]);
+  }
+
+  TEST_ASSERT_EQUAL_INT(64,
+      sharedStats.tags[IVY_MEMORY_TAG_RENDERER].aliveSize);
+  TEST_ASSERT_EQUAL_INT(4096,
+      sharedStats.tags[IVY_MEMORY_TAG_TEXTURE].aliveSize);
+  TEST_ASSERT_EQUAL_INT(4160, sharedStats.total.aliveSize);
+
+  // NOTE: allocations remember their tag
+  ivyFreeMemory(&rendererAllocator, data2);
+  TEST_ASSERT_EQUAL_INT(0,
+      sharedStats.tags[IVY_MEMORY_TAG_TEXTURE].aliveSize);
+  TEST_ASSERT_EQUAL_INT(64,
+      sharedStats.tags[IVY_MEMORY_TAG_RENDERER].aliveSize);
+
+  ivyFreeMemory(&rendererAllocator, data1);
+
+  ivyDestroyMemoryAllocator(&textureAllocator);
+  ivyDestroyMemoryAllocator(&rendererAllocator);
+  ivyDestroyMemoryAllocator(&backendAllocator);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testCountsAndPeak);
+  RUN_TEST(testTagsSharingStats);
+
+  return UNITY_END();
+}
@@ -0,0 +1,154 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <IvyDummyMemoryAllocator.h>
+#include <IvyVulkanHostMemoryAllocator.h>
+#include <pthread.h>
+#include <unity.h>
+
+void setUp(void) {
+    // set stuff up here
+}
+
+void tearDown(void) {
+    // clean stuff up here
+}
+
+// NOTE: stands in for a worker that recorded through Vulkan, the driver
+//       allocates and frees from it and the thread stays alive afterwards
+typedef struct IvyTestVulkanThread {
+  IvyVulkanHostMemoryAllocator *allocator;
+  IvyBool isReady;
+  IvyBool shouldExit;
+  pthread_mutex_t mutex;
+  pthread_cond_t condition;
+} IvyTestVulkanThread;
+
+IVY_INTERNAL void *ivyTestVulkanThread(void *data) {
+  void *command;
+  void *object;
+  IvyTestVulkanThread *vulkanThread = data;
+  VkAllocationCallbacks const *callbacks = &vulkanThread->allocator->callbacks;
+
+  command = callbacks->pfnAllocation(callbacks->pUserData, 64, 8,
+      VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+  object = callbacks->pfnAllocation(callbacks->pUserData, 200, 16,
+      VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+  if (!command || !object) {
+    return vulkanThread;
+  }
+
+  callbacks->pfnFree(callbacks->pUserData, object);
+  callbacks->pfnFree(callbacks->pUserData, command);
+
+  pthread_mutex_lock(&vulkanThread->mutex);
+  vulkanThread->isReady = 1;
+  pthread_cond_broadcast(&vulkanThread->condition);
+  while (!vulkanThread->shouldExit) {
+    pthread_cond_wait(&vulkanThread->condition, &vulkanThread->mutex);
+  }
+  pthread_mutex_unlock(&vulkanThread->mutex);
+
+  return NULL;
+}
+
+void testAllocationsAreAlignedAndTracked(void) {
+  uint8_t *data;
+  IvyCode ivyCode;
+  IvyDummyMemoryAllocator heapAllocator;
+  IvyVulkanHostMemoryAllocator allocator;
+  IvyVulkanHostMemoryStatistics statistics;
+  VkAllocationCallbacks const *callbacks;
+
+  ivyCode = ivyCreateDummyMemoryAllocator(&heapAllocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateVulkanHostMemoryAllocator(&heapAllocator, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  callbacks = &allocator.callbacks;
+
+  data = callbacks->pfnAllocation(callbacks->pUserData, 100, 64,
+      VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+  TEST_ASSERT_NOT_NULL(data);
+  TEST_ASSERT_EQUAL_INT(0, (uintptr_t)data % 64);
+
+  data = callbacks->pfnReallocation(callbacks->pUserData, data, 300, 64,
+      VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+  TEST_ASSERT_NOT_NULL(data);
+  TEST_ASSERT_EQUAL_INT(0, (uintptr_t)data % 64);
+
+  ivyGetVulkanHostMemoryStatistics(&allocator, &statistics);
+  TEST_ASSERT_EQUAL_INT(300, statistics.aliveSize);
+  TEST_ASSERT_EQUAL_INT(300,
+      statistics.aliveSizes[VK_SYSTEM_ALLOCATION_SCOPE_OBJECT]);
+  TEST_ASSERT_EQUAL_INT(0,
+      statistics.aliveSizes[VK_SYSTEM_ALLOCATION_SCOPE_DEVICE]);
+
+  callbacks->pfnFree(callbacks->pUserData, data);
+
+  ivyGetVulkanHostMemoryStatistics(&allocator, &statistics);
+  TEST_ASSERT_EQUAL_INT(0, statistics.aliveSize);
+  TEST_ASSERT_EQUAL_INT(2, statistics.allocationCount);
+
+  ivyDestroyVulkanHostMemoryAllocator(&allocator);
+  TEST_ASSERT_EQUAL_INT(0, heapAllocator.aliveAllocationCount);
+
+  ivyDestroyMemoryAllocator(&heapAllocator);
+}
+
+void testDestroyWhileDriverThreadIsAlive(void) {
+  IvyCode ivyCode;
+  void *result;
+  pthread_t thread;
+  IvyTestVulkanThread vulkanThread;
+  IvyDummyMemoryAllocator heapAllocator;
+  IvyVulkanHostMemoryAllocator allocator;
+
+  ivyCode = ivyCreateDummyMemoryAllocator(&heapAllocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  ivyCode = ivyCreateVulkanHostMemoryAllocator(&heapAllocator, &allocator);
+  TEST_ASSERT_EQUAL_INT(ivyCode, IVY_OK);
+
+  vulkanThread.allocator = &allocator;
+  vulkanThread.isReady = 0;
+  vulkanThread.shouldExit = 0;
+  pthread_mutex_init(&vulkanThread.mutex, NULL);
+  pthread_cond_init(&vulkanThread.condition, NULL);
+
+  TEST_ASSERT_EQUAL_INT(0,
+      pthread_create(&thread, NULL, ivyTestVulkanThread, &vulkanThread));
+
+  pthread_mutex_lock(&vulkanThread.mutex);
+  while (!vulkanThread.isReady) {
+    pthread_cond_wait(&vulkanThread.condition, &vulkanThread.mutex);
+  }
+  pthread_mutex_unlock(&vulkanThread.mutex);
+
+  // NOTE: the pool asserts that nothing is alive when it's destroyed, the
+  //       worker's cache included
+  ivyDestroyVulkanHostMemoryAllocator(&allocator);
+  TEST_ASSERT_EQUAL_INT(0, heapAllocator.aliveAllocationCount);
+
+  pthread_mutex_lock(&vulkanThread.mutex);
+  vulkanThread.shouldExit = 1;
+  pthread_cond_broadcast(&vulkanThread.condition);
+  pthread_mutex_unlock(&vulkanThread.mutex);
+
+  TEST_ASSERT_EQUAL_INT(0, pthread_join(thread, &result));
+  TEST_ASSERT_NULL(result);
+
+  pthread_cond_destroy(&vulkanThread.condition);
+  pthread_mutex_destroy(&vulkanThread.mutex);
+
+  ivyDestroyMemoryAllocator(&heapAllocator);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testAllocationsAreAlignedAndTracked);
+  RUN_TEST(testDestroyWhileDriverThreadIsAlive);
+
+  return UNITY_END();
+}